@@ -0,0 +1,294 @@
+#ifndef Benchmark_Stats_h
+#define Benchmark_Stats_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library includes.
+#include <algorithm>
+#include <chrono>
+#include <stdint.h>
+#include <stdio.h>
+#include <string>
+#include <vector>
+
+
+/// @brief Gets the current time of the monotonic clock all benchmarks are measured with
+/// @return Amount of microseconds since an unspecified point in time
+inline uint64_t Benchmark_Micros() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// @brief Gets the current time of the monotonic clock with the highest available resolution, used to measure single operations of the microbenchmarks
+/// @return Amount of nanoseconds since an unspecified point in time
+inline uint64_t Benchmark_Nanos() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/// @brief Gets the name of the configuration the library has been built with, contained in every result so that results of the static and dynamic as well as the STL and non-STL builds can be told apart
+/// @return Configuration name in the form "<static|dynamic>-<stl|nostl>"
+inline char const * Benchmark_Configuration() {
+#if THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_STL
+    return "dynamic-stl";
+#else
+    return "dynamic-nostl";
+#endif // THINGSBOARD_ENABLE_STL
+#else
+#if THINGSBOARD_ENABLE_STL
+    return "static-stl";
+#else
+    return "static-nostl";
+#endif // THINGSBOARD_ENABLE_STL
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+}
+
+
+/// @brief Logger passed to the library by the benchmarks, writes to stderr instead of stdout so that messages of the library do not end up between the results
+class Benchmark_Logger {
+  public:
+    /// @brief Writes the given message followed by a newline
+    /// @param message Message that should be written
+    /// @return Either the written amount of characters or an error indicator (being a negative number) if one occured
+    static int printfln(char const * message) {
+        return fprintf(stderr, "%s\n", message);
+    }
+
+    /// @brief Formats the given arguments into the given format and writes the result followed by a newline
+    /// @tparam ...Args Types of the arguments inserted into the format
+    /// @param format Format string the arguments are inserted into
+    /// @param ...args Arguments that replace their respective specifiers in the format
+    /// @return Either the written amount of characters or an error indicator (being a negative number) if one occured
+    template<typename... Args>
+    static int printfln(char const * format, Args const &... args) {
+        int const written_characters = fprintf(stderr, format, args...);
+        (void)fputc('\n', stderr);
+        return written_characters;
+    }
+};
+
+
+/// @brief Collects samples of a measured value, for example the latency of every message, and calculates statistics over all of them
+class Sample_Set {
+  public:
+    /// @brief Constructor
+    Sample_Set()
+      : m_samples()
+      , m_sorted(true)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Adds a single measured value
+    /// @param sample Measured value
+    void Add(uint64_t const & sample) {
+        m_samples.push_back(sample);
+        m_sorted = false;
+    }
+
+    /// @brief Removes all previously added values
+    void Clear() {
+        m_samples.clear();
+        m_sorted = true;
+    }
+
+    /// @brief Gets the amount of added values
+    /// @return Amount of added values
+    size_t Size() const {
+        return m_samples.size();
+    }
+
+    /// @brief Gets the value that the given percentage of all added values is smaller or equal to, uses the nearest-rank method
+    /// @param percent Percentage between 0 and 100
+    /// @return Value at the given percentile or 0 if no values were added
+    uint64_t Percentile(double const & percent) {
+        if (m_samples.empty()) {
+            return 0U;
+        }
+        Sort();
+        size_t rank = static_cast<size_t>(percent / 100.0 * m_samples.size() + 0.5);
+        rank = std::min(std::max(rank, static_cast<size_t>(1U)), m_samples.size());
+        return m_samples[rank - 1U];
+    }
+
+    /// @brief Gets the average of all added values
+    /// @return Average or 0 if no values were added
+    double Mean() const {
+        if (m_samples.empty()) {
+            return 0.0;
+        }
+        double sum = 0.0;
+        for (auto const & sample : m_samples) {
+            sum += sample;
+        }
+        return sum / m_samples.size();
+    }
+
+    /// @brief Gets the biggest added value
+    /// @return Biggest value or 0 if no values were added
+    uint64_t Max() const {
+        return m_samples.empty() ? 0U : *std::max_element(m_samples.begin(), m_samples.end());
+    }
+
+  private:
+    /// @brief Sorts the added values if values were added since the last time they were sorted
+    void Sort() {
+        if (!m_sorted) {
+            std::sort(m_samples.begin(), m_samples.end());
+            m_sorted = true;
+        }
+    }
+
+    std::vector<uint64_t> m_samples = {}; // All added values
+    bool                  m_sorted = {};  // Whether the values are currently sorted in ascending order
+};
+
+
+/// @brief Builds the result of a single benchmark as one JSON object per line (JSON Lines), so that the output of all benchmark executables can be concatenated and compared by scripts.
+/// Every result contains the name of the suite, the name of the benchmark and the configuration of the library, followed by the added key value pairs
+class Benchmark_Report {
+  public:
+    /// @brief Constructor
+    /// @param suite Name of the executable or group the benchmark belongs to
+    /// @param name Name of the benchmark itself
+    Benchmark_Report(char const * suite, char const * name)
+      : m_line()
+    {
+        Add("suite", suite);
+        Add("name", name);
+        Add("config", Benchmark_Configuration());
+    }
+
+    /// @brief Adds a string value
+    /// @param key Key of the value
+    /// @param value Value that will be escaped and written in quotes
+    /// @return Reference to this instance, allows to chain calls
+    Benchmark_Report & Add(char const * key, char const * value) {
+        Add_Key(key);
+        m_line += '"';
+        for (char const * character = value; character != nullptr && *character != '\0'; ++character) {
+            if (*character == '"' || *character == '\\') {
+                m_line += '\\';
+            }
+            m_line += *character;
+        }
+        m_line += '"';
+        return *this;
+    }
+
+    /// @brief Adds an integer value
+    /// @param key Key of the value
+    /// @param value Value
+    /// @return Reference to this instance, allows to chain calls
+    Benchmark_Report & Add(char const * key, uint64_t const & value) {
+        Add_Key(key);
+        m_line += std::to_string(value);
+        return *this;
+    }
+
+    /// @brief Adds a floating point value
+    /// @param key Key of the value
+    /// @param value Value, written with 3 decimal places
+    /// @return Reference to this instance, allows to chain calls
+    Benchmark_Report & Add(char const * key, double const & value) {
+        Add_Key(key);
+        char number[32U] = {};
+        (void)snprintf(number, sizeof(number), "%.3f", value);
+        m_line += number;
+        return *this;
+    }
+
+    /// @brief Adds the amount, mean, p50, p99 and maximum of the given samples, with the given prefix in front of every key
+    /// @param prefix Prefix of the keys, for example "latency_us" results in "latency_us_p50"
+    /// @param samples Samples the statistics are calculated from
+    /// @return Reference to this instance, allows to chain calls
+    Benchmark_Report & Add_Samples(char const * prefix, Sample_Set & samples) {
+        std::string key = prefix;
+        Add((key + "_mean").c_str(), samples.Mean());
+        Add((key + "_p50").c_str(), samples.Percentile(50.0));
+        Add((key + "_p99").c_str(), samples.Percentile(99.0));
+        Add((key + "_max").c_str(), samples.Max());
+        return *this;
+    }
+
+    /// @brief Writes the result as a single line
+    /// @param stream Stream the line is written to, default = stdout
+    void Print(FILE * stream = stdout) const {
+        (void)fprintf(stream, "{%s}\n", m_line.c_str());
+        (void)fflush(stream);
+    }
+
+  private:
+    /// @brief Adds the seperator to the previous value if there is one and the given key
+    /// @param key Key that should be added
+    void Add_Key(char const * key) {
+        if (!m_line.empty()) {
+            m_line += ',';
+        }
+        m_line += '"';
+        m_line += key;
+        m_line += "\":";
+    }
+
+    std::string m_line = {}; // Key value pairs that were added so far, without the surrounding braces
+};
+
+
+
+/// @brief Amount of batches every operation is measured in, the percentiles are calculated over the average duration of a single call in every batch
+size_t constexpr BENCHMARK_BATCHES = 30U;
+/// @brief Minimum duration of a single batch, the amount of calls per batch is doubled until a batch takes atleast this long, so that the resolution of the clock does not matter
+uint64_t constexpr BENCHMARK_BATCH_NANOSECONDS = 2000000U;
+
+/// @brief Prevents the compiler from optimizing away the calculation of the given value, because its result is otherwise never used
+/// @tparam T Type of the value
+/// @param value Value that has to be calculated
+template <typename T>
+inline void Benchmark_Keep(T const & value) {
+    asm volatile("" : : "g"(&value) : "memory");
+}
+
+/// @brief Measures how long a single call of the given operation takes, by calling it repeatedly in multiple batches
+/// @tparam Operation Callable without arguments
+/// @param suite Name of the executable or group the benchmark belongs to
+/// @param name Name of the benchmark itself
+/// @param operation Operation that should be measured
+/// @return Result containing the amount of calls and the p50, p99 and minimum duration of a single call in nanoseconds, parameters of the benchmark can be added before it is printed
+template <typename Operation>
+inline Benchmark_Report Measure_Operation(char const * suite, char const * name, Operation const & operation) {
+    uint64_t iterations = 1U;
+    while (iterations < (1U << 30U)) {
+        uint64_t const start = Benchmark_Nanos();
+        for (uint64_t i = 0U; i < iterations; ++i) {
+            operation();
+        }
+        if (Benchmark_Nanos() - start >= BENCHMARK_BATCH_NANOSECONDS) {
+            break;
+        }
+        iterations *= 2U;
+    }
+
+    // Durations are kept in picoseconds, because a single call of the fastest operations only takes a few nanoseconds
+    Sample_Set picoseconds;
+    uint64_t fastest = UINT64_MAX;
+    for (size_t batch = 0U; batch < BENCHMARK_BATCHES; ++batch) {
+        uint64_t const start = Benchmark_Nanos();
+        for (uint64_t i = 0U; i < iterations; ++i) {
+            operation();
+        }
+        uint64_t const duration = (Benchmark_Nanos() - start) * 1000U / iterations;
+        picoseconds.Add(duration);
+        fastest = std::min(fastest, duration);
+    }
+
+    uint64_t const median = picoseconds.Percentile(50.0);
+    Benchmark_Report report(suite, name);
+    report.Add("iterations", iterations * BENCHMARK_BATCHES)
+        .Add("ns_per_op_p50", median / 1000.0)
+        .Add("ns_per_op_p99", picoseconds.Percentile(99.0) / 1000.0)
+        .Add("ns_per_op_min", fastest / 1000.0)
+        .Add("ops_per_s", median != 0U ? 1000000000000.0 / median : 0.0);
+    return report;
+}
+
+#endif // Benchmark_Stats_h
@@ -0,0 +1,628 @@
+#ifndef Loopback_MQTT_Broker_h
+#define Loopback_MQTT_Broker_h
+
+// Local includes.
+#include "IMQTT_Client.h"
+#include "Benchmark_Stats.h"
+
+// Library includes.
+#include <algorithm>
+#include <map>
+#include <random>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <utility>
+#include <vector>
+
+
+// Topics of the server side of the ThingsBoard MQTT protocol, intentionally not shared with the library itself so that mistakes in the topics used by the library are noticed
+char constexpr LOOPBACK_TELEMETRY_TOPIC[] = "v1/devices/me/telemetry";
+char constexpr LOOPBACK_ATTRIBUTE_TOPIC[] = "v1/devices/me/attributes";
+char constexpr LOOPBACK_ATTRIBUTE_REQUEST_TOPIC[] = "v1/devices/me/attributes/request/";
+char constexpr LOOPBACK_ATTRIBUTE_RESPONSE_TOPIC[] = "v1/devices/me/attributes/response/";
+char constexpr LOOPBACK_RPC_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/";
+char constexpr LOOPBACK_RPC_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/";
+char constexpr LOOPBACK_PROVISION_REQUEST_TOPIC[] = "/provision/request";
+char constexpr LOOPBACK_PROVISION_RESPONSE_TOPIC[] = "/provision/response";
+char constexpr LOOPBACK_FIRMWARE_REQUEST_TOPIC[] = "v2/fw/request/";
+char constexpr LOOPBACK_FIRMWARE_RESPONSE_TOPIC[] = "v2/fw/response/";
+char constexpr LOOPBACK_CHUNK_TOPIC_PART[] = "/chunk/";
+char constexpr LOOPBACK_SHARED_KEYS[] = "\"sharedKeys\":\"";
+char constexpr LOOPBACK_CLIENT_KEYS[] = "\"clientKeys\":\"";
+char constexpr LOOPBACK_METHOD_KEY[] = "\"method\":\"";
+char constexpr LOOPBACK_DEFAULT_PROVISION_RESPONSE[] = "{\"status\":\"SUCCESS\",\"credentialsType\":\"ACCESS_TOKEN\",\"credentialsValue\":\"loopback\"}";
+// Same overhead PubSubClient expects in its buffer besides the topic and the payload, fixed header with the remaining length and the length of the topic
+size_t constexpr LOOPBACK_MQTT_OVERHEAD = 7U;
+
+
+/// @brief Part of the ThingsBoard MQTT protocol a message exchanged with the Loopback_MQTT_Broker belongs to
+enum class Loopback_API : uint8_t {
+    TELEMETRY,               ///< Telemetry sent by the device
+    ATTRIBUTES,              ///< Client-side attributes sent by the device
+    ATTRIBUTE_REQUEST,       ///< Attribute requests of the device and their responses
+    CLIENT_SIDE_RPC,         ///< RPC requests of the device and their responses
+    SERVER_SIDE_RPC,         ///< RPC requests of the server, started with Send_RPC_Request, and the responses of the device
+    SHARED_ATTRIBUTE_UPDATE, ///< Shared attribute updates of the server, started with Send_Shared_Attributes
+    PROVISION,               ///< Provisioning requests of the device and their responses
+    FIRMWARE,                ///< Firmware chunk requests of the device and the served chunks
+    OTHER                    ///< Any other topic, for example device claiming
+};
+
+/// @brief Amount of values in Loopback_API
+size_t constexpr LOOPBACK_API_AMOUNT = 9U;
+
+/// @brief Gets the name of the given API, used as the name of the benchmark results
+/// @param api API we want to get the name of
+/// @return Name of the API in lower case
+inline char const * Loopback_API_Name(Loopback_API const & api) {
+    static char const * const names[LOOPBACK_API_AMOUNT] = { "telemetry", "attributes", "attribute_request", "client_side_rpc", "server_side_rpc", "shared_attribute_update", "provision", "firmware", "other" };
+    return names[static_cast<size_t>(api)];
+}
+
+
+/// @brief Simulated properties of one direction of the network connection between the device and the Loopback_MQTT_Broker
+struct Loopback_Link {
+    uint64_t latency_microseconds = {}; // Fixed delay every message has before it is delivered
+    uint64_t jitter_microseconds = {};  // Maximum random delay, uniformly distributed, that is added to the fixed delay of every message
+    double   loss = {};                 // Probability between 0 and 1 that a message is lost and never delivered
+    uint64_t bandwidth = {};            // Amount of bytes per second the link can transfer, messages are serialized one after another. 0 means unlimited
+    bool     reorder = {};              // Whether the random delay may deliver messages in another order than they were sent in, otherwise messages are delivered in order like over TCP
+};
+
+
+/// @brief Statistics of a single Loopback_API, measured by the Loopback_MQTT_Broker
+struct Loopback_API_Stats {
+    size_t     messages = {};   // Amount of completed exchanges, a single message for telemetry, attributes and shared attribute updates or a request together with its response
+    size_t     published = {};  // Amount of messages published by the device, including requests that are sent again because their response did not arrive in time
+    size_t     bytes = {};      // Amount of topic and payload bytes of all messages, in both directions
+    size_t     lost = {};       // Amount of messages that were lost by the simulated link
+    size_t     rejected = {};   // Amount of messages that were not delivered, because they did not fit into the receive buffer or nobody subscribed to their topic
+    Sample_Set latency = {};    // Latency of every completed exchange in microseconds, from publishing the first message until the last message has been handled by the receiver
+};
+
+
+/// @brief In-process stand-in for a ThingsBoard server and the MQTT broker in front of it, implementing IMQTT_Client so that it can be passed to ThingsBoardSized directly.
+/// Serves telemetry and attribute sinks, attribute requests, client-side RPC, provisioning and firmware chunk requests with scripted responses,
+/// and allows to send server-side RPC requests and shared attribute updates to the device. Messages travel over two simulated links with configurable latency, jitter, loss and bandwidth,
+/// the server side handles messages once their delivery time has been reached and delivers messages to the device in loop(), which is called by ThingsBoardSized::loop().
+/// Everything runs on the calling thread, which allows to measure the end-to-end throughput and latency of the library without a network or a real server
+class Loopback_MQTT_Broker : public IMQTT_Client {
+  public:
+    /// @brief Constructor
+    /// @param seed Seed of the random number generator used for the simulated jitter and loss, allows to repeat runs exactly, default = 0
+    explicit Loopback_MQTT_Broker(uint32_t const & seed = 0U)
+      : m_data_callback()
+      , m_connect_callback()
+      , m_uplink()
+      , m_downlink()
+      , m_uplink_queue()
+      , m_downlink_queue()
+      , m_uplink_free(0U)
+      , m_downlink_free(0U)
+      , m_uplink_last(0U)
+      , m_downlink_last(0U)
+      , m_random(seed)
+      , m_receive_buffer_size(0U)
+      , m_send_buffer_size(0U)
+      , m_connected(false)
+      , m_subscriptions()
+      , m_shared_attributes()
+      , m_client_attributes()
+      , m_rpc_responses()
+      , m_provision_response(LOOPBACK_DEFAULT_PROVISION_RESPONSE)
+      , m_firmware()
+      , m_pending_server_rpc()
+      , m_next_server_rpc_id(0U)
+      , m_stats()
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+      , m_stream_topic()
+      , m_stream_payload()
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+    {
+        // Nothing to do
+    }
+
+    /// @brief Sets the simulated properties of the link from the device to the server
+    /// @param link Properties of the link
+    void Set_Uplink(Loopback_Link const & link) {
+        m_uplink = link;
+    }
+
+    /// @brief Sets the simulated properties of the link from the server to the device
+    /// @param link Properties of the link
+    void Set_Downlink(Loopback_Link const & link) {
+        m_downlink = link;
+    }
+
+    /// @brief Sets the value of an attribute, which is sent in the response to attribute requests for its key
+    /// @param shared Whether the attribute is a shared attribute or a client-side attribute
+    /// @param key Key of the attribute
+    /// @param json_value Value of the attribute serialized as json, strings therefore have to be quoted
+    void Set_Attribute(bool const & shared, char const * key, char const * json_value) {
+        (shared ? m_shared_attributes : m_client_attributes)[key] = json_value;
+    }
+
+    /// @brief Sets the response sent to client-side RPC requests with the given method, requests with methods that have no response set receive an empty json object
+    /// @param method Name of the requested method
+    /// @param json_response Response serialized as json
+    void Set_RPC_Response(char const * method, char const * json_response) {
+        m_rpc_responses[method] = json_response;
+    }
+
+    /// @brief Sets the response sent to provisioning requests
+    /// @param json_response Response serialized as json, default is a successful response with an access token
+    void Set_Provision_Response(char const * json_response) {
+        m_provision_response = json_response;
+    }
+
+    /// @brief Sets the firmware served to firmware chunk requests and the shared attributes describing it, which are requested by OTA_Firmware_Update before the update is started
+    /// @param title Title of the firmware
+    /// @param version Version of the firmware
+    /// @param checksum_algorithm Algorithm used to calculate the checksum, for example "SHA256"
+    /// @param checksum Checksum of the complete firmware as a hex string
+    /// @param data Firmware binary
+    /// @param size Size of the firmware binary
+    void Set_Firmware(char const * title, char const * version, char const * checksum_algorithm, char const * checksum, uint8_t const * data, size_t const & size) {
+        m_firmware.assign(data, data + size);
+        Set_Attribute(true, "fw_title", Quote(title).c_str());
+        Set_Attribute(true, "fw_version", Quote(version).c_str());
+        Set_Attribute(true, "fw_checksum_algorithm", Quote(checksum_algorithm).c_str());
+        Set_Attribute(true, "fw_checksum", Quote(checksum).c_str());
+        Set_Attribute(true, "fw_size", std::to_string(size).c_str());
+    }
+
+    /// @brief Sends a server-side RPC request to the device, the exchange is completed once the response of the device has been handled by the server
+    /// @param method Name of the requested method
+    /// @param json_params Parameters of the request serialized as json, default = "{}"
+    void Send_RPC_Request(char const * method, char const * json_params = "{}") {
+        size_t const id = m_next_server_rpc_id++;
+        uint64_t const now = Benchmark_Micros();
+        m_pending_server_rpc[id] = now;
+        std::string payload = "{\"method\":" + Quote(method) + ",\"params\":" + json_params + "}";
+        Enqueue(false, Loopback_API::SERVER_SIDE_RPC, LOOPBACK_RPC_REQUEST_TOPIC + std::to_string(id), payload, now, false);
+    }
+
+    /// @brief Sends a shared attribute update to the device, the exchange is completed once the update has been handled by the device
+    /// @param json_attributes Updated attributes serialized as a json object
+    void Send_Shared_Attributes(char const * json_attributes) {
+        Enqueue(false, Loopback_API::SHARED_ATTRIBUTE_UPDATE, LOOPBACK_ATTRIBUTE_TOPIC, json_attributes, Benchmark_Micros(), true);
+    }
+
+    /// @brief Gets the statistics of the given API
+    /// @param api API we want to get the statistics of
+    /// @return Statistics measured since the creation of this instance or the last call to Reset_Stats
+    Loopback_API_Stats & Get_Stats(Loopback_API const & api) {
+        return m_stats[static_cast<size_t>(api)];
+    }
+
+    /// @brief Resets the statistics of all APIs
+    void Reset_Stats() {
+        for (auto & stats : m_stats) {
+            stats = Loopback_API_Stats();
+        }
+    }
+
+    /// @brief Gets the amount of messages that are currently travelling over one of the links
+    /// @return Amount of messages that have not been delivered yet
+    size_t In_Flight() const {
+        return m_uplink_queue.size() + m_downlink_queue.size();
+    }
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override {
+        m_data_callback.Set_Callback(callback);
+    }
+
+    void set_connect_callback(Callback<void>::function callback) override {
+        m_connect_callback.Set_Callback(callback);
+    }
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        m_receive_buffer_size = receive_buffer_size;
+        m_send_buffer_size = send_buffer_size;
+        return true;
+    }
+
+    uint16_t get_receive_buffer_size() override {
+        return m_receive_buffer_size;
+    }
+
+    uint16_t get_send_buffer_size() override {
+        return m_send_buffer_size;
+    }
+
+    void set_server(char const * domain, uint16_t port) override {
+        // Nothing to do, the server is always in the same process
+    }
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override {
+        m_connected = true;
+        m_connect_callback.Call_Callback();
+        return true;
+    }
+
+    void disconnect() override {
+        m_connected = false;
+        m_subscriptions.clear();
+        m_uplink_queue.clear();
+        m_downlink_queue.clear();
+    }
+
+    bool loop() override {
+        if (!m_connected) {
+            return false;
+        }
+        uint64_t const now = Benchmark_Micros();
+        while (!m_uplink_queue.empty() && m_uplink_queue.begin()->first <= now) {
+            Loopback_Message const message = std::move(m_uplink_queue.begin()->second);
+            m_uplink_queue.erase(m_uplink_queue.begin());
+            Handle_Uplink(message);
+        }
+        while (m_connected && !m_downlink_queue.empty() && m_downlink_queue.begin()->first <= now) {
+            Loopback_Message message = std::move(m_downlink_queue.begin()->second);
+            m_downlink_queue.erase(m_downlink_queue.begin());
+            Deliver_Downlink(message);
+        }
+        return true;
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
+        if (!m_connected || LOOPBACK_MQTT_OVERHEAD + strlen(topic) + length > m_send_buffer_size) {
+            return false;
+        }
+        Enqueue(true, Classify_Uplink(topic), topic, std::string(reinterpret_cast<char const *>(payload), length), Benchmark_Micros(), false);
+        return true;
+    }
+
+    bool subscribe(char const * topic) override {
+        if (!m_connected) {
+            return false;
+        }
+        for (auto const & subscription : m_subscriptions) {
+            if (subscription == topic) {
+                return true;
+            }
+        }
+        m_subscriptions.emplace_back(topic);
+        return true;
+    }
+
+    bool unsubscribe(char const * topic) override {
+        if (!m_connected) {
+            return false;
+        }
+        for (auto it = m_subscriptions.begin(); it != m_subscriptions.end(); ++it) {
+            if (*it == topic) {
+                m_subscriptions.erase(it);
+                break;
+            }
+        }
+        return true;
+    }
+
+    bool connected() override {
+        return m_connected;
+    }
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+    bool begin_publish(char const * topic, size_t const & length) override {
+        if (!m_connected) {
+            return false;
+        }
+        m_stream_topic = topic;
+        m_stream_payload.clear();
+        m_stream_payload.reserve(length);
+        return true;
+    }
+
+    bool end_publish() override {
+        if (!m_connected) {
+            return false;
+        }
+        Enqueue(true, Classify_Uplink(m_stream_topic.c_str()), m_stream_topic, m_stream_payload, Benchmark_Micros(), false);
+        return true;
+    }
+
+    size_t write(uint8_t payload_byte) override {
+        m_stream_payload += static_cast<char>(payload_byte);
+        return 1U;
+    }
+
+    size_t write(uint8_t const * buffer, size_t const & size) override {
+        m_stream_payload.append(reinterpret_cast<char const *>(buffer), size);
+        return size;
+    }
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+  private:
+    /// @brief Message travelling over one of the simulated links
+    struct Loopback_Message {
+        Loopback_API api = {};      // API the message belongs to
+        std::string  topic = {};    // Topic the message was published on
+        std::string  payload = {};  // Payload of the message
+        uint64_t     origin = {};   // Point in time the exchange the message belongs to was started at
+        bool         completes = {}; // Whether handling the message completes the exchange it belongs to
+    };
+
+    /// @brief Calculates the delivery time of a message over the given link and queues it, unless the link loses it
+    /// @param uplink Whether the message is sent from the device to the server or the other way around
+    /// @param api API the message belongs to
+    /// @param topic Topic the message is published on
+    /// @param payload Payload of the message
+    /// @param origin Point in time the exchange the message belongs to was started at
+    /// @param completes Whether handling the message completes the exchange it belongs to
+    void Enqueue(bool const & uplink, Loopback_API const & api, std::string const & topic, std::string const & payload, uint64_t const & origin, bool const & completes) {
+        Loopback_API_Stats & stats = Get_Stats(api);
+        stats.bytes += topic.size() + payload.size();
+        if (uplink) {
+            stats.published++;
+        }
+        Loopback_Link const & link = uplink ? m_uplink : m_downlink;
+        if (link.loss > 0.0 && std::uniform_real_distribution<double>(0.0, 1.0)(m_random) < link.loss) {
+            stats.lost++;
+            return;
+        }
+        uint64_t const now = Benchmark_Micros();
+        uint64_t & link_free = uplink ? m_uplink_free : m_downlink_free;
+        uint64_t & last_delivery = uplink ? m_uplink_last : m_downlink_last;
+        // Messages are put onto the link one after another, therefore a message has to wait until all previous messages have been sent
+        uint64_t sent = std::max(now, link_free);
+        if (link.bandwidth != 0U) {
+            sent += (topic.size() + payload.size() + LOOPBACK_MQTT_OVERHEAD) * 1000000U / link.bandwidth;
+        }
+        link_free = sent;
+        uint64_t delivery = sent + link.latency_microseconds;
+        if (link.jitter_microseconds != 0U) {
+            delivery += std::uniform_int_distribution<uint64_t>(0U, link.jitter_microseconds)(m_random);
+        }
+        if (!link.reorder) {
+            delivery = std::max(delivery, last_delivery);
+            last_delivery = delivery;
+        }
+        Loopback_Message message;
+        message.api = api;
+        message.topic = topic;
+        message.payload = payload;
+        message.origin = origin;
+        message.completes = completes;
+        // Messages with the same delivery time are inserted after the already existing ones and are therefore still delivered in order
+        (uplink ? m_uplink_queue : m_downlink_queue).emplace(delivery, std::move(message));
+    }
+
+    /// @brief Gets the API a message published by the device belongs to
+    /// @param topic Topic the message was published on
+    /// @return API the message belongs to
+    static Loopback_API Classify_Uplink(char const * topic) {
+        if (strcmp(topic, LOOPBACK_TELEMETRY_TOPIC) == 0) {
+            return Loopback_API::TELEMETRY;
+        }
+        else if (strcmp(topic, LOOPBACK_ATTRIBUTE_TOPIC) == 0) {
+            return Loopback_API::ATTRIBUTES;
+        }
+        else if (Starts_With(topic, LOOPBACK_ATTRIBUTE_REQUEST_TOPIC)) {
+            return Loopback_API::ATTRIBUTE_REQUEST;
+        }
+        else if (Starts_With(topic, LOOPBACK_RPC_REQUEST_TOPIC)) {
+            return Loopback_API::CLIENT_SIDE_RPC;
+        }
+        else if (Starts_With(topic, LOOPBACK_RPC_RESPONSE_TOPIC)) {
+            return Loopback_API::SERVER_SIDE_RPC;
+        }
+        else if (strcmp(topic, LOOPBACK_PROVISION_REQUEST_TOPIC) == 0) {
+            return Loopback_API::PROVISION;
+        }
+        else if (Starts_With(topic, LOOPBACK_FIRMWARE_REQUEST_TOPIC)) {
+            return Loopback_API::FIRMWARE;
+        }
+        return Loopback_API::OTHER;
+    }
+
+    /// @brief Handles a message published by the device, once it has arrived at the server, and queues the response if the message was a request
+    /// @param message Message that arrived at the server
+    void Handle_Uplink(Loopback_Message const & message) {
+        char const * topic = message.topic.c_str();
+        switch (message.api) {
+            case Loopback_API::ATTRIBUTE_REQUEST: {
+                std::string response = "{";
+                Append_Attributes(response, "client", m_client_attributes, Find_Value(message.payload, LOOPBACK_CLIENT_KEYS));
+                Append_Attributes(response, "shared", m_shared_attributes, Find_Value(message.payload, LOOPBACK_SHARED_KEYS));
+                response += "}";
+                Enqueue(false, message.api, LOOPBACK_ATTRIBUTE_RESPONSE_TOPIC + Suffix(topic, LOOPBACK_ATTRIBUTE_REQUEST_TOPIC), response, message.origin, true);
+                break;
+            }
+            case Loopback_API::CLIENT_SIDE_RPC: {
+                auto const response = m_rpc_responses.find(Find_Value(message.payload, LOOPBACK_METHOD_KEY));
+                Enqueue(false, message.api, LOOPBACK_RPC_RESPONSE_TOPIC + Suffix(topic, LOOPBACK_RPC_REQUEST_TOPIC), response != m_rpc_responses.end() ? response->second : "{}", message.origin, true);
+                break;
+            }
+            case Loopback_API::SERVER_SIDE_RPC: {
+                auto const pending = m_pending_server_rpc.find(strtoul(topic + strlen(LOOPBACK_RPC_RESPONSE_TOPIC), nullptr, 10));
+                if (pending != m_pending_server_rpc.end()) {
+                    Complete(message.api, pending->second);
+                    m_pending_server_rpc.erase(pending);
+                }
+                break;
+            }
+            case Loopback_API::PROVISION:
+                Enqueue(false, message.api, LOOPBACK_PROVISION_RESPONSE_TOPIC, m_provision_response, message.origin, true);
+                break;
+            case Loopback_API::FIRMWARE: {
+                // Topic has the form v2/fw/request/<request id>/chunk/<chunk index> and the payload contains the chunk size
+                std::string const request = Suffix(topic, LOOPBACK_FIRMWARE_REQUEST_TOPIC);
+                size_t const chunk_part = request.find(LOOPBACK_CHUNK_TOPIC_PART);
+                if (chunk_part == std::string::npos) {
+                    break;
+                }
+                size_t const chunk = strtoul(request.c_str() + chunk_part + strlen(LOOPBACK_CHUNK_TOPIC_PART), nullptr, 10);
+                size_t const chunk_size = strtoul(message.payload.c_str(), nullptr, 10);
+                size_t const offset = std::min(chunk * chunk_size, m_firmware.size());
+                size_t const length = std::min(chunk_size, m_firmware.size() - offset);
+                Enqueue(false, message.api, LOOPBACK_FIRMWARE_RESPONSE_TOPIC + request, std::string(m_firmware.begin() + offset, m_firmware.begin() + offset + length), message.origin, true);
+                break;
+            }
+            default:
+                // Telemetry, attributes and any other messages are simply received by the server
+                Complete(message.api, message.origin);
+                break;
+        }
+    }
+
+    /// @brief Delivers a message sent by the server to the device, if the device subscribed to its topic and it fits into the receive buffer
+    /// @param message Message that arrived at the device
+    void Deliver_Downlink(Loopback_Message & message) {
+        Loopback_API_Stats & stats = Get_Stats(message.api);
+        if (!Is_Subscribed(message.topic) || LOOPBACK_MQTT_OVERHEAD + message.topic.size() + message.payload.size() > m_receive_buffer_size) {
+            stats.rejected++;
+            return;
+        }
+        // Data callback expects mutable null-terminated strings, which the message owns until the callback returns
+        m_data_callback.Call_Callback(&message.topic[0], reinterpret_cast<uint8_t *>(&message.payload[0]), static_cast<unsigned int>(message.payload.size()));
+        if (message.completes) {
+            Complete(message.api, message.origin);
+        }
+    }
+
+    /// @brief Accounts a completed exchange
+    /// @param api API the exchange belongs to
+    /// @param origin Point in time the exchange was started at
+    void Complete(Loopback_API const & api, uint64_t const & origin) {
+        Loopback_API_Stats & stats = Get_Stats(api);
+        stats.messages++;
+        stats.latency.Add(Benchmark_Micros() - origin);
+    }
+
+    /// @brief Whether the device subscribed to a topic filter matching the given topic, supports the single-level (+) and multi-level (#) wildcard.
+    /// A single-level wildcard at the end of the filter matches all remaining levels like ThingsBoard does, because the library subscribes to v2/fw/response/+ to receive v2/fw/response/<id>/chunk/<index>
+    /// @param topic Topic a message is published on
+    /// @return Whether a matching subscription exists
+    bool Is_Subscribed(std::string const & topic) const {
+        for (auto const & filter : m_subscriptions) {
+            size_t topic_index = 0U;
+            size_t filter_index = 0U;
+            bool matches = true;
+            while (filter_index < filter.size()) {
+                if (filter[filter_index] == '#') {
+                    topic_index = topic.size();
+                    filter_index = filter.size();
+                    break;
+                }
+                else if (filter[filter_index] == '+') {
+                    bool const last_level = filter_index + 1U == filter.size();
+                    while (topic_index < topic.size() && (last_level || topic[topic_index] != '/')) {
+                        topic_index++;
+                    }
+                    filter_index++;
+                }
+                else if (topic_index < topic.size() && filter[filter_index] == topic[topic_index]) {
+                    topic_index++;
+                    filter_index++;
+                }
+                else {
+                    matches = false;
+                    break;
+                }
+            }
+            if (matches && topic_index == topic.size()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Appends the requested attributes of one scope to an attribute response
+    /// @param response Response the attributes are appended to
+    /// @param scope Key of the scope in the response
+    /// @param attributes All attributes of the scope
+    /// @param requested_keys Comma seperated keys that were requested, nothing is appended if it is empty
+    static void Append_Attributes(std::string & response, char const * scope, std::map<std::string, std::string> const & attributes, std::string const & requested_keys) {
+        if (requested_keys.empty()) {
+            return;
+        }
+        if (response.size() > 1U) {
+            response += ",";
+        }
+        response += Quote(scope) + ":{";
+        bool first = true;
+        size_t start = 0U;
+        while (start <= requested_keys.size()) {
+            size_t end = requested_keys.find(',', start);
+            if (end == std::string::npos) {
+                end = requested_keys.size();
+            }
+            auto const attribute = attributes.find(requested_keys.substr(start, end - start));
+            if (attribute != attributes.end()) {
+                response += (first ? "" : ",") + Quote(attribute->first.c_str()) + ":" + attribute->second;
+                first = false;
+            }
+            start = end + 1U;
+        }
+        response += "}";
+    }
+
+    /// @brief Gets the string value following the given key in a json payload, without parsing the complete payload
+    /// @param payload Json payload the value is searched in
+    /// @param key Key including the quotes, the colon and the opening quote of the value
+    /// @return Value until the closing quote or an empty string if the key was not found
+    static std::string Find_Value(std::string const & payload, char const * key) {
+        size_t const start = payload.find(key);
+        if (start == std::string::npos) {
+            return std::string();
+        }
+        size_t const value_start = start + strlen(key);
+        size_t const value_end = payload.find('"', value_start);
+        return payload.substr(value_start, value_end == std::string::npos ? std::string::npos : value_end - value_start);
+    }
+
+    /// @brief Whether the given topic starts with the given prefix
+    /// @param topic Topic that should be checked
+    /// @param prefix Prefix the topic should start with
+    /// @return Whether the topic starts with the prefix
+    static bool Starts_With(char const * topic, char const * prefix) {
+        return strncmp(topic, prefix, strlen(prefix)) == 0;
+    }
+
+    /// @brief Gets the part of the topic after the given prefix, which is mostly the request id
+    /// @param topic Topic starting with the given prefix
+    /// @param prefix Prefix of the topic
+    /// @return Remaining part of the topic
+    static std::string Suffix(char const * topic, char const * prefix) {
+        return std::string(topic + strlen(prefix));
+    }
+
+    /// @brief Surrounds the given string with quotes, to use it as a json string
+    /// @param value String that should be quoted
+    /// @return Quoted string
+    static std::string Quote(char const * value) {
+        return "\"" + std::string(value) + "\"";
+    }
+
+    Callback<void, char *, uint8_t *, unsigned int> m_data_callback = {};        // Callback messages delivered to the device are passed to
+    Callback<void>                                  m_connect_callback = {};     // Callback that is called once the device has connected
+    Loopback_Link                                   m_uplink = {};               // Simulated link from the device to the server
+    Loopback_Link                                   m_downlink = {};             // Simulated link from the server to the device
+    std::multimap<uint64_t, Loopback_Message>       m_uplink_queue = {};         // Messages travelling to the server, ordered by their delivery time
+    std::multimap<uint64_t, Loopback_Message>       m_downlink_queue = {};       // Messages travelling to the device, ordered by their delivery time
+    uint64_t                                        m_uplink_free = {};          // Point in time the uplink has sent all previous messages and is free again
+    uint64_t                                        m_downlink_free = {};        // Point in time the downlink has sent all previous messages and is free again
+    uint64_t                                        m_uplink_last = {};          // Delivery time of the last message queued on the uplink, used to keep the order if reordering is disabled
+    uint64_t                                        m_downlink_last = {};        // Delivery time of the last message queued on the downlink, used to keep the order if reordering is disabled
+    std::mt19937                                    m_random;                    // Random number generator used for the simulated jitter and loss
+    uint16_t                                        m_receive_buffer_size = {};  // Maximum size of messages delivered to the device, including LOOPBACK_MQTT_OVERHEAD
+    uint16_t                                        m_send_buffer_size = {};     // Maximum size of messages published by the device, including LOOPBACK_MQTT_OVERHEAD
+    bool                                            m_connected = {};            // Whether the device is currently connected
+    std::vector<std::string>                        m_subscriptions = {};        // Topic filters the device subscribed to
+    std::map<std::string, std::string>              m_shared_attributes = {};    // Shared attributes and their values serialized as json
+    std::map<std::string, std::string>              m_client_attributes = {};    // Client-side attributes and their values serialized as json
+    std::map<std::string, std::string>              m_rpc_responses = {};        // Responses to client-side RPC requests for every method, serialized as json
+    std::string                                     m_provision_response = {};   // Response to provisioning requests, serialized as json
+    std::vector<uint8_t>                            m_firmware = {};             // Firmware binary served to firmware chunk requests
+    std::map<size_t, uint64_t>                      m_pending_server_rpc = {};   // Point in time every server-side RPC request that did not receive a response yet has been sent at
+    size_t                                          m_next_server_rpc_id = {};   // Id of the next server-side RPC request
+    Loopback_API_Stats                              m_stats[LOOPBACK_API_AMOUNT]; // Statistics of every API
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+    std::string                                     m_stream_topic = {};         // Topic of the message that is currently streamed with begin_publish
+    std::string                                     m_stream_payload = {};       // Payload written so far to the message that is currently streamed with begin_publish
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+};
+
+#endif // Loopback_MQTT_Broker_h
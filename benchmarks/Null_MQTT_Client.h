@@ -0,0 +1,143 @@
+#ifndef Null_MQTT_Client_h
+#define Null_MQTT_Client_h
+
+// Local include.
+#include "IMQTT_Client.h"
+
+// Library includes.
+#include <string.h>
+#include <string>
+
+
+/// @brief MQTT client that is always connected and discards everything that is published, only counting the amount of messages and bytes.
+/// Used by the microbenchmarks to measure the time the library itself needs to serialize and dispatch messages, without any influence of a network or a broker.
+/// Messages received from the server can be simulated with Deliver(), which directly calls the data callback registered by ThingsBoardSized
+class Null_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructor
+    Null_MQTT_Client()
+      : m_data_callback()
+      , m_connect_callback()
+      , m_receive_buffer_size(0U)
+      , m_send_buffer_size(0U)
+      , m_published_messages(0U)
+      , m_published_bytes(0U)
+      , m_topic()
+      , m_payload()
+    {
+        // Nothing to do
+    }
+
+    /// @brief Passes the given message to the data callback, as if it had been received from the server.
+    /// Topic and payload are copied into internal buffers first, because the callback receives mutable pointers like it does with a real MQTT client
+    /// @param topic Topic the message has been published on
+    /// @param payload Payload of the message
+    /// @param length Length of the payload
+    void Deliver(char const * topic, uint8_t const * payload, size_t const & length) {
+        m_topic.assign(topic);
+        m_payload.assign(reinterpret_cast<char const *>(payload), length);
+        m_data_callback.Call_Callback(&m_topic[0], reinterpret_cast<uint8_t *>(&m_payload[0]), length);
+    }
+
+    /// @brief Gets the amount of messages published since the creation of the instance
+    /// @return Amount of published messages
+    size_t Get_Published_Messages() const {
+        return m_published_messages;
+    }
+
+    /// @brief Gets the amount of payload bytes published since the creation of the instance
+    /// @return Amount of published bytes
+    size_t Get_Published_Bytes() const {
+        return m_published_bytes;
+    }
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override {
+        m_data_callback.Set_Callback(callback);
+    }
+
+    void set_connect_callback(Callback<void>::function callback) override {
+        m_connect_callback.Set_Callback(callback);
+    }
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        m_receive_buffer_size = receive_buffer_size;
+        m_send_buffer_size = send_buffer_size;
+        return true;
+    }
+
+    uint16_t get_receive_buffer_size() override {
+        return m_receive_buffer_size;
+    }
+
+    uint16_t get_send_buffer_size() override {
+        return m_send_buffer_size;
+    }
+
+    void set_server(char const * domain, uint16_t port) override {
+        // Nothing to do, there is no server
+    }
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override {
+        m_connect_callback.Call_Callback();
+        return true;
+    }
+
+    void disconnect() override {
+        // Nothing to do, the client is always connected
+    }
+
+    bool loop() override {
+        return true;
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
+        m_published_messages++;
+        m_published_bytes += length;
+        return true;
+    }
+
+    bool subscribe(char const * topic) override {
+        return true;
+    }
+
+    bool unsubscribe(char const * topic) override {
+        return true;
+    }
+
+    bool connected() override {
+        return true;
+    }
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+    bool begin_publish(char const * topic, size_t const & length) override {
+        m_published_messages++;
+        return true;
+    }
+
+    bool end_publish() override {
+        return true;
+    }
+
+    size_t write(uint8_t payload_byte) override {
+        m_published_bytes++;
+        return 1U;
+    }
+
+    size_t write(uint8_t const * buffer, size_t const & size) override {
+        m_published_bytes += size;
+        return size;
+    }
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+  private:
+    Callback<void, char *, uint8_t *, unsigned int> m_data_callback = {};       // Callback messages passed to Deliver() are forwarded to
+    Callback<void>                                  m_connect_callback = {};    // Callback that is called once connect() has been called
+    uint16_t                                        m_receive_buffer_size = {}; // Receive buffer size requested by the library, not enforced
+    uint16_t                                        m_send_buffer_size = {};    // Send buffer size requested by the library, not enforced
+    size_t                                          m_published_messages = {};  // Amount of messages published so far
+    size_t                                          m_published_bytes = {};     // Amount of payload bytes published so far
+    std::string                                     m_topic = {};               // Copy of the topic of the message that is currently delivered
+    std::string                                     m_payload = {};             // Copy of the payload of the message that is currently delivered
+};
+
+#endif // Null_MQTT_Client_h
@@ -0,0 +1,306 @@
+// Measures the end-to-end throughput and latency of every API of the library, connected to the in-process Loopback_MQTT_Broker instead of a real ThingsBoard server.
+// Prints one JSON object per API to stdout, containing the messages per second, the bytes per message and the p50 / p99 latency.
+//
+// Usage: end_to_end_benchmark [--messages N] [--latency-us N] [--jitter-us N] [--loss P] [--bandwidth B] [--timeout-us N] [--firmware-size N] [--chunk-size N] [--seed N]
+
+// Local includes.
+#include "Loopback_MQTT_Broker.h"
+#include "Benchmark_Stats.h"
+
+// Library includes.
+#include <ThingsBoard.h>
+#include <Server_Side_RPC.h>
+#include <Client_Side_RPC.h>
+#include <Attribute_Request.h>
+#include <Shared_Attribute_Update.h>
+#include <Provision.h>
+#include <OTA_Firmware_Update.h>
+#include <HashGenerator.h>
+#include <IUpdater.h>
+#include <functional>
+#include <stdlib.h>
+#include <string.h>
+#include <vector>
+
+
+constexpr char BENCHMARK_SUITE[] = "end_to_end";
+constexpr char BENCHMARK_HOST[] = "loopback";
+constexpr char BENCHMARK_TOKEN[] = "benchmark";
+constexpr char BENCHMARK_RPC_METHOD[] = "benchmark";
+constexpr char BENCHMARK_FW_TITLE[] = "benchmark";
+constexpr char BENCHMARK_FW_CURRENT_VERSION[] = "1.0.0";
+constexpr char BENCHMARK_FW_VERSION[] = "1.0.1";
+constexpr uint16_t BENCHMARK_BUFFER_SIZE = 512U;
+constexpr size_t BENCHMARK_ENDPOINTS_AMOUNT = 10U;
+constexpr char const * BENCHMARK_ATTRIBUTE_KEYS[] = { "interval", "mode" };
+constexpr size_t BENCHMARK_ATTRIBUTE_KEYS_AMOUNT = sizeof(BENCHMARK_ATTRIBUTE_KEYS) / sizeof(BENCHMARK_ATTRIBUTE_KEYS[0]);
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+using Benchmark_ThingsBoard = ThingsBoardSized<>;
+using Benchmark_Server_Side_RPC = Server_Side_RPC<>;
+using Benchmark_Attribute_Request = Attribute_Request<>;
+using Benchmark_Attribute_Request_Callback = Attribute_Request_Callback;
+using Benchmark_Shared_Attribute_Callback = Shared_Attribute_Callback;
+#else
+// OTA_Firmware_Update subscribes two additional API implementations, which do not fit into the default amount of endpoints together with all other APIs
+using Benchmark_ThingsBoard = ThingsBoardSized<Default_Response_Amount, BENCHMARK_ENDPOINTS_AMOUNT>;
+using Benchmark_Server_Side_RPC = Server_Side_RPC<Default_Subscriptions_Amount, 1U>;
+using Benchmark_Attribute_Request = Attribute_Request<Default_Subscriptions_Amount, BENCHMARK_ATTRIBUTE_KEYS_AMOUNT>;
+using Benchmark_Attribute_Request_Callback = Attribute_Request_Callback<BENCHMARK_ATTRIBUTE_KEYS_AMOUNT>;
+using Benchmark_Shared_Attribute_Callback = Shared_Attribute_Callback<>;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+
+/// @brief Settings of a single benchmark run, parsed from the command line
+struct Benchmark_Options {
+    size_t        messages = 1000U;                // Amount of messages sent for every API
+    Loopback_Link link = {};                       // Simulated properties of both directions of the connection
+    uint64_t      timeout_microseconds = 1000000U; // Time a request is waited for before it is counted as timed out
+    size_t        firmware_size = 65536U;          // Size of the firmware downloaded in the firmware benchmark
+    uint16_t      chunk_size = 1024U;              // Size of the chunks the firmware is requested in
+    uint32_t      seed = 0U;                       // Seed of the simulated jitter and loss
+};
+
+
+/// @brief Updater that keeps the downloaded firmware in memory
+class Memory_Updater : public IUpdater {
+  public:
+    bool begin(size_t const & firmware_size) override {
+        m_firmware.clear();
+        m_firmware.reserve(firmware_size);
+        return true;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        m_firmware.insert(m_firmware.end(), payload, payload + total_bytes);
+        return total_bytes;
+    }
+
+    void reset() override {
+        m_firmware.clear();
+    }
+
+    bool end() override {
+        return true;
+    }
+
+  private:
+    std::vector<uint8_t> m_firmware = {}; // Received firmware binary
+};
+
+
+/// @brief Calls the loop of the library until the given condition is met or the given time has passed
+/// @param tb Instance of the library connected to the broker
+/// @param done Condition that ends the loop
+/// @param timeout_microseconds Maximum time the loop runs for
+/// @return Whether the condition was met before the time has passed
+static bool Loop_Until(Benchmark_ThingsBoard & tb, std::function<bool()> const & done, uint64_t const & timeout_microseconds) {
+    uint64_t const deadline = Benchmark_Micros() + timeout_microseconds;
+    while (!done()) {
+        if (Benchmark_Micros() > deadline) {
+            return false;
+        }
+        (void)tb.loop();
+    }
+    return true;
+}
+
+/// @brief Runs the given benchmark and prints the results measured by the broker for the given API
+/// @param broker Broker the library is connected to
+/// @param api API the results are printed for
+/// @param run Benchmark, returns the amount of requests that timed out
+static void Run_Benchmark(Loopback_MQTT_Broker & broker, Loopback_API const & api, std::function<size_t()> const & run) {
+    broker.Reset_Stats();
+    uint64_t const start = Benchmark_Micros();
+    size_t const timeouts = run();
+    uint64_t const duration = Benchmark_Micros() - start;
+    Loopback_API_Stats & stats = broker.Get_Stats(api);
+    Benchmark_Report(BENCHMARK_SUITE, Loopback_API_Name(api))
+        .Add("messages", static_cast<uint64_t>(stats.messages))
+        .Add("lost", static_cast<uint64_t>(stats.lost))
+        .Add("rejected", static_cast<uint64_t>(stats.rejected))
+        .Add("timeouts", static_cast<uint64_t>(timeouts))
+        .Add("duration_us", duration)
+        .Add("msgs_per_s", duration != 0U ? stats.messages * 1000000.0 / duration : 0.0)
+        .Add("bytes_per_msg", stats.messages != 0U ? static_cast<double>(stats.bytes) / stats.messages : 0.0)
+        .Add_Samples("latency_us", stats.latency)
+        .Print();
+}
+
+/// @brief Parses the command line options
+/// @param argc Amount of arguments
+/// @param argv Arguments
+/// @param options Options that are overwritten with the passed values
+/// @return Whether all arguments were valid
+static bool Parse_Options(int argc, char ** argv, Benchmark_Options & options) {
+    for (int i = 1; i + 1 < argc; i += 2) {
+        char const * name = argv[i];
+        char const * value = argv[i + 1];
+        if (strcmp(name, "--messages") == 0) {
+            options.messages = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(name, "--latency-us") == 0) {
+            options.link.latency_microseconds = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(name, "--jitter-us") == 0) {
+            options.link.jitter_microseconds = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(name, "--loss") == 0) {
+            options.link.loss = strtod(value, nullptr);
+        }
+        else if (strcmp(name, "--bandwidth") == 0) {
+            options.link.bandwidth = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(name, "--timeout-us") == 0) {
+            options.timeout_microseconds = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(name, "--firmware-size") == 0) {
+            options.firmware_size = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(name, "--chunk-size") == 0) {
+            options.chunk_size = static_cast<uint16_t>(strtoul(value, nullptr, 10));
+        }
+        else if (strcmp(name, "--seed") == 0) {
+            options.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        }
+        else {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && options.chunk_size != 0U;
+}
+
+int main(int argc, char ** argv) {
+    Benchmark_Options options;
+    if (!Parse_Options(argc, argv, options)) {
+        (void)fprintf(stderr, "Usage: %s [--messages N] [--latency-us N] [--jitter-us N] [--loss P] [--bandwidth B] [--timeout-us N] [--firmware-size N] [--chunk-size N] [--seed N]\n", argv[0]);
+        return 1;
+    }
+
+    Loopback_MQTT_Broker broker(options.seed);
+    broker.Set_Uplink(options.link);
+    broker.Set_Downlink(options.link);
+    broker.Set_Attribute(true, "interval", "1000");
+    broker.Set_Attribute(true, "mode", "\"normal\"");
+    broker.Set_RPC_Response(BENCHMARK_RPC_METHOD, "{\"result\":42}");
+
+    Benchmark_Server_Side_RPC server_rpc;
+    Client_Side_RPC<> client_rpc;
+    Benchmark_Attribute_Request attribute_request;
+    Shared_Attribute_Update<> shared_update;
+    Provision<> provision;
+    OTA_Firmware_Update<> ota;
+    IAPI_Implementation * const apis[] = { &server_rpc, &client_rpc, &attribute_request, &shared_update, &provision, &ota };
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Benchmark_ThingsBoard tb(broker, BENCHMARK_BUFFER_SIZE, BENCHMARK_BUFFER_SIZE, Default_Max_Stack_Size, Default_Max_Response_Size, apis + 0U, apis + sizeof(apis) / sizeof(apis[0]));
+#else
+    Benchmark_ThingsBoard tb(broker, BENCHMARK_BUFFER_SIZE, BENCHMARK_BUFFER_SIZE, Default_Max_Stack_Size, apis + 0U, apis + sizeof(apis) / sizeof(apis[0]));
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    if (!tb.connect(BENCHMARK_HOST, BENCHMARK_TOKEN)) {
+        (void)fprintf(stderr, "Connecting to the loopback broker failed\n");
+        return 1;
+    }
+
+    (void)server_rpc.RPC_Subscribe(RPC_Callback(BENCHMARK_RPC_METHOD, [](JsonVariantConst const & params, JsonDocument & response) {
+        response["result"] = params;
+    }));
+    (void)shared_update.Shared_Attributes_Subscribe(Benchmark_Shared_Attribute_Callback([](JsonObjectConst const & data) {
+        // Nothing to do, the update is only received
+    }));
+
+    // Open loop, all messages are sent as fast as the library allows and the run ends once the server received all of them
+    auto const send_all = [&](std::function<bool(size_t const &)> const & send) {
+        return [&, send]() {
+            for (size_t i = 0U; i < options.messages; ++i) {
+                (void)send(i);
+                (void)tb.loop();
+            }
+            (void)Loop_Until(tb, [&]() { return broker.In_Flight() == 0U; }, options.timeout_microseconds);
+            return static_cast<size_t>(0U);
+        };
+    };
+    // Closed loop, every request is only sent once the response to the previous one has been received or it timed out
+    // Callbacks mark the request they belong to as finished, they outlive the loop because the library still calls them once the request timed out
+    size_t finished_request = SIZE_MAX;
+    auto const request_all = [&](std::function<bool(size_t const &)> const & request) {
+        return [&, request]() {
+            size_t timeouts = 0U;
+            for (size_t i = 0U; i < options.messages; ++i) {
+                if (!request(i) || !Loop_Until(tb, [&finished_request, i]() { return finished_request == i; }, options.timeout_microseconds * 2U)) {
+                    timeouts++;
+                }
+            }
+            return timeouts;
+        };
+    };
+
+    Run_Benchmark(broker, Loopback_API::TELEMETRY, send_all([&](size_t const & i) {
+        return tb.sendTelemetryData("temperature", static_cast<int>(i));
+    }));
+    Run_Benchmark(broker, Loopback_API::ATTRIBUTES, send_all([&](size_t const & i) {
+        return tb.sendAttributeData("uptime", static_cast<int>(i));
+    }));
+    Run_Benchmark(broker, Loopback_API::SHARED_ATTRIBUTE_UPDATE, send_all([&](size_t const & i) {
+        broker.Send_Shared_Attributes("{\"interval\":2000}");
+        return true;
+    }));
+    Run_Benchmark(broker, Loopback_API::ATTRIBUTE_REQUEST, request_all([&](size_t const & i) {
+        return attribute_request.Shared_Attributes_Request(Benchmark_Attribute_Request_Callback([&finished_request, i](JsonObjectConst const & data) {
+            finished_request = i;
+        }, options.timeout_microseconds, [&finished_request, i]() {
+            finished_request = i;
+        }, BENCHMARK_ATTRIBUTE_KEYS + 0U, BENCHMARK_ATTRIBUTE_KEYS + BENCHMARK_ATTRIBUTE_KEYS_AMOUNT));
+    }));
+    Run_Benchmark(broker, Loopback_API::CLIENT_SIDE_RPC, request_all([&](size_t const & i) {
+        return client_rpc.RPC_Request(RPC_Request_Callback(BENCHMARK_RPC_METHOD, [&finished_request, i](JsonDocument const & data) {
+            finished_request = i;
+        }, nullptr, options.timeout_microseconds, [&finished_request, i]() {
+            finished_request = i;
+        }));
+    }));
+    Run_Benchmark(broker, Loopback_API::SERVER_SIDE_RPC, [&]() {
+        // Requests are sent by the server, therefore the exchange is completed once the broker received the response
+        Loopback_API_Stats const & stats = broker.Get_Stats(Loopback_API::SERVER_SIDE_RPC);
+        size_t timeouts = 0U;
+        for (size_t i = 0U; i < options.messages; ++i) {
+            size_t const completed = stats.messages;
+            broker.Send_RPC_Request(BENCHMARK_RPC_METHOD, std::to_string(i).c_str());
+            if (!Loop_Until(tb, [&]() { return stats.messages != completed; }, options.timeout_microseconds)) {
+                timeouts++;
+            }
+        }
+        return timeouts;
+    });
+    Run_Benchmark(broker, Loopback_API::PROVISION, request_all([&](size_t const & i) {
+        return provision.Provision_Request(Provision_Callback(Access_Token(), [&finished_request, i](JsonDocument const & data) {
+            finished_request = i;
+        }, "benchmark_key", "benchmark_secret", nullptr, options.timeout_microseconds, [&finished_request, i]() {
+            finished_request = i;
+        }));
+    }));
+
+    // Firmware is downloaded once, every served chunk is a single exchange
+    std::vector<uint8_t> firmware(options.firmware_size);
+    for (size_t i = 0U; i < firmware.size(); ++i) {
+        firmware[i] = static_cast<uint8_t>(i * 31U);
+    }
+    char checksum[(MBEDTLS_MD_MAX_SIZE * 2) + 1] = {};
+    HashGenerator hash;
+    (void)hash.start(MBEDTLS_MD_SHA256);
+    (void)hash.update(firmware.data(), firmware.size());
+    (void)hash.finish(checksum);
+    broker.Set_Firmware(BENCHMARK_FW_TITLE, BENCHMARK_FW_VERSION, "SHA256", checksum, firmware.data(), firmware.size());
+    Memory_Updater updater;
+    Run_Benchmark(broker, Loopback_API::FIRMWARE, [&]() {
+        finished_request = SIZE_MAX;
+        bool const started = ota.Start_Firmware_Update(OTA_Update_Callback(BENCHMARK_FW_TITLE, BENCHMARK_FW_CURRENT_VERSION, &updater, [&finished_request](bool const & success) {
+            finished_request = 0U;
+        }, nullptr, nullptr, CHUNK_RETRIES, options.chunk_size, options.timeout_microseconds));
+        // Every chunk can be retried, therefore the whole download is given enough time for every chunk to time out once
+        uint64_t const chunks = options.firmware_size / options.chunk_size + 1U;
+        return static_cast<size_t>(started && Loop_Until(tb, [&finished_request]() { return finished_request == 0U; }, options.timeout_microseconds * (chunks + 1U)) ? 0U : 1U);
+    });
+
+    tb.disconnect();
+    return 0;
+}
@@ -0,0 +1,427 @@
+// Measures the time single calls of the hot paths of the library take, connected to the Null_MQTT_Client so that neither a network nor a broker influences the results.
+// Prints one JSON object per benchmark and parameter to stdout, containing the amount of calls and the p50 / p99 / minimum duration of a single call in nanoseconds.
+// Messages logged by the library are written to stderr instead, so that they do not end up between the results.
+// Built once for every combination of THINGSBOARD_ENABLE_DYNAMIC and THINGSBOARD_ENABLE_STL, the configuration is contained in every result.
+//
+// Usage: microbenchmark
+
+// Local includes.
+#include "Null_MQTT_Client.h"
+#include "Benchmark_Stats.h"
+
+// Library includes.
+#include <ThingsBoard.h>
+#include <Server_Side_RPC.h>
+#include <Shared_Attribute_Update.h>
+#include <HashGenerator.h>
+#include <Helper.h>
+#include <stdio.h>
+#include <string.h>
+#include <string>
+#if THINGSBOARD_ENABLE_STL
+#include <Inline_Delegate.h>
+#include <functional>
+#endif // THINGSBOARD_ENABLE_STL
+
+
+constexpr char BENCHMARK_SUITE[] = "micro";
+constexpr char BENCHMARK_TELEMETRY_TOPIC[] = "v1/devices/me/telemetry";
+constexpr char BENCHMARK_ATTRIBUTE_TOPIC[] = "v1/devices/me/attributes";
+constexpr char BENCHMARK_RPC_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/1";
+constexpr char BENCHMARK_API_TOPIC_FORMAT[] = "bench/%u/";
+constexpr uint16_t BENCHMARK_BUFFER_SIZE = 4096U;
+constexpr size_t BENCHMARK_MAX_KEYS = 64U;
+constexpr size_t BENCHMARK_MAX_APIS = 32U;
+constexpr size_t BENCHMARK_NAME_SIZE = 16U;
+constexpr size_t BENCHMARK_JSON_SIZE = JSON_OBJECT_SIZE(BENCHMARK_MAX_KEYS) + BENCHMARK_MAX_KEYS * BENCHMARK_NAME_SIZE;
+constexpr size_t BENCHMARK_CONTAINER_SIZE = 64U;
+constexpr size_t BENCHMARK_KEY_AMOUNTS[] = { 1U, 2U, 4U, 8U, 16U, 32U, 64U };
+constexpr size_t BENCHMARK_API_AMOUNTS[] = { 1U, 2U, 4U, 8U, 16U, 32U };
+constexpr size_t BENCHMARK_METHOD_AMOUNTS[] = { 1U, 8U, 32U };
+constexpr size_t BENCHMARK_PAYLOAD_SIZES[] = { 16U, 256U, 4096U };
+constexpr size_t BENCHMARK_HASH_SIZES[] = { 64U, 1024U, 16384U };
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+using Benchmark_ThingsBoard = ThingsBoardSized<Benchmark_Logger>;
+using Benchmark_Server_Side_RPC = Server_Side_RPC<Benchmark_Logger>;
+using Benchmark_Shared_Attribute_Update = Shared_Attribute_Update<Benchmark_Logger>;
+using Benchmark_Shared_Attribute_Callback = Shared_Attribute_Callback;
+using Benchmark_Container = Vector<size_t>;
+#else
+using Benchmark_ThingsBoard = ThingsBoardSized<Default_Response_Amount, BENCHMARK_MAX_APIS, Benchmark_Logger>;
+using Benchmark_Server_Side_RPC = Server_Side_RPC<BENCHMARK_MAX_APIS, Default_RPC_Amount, Benchmark_Logger>;
+using Benchmark_Shared_Attribute_Update = Shared_Attribute_Update<BENCHMARK_MAX_KEYS, 1U, Benchmark_Logger>;
+using Benchmark_Shared_Attribute_Callback = Shared_Attribute_Callback<1U>;
+using Benchmark_Container = Array<size_t, BENCHMARK_CONTAINER_SIZE>;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+#if THINGSBOARD_ENABLE_STL
+using Benchmark_Function = std::function<void(size_t const &)>;
+using Benchmark_Delegate = Inline_Delegate<void(size_t const &)>;
+// Every callback of the library uses the Inline_Delegate instead of std::function if THINGSBOARD_ENABLE_INLINE_DELEGATE is set, if it were bigger that would increase the RAM used by every callback
+static_assert(sizeof(Benchmark_Delegate) <= sizeof(Benchmark_Function), "Inline_Delegate is bigger than the std::function it replaces");
+#endif // THINGSBOARD_ENABLE_STL
+
+
+char        g_name_storage[BENCHMARK_MAX_KEYS][BENCHMARK_NAME_SIZE] = {}; // Keys and method names used by all benchmarks, "key_<index>"
+char const *g_names[BENCHMARK_MAX_KEYS] = {};                             // Pointers to the keys, allows to pass them as a range of char const *
+size_t      g_callbacks = 0U;                                              // Amount of times any subscribed callback has been called, to notice benchmarks that do not reach the measured code
+
+
+/// @brief API implementation that only counts received responses, used to measure the dispatching of received messages
+/// to the API implementation responsible for them depending on the amount of subscribed API implementations
+class Benchmark_API : public IAPI_Implementation {
+  public:
+    /// @brief Constructor
+    Benchmark_API()
+      : m_prefix()
+      , m_process_type(API_Process_Type::RAW)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Sets the prefix of the topics this instance handles and the way their payload is processed
+    /// @param index Index of the instance, contained in its prefix
+    /// @param process_type Whether the payload is passed as raw bytes or deserialized into json first
+    void Configure(size_t const & index, API_Process_Type const & process_type) {
+        (void)snprintf(m_prefix, sizeof(m_prefix), BENCHMARK_API_TOPIC_FORMAT, static_cast<unsigned int>(index));
+        m_process_type = process_type;
+    }
+
+    API_Process_Type Get_Process_Type() const override {
+        return m_process_type;
+    }
+
+    void Process_Response(char const * topic, uint8_t * payload, unsigned int length) override {
+        g_callbacks++;
+    }
+
+    void Process_Json_Response(char const * topic, JsonDocument const & data) override {
+        g_callbacks++;
+    }
+
+    char const * Get_Response_Topic_Prefix() const override {
+        return m_prefix;
+    }
+
+    bool Compare_Response_Topic(char const * topic) const override {
+        return strncmp(m_prefix, topic, strlen(m_prefix)) == 0;
+    }
+
+    bool Unsubscribe() override {
+        return true;
+    }
+
+    bool Resubscribe_Topic() override {
+        return true;
+    }
+
+    void loop() override {
+        // Nothing to do
+    }
+
+    void Initialize() override {
+        // Nothing to do
+    }
+
+    void Set_Client_Context(IAPI_Client_Context & context) override {
+        // Nothing to do
+    }
+
+  private:
+    char             m_prefix[BENCHMARK_NAME_SIZE] = {}; // Prefix of the topics handled by this instance, "bench/<index>/"
+    API_Process_Type m_process_type = {};                // Whether the payload is passed as raw bytes or deserialized into json first
+};
+
+
+/// @brief Counts the calls of a callback bound to one of its methods, used to measure calling the callback the same way the library calls its internal callbacks
+class Benchmark_Counter {
+  public:
+    /// @brief Counts the call
+    /// @param amount Amount the calls are increased by
+    void Count(size_t const & amount) {
+        g_callbacks += amount;
+    }
+};
+
+/// @brief Counts the call of a server-side RPC callback, does not create a response so that only the lookup of the method is measured
+/// @param params Parameters of the request
+/// @param response Response, kept empty
+static void Count_RPC(JsonVariantConst const & params, JsonDocument & response) {
+    g_callbacks++;
+}
+
+/// @brief Counts the call of a shared attribute callback
+/// @param data Received shared attributes
+static void Count_Shared_Attributes(JsonObjectConst const & data) {
+    g_callbacks++;
+}
+
+/// @brief Creates a json object with the given amount of keys, each with a short integer value
+/// @param amount Amount of keys
+/// @return Serialized json object
+static std::string Create_Json(size_t const & amount) {
+    std::string json = "{";
+    for (size_t i = 0U; i < amount; ++i) {
+        if (i != 0U) {
+            json += ',';
+        }
+        json += '"';
+        json += g_names[i];
+        json += "\":";
+        json += std::to_string(i);
+    }
+    json += '}';
+    return json;
+}
+
+/// @brief Sends the given key value pairs as telemetry, hides the additional template parameter required if THINGSBOARD_ENABLE_DYNAMIC is not set
+/// @param tb Instance of the library
+/// @param first Pointer to the first key value pair
+/// @param last Pointer to the end of the key value pairs (last element + 1)
+/// @return Whether sending the data was successful or not
+static bool Send_Telemetry(Benchmark_ThingsBoard & tb, Telemetry const * first, Telemetry const * last) {
+#if THINGSBOARD_ENABLE_DYNAMIC
+    return tb.sendTelemetry(first, last);
+#else
+    return tb.sendTelemetry<BENCHMARK_MAX_KEYS>(first, last);
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+}
+
+/// @brief Sends the given key value pairs as telemetry the way sendTelemetry did before it wrote the json directly,
+/// by copying them into a JsonDocument first and then measuring and serializing that document, allows to compare both paths on the same data
+/// @param tb Instance of the library
+/// @param first Pointer to the first key value pair
+/// @param last Pointer to the end of the key value pairs (last element + 1)
+/// @return Whether sending the data was successful or not
+static bool Send_Telemetry_Json_Document(Benchmark_ThingsBoard & tb, Telemetry const * first, Telemetry const * last) {
+#if THINGSBOARD_ENABLE_DYNAMIC
+    TBJsonDocument document(JSON_OBJECT_SIZE(last - first));
+#else
+    StaticJsonDocument<JSON_OBJECT_SIZE(BENCHMARK_MAX_KEYS)> document;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    for (auto it = first; it != last; ++it) {
+        if (!it->SerializeKeyValue(document)) {
+            return false;
+        }
+    }
+    return tb.sendTelemetryJson(document, Helper::Measure_Json(document));
+}
+
+
+/// @brief Measures serializing and publishing json with Send_Json and already serialized json with Send_Json_String, as well as sendTelemetry with an increasing amount of key value pairs.
+/// sendTelemetry is measured once with the direct json writer it uses and once with the previous path over a JsonDocument on the same key value pairs
+static void Benchmark_Send() {
+    Null_MQTT_Client client;
+    Benchmark_ThingsBoard tb(client, BENCHMARK_BUFFER_SIZE, BENCHMARK_BUFFER_SIZE, BENCHMARK_BUFFER_SIZE);
+    Telemetry telemetry[BENCHMARK_MAX_KEYS] = {};
+    for (size_t i = 0U; i < BENCHMARK_MAX_KEYS; ++i) {
+        telemetry[i] = Telemetry(g_names[i], static_cast<int>(i));
+    }
+
+    for (auto const & amount : BENCHMARK_KEY_AMOUNTS) {
+        StaticJsonDocument<BENCHMARK_JSON_SIZE> document;
+        for (size_t i = 0U; i < amount; ++i) {
+            document[g_names[i]] = static_cast<int>(i);
+        }
+        size_t const json_size = Helper::Measure_Json(document);
+        std::string const json = Create_Json(amount);
+
+        Measure_Operation(BENCHMARK_SUITE, "send_json", [&]() {
+            Benchmark_Keep(tb.Send_Json(BENCHMARK_TELEMETRY_TOPIC, document, json_size));
+        }).Add("keys", static_cast<uint64_t>(amount)).Add("bytes", static_cast<uint64_t>(json_size)).Print();
+
+        Measure_Operation(BENCHMARK_SUITE, "send_json_string", [&]() {
+            Benchmark_Keep(tb.Send_Json_String(BENCHMARK_TELEMETRY_TOPIC, json.c_str()));
+        }).Add("keys", static_cast<uint64_t>(amount)).Add("bytes", static_cast<uint64_t>(json.size())).Print();
+
+        Measure_Operation(BENCHMARK_SUITE, "send_telemetry", [&]() {
+            Benchmark_Keep(Send_Telemetry(tb, telemetry, telemetry + amount));
+        }).Add("keys", static_cast<uint64_t>(amount)).Print();
+
+        Measure_Operation(BENCHMARK_SUITE, "send_telemetry_json_document", [&]() {
+            Benchmark_Keep(Send_Telemetry_Json_Document(tb, telemetry, telemetry + amount));
+        }).Add("keys", static_cast<uint64_t>(amount)).Print();
+    }
+}
+
+/// @brief Measures dispatching a received message to the API implementation responsible for it, depending on the amount of subscribed API implementations.
+/// The message is always addressed to the last subscribed API implementation
+/// @param process_type Whether the API implementations receive the payload as raw bytes or deserialized into json
+static void Benchmark_Dispatch(API_Process_Type const & process_type) {
+    static uint8_t constexpr payload[] = "{\"value\":1}";
+
+    for (auto const & amount : BENCHMARK_API_AMOUNTS) {
+        Benchmark_API apis[BENCHMARK_MAX_APIS] = {};
+        Null_MQTT_Client client;
+        Benchmark_ThingsBoard tb(client, BENCHMARK_BUFFER_SIZE, BENCHMARK_BUFFER_SIZE);
+        for (size_t i = 0U; i < amount; ++i) {
+            apis[i].Configure(i, process_type);
+            tb.Subscribe_API_Implementation(apis[i]);
+        }
+        char topic[BENCHMARK_NAME_SIZE + 4U] = {};
+        (void)snprintf(topic, sizeof(topic), "%sresponse", apis[amount - 1U].Get_Response_Topic_Prefix());
+
+        g_callbacks = 0U;
+        Measure_Operation(BENCHMARK_SUITE, process_type == API_Process_Type::RAW ? "dispatch_raw" : "dispatch_json", [&]() {
+            client.Deliver(topic, payload, sizeof(payload) - 1U);
+        }).Add("apis", static_cast<uint64_t>(amount)).Add("callbacks", static_cast<uint64_t>(g_callbacks)).Print();
+    }
+}
+
+/// @brief Measures estimating the amount of nodes of a received json payload, which is used to size the JsonDocument it is deserialized into.
+/// Compares the previous estimation, which calls Helper::getOccurences once for each of the symbols ',', '{' and '[', with the single word-wise pass of Helper::getJsonNodeCount on the same payloads.
+/// The string heavy payload contains the counted symbols inside of strings as well, which forces getJsonNodeCount to handle quotes and escapes byte by byte
+static void Benchmark_Json_Node_Count() {
+    char const * const patterns[] = { "{\"a\":[1,2],\"b\":3}", "{\"key\":\"va,l{u[e\",\"e\":\"\\\"\"}" };
+    char const * const pattern_names[] = { "numeric", "string_heavy" };
+    for (size_t pattern = 0U; pattern < sizeof(patterns) / sizeof(patterns[0]); ++pattern) {
+        for (auto const & size : BENCHMARK_PAYLOAD_SIZES) {
+            std::string payload;
+            while (payload.size() < size) {
+                payload += patterns[pattern];
+            }
+            payload.resize(size);
+            uint8_t const * bytes = reinterpret_cast<uint8_t const *>(payload.data());
+            unsigned int const length = payload.size();
+
+            size_t const occurences = Helper::getOccurences(bytes, ',', length) + Helper::getOccurences(bytes, '{', length) + Helper::getOccurences(bytes, '[', length);
+            Measure_Operation(BENCHMARK_SUITE, "json_node_count_occurences", [&]() {
+                Benchmark_Keep(Helper::getOccurences(bytes, ',', length) + Helper::getOccurences(bytes, '{', length) + Helper::getOccurences(bytes, '[', length));
+            }).Add("payload", pattern_names[pattern]).Add("bytes", static_cast<uint64_t>(size)).Add("nodes", static_cast<uint64_t>(occurences)).Print();
+
+            size_t const nodes = Helper::getJsonNodeCount(bytes, length);
+            Measure_Operation(BENCHMARK_SUITE, "json_node_count_swar", [&]() {
+                Benchmark_Keep(Helper::getJsonNodeCount(bytes, length));
+            }).Add("payload", pattern_names[pattern]).Add("bytes", static_cast<uint64_t>(size)).Add("nodes", static_cast<uint64_t>(nodes)).Print();
+        }
+    }
+}
+
+/// @brief Measures looking up the callback of a received server-side RPC request, depending on the amount of subscribed methods.
+/// The request always calls the last subscribed method
+static void Benchmark_RPC_Lookup() {
+    for (auto const & amount : BENCHMARK_METHOD_AMOUNTS) {
+        Benchmark_Server_Side_RPC rpc;
+        Null_MQTT_Client client;
+        Benchmark_ThingsBoard tb(client, BENCHMARK_BUFFER_SIZE, BENCHMARK_BUFFER_SIZE);
+        tb.Subscribe_API_Implementation(rpc);
+        for (size_t i = 0U; i < amount; ++i) {
+            (void)rpc.RPC_Subscribe(RPC_Callback(g_names[i], Count_RPC));
+        }
+        std::string const request = std::string("{\"method\":\"") + g_names[amount - 1U] + "\",\"params\":{}}";
+        StaticJsonDocument<BENCHMARK_JSON_SIZE> document;
+        (void)deserializeJson(document, request.c_str());
+
+        g_callbacks = 0U;
+        Measure_Operation(BENCHMARK_SUITE, "rpc_lookup", [&]() {
+            rpc.Process_Json_Response(BENCHMARK_RPC_REQUEST_TOPIC, document);
+        }).Add("methods", static_cast<uint64_t>(amount)).Add("callbacks", static_cast<uint64_t>(g_callbacks)).Print();
+    }
+}
+
+/// @brief Measures dispatching a received shared attribute update, containing the given amount of keys, to the same amount of callbacks which are each subscribed to one of the keys
+static void Benchmark_Shared_Attributes() {
+    for (auto const & amount : BENCHMARK_KEY_AMOUNTS) {
+        Benchmark_Shared_Attribute_Update shared_update;
+        Null_MQTT_Client client;
+        Benchmark_ThingsBoard tb(client, BENCHMARK_BUFFER_SIZE, BENCHMARK_BUFFER_SIZE);
+        tb.Subscribe_API_Implementation(shared_update);
+        for (size_t i = 0U; i < amount; ++i) {
+            (void)shared_update.Shared_Attributes_Subscribe(Benchmark_Shared_Attribute_Callback(Count_Shared_Attributes, g_names + i, g_names + i + 1U));
+        }
+        std::string const update = Create_Json(amount);
+        StaticJsonDocument<BENCHMARK_JSON_SIZE> document;
+        (void)deserializeJson(document, update.c_str());
+
+        g_callbacks = 0U;
+        Measure_Operation(BENCHMARK_SUITE, "shared_attribute_dispatch", [&]() {
+            shared_update.Process_Json_Response(BENCHMARK_ATTRIBUTE_TOPIC, document);
+        }).Add("keys", static_cast<uint64_t>(amount)).Add("callbacks", static_cast<uint64_t>(g_callbacks)).Print();
+    }
+}
+
+/// @brief Measures filling the container used for all internal lists of the library and erasing every element from the front again,
+/// which is the Vector if THINGSBOARD_ENABLE_DYNAMIC is set and the Array otherwise
+static void Benchmark_Container_Operations() {
+    Benchmark_Container container;
+    Measure_Operation(BENCHMARK_SUITE, "container_push_back_erase", [&]() {
+        for (size_t i = 0U; i < BENCHMARK_CONTAINER_SIZE; ++i) {
+            container.push_back(i);
+        }
+        while (container.size() != 0U) {
+            container.erase(container.begin());
+        }
+        Benchmark_Keep(container);
+    }).Add("elements", static_cast<uint64_t>(BENCHMARK_CONTAINER_SIZE)).Print();
+}
+
+#if THINGSBOARD_ENABLE_STL
+/// @brief Measures calling and copying a method bound to an object with std::bind, once stored in std::function and once in the Inline_Delegate, which is what every internal callback is
+/// if THINGSBOARD_ENABLE_INLINE_DELEGATE is set. The size of both is added to every result, the bound method is too big to be stored inline in std::function of libstdc++
+static void Benchmark_Callback() {
+    Benchmark_Counter counter;
+    Benchmark_Function const function = std::bind(&Benchmark_Counter::Count, &counter, std::placeholders::_1);
+    Benchmark_Delegate const delegate = std::bind(&Benchmark_Counter::Count, &counter, std::placeholders::_1);
+
+    g_callbacks = 0U;
+    Measure_Operation(BENCHMARK_SUITE, "callback_call_std_function", [&]() {
+        // Ensures the compiler can not inline the stored method, because it has to assume the callback has been changed
+        Benchmark_Keep(function);
+        function(1U);
+    }).Add("bytes", static_cast<uint64_t>(sizeof(function))).Add("callbacks", static_cast<uint64_t>(g_callbacks)).Print();
+
+    g_callbacks = 0U;
+    Measure_Operation(BENCHMARK_SUITE, "callback_call_inline_delegate", [&]() {
+        Benchmark_Keep(delegate);
+        delegate(1U);
+    }).Add("bytes", static_cast<uint64_t>(sizeof(delegate))).Add("callbacks", static_cast<uint64_t>(g_callbacks)).Print();
+
+    Measure_Operation(BENCHMARK_SUITE, "callback_copy_std_function", [&]() {
+        Benchmark_Function const copy = function;
+        Benchmark_Keep(copy);
+    }).Add("bytes", static_cast<uint64_t>(sizeof(function))).Print();
+
+    Measure_Operation(BENCHMARK_SUITE, "callback_copy_inline_delegate", [&]() {
+        Benchmark_Delegate const copy = delegate;
+        Benchmark_Keep(copy);
+    }).Add("bytes", static_cast<uint64_t>(sizeof(delegate))).Print();
+}
+#endif // THINGSBOARD_ENABLE_STL
+
+/// @brief Measures calculating the SHA256 hash of a firmware chunk of the given sizes, including starting and finishing the calculation
+static void Benchmark_Hash() {
+    for (auto const & size : BENCHMARK_HASH_SIZES) {
+        std::string const data(size, 'x');
+        char hash[(MBEDTLS_MD_MAX_SIZE * 2U) + 1U] = {};
+
+        Measure_Operation(BENCHMARK_SUITE, "hash_sha256", [&]() {
+            HashGenerator generator;
+            (void)generator.start(MBEDTLS_MD_SHA256);
+            (void)generator.update(reinterpret_cast<uint8_t const *>(data.data()), data.size());
+            (void)generator.finish(hash);
+            Benchmark_Keep(hash);
+        }).Add("bytes", static_cast<uint64_t>(size)).Print();
+    }
+}
+
+
+int main(int argc, char ** argv) {
+    for (size_t i = 0U; i < BENCHMARK_MAX_KEYS; ++i) {
+        (void)snprintf(g_name_storage[i], sizeof(g_name_storage[i]), "key_%u", static_cast<unsigned int>(i));
+        g_names[i] = g_name_storage[i];
+    }
+
+    Benchmark_Send();
+    Benchmark_Dispatch(API_Process_Type::RAW);
+    Benchmark_Dispatch(API_Process_Type::JSON);
+    Benchmark_Json_Node_Count();
+    Benchmark_RPC_Lookup();
+    Benchmark_Shared_Attributes();
+    Benchmark_Container_Operations();
+#if THINGSBOARD_ENABLE_STL
+    Benchmark_Callback();
+#endif // THINGSBOARD_ENABLE_STL
+    Benchmark_Hash();
+    return 0;
+}
@@ -0,0 +1,387 @@
+// Measures the throughput and resilience of OTA_Firmware_Update, downloading a firmware binary from the in-process Loopback_MQTT_Broker into a file.
+// The broker serves v2/fw/response/<id>/chunk/<n> from the given file or a generated binary, over links with the given round trip time, jitter, loss and reordering.
+// Runs the complete Start_Firmware_Update flow once for every combination of the given chunk sizes, round trip times and loss probabilities
+// and prints one JSON object per combination to stdout, containing the effective bytes per second, retries, timeouts, wall time and peak memory usage.
+// Messages logged by the library, like timed out chunk requests, are written to stderr.
+//
+// Usage: ota_benchmark [--firmware PATH] [--firmware-size N] [--output PATH] [--chunk-sizes N,...] [--rtts-us N,...] [--losses P,...] [--jitter-us N] [--reorder 0|1]
+//                      [--bandwidth B] [--timeout-us N] [--retries N] [--window N] [--max-chunk-size N] [--seed N]
+
+// Local includes.
+#include "Loopback_MQTT_Broker.h"
+#include "Benchmark_Stats.h"
+
+// Library includes.
+#include <ThingsBoard.h>
+#include <OTA_Firmware_Update.h>
+#include <HashGenerator.h>
+#include <IUpdater.h>
+#include <Memory_Stats.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <string>
+#include <vector>
+
+
+constexpr char BENCHMARK_SUITE[] = "ota";
+constexpr char BENCHMARK_HOST[] = "loopback";
+constexpr char BENCHMARK_TOKEN[] = "benchmark";
+constexpr char BENCHMARK_FW_TITLE[] = "benchmark";
+constexpr char BENCHMARK_FW_CURRENT_VERSION[] = "1.0.0";
+constexpr char BENCHMARK_FW_VERSION[] = "1.0.1";
+constexpr uint16_t BENCHMARK_BUFFER_SIZE = 512U;
+
+/// @brief Logger passed to OTA_Firmware_Update, counts timed out chunk requests and forwards every message to the Benchmark_Logger
+class Timeout_Counting_Logger {
+  public:
+    /// @brief Writes the given message and counts it if it is a timed out chunk request, which is formatted before being logged
+    /// @param message Message that should be written
+    /// @return Either the written amount of characters or an error indicator (being a negative number) if one occured
+    static int printfln(char const * message) {
+        // Only the part of the message before the first inserted argument is compared
+        if (strncmp(message, CHUNK_REQUEST_TIMED_OUT, strcspn(CHUNK_REQUEST_TIMED_OUT, "%")) == 0) {
+            Get_Timeouts()++;
+        }
+        return Benchmark_Logger::printfln(message);
+    }
+
+    /// @brief Formats the given arguments into the given format and writes the result
+    /// @tparam ...Args Types of the arguments inserted into the format
+    /// @param format Format string the arguments are inserted into
+    /// @param ...args Arguments that replace their respective specifiers in the format
+    /// @return Either the written amount of characters or an error indicator (being a negative number) if one occured
+    template<typename... Args>
+    static int printfln(char const * format, Args const &... args) {
+        return Benchmark_Logger::printfln(format, args...);
+    }
+
+    /// @brief Gets the amount of timed out chunk requests, a function local static is used so that the class can stay header only
+    /// @return Reference to the amount of timed out chunk requests since it has last been reset
+    static size_t & Get_Timeouts() {
+        static size_t timeouts = 0U;
+        return timeouts;
+    }
+};
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+using Benchmark_ThingsBoard = ThingsBoardSized<Benchmark_Logger>;
+#else
+using Benchmark_ThingsBoard = ThingsBoardSized<Default_Response_Amount, Default_Endpoints_Amount, Benchmark_Logger>;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+using Benchmark_OTA_Firmware_Update = OTA_Firmware_Update<Timeout_Counting_Logger>;
+
+
+/// @brief Settings of all benchmark runs, parsed from the command line
+struct Benchmark_Options {
+    char const *          firmware_path = {};                     // File the served firmware binary is read from, a binary of firmware_size bytes is generated if it is not set
+    size_t                firmware_size = 65536U;                 // Size of the generated firmware binary
+    char const *          output_path = {};                       // File the downloaded firmware is written to, a temporary file is used if it is not set
+    std::vector<uint64_t> chunk_sizes = { 512U, 1024U, 4096U };   // Sizes of the chunks the firmware is requested in
+    std::vector<uint64_t> rtts = { 0U, 10000U, 50000U };          // Round trip times in microseconds, each direction of the connection has half of the round trip time as latency
+    std::vector<double>   losses = { 0.0, 0.01, 0.05 };           // Probabilities that a message is lost, in each direction of the connection
+    uint64_t              jitter_microseconds = {};               // Maximum random delay added to every message
+    bool                  reorder = {};                           // Whether the random delay may reorder messages
+    uint64_t              bandwidth = {};                         // Amount of bytes per second each direction of the connection can transfer, 0 means unlimited
+    uint64_t              timeout_microseconds = 250000U;         // Time a chunk request is waited for before it is sent again
+    uint8_t               retries = CHUNK_RETRIES;                // Amount of times a single chunk is requested again before the update is aborted
+    uint8_t               window_size = CHUNK_WINDOW_SIZE;        // Amount of chunk requests that may be outstanding at the same time
+    uint16_t              max_chunk_size = {};                    // Maximum size the chunks may grow to in the adaptive mode, starting from each of the chunk sizes, 0 disables the adaptive mode
+    uint32_t              seed = {};                              // Seed of the simulated jitter and loss
+};
+
+
+/// @brief Updater that writes the downloaded firmware into a file
+class File_Updater : public IUpdater {
+  public:
+    /// @brief Constructor
+    /// @param path File the firmware is written to, a temporary file that is removed once the instance is destroyed is used if it is nullptr
+    explicit File_Updater(char const * path)
+      : m_path(path)
+      , m_file(nullptr)
+      , m_written(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor
+    ~File_Updater() {
+        Close();
+    }
+
+    bool begin(size_t const & firmware_size) override {
+        Close();
+        m_file = (m_path != nullptr) ? fopen(m_path, "wb") : tmpfile();
+        m_written = 0U;
+        return m_file != nullptr;
+    }
+
+    size_t write(uint8_t * payload, size_t const & total_bytes) override {
+        if (m_file == nullptr) {
+            return 0U;
+        }
+        size_t const written = fwrite(payload, 1U, total_bytes, m_file);
+        m_written += written;
+        return written;
+    }
+
+    void reset() override {
+        Close();
+        m_written = 0U;
+    }
+
+    bool end() override {
+        return m_file != nullptr && fflush(m_file) == 0;
+    }
+
+    /// @brief Gets the amount of bytes written since the update has last been started
+    /// @return Amount of written bytes
+    size_t Get_Written() const {
+        return m_written;
+    }
+
+  private:
+    /// @brief Closes the currently opened file if there is one
+    void Close() {
+        if (m_file != nullptr) {
+            (void)fclose(m_file);
+            m_file = nullptr;
+        }
+    }
+
+    char const * m_path = {};    // File the firmware is written to or nullptr if a temporary file is used
+    FILE *       m_file = {};    // Currently opened file
+    size_t       m_written = {}; // Amount of bytes written since the update has last been started
+};
+
+
+// State of the currently running update, global because the callbacks are plain function pointers if THINGSBOARD_ENABLE_STL is not set
+bool   g_finished = false;     // Whether the finish callback of the update has been called
+bool   g_success = false;      // Whether the update finished successfully
+size_t g_written_chunks = 0U;  // Amount of chunks written since the update has been started, including chunks written again after the update had to be restarted
+
+
+/// @brief Parses a comma seperated list of numbers
+/// @tparam T Type of the numbers
+/// @param value Comma seperated list
+/// @param parse Method converting a single number
+/// @return Parsed numbers
+template<typename T, typename Parse>
+static std::vector<T> Parse_List(char const * value, Parse const & parse) {
+    std::vector<T> list;
+    char const * current = value;
+    while (*current != '\0') {
+        char * end = nullptr;
+        list.push_back(static_cast<T>(parse(current, &end)));
+        if (end == current) {
+            return std::vector<T>();
+        }
+        current = (*end == ',') ? end + 1 : end;
+    }
+    return list;
+}
+
+/// @brief Parses the command line options
+/// @param argc Amount of arguments
+/// @param argv Arguments
+/// @param options Options that are overwritten with the passed values
+/// @return Whether all arguments were valid
+static bool Parse_Options(int argc, char ** argv, Benchmark_Options & options) {
+    auto const parse_unsigned = [](char const * value, char ** end) { return strtoull(value, end, 10); };
+    auto const parse_double = [](char const * value, char ** end) { return strtod(value, end); };
+    for (int i = 1; i + 1 < argc; i += 2) {
+        char const * name = argv[i];
+        char const * value = argv[i + 1];
+        if (strcmp(name, "--firmware") == 0) {
+            options.firmware_path = value;
+        }
+        else if (strcmp(name, "--firmware-size") == 0) {
+            options.firmware_size = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(name, "--output") == 0) {
+            options.output_path = value;
+        }
+        else if (strcmp(name, "--chunk-sizes") == 0) {
+            options.chunk_sizes = Parse_List<uint64_t>(value, parse_unsigned);
+        }
+        else if (strcmp(name, "--rtts-us") == 0) {
+            options.rtts = Parse_List<uint64_t>(value, parse_unsigned);
+        }
+        else if (strcmp(name, "--losses") == 0) {
+            options.losses = Parse_List<double>(value, parse_double);
+        }
+        else if (strcmp(name, "--jitter-us") == 0) {
+            options.jitter_microseconds = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(name, "--reorder") == 0) {
+            options.reorder = strtoul(value, nullptr, 10) != 0U;
+        }
+        else if (strcmp(name, "--bandwidth") == 0) {
+            options.bandwidth = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(name, "--timeout-us") == 0) {
+            options.timeout_microseconds = strtoull(value, nullptr, 10);
+        }
+        else if (strcmp(name, "--retries") == 0) {
+            options.retries = static_cast<uint8_t>(strtoul(value, nullptr, 10));
+        }
+        else if (strcmp(name, "--window") == 0) {
+            options.window_size = static_cast<uint8_t>(strtoul(value, nullptr, 10));
+        }
+        else if (strcmp(name, "--max-chunk-size") == 0) {
+            options.max_chunk_size = static_cast<uint16_t>(strtoul(value, nullptr, 10));
+        }
+        else if (strcmp(name, "--seed") == 0) {
+            options.seed = static_cast<uint32_t>(strtoul(value, nullptr, 10));
+        }
+        else {
+            return false;
+        }
+    }
+    for (auto const & chunk_size : options.chunk_sizes) {
+        if (chunk_size == 0U || chunk_size > UINT16_MAX) {
+            return false;
+        }
+    }
+    return argc % 2 == 1 && !options.chunk_sizes.empty() && !options.rtts.empty() && !options.losses.empty();
+}
+
+/// @brief Reads the firmware binary from the given file or generates one if no file is given
+/// @param options Options containing the file or the size of the generated binary
+/// @param firmware Firmware binary
+/// @return Whether reading the file was successful
+static bool Load_Firmware(Benchmark_Options const & options, std::vector<uint8_t> & firmware) {
+    if (options.firmware_path == nullptr) {
+        firmware.resize(options.firmware_size);
+        for (size_t i = 0U; i < firmware.size(); ++i) {
+            firmware[i] = static_cast<uint8_t>(i * 31U);
+        }
+        return true;
+    }
+    FILE * file = fopen(options.firmware_path, "rb");
+    if (file == nullptr) {
+        return false;
+    }
+    uint8_t buffer[4096U] = {};
+    size_t read = 0U;
+    while ((read = fread(buffer, 1U, sizeof(buffer), file)) != 0U) {
+        firmware.insert(firmware.end(), buffer, buffer + read);
+    }
+    (void)fclose(file);
+    return !firmware.empty();
+}
+
+/// @brief Downloads the given firmware once with the given settings and prints the results
+/// @param options Options shared by all runs
+/// @param firmware Firmware binary served by the broker
+/// @param checksum SHA256 checksum of the firmware binary as a hex string
+/// @param chunk_size Size of the chunks the firmware is requested in
+/// @param rtt Round trip time of the connection in microseconds
+/// @param loss Probability that a message is lost, in each direction of the connection
+static void Run_Benchmark(Benchmark_Options const & options, std::vector<uint8_t> const & firmware, char const * checksum, uint16_t const & chunk_size, uint64_t const & rtt, double const & loss) {
+    Loopback_Link link;
+    link.latency_microseconds = rtt / 2U;
+    link.jitter_microseconds = options.jitter_microseconds;
+    link.loss = loss;
+    link.bandwidth = options.bandwidth;
+    link.reorder = options.reorder;
+
+    Loopback_MQTT_Broker broker(options.seed);
+    broker.Set_Firmware(BENCHMARK_FW_TITLE, BENCHMARK_FW_VERSION, "SHA256", checksum, firmware.data(), firmware.size());
+    Benchmark_OTA_Firmware_Update ota;
+    IAPI_Implementation * const apis[] = { &ota };
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Benchmark_ThingsBoard tb(broker, BENCHMARK_BUFFER_SIZE, BENCHMARK_BUFFER_SIZE, Default_Max_Stack_Size, Default_Max_Response_Size, apis + 0U, apis + sizeof(apis) / sizeof(apis[0]));
+#else
+    Benchmark_ThingsBoard tb(broker, BENCHMARK_BUFFER_SIZE, BENCHMARK_BUFFER_SIZE, Default_Max_Stack_Size, apis + 0U, apis + sizeof(apis) / sizeof(apis[0]));
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    // Connecting and subscribing happens without any loss, so that every run measures the download itself
+    if (!tb.connect(BENCHMARK_HOST, BENCHMARK_TOKEN)) {
+        (void)fprintf(stderr, "Connecting to the loopback broker failed\n");
+        return;
+    }
+    broker.Set_Uplink(link);
+    broker.Set_Downlink(link);
+
+    File_Updater updater(options.output_path);
+    g_finished = false;
+    g_success = false;
+    g_written_chunks = 0U;
+    Timeout_Counting_Logger::Get_Timeouts() = 0U;
+    Memory_Stats::Reset_Peaks();
+    broker.Reset_Stats();
+
+    OTA_Update_Callback callback(BENCHMARK_FW_TITLE, BENCHMARK_FW_CURRENT_VERSION, &updater, [](bool const & success) {
+        g_finished = true;
+        g_success = success;
+    }, [](size_t const & current, size_t const & total) {
+        g_written_chunks++;
+    }, nullptr, options.retries, chunk_size, options.timeout_microseconds, options.window_size);
+    callback.Set_Max_Chunk_Size(options.max_chunk_size);
+
+    uint64_t const start = Benchmark_Micros();
+    bool const started = ota.Start_Firmware_Update(callback);
+
+    // Every chunk and the request of the firmware information can time out for every retry, the update is given enough time for all of them
+    uint64_t const chunks = firmware.size() / chunk_size + 1U;
+    uint64_t const deadline = start + options.timeout_microseconds * (chunks + 1U) * (options.retries + 1U) + rtt * chunks;
+    while (started && !g_finished && Benchmark_Micros() < deadline) {
+        (void)tb.loop();
+    }
+    uint64_t const duration = Benchmark_Micros() - start;
+
+    Loopback_API_Stats const & stats = broker.Get_Stats(Loopback_API::FIRMWARE);
+    char const * result = !started ? "not_started" : (!g_finished ? "deadline" : (g_success ? "success" : "failed"));
+    Benchmark_Report(BENCHMARK_SUITE, "firmware_download")
+        .Add("result", result)
+        .Add("firmware_bytes", static_cast<uint64_t>(firmware.size()))
+        .Add("chunk_size", static_cast<uint64_t>(chunk_size))
+        .Add("window_size", static_cast<uint64_t>(options.window_size))
+        .Add("max_chunk_size", static_cast<uint64_t>(options.max_chunk_size))
+        .Add("rtt_us", rtt)
+        .Add("jitter_us", options.jitter_microseconds)
+        .Add("loss", loss)
+        .Add("reorder", static_cast<uint64_t>(options.reorder))
+        .Add("wall_time_us", duration)
+        .Add("bytes_per_s", (g_success && duration != 0U) ? firmware.size() * 1000000.0 / duration : 0.0)
+        .Add("written_bytes", static_cast<uint64_t>(updater.Get_Written()))
+        .Add("chunk_requests", static_cast<uint64_t>(stats.published))
+        .Add("retries", static_cast<uint64_t>(stats.published > g_written_chunks ? stats.published - g_written_chunks : 0U))
+        .Add("timeouts", static_cast<uint64_t>(Timeout_Counting_Logger::Get_Timeouts()))
+        .Add("lost", static_cast<uint64_t>(stats.lost))
+        .Add("rejected", static_cast<uint64_t>(stats.rejected))
+        .Add("peak_heap_bytes", static_cast<uint64_t>(Memory_Stats::Get_Total().peak_bytes))
+        .Add("peak_ota_bytes", static_cast<uint64_t>(Memory_Stats::Get(Memory_Subsystem::OTA).peak_bytes))
+        .Add("peak_stack_bytes", static_cast<uint64_t>(Memory_Stats::Get_Total().peak_stack_bytes))
+        .Print();
+
+    tb.disconnect();
+}
+
+int main(int argc, char ** argv) {
+    Benchmark_Options options;
+    if (!Parse_Options(argc, argv, options)) {
+        (void)fprintf(stderr, "Usage: %s [--firmware PATH] [--firmware-size N] [--output PATH] [--chunk-sizes N,...] [--rtts-us N,...] [--losses P,...] [--jitter-us N] [--reorder 0|1] [--bandwidth B] [--timeout-us N] [--retries N] [--window N] [--max-chunk-size N] [--seed N]\n", argv[0]);
+        return 1;
+    }
+    std::vector<uint8_t> firmware;
+    if (!Load_Firmware(options, firmware)) {
+        (void)fprintf(stderr, "Reading the firmware from %s failed\n", options.firmware_path);
+        return 1;
+    }
+
+    char checksum[(MBEDTLS_MD_MAX_SIZE * 2) + 1] = {};
+    HashGenerator hash;
+    (void)hash.start(MBEDTLS_MD_SHA256);
+    (void)hash.update(firmware.data(), firmware.size());
+    (void)hash.finish(checksum);
+
+    for (auto const & chunk_size : options.chunk_sizes) {
+        for (auto const & rtt : options.rtts) {
+            for (auto const & loss : options.losses) {
+                Run_Benchmark(options, firmware, checksum, static_cast<uint16_t>(chunk_size), rtt, loss);
+            }
+        }
+    }
+    return 0;
+}
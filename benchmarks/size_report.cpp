@@ -0,0 +1,66 @@
+// Reports the RAM the ThingsBoard class and every shipped API implementation require in the configuration the library has been built with.
+// Measured with sizeof, meaning only the memory of the instance itself is contained and not the memory it allocates on the heap once callbacks are subscribed or messages are sent.
+// Prints one JSON object per class, followed by the sum of all API implementations, so that the output of two revisions of the library can be compared by scripts.
+// Built for every combination of THINGSBOARD_ENABLE_DYNAMIC and THINGSBOARD_ENABLE_STL and additionally with THINGSBOARD_ENABLE_INLINE_DELEGATE,
+// because the function type of the callbacks changes the size of every class that stores them.
+//
+// Usage: size_report
+
+// Local includes.
+#include "Benchmark_Stats.h"
+
+// Library includes.
+#include <ThingsBoard.h>
+#include <Attribute_Request.h>
+#include <Client_Side_RPC.h>
+#include <Provision.h>
+#include <Server_Side_RPC.h>
+#include <Shared_Attribute_Update.h>
+#if THINGSBOARD_ENABLE_STL
+#include <OTA_Firmware_Update.h>
+#endif // THINGSBOARD_ENABLE_STL
+
+
+constexpr char BENCHMARK_SUITE[] = "size";
+
+size_t g_api_bytes = 0U; // Sum of the sizes of all reported API implementations
+size_t g_apis = 0U;      // Amount of reported API implementations
+
+
+/// @brief Prints the size of the given type, with the default template arguments of the library
+/// @tparam T Type whose size should be reported
+/// @param name Name of the type, used as the name of the result
+/// @param api Whether the type is an API implementation and should therefore be contained in the sum of all API implementations
+template <typename T>
+static void Report_Size(char const * name, bool const & api) {
+    if (api) {
+        g_api_bytes += sizeof(T);
+        g_apis++;
+    }
+    Benchmark_Report(BENCHMARK_SUITE, name)
+        .Add("inline_delegate", static_cast<uint64_t>(THINGSBOARD_ENABLE_INLINE_DELEGATE))
+        .Add("bytes", static_cast<uint64_t>(sizeof(T)))
+        .Print();
+}
+
+
+int main(int argc, char ** argv) {
+    Report_Size<Callback<void>>("Callback", false);
+    Report_Size<ThingsBoard>("ThingsBoard", false);
+    Report_Size<Attribute_Request<>>("Attribute_Request", true);
+    Report_Size<Client_Side_RPC<>>("Client_Side_RPC", true);
+    Report_Size<Provision<>>("Provision", true);
+    Report_Size<Server_Side_RPC<>>("Server_Side_RPC", true);
+    Report_Size<Shared_Attribute_Update<>>("Shared_Attribute_Update", true);
+#if THINGSBOARD_ENABLE_STL
+    Report_Size<OTA_Firmware_Update<>>("OTA_Firmware_Update", true);
+#endif // THINGSBOARD_ENABLE_STL
+
+    // The non-STL configurations can not build OTA_Firmware_Update, the amount of API implementations tells both sums apart
+    Benchmark_Report(BENCHMARK_SUITE, "api_total")
+        .Add("inline_delegate", static_cast<uint64_t>(THINGSBOARD_ENABLE_INLINE_DELEGATE))
+        .Add("apis", static_cast<uint64_t>(g_apis))
+        .Add("bytes", static_cast<uint64_t>(g_api_bytes))
+        .Print();
+    return 0;
+}
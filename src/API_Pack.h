@@ -0,0 +1,72 @@
+#ifndef API_Pack_h
+#define API_Pack_h
+
+// Local includes.
+#include "IAPI_Implementation.h"
+
+
+/// @brief Empty type used to select the get() overload of the API_Pack that returns the API implementation of the given type
+/// @tparam API Type of the API implementation that should be returned
+template <typename API>
+struct API_Pack_Tag {};
+
+
+/// @brief Holds a fixed set of API implementations by value, whose types are known at compile time, specialized below for the empty pack and for one or more API implementations.
+/// In comparison to subscribing the API implementations at runtime, they do not have to be stored as pointers and are not called through their virtual methods,
+/// instead every call is expanded at compile time into one qualified call per contained API implementation, which the compiler can inline.
+/// Can be passed as the last template argument of ThingsBoardSized or used through the ThingsBoardStatic alias
+/// @tparam APIs Types of the contained API implementations, each has to be default constructible and derive from IAPI_Implementation, every type may only be contained once
+template <typename... APIs>
+class API_Pack;
+
+template <>
+class API_Pack<> {
+  public:
+    /// @brief Amount of contained API implementations
+    static size_t constexpr SIZE = 0U;
+
+    /// @brief Calls the given function with every contained API implementation, does nothing for the empty pack
+    /// @tparam Function Function object with a templated call operator that receives a reference to an API implementation
+    /// @param function Function object that should be called
+    template <typename Function>
+    void for_each(Function & function) {
+        // Nothing to do
+    }
+
+  protected:
+    /// @brief Overload that ends the overload set of the get() methods of all derived packs
+    void get(API_Pack_Tag<void>);
+};
+
+template <typename API, typename... Remaining>
+class API_Pack<API, Remaining...> : public API_Pack<Remaining...> {
+  public:
+    /// @brief Amount of contained API implementations
+    static size_t constexpr SIZE = 1U + sizeof...(Remaining);
+
+    /// @brief Calls the given function with every contained API implementation, in the order they were passed as template arguments.
+    /// The function receives each API implementation as a reference to its actual type, meaning calls inside the function are resolved at compile time
+    /// @tparam Function Function object with a templated call operator that receives a reference to an API implementation
+    /// @param function Function object that should be called
+    template <typename Function>
+    void for_each(Function & function) {
+        function(m_api);
+        API_Pack<Remaining...>::for_each(function);
+    }
+
+    using API_Pack<Remaining...>::get;
+
+    /// @brief Gets the contained API implementation of the given type
+    /// @return Reference to the contained API implementation
+    API & get(API_Pack_Tag<API>) {
+        return m_api;
+    }
+
+  private:
+    API m_api = {}; // Contained API implementation
+};
+
+template <typename API, typename... Remaining>
+size_t constexpr API_Pack<API, Remaining...>::SIZE;
+
+#endif // API_Pack_h
@@ -0,0 +1,252 @@
+#ifndef Allocator_Policy_h
+#define Allocator_Policy_h
+
+// Local include.
+#include "IAllocator.h"
+#include "Memory_Stats.h"
+
+// Library include.
+#include <stdlib.h>
+#if THINGSBOARD_ENABLE_STL
+#include <new>
+#endif // THINGSBOARD_ENABLE_STL
+
+
+/// @brief Amount of bytes in front of every array created with Allocator_Policy::Create_Array, that hold the amount of elements in the array.
+/// Atleast the alignment of any type, so that the elements following it are still correctly aligned
+size_t constexpr ALLOCATOR_ARRAY_HEADER_SIZE = sizeof(size_t) > alignof(::max_align_t) ? sizeof(size_t) : alignof(::max_align_t);
+
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+/// @brief Header in front of every allocation made by the Allocator_Policy if THINGSBOARD_ENABLE_MEMORY_STATS is set,
+/// allows to account freeing the memory to the same subsystem and with the same size it was allocated with
+struct Allocator_Stats_Header {
+    size_t           size = {};      // Amount of bytes that were requested
+    Memory_Subsystem subsystem = {}; // Subsystem the memory was allocated for
+};
+
+/// @brief Amount of bytes in front of every allocation that hold the Allocator_Stats_Header, rounded up to the alignment of any type,
+/// so that the allocated memory following it is still correctly aligned. Has to be included when calculating the memory required by an installed allocator
+size_t constexpr ALLOCATOR_STATS_HEADER_SIZE = (sizeof(Allocator_Stats_Header) + alignof(::max_align_t) - 1U) / alignof(::max_align_t) * alignof(::max_align_t);
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+
+
+/// @brief Tag type used to select the placement new overload below, instead of the one from the <new> header,
+/// which is not available on every board that does not support the C++ STL
+struct Allocator_Placement {};
+
+/// @brief Placement new overload used to construct elements inside already allocated uninitialized memory
+/// @param size Size of the constructed element, not used because the memory has already been allocated
+/// @param tag Tag that selects this overload
+/// @param position Pointer to the uninitialized memory the element should be constructed in
+/// @return Pointer to the uninitialized memory the element should be constructed in
+inline void * operator new(size_t size, Allocator_Placement const & tag, void * position) {
+    return position;
+}
+
+/// @brief Matching placement delete, only ever called by the compiler if the constructor of the element throws an exception
+/// @param pointer Pointer to the memory the element would have been constructed in
+/// @param tag Tag that selects this overload
+/// @param position Pointer to the uninitialized memory the element should be constructed in
+inline void operator delete(void * pointer, Allocator_Placement const & tag, void * position) {
+    // Nothing to do
+}
+
+
+/// @brief Routes every memory allocation made by the library through one IAllocator, instead of using new and delete directly.
+/// Includes the internal buffers used to send data, the pending requests, timers and the content of all Vector instances and JsonDocument instances allocated on the heap.
+/// If no allocator has been installed, the memory is allocated on the heap with malloc, which results in the same behaviour as before.
+/// Installing a Fixed_Block_Allocator or Bump_Allocator at startup, before any other instance of the library is created,
+/// allows to run with a deterministic memory pool with an upper bound and without any further use of the general heap.
+/// The policy is the same for the whole program, instead of being passed as a template argument, because the containers and JsonDocument instances
+/// are created by every API implementation and callback seperately, which would require the allocator in the type of every single one of them
+class Allocator_Policy {
+  public:
+    /// @brief Installs the given allocator, used for every allocation made afterwards.
+    /// Memory is always freed with the allocator installed at that time, therefore it should be installed once at startup and never changed while instances of the library exist
+    /// @param allocator Allocator that should be used or nullptr to use the heap again, has to be kept alive for as long as it is installed
+    static void Set_Allocator(IAllocator * allocator) {
+        Get_Installed_Allocator() = allocator;
+    }
+
+    /// @brief Gets the currently installed allocator
+    /// @return Pointer to the installed allocator or nullptr if the memory is allocated on the heap
+    static IAllocator * Get_Allocator() {
+        return Get_Installed_Allocator();
+    }
+
+    /// @brief Allocates uninitialized memory with the installed allocator
+    /// @param size Amount of bytes that should be allocated
+    /// @param subsystem Subsystem the allocation is accounted to if THINGSBOARD_ENABLE_MEMORY_STATS is set, defaults to the subsystem of the innermost Memory_Scope
+    /// @return Pointer to the allocated memory or nullptr if there is not enough memory left
+    static void * allocate(size_t size, Memory_Subsystem subsystem = Memory_Scope::Current()) {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        uint8_t * memory = static_cast<uint8_t *>(Raw_Allocate(ALLOCATOR_STATS_HEADER_SIZE + size));
+        if (memory == nullptr) {
+            Memory_Stats::Record_Failure(subsystem);
+            return nullptr;
+        }
+        Allocator_Stats_Header * header = reinterpret_cast<Allocator_Stats_Header *>(memory);
+        header->size = size;
+        header->subsystem = subsystem;
+        Memory_Stats::Record_Allocation(subsystem, size);
+        return memory + ALLOCATOR_STATS_HEADER_SIZE;
+#else
+        return Raw_Allocate(size);
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+    /// @brief Frees memory previously allocated with the installed allocator
+    /// @param pointer Pointer to the memory that should be freed, may be nullptr
+    static void deallocate(void * pointer) {
+        if (pointer == nullptr) {
+            return;
+        }
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        uint8_t * memory = static_cast<uint8_t *>(pointer) - ALLOCATOR_STATS_HEADER_SIZE;
+        Allocator_Stats_Header const * header = reinterpret_cast<Allocator_Stats_Header const *>(memory);
+        Memory_Stats::Record_Deallocation(header->subsystem, header->size);
+        pointer = memory;
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+        IAllocator * allocator = Get_Installed_Allocator();
+        if (allocator != nullptr) {
+            allocator->deallocate(pointer);
+            return;
+        }
+        free(pointer);
+    }
+
+    /// @brief Changes the size of memory previously allocated with the installed allocator
+    /// @param pointer Pointer to the memory that should be resized, allocates new memory if it is nullptr
+    /// @param size Amount of bytes the memory should have afterwards
+    /// @param subsystem Subsystem newly allocated memory is accounted to if the given pointer is nullptr, resized memory stays accounted to the subsystem it was allocated for
+    /// @return Pointer to the resized memory or nullptr if there is not enough memory left, in which case the given memory is still valid
+    static void * reallocate(void * pointer, size_t size, Memory_Subsystem subsystem = Memory_Scope::Current()) {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        if (pointer == nullptr) {
+            return allocate(size, subsystem);
+        }
+        uint8_t * memory = static_cast<uint8_t *>(pointer) - ALLOCATOR_STATS_HEADER_SIZE;
+        Allocator_Stats_Header const previous = *reinterpret_cast<Allocator_Stats_Header const *>(memory);
+        memory = static_cast<uint8_t *>(Raw_Reallocate(memory, ALLOCATOR_STATS_HEADER_SIZE + size));
+        if (memory == nullptr) {
+            Memory_Stats::Record_Failure(previous.subsystem);
+            return nullptr;
+        }
+        reinterpret_cast<Allocator_Stats_Header *>(memory)->size = size;
+        Memory_Stats::Record_Resize(previous.subsystem, previous.size, size);
+        return memory + ALLOCATOR_STATS_HEADER_SIZE;
+#else
+        return Raw_Reallocate(pointer, size);
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+    /// @brief Allocates an array with the installed allocator and value initializes every element, replaces new T[count]()
+    /// @tparam T Type of the elements, has to be default constructible
+    /// @param count Amount of elements in the array
+    /// @param subsystem Subsystem the allocation is accounted to if THINGSBOARD_ENABLE_MEMORY_STATS is set, defaults to the subsystem of the innermost Memory_Scope
+    /// @return Pointer to the first element or nullptr if the count is 0 or there is not enough memory left
+    template <typename T>
+    static T * Create_Array(size_t const & count, Memory_Subsystem subsystem = Memory_Scope::Current()) {
+        if (count == 0U) {
+            return nullptr;
+        }
+        uint8_t * memory = static_cast<uint8_t *>(allocate(ALLOCATOR_ARRAY_HEADER_SIZE + count * sizeof(T), subsystem));
+        if (memory == nullptr) {
+            return nullptr;
+        }
+        *reinterpret_cast<size_t *>(memory) = count;
+        T * elements = reinterpret_cast<T *>(memory + ALLOCATOR_ARRAY_HEADER_SIZE);
+        for (size_t i = 0U; i < count; ++i) {
+            new (Allocator_Placement(), elements + i) T();
+        }
+        return elements;
+    }
+
+    /// @brief Destroys every element of an array previously created with Create_Array and frees its memory, replaces delete[] elements
+    /// @tparam T Type of the elements
+    /// @param elements Pointer to the first element, may be nullptr
+    template <typename T>
+    static void Destroy_Array(T * elements) {
+        if (elements == nullptr) {
+            return;
+        }
+        uint8_t * memory = reinterpret_cast<uint8_t *>(elements) - ALLOCATOR_ARRAY_HEADER_SIZE;
+        size_t const count = *reinterpret_cast<size_t *>(memory);
+        for (size_t i = count; i > 0U; --i) {
+            elements[i - 1U].~T();
+        }
+        deallocate(memory);
+    }
+
+  private:
+    /// @brief Allocates uninitialized memory with the installed allocator or on the heap, without accounting it
+    /// @param size Amount of bytes that should be allocated
+    /// @return Pointer to the allocated memory or nullptr if there is not enough memory left
+    static void * Raw_Allocate(size_t size) {
+        IAllocator * allocator = Get_Installed_Allocator();
+        return allocator != nullptr ? allocator->allocate(size) : malloc(size);
+    }
+
+    /// @brief Changes the size of memory with the installed allocator or on the heap, without accounting it
+    /// @param pointer Pointer to the memory that should be resized, allocates new memory if it is nullptr
+    /// @param size Amount of bytes the memory should have afterwards
+    /// @return Pointer to the resized memory or nullptr if there is not enough memory left, in which case the given memory is still valid
+    static void * Raw_Reallocate(void * pointer, size_t size) {
+        IAllocator * allocator = Get_Installed_Allocator();
+        return allocator != nullptr ? allocator->reallocate(pointer, size) : realloc(pointer, size);
+    }
+
+    /// @brief Gets the storage of the installed allocator, a function local static is used so that the class can stay header only
+    /// @return Reference to the pointer to the installed allocator
+    static IAllocator *& Get_Installed_Allocator() {
+        static IAllocator * allocator = nullptr;
+        return allocator;
+    }
+};
+
+
+#if THINGSBOARD_ENABLE_STL
+/// @brief Allocator for the C++ STL containers, that allocates their memory with the Allocator_Policy, used for the Vector signature if THINGSBOARD_ENABLE_STL is set.
+/// STL containers can not handle failed allocations, therefore if the installed allocator runs out of memory std::bad_alloc is thrown or the program is aborted if exceptions are disabled
+/// @tparam T Type of the elements the container holds
+template <typename T>
+class Policy_Allocator {
+  public:
+    using value_type = T;
+
+    Policy_Allocator() = default;
+
+    template <typename U>
+    Policy_Allocator(Policy_Allocator<U> const & other) {
+        // Nothing to do
+    }
+
+    T * allocate(size_t count) {
+        void * memory = Allocator_Policy::allocate(count * sizeof(T), Memory_Scope::Current_Or(Memory_Subsystem::CALLBACKS));
+        if (memory == nullptr) {
+#if __cpp_exceptions
+            throw std::bad_alloc();
+#else
+            abort();
+#endif // __cpp_exceptions
+        }
+        return static_cast<T *>(memory);
+    }
+
+    void deallocate(T * pointer, size_t count) {
+        Allocator_Policy::deallocate(pointer);
+    }
+
+    template <typename U>
+    bool operator==(Policy_Allocator<U> const & other) const {
+        return true;
+    }
+
+    template <typename U>
+    bool operator!=(Policy_Allocator<U> const & other) const {
+        return false;
+    }
+};
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // Allocator_Policy_h
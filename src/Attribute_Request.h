@@ -4,6 +4,7 @@
 // Local includes.
 #include "Attribute_Request_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Pending_Request_Table.h"
 
 
 // Attribute request API topics.
@@ -84,26 +85,15 @@ class Attribute_Request : public IAPI_Implementation {
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
         size_t const request_id = Helper::parseRequestId(ATTRIBUTE_RESPONSE_TOPIC, topic);
         JsonObjectConst object = data.template as<JsonObjectConst>();
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
 
-#if THINGSBOARD_ENABLE_STL
-#if THINGSBOARD_ENABLE_DYNAMIC
-        auto it = std::find_if(m_attribute_request_callbacks.begin(), m_attribute_request_callbacks.end(), [&request_id](Attribute_Request_Callback & attribute_request) {
-#else
-        auto it = std::find_if(m_attribute_request_callbacks.begin(), m_attribute_request_callbacks.end(), [&request_id](Attribute_Request_Callback<MaxAttributes> & attribute_request) {
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-            return attribute_request.Get_Request_ID() == request_id;
-        });
-        if (it != m_attribute_request_callbacks.end()) {
-            auto & attribute_request = *it;
-#else
-        for (auto it = m_attribute_request_callbacks.begin(); it != m_attribute_request_callbacks.end(); ++it) {
-            auto & attribute_request = *it;
-
-            if (attribute_request.Get_Request_ID() != request_id) {
-                continue;
+        auto * attribute_request = m_attribute_request_callbacks.find(request_id);
+        if (attribute_request != nullptr) {
+            if (timer_wheel != nullptr) {
+                attribute_request->Stop_Timeout_Timer(*timer_wheel);
             }
-#endif // THINGSBOARD_ENABLE_STL
-            char const * attribute_response_key = attribute_request.Get_Attribute_Key();
+
+            char const * attribute_response_key = attribute_request->Get_Attribute_Key();
             if (attribute_response_key == nullptr) {
 #if THINGSBOARD_ENABLE_DEBUG
                 Logger::printfln(ATT_KEY_NOT_FOUND);
@@ -115,15 +105,12 @@ class Attribute_Request : public IAPI_Implementation {
                 object = object[attribute_response_key];
             }
 
-            attribute_request.Stop_Timeout_Timer();
-            attribute_request.Call_Callback(object);
+            attribute_request->Call_Callback(object);
 
             delete_callback:
-            // Delete callback because the changes have been requested and the callback is no longer needed
-            Helper::remove(m_attribute_request_callbacks, it);
-#if !THINGSBOARD_ENABLE_STL
-            break;
-#endif // !THINGSBOARD_ENABLE_STL
+            // Delete callback because the changes have been requested and the callback is no longer needed,
+            // removed by request id, because the callback might have sent further requests which may have moved the entry
+            (void)m_attribute_request_callbacks.remove(request_id);
         }
 
         // Unsubscribe from the shared attribute request topic,
@@ -134,6 +121,10 @@ class Attribute_Request : public IAPI_Implementation {
         }
     }
 
+    char const * Get_Response_Topic_Prefix() const override {
+        return ATTRIBUTE_RESPONSE_TOPIC;
+    }
+
     bool Compare_Response_Topic(char const * topic) const override {
         return strncmp(ATTRIBUTE_RESPONSE_TOPIC, topic, strlen(ATTRIBUTE_RESPONSE_TOPIC)) == 0;
     }
@@ -146,23 +137,16 @@ class Attribute_Request : public IAPI_Implementation {
         return Unsubscribe();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
-        for (auto & attribute_request : m_attribute_request_callbacks) {
-            attribute_request.Update_Timeout_Timer();
-        }
+        // Nothing to do
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
     }
 
-    void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
-        m_send_json_callback.Set_Callback(send_json_callback);
-        m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
-        m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
-        m_get_request_id_callback.Set_Callback(get_request_id_callback);
+    void Set_Client_Context(IAPI_Client_Context & context) override {
+        m_client_context = &context;
     }
 
   private:
@@ -193,18 +177,6 @@ class Attribute_Request : public IAPI_Implementation {
             return false;
         }
 
-#if THINGSBOARD_ENABLE_DYNAMIC
-        Attribute_Request_Callback * registered_callback = nullptr;
-#else
-        Attribute_Request_Callback<MaxAttributes> * registered_callback = nullptr;
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-        if (!Attributes_Request_Subscribe(callback, registered_callback)) {
-            return false;
-        }
-        else if (registered_callback == nullptr) {
-            return false;
-        }
-
         // String are const char* and therefore stored as a pointer --> zero copy, meaning the size for the strings is 0 bytes,
         // Data structure size depends on the amount of key value pairs passed + the default clientKeys or sharedKeys
         // See https://arduinojson.org/v6/assistant/ for more information on the needed size for the JsonDocument
@@ -222,8 +194,9 @@ class Attribute_Request : public IAPI_Implementation {
             size += strlen(",");
         }
 
-        // Initalizes complete array to 0, required because strncat needs both destination and source to contain proper null terminated strings
-        char request[size] = {};
+        // Initalizes complete array to 0, required because strncat needs both destination and source to contain proper null terminated strings.
+        // Additional byte is required for the null termination character, because strncat always writes it after the appended characters
+        char request[size + 1U] = {};
         for (const auto & att : attributes) {
             if (Helper::stringIsNullorEmpty(att)) {
 #if THINGSBOARD_ENABLE_DEBUG
@@ -243,30 +216,51 @@ class Attribute_Request : public IAPI_Implementation {
         // and because there is not enough space the value would simply be "undefined" instead. Which would cause the request to not be sent correctly
         request_buffer[attribute_request_key] = static_cast<const char*>(request);
 
-        size_t * p_request_id = m_get_request_id_callback.Call_Callback();
+        size_t * p_request_id = m_client_context->Get_Request_ID();
         if (p_request_id == nullptr) {
             Logger::printfln(REQUEST_ID_NULL);
             return false;
         }
         auto & request_id = *p_request_id;
 
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
+        if (timer_wheel == nullptr) {
+            Logger::printfln(TIMER_WHEEL_NULL);
+            return false;
+        }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+        Attribute_Request_Callback * registered_callback = nullptr;
+#else
+        Attribute_Request_Callback<MaxAttributes> * registered_callback = nullptr;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        if (!Attributes_Request_Subscribe(callback, request_id + 1U, registered_callback)) {
+            return false;
+        }
+        else if (registered_callback == nullptr) {
+            return false;
+        }
+
         registered_callback->Set_Request_ID(++request_id);
         registered_callback->Set_Attribute_Key(attribute_response_key);
-        registered_callback->Start_Timeout_Timer();
+        if (!registered_callback->Start_Timeout_Timer(*timer_wheel)) {
+            Logger::printfln(UNABLE_TO_ARM_TIMEOUT_TIMER);
+        }
 
         char topic[Helper::detectSize(ATTRIBUTE_REQUEST_TOPIC, request_id)] = {};
         (void)snprintf(topic, sizeof(topic), ATTRIBUTE_REQUEST_TOPIC, request_id);
-        return m_send_json_callback.Call_Callback(topic, request_buffer, Helper::Measure_Json(request_buffer));
+        return m_client_context->Send_Json(topic, request_buffer, Helper::Measure_Json(request_buffer));
     }
 
     /// @brief Subscribes to attribute response topic
     /// @param callback Callback method that will be called
+    /// @param request_id Request id the request will be sent with, used to find the local version once the response is received
     /// @param registered_callback Editable pointer to a reference of the local version that was copied from the passed callback
     /// @return Whether requesting the given callback was successful or not
 #if THINGSBOARD_ENABLE_DYNAMIC
-    bool Attributes_Request_Subscribe(Attribute_Request_Callback const & callback, Attribute_Request_Callback * & registered_callback) {
+    bool Attributes_Request_Subscribe(Attribute_Request_Callback const & callback, size_t const & request_id, Attribute_Request_Callback * & registered_callback) {
 #else
-    bool Attributes_Request_Subscribe(Attribute_Request_Callback<MaxAttributes> const & callback, Attribute_Request_Callback<MaxAttributes> * & registered_callback) {
+    bool Attributes_Request_Subscribe(Attribute_Request_Callback<MaxAttributes> const & callback, size_t const & request_id, Attribute_Request_Callback<MaxAttributes> * & registered_callback) {
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 #if !THINGSBOARD_ENABLE_DYNAMIC
         if (m_attribute_request_callbacks.size() + 1 > m_attribute_request_callbacks.capacity()) {
@@ -274,12 +268,11 @@ class Attribute_Request : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        if (!m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC)) {
+        if (!m_client_context->Subscribe_Topic(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC)) {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
           return false;
         }
-        m_attribute_request_callbacks.push_back(callback);
-        registered_callback = &m_attribute_request_callbacks.back();
+        registered_callback = m_attribute_request_callbacks.insert(request_id, callback);
         return true;
     }
 
@@ -287,14 +280,21 @@ class Attribute_Request : public IAPI_Implementation {
     /// @return Whether unsubcribing the previously subscribed callbacks
     /// and from the  attribute response topic, was successful or not
     bool Attributes_Request_Unsubscribe() {
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
+        if (timer_wheel != nullptr) {
+#if THINGSBOARD_ENABLE_DYNAMIC
+            m_attribute_request_callbacks.for_each([timer_wheel](Attribute_Request_Callback & attribute_request) {
+#else
+            m_attribute_request_callbacks.for_each([timer_wheel](Attribute_Request_Callback<MaxAttributes> & attribute_request) {
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+                attribute_request.Stop_Timeout_Timer(*timer_wheel);
+            });
+        }
         m_attribute_request_callbacks.clear();
-        return m_unsubscribe_topic_callback.Call_Callback(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
+        return m_client_context->Unsubscribe_Topic(ATTRIBUTE_RESPONSE_SUBSCRIBE_TOPIC);
     }
 
-    Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};          // Send json document callback
-    Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};    // Subscribe mqtt topic client callback
-    Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};  // Unubscribe mqtt topic client callback
-    Callback<size_t *>                                                       m_get_request_id_callback = {};     // Get internal request id callback
+    IAPI_Client_Context *                                                    m_client_context = &Unbound_Client_Context::Get_Instance(); // Non-owning pointer to the client this API implementation communicates with the cloud over
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
@@ -305,9 +305,9 @@ class Attribute_Request : public IAPI_Implementation {
     // Therefore copy-by-value has been choosen as for this specific use case it is more advantageous,
     // especially because at most we copy internal vectors or array, that will only ever contain a few pointers
 #if THINGSBOARD_ENABLE_DYNAMIC
-    Vector<Attribute_Request_Callback>                                       m_attribute_request_callbacks = {}; // Client-side or shared attribute request callback vector
+    Pending_Request_Table<Attribute_Request_Callback>                        m_attribute_request_callbacks = {}; // Client-side or shared attribute request callbacks, keyed by the request id they were sent with
 #else
-    Array<Attribute_Request_Callback<MaxAttributes>, MaxSubscriptions>       m_attribute_request_callbacks = {}; // Client-side or shared attribute request callback array
+    Pending_Request_Table<Attribute_Request_Callback<MaxAttributes>, MaxSubscriptions> m_attribute_request_callbacks = {}; // Client-side or shared attribute request callbacks, keyed by the request id they were sent with
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 };
 
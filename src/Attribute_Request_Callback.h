@@ -2,7 +2,7 @@
 #define Attribute_Request_Callback_h
 
 // Local includes.
-#include "Callback_Watchdog.h"
+#include "Timer_Wheel.h"
 #if !THINGSBOARD_ENABLE_DYNAMIC
 #include "Constants.h"
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
@@ -44,13 +44,14 @@ class Attribute_Request_Callback : public Callback<void, JsonObjectConst const &
     /// or if the connection could not be established, default = nullptr
     /// @param ...args Arguments that will be forwarded into the overloaded vector constructor see https://en.cppreference.com/w/cpp/container/vector/vector for more information
     template<typename... Args>
-    Attribute_Request_Callback(function callback, uint64_t const & timeout_microseconds = 0U, Callback_Watchdog::function timeout_callback = nullptr, Args const &... args)
+    Attribute_Request_Callback(function callback, uint64_t const & timeout_microseconds = 0U, Callback<void>::function timeout_callback = nullptr, Args const &... args)
       : Callback(callback)
       , m_attributes(args...)
       , m_request_id(0U)
       , m_attribute_key(nullptr)
       , m_timeout_microseconds(timeout_microseconds)
       , m_timeout_callback(timeout_callback)
+      , m_timeout_handle(INVALID_TIMER_HANDLE)
     {
         // Nothing to do
     }
@@ -134,31 +135,29 @@ class Attribute_Request_Callback : public Callback<void, JsonObjectConst const &
         m_timeout_microseconds = timeout_microseconds;
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Updates the internal timeout timer
-    void Update_Timeout_Timer() {
-        m_timeout_callback.update();
-    }
-#endif // !THINGSBOARD_USE_ESP_TIMER
-
-    /// @brief Starts the internal timeout timer if we actually received a configured valid timeout time and a valid callback.
+    /// @brief Arms the timeout timer in the given shared timer wheel, if we actually received a configured valid timeout time.
     /// Is called as soon as the request is actually sent
-    void Start_Timeout_Timer() {
+    /// @param timer_wheel Timer wheel that is shared by all requests and calls the timeout callback if the timer is not stopped in time
+    /// @return Whether the timer was armed or no timer was required, false if the timer wheel had no space for another timer
+    bool Start_Timeout_Timer(Timer_Wheel & timer_wheel) {
         if (m_timeout_microseconds == 0U) {
-            return;
+            return true;
         }
-        m_timeout_callback.once(m_timeout_microseconds);
+        (void)timer_wheel.cancel(m_timeout_handle);
+        m_timeout_handle = timer_wheel.arm(m_timeout_microseconds, m_timeout_callback);
+        return m_timeout_handle != INVALID_TIMER_HANDLE;
     }
 
-    /// @brief Stops the internal timeout timer, is called as soon as an answer is received from the cloud
+    /// @brief Cancels the timeout timer in the given shared timer wheel, is called as soon as an answer is received from the cloud
     /// if it isn't we call the previously subscribed callback instead
-    void Stop_Timeout_Timer() {
-        m_timeout_callback.detach();
+    /// @param timer_wheel Timer wheel the timeout timer was previously armed in
+    void Stop_Timeout_Timer(Timer_Wheel & timer_wheel) {
+        (void)timer_wheel.cancel(m_timeout_handle);
     }
 
     /// @brief Sets the callback method that will be called upon request timeout (did not receive a response in the given timeout time)
     /// @param timeout_callback Callback function that will be called
-    void Set_Timeout_Callback(Callback_Watchdog::function timeout_callback) {
+    void Set_Timeout_Callback(Callback<void>::function timeout_callback) {
         m_timeout_callback.Set_Callback(timeout_callback);
     }
 
@@ -171,7 +170,8 @@ class Attribute_Request_Callback : public Callback<void, JsonObjectConst const &
     size_t                             m_request_id = {};           // Id the request was called with
     char const                         *m_attribute_key = {};       // Attribute key that we wil receive the response on ("client" or "shared")
     uint64_t                           m_timeout_microseconds = {}; // Timeout time until we expect response to request
-    Callback_Watchdog                  m_timeout_callback = {};     // Handles callback that will be called if request times out
+    Callback<void>                     m_timeout_callback = {};     // Callback that will be called if request times out
+    Timer_Handle                       m_timeout_handle = {};       // Handle of the timeout timer armed in the shared timer wheel
 };
 
 #endif // Attribute_Request_Callback_h
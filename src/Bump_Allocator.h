@@ -0,0 +1,125 @@
+#ifndef Bump_Allocator_h
+#define Bump_Allocator_h
+
+// Local include.
+#include "IAllocator.h"
+
+// Library include.
+#include <string.h>
+
+
+/// @brief Amount of bytes in front of every allocation of a Bump_Allocator, that hold the size of the allocation.
+/// Atleast the alignment of any type, so that the allocated memory following it is still correctly aligned
+size_t constexpr BUMP_ALLOCATOR_HEADER_SIZE = sizeof(size_t) > alignof(::max_align_t) ? sizeof(size_t) : alignof(::max_align_t);
+
+
+/// @brief Allocator that places every allocation directly after the previous one, in a buffer owned by the instance itself (bump or arena allocation).
+/// Allocating is O(1) and allocations of any size fit as long as enough of the buffer is left. Memory is only reused once it is freed in the reverse order it was allocated in,
+/// or once every allocation has been freed, which resets the whole buffer. Therefore fits best for the short lived buffers of a single send or receive,
+/// which are always freed before the next message is processed, whereas long lived allocations (containers, pending requests) should be created at startup and never freed
+/// @tparam Size Amount of bytes the buffer can hold, including a small header in front of every allocation
+template <size_t Size>
+class Bump_Allocator : public IAllocator {
+  public:
+    static_assert(Size > BUMP_ALLOCATOR_HEADER_SIZE, "Buffer has to be able to hold atleast one allocation");
+
+    /// @brief Constructor
+    Bump_Allocator()
+      : m_buffer()
+      , m_offset(0U)
+      , m_last(SIZE_MAX)
+      , m_live(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Gets the amount of bytes of the buffer that are currently used, including the gaps of freed allocations that could not be reused yet
+    /// @return Amount of used bytes
+    size_t used() const {
+        return m_offset;
+    }
+
+    /// @brief Gets the amount of bytes that can still be allocated at the end of the buffer, without the header of the next allocation
+    /// @return Amount of unused bytes
+    size_t available() const {
+        return Size - m_offset > BUMP_ALLOCATOR_HEADER_SIZE ? Size - m_offset - BUMP_ALLOCATOR_HEADER_SIZE : 0U;
+    }
+
+    void * allocate(size_t size) override {
+        size_t const required = BUMP_ALLOCATOR_HEADER_SIZE + Align(size);
+        if (required > Size - m_offset) {
+            return nullptr;
+        }
+        *reinterpret_cast<size_t *>(m_buffer + m_offset) = size;
+        m_last = m_offset;
+        m_offset += required;
+        m_live++;
+        return m_buffer + m_last + BUMP_ALLOCATOR_HEADER_SIZE;
+    }
+
+    void deallocate(void * pointer) override {
+        if (pointer == nullptr) {
+            return;
+        }
+        m_live--;
+        if (m_live == 0U) {
+            m_offset = 0U;
+            m_last = SIZE_MAX;
+        }
+        else if (Get_Offset(pointer) == m_last) {
+            // Only the most recent allocation can be given back, because the offset of the allocation before it is not known
+            m_offset = m_last;
+            m_last = SIZE_MAX;
+        }
+    }
+
+    void * reallocate(void * pointer, size_t size) override {
+        if (pointer == nullptr) {
+            return allocate(size);
+        }
+        size_t const offset = Get_Offset(pointer);
+        size_t const previous_size = *reinterpret_cast<size_t *>(m_buffer + offset);
+        if (offset == m_last) {
+            // The most recent allocation can grow or shrink in place
+            size_t const required = BUMP_ALLOCATOR_HEADER_SIZE + Align(size);
+            if (required > Size - offset) {
+                return nullptr;
+            }
+            *reinterpret_cast<size_t *>(m_buffer + offset) = size;
+            m_offset = offset + required;
+            return pointer;
+        }
+        else if (size <= previous_size) {
+            return pointer;
+        }
+        void * memory = allocate(size);
+        if (memory == nullptr) {
+            return nullptr;
+        }
+        memcpy(memory, pointer, previous_size);
+        deallocate(pointer);
+        return memory;
+    }
+
+  private:
+    /// @brief Rounds the given size up to the alignment of any type, so that the following allocation is correctly aligned as well
+    /// @param size Amount of bytes that should be allocated
+    /// @return Amount of bytes the allocation uses in the buffer
+    static size_t Align(size_t const & size) {
+        return (size + alignof(::max_align_t) - 1U) / alignof(::max_align_t) * alignof(::max_align_t);
+    }
+
+    /// @brief Gets the offset of the header of the given allocation in the buffer
+    /// @param pointer Pointer previously returned by allocate or reallocate
+    /// @return Offset of the header in front of the allocation
+    size_t Get_Offset(void * pointer) const {
+        return static_cast<uint8_t const *>(pointer) - m_buffer - BUMP_ALLOCATOR_HEADER_SIZE;
+    }
+
+    alignas(::max_align_t) uint8_t m_buffer[Size]; // Buffer all allocations are placed in
+    size_t                         m_offset = {};  // Offset of the first unused byte in the buffer
+    size_t                         m_last = {};    // Offset of the header of the most recent allocation that has not been freed yet or SIZE_MAX if it is not known
+    size_t                         m_live = {};    // Amount of allocations that have not been freed yet
+};
+
+#endif // Bump_Allocator_h
@@ -14,13 +14,18 @@
 #if THINGSBOARD_ENABLE_STL
 #include <functional>
 #include <vector>
+#include "Allocator_Policy.h"
 #endif // THINGSBOARD_ENABLE_STL
+#if THINGSBOARD_ENABLE_STL && THINGSBOARD_ENABLE_INLINE_DELEGATE
+#include "Inline_Delegate.h"
+#endif // THINGSBOARD_ENABLE_STL && THINGSBOARD_ENABLE_INLINE_DELEGATE
 
 
 #if THINGSBOARD_ENABLE_STL && THINGSBOARD_ENABLE_DYNAMIC
-/// @brief Vector signature, makes it possible to use the Vector name everywhere instead of having to differentiate between C++ STL support or not
+/// @brief Vector signature, makes it possible to use the Vector name everywhere instead of having to differentiate between C++ STL support or not.
+/// The memory is allocated with the Allocator_Policy, the same as the replacement Vector class used if THINGSBOARD_ENABLE_STL is not set
 template<typename T>
-using Vector = std::vector<T>;
+using Vector = std::vector<T, Policy_Allocator<T>>;
 #endif // THINGSBOARD_ENABLE_STL && THINGSBOARD_ENABLE_DYNAMIC
 
 
@@ -33,7 +38,9 @@ template<typename return_typ, typename... argument_types>
 class Callback {
   public:
     /// @brief Callback signature
-#if THINGSBOARD_ENABLE_STL
+#if THINGSBOARD_ENABLE_STL && THINGSBOARD_ENABLE_INLINE_DELEGATE
+    using function = Inline_Delegate<return_typ(argument_types... arguments)>;
+#elif THINGSBOARD_ENABLE_STL
     using function = std::function<return_typ(argument_types... arguments)>;
 #else
     using function = return_typ (*)(argument_types... arguments);
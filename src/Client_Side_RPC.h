@@ -4,6 +4,7 @@
 // Local includes.
 #include "RPC_Request_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Pending_Request_Table.h"
 
 
 // Client side RPC topics.
@@ -52,14 +53,6 @@ class Client_Side_RPC : public IAPI_Implementation {
             Logger::printfln(CLIENT_RPC_METHOD_NULL);
             return false;
         }
-        RPC_Request_Callback * registered_callback = nullptr;
-        if (!RPC_Request_Subscribe(callback, registered_callback)) {
-            return false;
-        }
-        else if (registered_callback == nullptr) {
-            return false;
-        }
-
         JsonArray const * parameters = callback.Get_Parameters();
 
 #if THINGSBOARD_ENABLE_DYNAMIC
@@ -88,19 +81,35 @@ class Client_Side_RPC : public IAPI_Implementation {
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
 
-        size_t * p_request_id = m_get_request_id_callback.Call_Callback();
+        size_t * p_request_id = m_client_context->Get_Request_ID();
         if (p_request_id == nullptr) {
             Logger::printfln(REQUEST_ID_NULL);
             return false;
         }
         auto & request_id = *p_request_id;
 
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
+        if (timer_wheel == nullptr) {
+            Logger::printfln(TIMER_WHEEL_NULL);
+            return false;
+        }
+
+        RPC_Request_Callback * registered_callback = nullptr;
+        if (!RPC_Request_Subscribe(callback, request_id + 1U, registered_callback)) {
+            return false;
+        }
+        else if (registered_callback == nullptr) {
+            return false;
+        }
+
         registered_callback->Set_Request_ID(++request_id);
-        registered_callback->Start_Timeout_Timer();
+        if (!registered_callback->Start_Timeout_Timer(*timer_wheel)) {
+            Logger::printfln(UNABLE_TO_ARM_TIMEOUT_TIMER);
+        }
 
         char topic[Helper::detectSize(RPC_SEND_REQUEST_TOPIC, request_id)] = {};
         (void)snprintf(topic, sizeof(topic), RPC_SEND_REQUEST_TOPIC, request_id);
-        return m_send_json_callback.Call_Callback(topic, request_buffer, Helper::Measure_Json(request_buffer));
+        return m_client_context->Send_Json(topic, request_buffer, Helper::Measure_Json(request_buffer));
     }
 
     API_Process_Type Get_Process_Type() const override {
@@ -113,29 +122,18 @@ class Client_Side_RPC : public IAPI_Implementation {
 
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
         size_t const request_id = Helper::parseRequestId(RPC_RESPONSE_TOPIC, topic);
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
 
-#if THINGSBOARD_ENABLE_STL
-        auto it = std::find_if(m_rpc_request_callbacks.begin(), m_rpc_request_callbacks.end(), [&request_id](RPC_Request_Callback & rpc_request) {
-            return rpc_request.Get_Request_ID() == request_id;
-        });
-        if (it != m_rpc_request_callbacks.end()) {
-            auto & rpc_request = *it;
-#else
-        for (auto it = m_rpc_request_callbacks.begin(); it != m_rpc_request_callbacks.end(); ++it) {
-            auto & rpc_request = *it;
-
-            if (rpc_request.Get_Request_ID() != request_id) {
-                continue;
+        RPC_Request_Callback * rpc_request = m_rpc_request_callbacks.find(request_id);
+        if (rpc_request != nullptr) {
+            if (timer_wheel != nullptr) {
+                rpc_request->Stop_Timeout_Timer(*timer_wheel);
             }
-#endif // THINGSBOARD_ENABLE_STL
-            rpc_request.Stop_Timeout_Timer();
-            rpc_request.Call_Callback(data);
-
-            // Delete callback because the changes have been requested and the callback is no longer needed
-            Helper::remove(m_rpc_request_callbacks, it);
-#if !THINGSBOARD_ENABLE_STL
-            break;
-#endif // !THINGSBOARD_ENABLE_STL
+            rpc_request->Call_Callback(data);
+
+            // Delete callback because the changes have been requested and the callback is no longer needed,
+            // removed by request id, because the callback might have sent further requests which may have moved the entry
+            (void)m_rpc_request_callbacks.remove(request_id);
         }
 
         // Attempt to unsubscribe from the shared attribute request topic,
@@ -146,6 +144,10 @@ class Client_Side_RPC : public IAPI_Implementation {
         }
     }
 
+    char const * Get_Response_Topic_Prefix() const override {
+        return RPC_RESPONSE_TOPIC;
+    }
+
     bool Compare_Response_Topic(char const * topic) const override {
         return strncmp(RPC_RESPONSE_TOPIC, topic, strlen(RPC_RESPONSE_TOPIC)) == 0;
     }
@@ -158,23 +160,16 @@ class Client_Side_RPC : public IAPI_Implementation {
         return Unsubscribe();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
-        for (auto & rpc_request : m_rpc_request_callbacks) {
-            rpc_request.Update_Timeout_Timer();
-        }
+        // Nothing to do
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
     }
 
-    void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
-        m_send_json_callback.Set_Callback(send_json_callback);
-        m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
-        m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
-        m_get_request_id_callback.Set_Callback(get_request_id_callback);
+    void Set_Client_Context(IAPI_Client_Context & context) override {
+        m_client_context = &context;
     }
 
   private:
@@ -182,21 +177,21 @@ class Client_Side_RPC : public IAPI_Implementation {
     /// that will be called if a reponse from the server for the method with the given name is received.
     /// See https://thingsboard.io/docs/user-guide/rpc/#client-side-rpc for more information
     /// @param callback Callback method that will be called
+    /// @param request_id Request id the request will be sent with, used to find the local version once the response is received
     /// @param registered_callback Editable pointer to a reference of the local version that was copied from the passed callback
     /// @return Whether requesting the given callback was successful or not
-    bool RPC_Request_Subscribe(RPC_Request_Callback const & callback, RPC_Request_Callback * & registered_callback) {
+    bool RPC_Request_Subscribe(RPC_Request_Callback const & callback, size_t const & request_id, RPC_Request_Callback * & registered_callback) {
 #if !THINGSBOARD_ENABLE_DYNAMIC
         if (m_rpc_request_callbacks.size() + 1 > m_rpc_request_callbacks.capacity()) {
             Logger::printfln(MAX_SUBSCRIPTIONS_EXCEEDED, MAX_SUBSCRIPTIONS_TEMPLATE_NAME, CLIENT_SIDE_RPC_SUBSCRIPTIONS);
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        if (!m_subscribe_topic_callback.Call_Callback(RPC_RESPONSE_SUBSCRIBE_TOPIC)) {
+        if (!m_client_context->Subscribe_Topic(RPC_RESPONSE_SUBSCRIBE_TOPIC)) {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, RPC_RESPONSE_SUBSCRIBE_TOPIC);
             return false;
         }
-        m_rpc_request_callbacks.push_back(callback);
-        registered_callback = &m_rpc_request_callbacks.back();
+        registered_callback = m_rpc_request_callbacks.insert(request_id, callback);
         return true;
     }
 
@@ -204,14 +199,17 @@ class Client_Side_RPC : public IAPI_Implementation {
     /// @return Whether unsubcribing the previously subscribed callbacks
     /// and from the client-side RPC response topic, was successful or not
     bool RPC_Request_Unsubscribe() {
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
+        if (timer_wheel != nullptr) {
+            m_rpc_request_callbacks.for_each([timer_wheel](RPC_Request_Callback & rpc_request) {
+                rpc_request.Stop_Timeout_Timer(*timer_wheel);
+            });
+        }
         m_rpc_request_callbacks.clear();
-        return m_unsubscribe_topic_callback.Call_Callback(RPC_RESPONSE_SUBSCRIBE_TOPIC);
+        return m_client_context->Unsubscribe_Topic(RPC_RESPONSE_SUBSCRIBE_TOPIC);
     }
 
-    Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};          // Send json document callback
-    Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};    // Subscribe mqtt topic client callback
-    Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};  // Unubscribe mqtt topic client callback
-    Callback<size_t *>                                                       m_get_request_id_callback = {};     // Get internal request id callback
+    IAPI_Client_Context *                                                    m_client_context = &Unbound_Client_Context::Get_Instance(); // Non-owning pointer to the client this API implementation communicates with the cloud over
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
@@ -222,9 +220,9 @@ class Client_Side_RPC : public IAPI_Implementation {
     // Therefore copy-by-value has been choosen as for this specific use case it is more advantageous,
     // especially because at most we copy internal vectors or array, that will only ever contain a few pointers
 #if THINGSBOARD_ENABLE_DYNAMIC
-    Vector<RPC_Request_Callback>                                             m_rpc_request_callbacks = {};       // Server side RPC callbacks vector
+    Pending_Request_Table<RPC_Request_Callback>                              m_rpc_request_callbacks = {};       // Client side RPC callbacks, keyed by the request id they were sent with
 #else
-    Array<RPC_Request_Callback, MaxSubscriptions>                            m_rpc_request_callbacks = {};       // Server side RPC callbacks array
+    Pending_Request_Table<RPC_Request_Callback, MaxSubscriptions>            m_rpc_request_callbacks = {};       // Client side RPC callbacks, keyed by the request id they were sent with
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 };
 
@@ -42,6 +42,25 @@
 #    endif
 #  endif
 
+// Use the Inline_Delegate class instead of std::function as the function type of all internal callbacks, requires the C++ STL.
+// Stores the wrapped functor, meaning the function pointer, lambda or std::bind result directly inside of the callback instead of on the heap,
+// which removes the heap allocations when creating and copying callbacks, at the cost of a compile time error if a passed lambda captures more state
+// than fits into the internal buffer (DEFAULT_INLINE_DELEGATE_CAPACITY, three pointers) or requires a bigger alignment than a pointer, like a captured double on 32 bit platforms.
+// A callback is four pointers big, the same as std::function in libstdc++, which however only stores functors of up to two pointers inline
+// and allocates bigger ones, like the result of std::bind with a member function pointer, on the heap instead. Other standard libraries use bigger std::function instances,
+// the microbenchmark prints the size of both and the duration of a call.
+// Disabled by default, because existing code might pass lambdas that capture more state than that.
+#  ifndef THINGSBOARD_ENABLE_INLINE_DELEGATE
+#    define THINGSBOARD_ENABLE_INLINE_DELEGATE 0
+#  endif
+
+// Accounts every allocation made by the library to the part of the library it was made for (received documents, send buffers, rpc responses, callbacks, ota and timers),
+// and tracks their current and peak usage, which can be queried with the getMemoryStats method of the ThingsBoard class. Allows to right-size the buffer sizes, MaxResponse and the maximum stack size from real data.
+// Disabled by default, because every allocation requires a small additional header and accounting it costs some performance.
+#  ifndef THINGSBOARD_ENABLE_MEMORY_STATS
+#    define THINGSBOARD_ENABLE_MEMORY_STATS 0
+#  endif
+
 // Use advanced STL features if they are supported by the compiler (std::ranges::view, template constraints and concepts).
 // Currently only the case for ESP IDF when using a major version following 5 and when using Arduino following a major version 3.
 // Allows to improve performance significantly, because to filter arrays or vectors we do not have to make copies of them anymore.
@@ -114,6 +133,20 @@
 #    endif
 #  endif
 
+// Use the POSIX socket headers internally for handling the sending and receiving of MQTT data, as long as the headers exist and neither Arduino nor Espressif IDF is used,
+// to allow users running natively on Linux or other POSIX systems to use the POSIX_MQTT_Client, for example on edge gateways or to measure the throughput against a local broker on a workstation.
+#  ifndef THINGSBOARD_USE_POSIX_SOCKETS
+#    ifdef __has_include
+#      if !defined(ARDUINO) && !defined(ESP_PLATFORM) && __has_include(<sys/socket.h>) && __has_include(<netdb.h>) && __has_include(<poll.h>)
+#        define THINGSBOARD_USE_POSIX_SOCKETS 1
+#      else
+#        define THINGSBOARD_USE_POSIX_SOCKETS 0
+#      endif
+#    else
+#      define THINGSBOARD_USE_POSIX_SOCKETS 0
+#    endif
+#  endif
+
 // Enables the ThingsBoard class to be fully dynamic instead of requiring template arguments to statically allocate memory.
 // If enabled the program might be slightly slower and all the memory will be placed onto the heap instead of the stack.
 // See https://arduinojson.org/v6/api/dynamicjsondocument/ for the main difference in the underlying code.
@@ -3,6 +3,7 @@
 
 // Local includes.
 #include "Configuration.h"
+#include "Allocator_Policy.h"
 
 // Library includes.
 #if THINGSBOARD_ENABLE_PSRAM || THINGSBOARD_ENABLE_DYNAMIC
@@ -15,6 +16,12 @@
 #define Default_Attributes_Amount 1
 #define Default_RPC_Amount 0
 #define Default_Request_RPC_Amount 2
+// Full OTA chunk window (MAX_CHUNK_WINDOW_SIZE, 8), RPC sweep, spool drain, coalescing flush, client-side RPC (Default_Request_RPC_Amount, 2), attribute request and provisioning timeouts, rounded up
+#define Default_Timers_Amount 16
+#define Default_Spool_Drain_Interval 250000
+#define Default_Coalescing_Window 0
+#define Default_Pending_RPC_Amount 2
+#define Default_Pending_RPC_Timeout 10000000
 #define Default_Payload_Size 64
 #define Default_Max_Stack_Size 1024
 #if THINGSBOARD_ENABLE_STREAM_UTILS
@@ -22,6 +29,8 @@
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
 #if THINGSBOARD_ENABLE_DYNAMIC
 #define Default_Max_Response_Size 0
+#define Default_Max_Receive_Arena_Size 0
+#define Default_Receive_Arena_Shrink_Interval 0
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 
 
@@ -33,6 +42,7 @@ char constexpr UNABLE_TO_SERIALIZE[] = "Unable to serialize key-value json";
 char constexpr CONNECT_FAILED[] = "Connecting to server failed";
 char constexpr UNABLE_TO_SERIALIZE_JSON[] = "Unable to serialize json data";
 char constexpr UNABLE_TO_ALLOCATE_JSON[] = "Allocating memory for the JsonDocument failed, passed JsonDocument is NULL";
+char constexpr UNABLE_TO_ALLOCATE_MEMORY[] = "Allocating (%u) bytes for the internal send buffer failed, increase the memory of the installed allocator";
 char constexpr JSON_SIZE_TO_SMALL[] = "JsonDocument too small to store all values. Ensure every key value pair gets JSON_OBJECT_SIZE(1) capacity + size required by value / key that is inserted";
 
 
@@ -52,10 +62,42 @@ struct SpiRamAllocator {
     return heap_caps_realloc(ptr, new_size, MALLOC_CAP_SPIRAM);
   }
 };
+#endif // THINGSBOARD_ENABLE_PSRAM
 
-using TBJsonDocument = BasicJsonDocument<SpiRamAllocator>;
-#elif THINGSBOARD_ENABLE_DYNAMIC
-using TBJsonDocument = DynamicJsonDocument;
-#endif
+#if THINGSBOARD_ENABLE_PSRAM || THINGSBOARD_ENABLE_DYNAMIC
+/// @brief Allocator for the JsonDocument instances allocated on the heap, that allocates their memory with the Allocator_Policy.
+/// If no allocator has been installed and THINGSBOARD_ENABLE_PSRAM is set, the memory is placed onto psram instead, like before the Allocator_Policy existed
+struct Json_Policy_Allocator {
+  void* allocate(size_t size) {
+#if THINGSBOARD_ENABLE_PSRAM
+    if (Allocator_Policy::Get_Allocator() == nullptr) {
+      return SpiRamAllocator().allocate(size);
+    }
+#endif // THINGSBOARD_ENABLE_PSRAM
+    return Allocator_Policy::allocate(size);
+  }
+
+  void deallocate(void* pointer) {
+#if THINGSBOARD_ENABLE_PSRAM
+    if (Allocator_Policy::Get_Allocator() == nullptr) {
+      SpiRamAllocator().deallocate(pointer);
+      return;
+    }
+#endif // THINGSBOARD_ENABLE_PSRAM
+    Allocator_Policy::deallocate(pointer);
+  }
+
+  void* reallocate(void* ptr, size_t new_size) {
+#if THINGSBOARD_ENABLE_PSRAM
+    if (Allocator_Policy::Get_Allocator() == nullptr) {
+      return SpiRamAllocator().reallocate(ptr, new_size);
+    }
+#endif // THINGSBOARD_ENABLE_PSRAM
+    return Allocator_Policy::reallocate(ptr, new_size);
+  }
+};
+
+using TBJsonDocument = BasicJsonDocument<Json_Policy_Allocator>;
+#endif // THINGSBOARD_ENABLE_PSRAM || THINGSBOARD_ENABLE_DYNAMIC
 
 #endif // Constants_h
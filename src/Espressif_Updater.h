@@ -57,6 +57,38 @@ class Espressif_Updater : public IUpdater {
         return true;
     }
 
+#if (ESP_IDF_VERSION_MAJOR == 5 && ESP_IDF_VERSION_MINOR >= 5) || ESP_IDF_VERSION_MAJOR > 5
+    bool resume(size_t const & firmware_size, size_t const & offset) override {
+        esp_partition_t const * running = esp_ota_get_running_partition();
+        esp_partition_t const * configured = esp_ota_get_boot_partition();
+
+        if (configured != running) {
+            Logger::printfln(INVALID_OTA_PARTIION);
+            return false;
+        }
+
+        esp_partition_t const * update_partition = esp_ota_get_next_update_partition(nullptr);
+
+        if (update_partition == nullptr) {
+            Logger::printfln(MISSING_OTA_APP);
+            return false;
+        }
+
+        // Only erases the remaining part of the partition after the given offset, the data before it is kept as is and further writes continue directly after it
+        esp_ota_handle_t ota_handle;
+        esp_err_t const error = esp_ota_resume(update_partition, firmware_size, offset, &ota_handle);
+
+        if (error != ESP_OK) {
+            Logger::printfln(BEGIN_UPDATE_FAILED, esp_err_to_name(error));
+            return false;
+        }
+
+        m_ota_handle = ota_handle;
+        m_update_partition = update_partition;
+        return true;
+    }
+#endif // (ESP_IDF_VERSION_MAJOR == 5 && ESP_IDF_VERSION_MINOR >= 5) || ESP_IDF_VERSION_MAJOR > 5
+
     size_t write(uint8_t * payload, size_t const & total_bytes) override {
         esp_err_t const error = esp_ota_write(m_ota_handle, payload, total_bytes);
         size_t const written_bytes = (error == ESP_OK) ? total_bytes : 0U;
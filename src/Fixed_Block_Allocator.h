@@ -0,0 +1,88 @@
+#ifndef Fixed_Block_Allocator_h
+#define Fixed_Block_Allocator_h
+
+// Local include.
+#include "IAllocator.h"
+
+
+uint16_t constexpr FIXED_BLOCK_INVALID_INDEX = UINT16_MAX;
+
+
+/// @brief Allocator that splits a buffer owned by the instance itself into a fixed amount of blocks with the same size.
+/// Allocating and freeing is O(1), because unused blocks are linked into a list, and the memory never fragments, because every allocation uses exactly one block.
+/// Allocations bigger than a single block fail, therefore the block size has to be atleast as big as the biggest allocation made by the library,
+/// which is mostly the send buffer, the biggest received JsonDocument or the largest container used
+/// @tparam BlockSize Amount of bytes every block can hold, rounded up to the alignment of any type
+/// @tparam BlockAmount Amount of blocks, therefore the maximum amount of allocations that can exist at the same time
+template <size_t BlockSize, size_t BlockAmount>
+class Fixed_Block_Allocator : public IAllocator {
+  public:
+    static_assert(BlockSize > 0U, "Blocks have to be able to hold atleast one byte");
+    static_assert(BlockAmount > 0U && BlockAmount < FIXED_BLOCK_INVALID_INDEX, "Block amount has to be atleast one and smaller than FIXED_BLOCK_INVALID_INDEX");
+
+    /// @brief Amount of bytes between the start of two blocks
+    static size_t constexpr BLOCK_STRIDE = (BlockSize + alignof(::max_align_t) - 1U) / alignof(::max_align_t) * alignof(::max_align_t);
+
+    /// @brief Constructor
+    Fixed_Block_Allocator()
+      : m_blocks()
+      , m_next_free()
+      , m_first_free(0U)
+      , m_used(0U)
+    {
+        for (size_t i = 0U; i < BlockAmount; ++i) {
+            m_next_free[i] = i + 1U < BlockAmount ? i + 1U : FIXED_BLOCK_INVALID_INDEX;
+        }
+    }
+
+    /// @brief Gets the amount of blocks that are currently allocated
+    /// @return Amount of allocated blocks
+    size_t used() const {
+        return m_used;
+    }
+
+    /// @brief Gets the amount of blocks that can still be allocated
+    /// @return Amount of unused blocks
+    size_t available() const {
+        return BlockAmount - m_used;
+    }
+
+    void * allocate(size_t size) override {
+        if (size > BlockSize || m_first_free == FIXED_BLOCK_INVALID_INDEX) {
+            return nullptr;
+        }
+        uint16_t const block = m_first_free;
+        m_first_free = m_next_free[block];
+        m_used++;
+        return m_blocks + block * BLOCK_STRIDE;
+    }
+
+    void deallocate(void * pointer) override {
+        if (pointer == nullptr) {
+            return;
+        }
+        uint16_t const block = (static_cast<uint8_t *>(pointer) - m_blocks) / BLOCK_STRIDE;
+        m_next_free[block] = m_first_free;
+        m_first_free = block;
+        m_used--;
+    }
+
+    void * reallocate(void * pointer, size_t size) override {
+        if (pointer == nullptr) {
+            return allocate(size);
+        }
+        // Every block already has the maximum size, therefore resizing either keeps the same block or fails
+        return size <= BlockSize ? pointer : nullptr;
+    }
+
+  private:
+    alignas(::max_align_t) uint8_t m_blocks[BLOCK_STRIDE * BlockAmount]; // Buffer all blocks are placed in
+    uint16_t                       m_next_free[BlockAmount];              // Next unused block for every unused block, forms the list of unused blocks
+    uint16_t                       m_first_free = {};                     // First unused block or FIXED_BLOCK_INVALID_INDEX if all blocks are used
+    size_t                         m_used = {};                           // Amount of currently allocated blocks
+};
+
+template <size_t BlockSize, size_t BlockAmount>
+size_t constexpr Fixed_Block_Allocator<BlockSize, BlockAmount>::BLOCK_STRIDE;
+
+#endif // Fixed_Block_Allocator_h
@@ -3,6 +3,7 @@
 
 // Library include.
 #include <stdio.h>
+#include <string.h>
 
 HashGenerator::~HashGenerator(void) {
     free();
@@ -12,6 +13,7 @@ bool HashGenerator::start(mbedtls_md_type_t const & type) {
     // Clear the internal structure of any previous attempt, because if we do not the init function will not work correctly
     free();
     m_size = mbedtls_type_to_size(type);
+    m_type = type;
     // Initialize the context
     mbedtls_md_init(&m_ctx);
     // Choose the hash function
@@ -38,6 +40,34 @@ bool HashGenerator::finish(char * hash_string) {
     return success;
 }
 
+size_t HashGenerator::save_state(uint8_t * buffer, size_t const & buffer_size) const {
+    size_t const context_size = mbedtls_type_to_context_size(m_type);
+#if MBEDTLS_VERSION_MAJOR < 3
+    void const * context = m_ctx.md_ctx;
+#else
+    void const * context = m_ctx.MBEDTLS_PRIVATE(md_ctx);
+#endif
+    if (buffer == nullptr || context == nullptr || context_size == 0U || buffer_size < context_size) {
+        return 0U;
+    }
+    (void)memcpy(buffer, context, context_size);
+    return context_size;
+}
+
+bool HashGenerator::restore_state(uint8_t const * buffer, size_t const & buffer_size) {
+    size_t const context_size = mbedtls_type_to_context_size(m_type);
+#if MBEDTLS_VERSION_MAJOR < 3
+    void * context = m_ctx.md_ctx;
+#else
+    void * context = m_ctx.MBEDTLS_PRIVATE(md_ctx);
+#endif
+    if (buffer == nullptr || context == nullptr || context_size == 0U || buffer_size != context_size) {
+        return false;
+    }
+    (void)memcpy(context, buffer, context_size);
+    return true;
+}
+
 void HashGenerator::free() {
     // MBEDTLS Version 3 is a major breaking changes were accessing the internal structures requires the MBEDTLS_PRIVATE macro
 #if MBEDTLS_VERSION_MAJOR < 3
@@ -84,3 +114,30 @@ size_t HashGenerator::mbedtls_type_to_size(mbedtls_md_type_t const & type) {
             return 0U;
     }
 }
+
+size_t HashGenerator::mbedtls_type_to_context_size(mbedtls_md_type_t const & type) {
+    // Alternative implementations (MBEDTLS_*_ALT), like the hardware accelerated SHA of the ESP32, may keep parts of the intermediate state outside of the context,
+    // copying the context would therefore silently result in a wrong hash after restoring it, so saving and restoring the state is not supported for them
+    switch (type) {
+#ifndef MBEDTLS_MD5_ALT
+        case mbedtls_md_type_t::MBEDTLS_MD_MD5:
+            return sizeof(mbedtls_md5_context);
+#endif // MBEDTLS_MD5_ALT
+#ifndef MBEDTLS_SHA1_ALT
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA1:
+            return sizeof(mbedtls_sha1_context);
+#endif // MBEDTLS_SHA1_ALT
+#ifndef MBEDTLS_SHA256_ALT
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA224: // Fallthrough same behaviour
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA256:
+            return sizeof(mbedtls_sha256_context);
+#endif // MBEDTLS_SHA256_ALT
+#ifndef MBEDTLS_SHA512_ALT
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA384: // Fallthrough same behaviour
+        case mbedtls_md_type_t::MBEDTLS_MD_SHA512:
+            return sizeof(mbedtls_sha512_context);
+#endif // MBEDTLS_SHA512_ALT
+        default:
+            return 0U;
+    }
+}
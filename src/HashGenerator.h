@@ -7,6 +7,10 @@
 // Library includes.
 #if THINGSBOARD_USE_MBED_TLS
 #include <mbedtls/md.h>
+#include <mbedtls/md5.h>
+#include <mbedtls/sha1.h>
+#include <mbedtls/sha256.h>
+#include <mbedtls/sha512.h>
 #else
 #include <Seeed_mbedtls.h>
 #endif // THINGSBOARD_USE_MBED_TLS
@@ -14,6 +18,13 @@
 #include <stddef.h>
 
 
+// Maximum size consists of size required for byte representation of the hash * 2 because every byte is 2 hex characters + 1 for null termination
+size_t constexpr FIRMWARE_HASH_SIZE = (MBEDTLS_MD_MAX_SIZE * 2U) + 1;
+// Maximum size of the internal state of any hash calculation that supports saving and restoring its state,
+// the sha512 context is the biggest, because it keeps its intermediate state in 64-bit words and processes blocks of 128 bytes
+size_t constexpr MAX_HASH_STATE_SIZE = sizeof(mbedtls_sha512_context);
+
+
 /// @brief Wrapper class which allows generating a hash of the given type from any arbitrary byte payload, which is hashable in chunks.
 /// The class wraps around either the Arduino Seeed mbedtls library from Seed Studio (https://github.com/Seeed-Studio/Seeed_Arduino_mbedtls) or the offical ESP Mbed TLS implementation from Mbed TLS (https://github.com/Mbed-TLS/mbedtls), the latter takes precendence if it exists.
 /// This is done because it removes the need to include another library, because the component already exists on the system and we can therefore simply utilize that one.
@@ -50,6 +61,22 @@ class HashGenerator {
     /// @return Whether stopping and caculating the final hash for the given bytes was successful or not
     bool finish(char * hash_string);
 
+    /// @brief Copies the internal state of the currently ongoing hash calculation into the given buffer, allows to continue the calculation later on with restore_state(),
+    /// even if the device has been restarted in the meantime. Only works for the MD5, SHA1 and SHA2 family of hashes and only if the underlying implementation
+    /// keeps the complete intermediate state inside of its context. Alternative implementations enabled with MBEDTLS_MD5_ALT, MBEDTLS_SHA1_ALT, MBEDTLS_SHA256_ALT or MBEDTLS_SHA512_ALT,
+    /// like the hardware accelerated SHA of the ESP32, do not guarantee that and are therefore not supported, meaning a checkpointed OTA update restarts the hash from the first chunk instead
+    /// @param buffer Output buffer the internal state will be copied into, should be able to hold at least MAX_HASH_STATE_SIZE bytes
+    /// @param buffer_size Size of the given output buffer
+    /// @return Amount of bytes copied into the given buffer, 0 if no hash calculation has been started, the type is not supported or the buffer was too small
+    size_t save_state(uint8_t * buffer, size_t const & buffer_size) const;
+
+    /// @brief Overwrites the internal state of the hash calculation with a state previously copied with save_state(),
+    /// start() has to be called beforehand with the same type the state was originally created with
+    /// @param buffer Buffer containing the internal state previously returned by save_state()
+    /// @param buffer_size Amount of bytes previously returned by save_state()
+    /// @return Whether restoring the internal state was successful or not, false if the type is not supported, see save_state() for the supported types
+    bool restore_state(uint8_t const * buffer, size_t const & buffer_size);
+
   private:
     /// @brief Frees all internally allocated memory to ensure no memory leak occurs, additionally check if a hash calculation was ever started,
     /// before freeing, because freeing without having started a hash calculation causes a crash.
@@ -62,7 +89,13 @@ class HashGenerator {
     /// @return Amount of bytes needed to be allocated by the buffer that will hold the final hash that is then transformed into a string
     size_t mbedtls_type_to_size(mbedtls_md_type_t const & type);
 
+    /// @brief Calculates the amount of bytes of the internal context of the given hash type, which contains the complete intermediate state of the hash calculation
+    /// @param type Supported type of hash that should be generated from this class
+    /// @return Amount of bytes of the internal context, 0 if saving and restoring the state of the given type is not supported, because it is unknown or uses an alternative implementation
+    static size_t mbedtls_type_to_context_size(mbedtls_md_type_t const & type);
+
     size_t               m_size = {}; // Actual size in bytes, depend on the mbedtls_md_type_t given in the start method
+    mbedtls_md_type_t    m_type = {}; // Type of hash that is currently calculated, given in the start method
     mbedtls_md_context_t m_ctx = {};  // Context used to access the already written bytes and update them latter
 };
 
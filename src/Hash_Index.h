@@ -0,0 +1,172 @@
+#ifndef Hash_Index_h
+#define Hash_Index_h
+
+// Local includes.
+#include "Callback.h"
+
+
+uint16_t constexpr HASH_INDEX_EMPTY_SLOT = UINT16_MAX;
+uint8_t constexpr HASH_INDEX_MAX_SEED_ATTEMPTS = 16U;
+uint32_t constexpr HASH_INDEX_MULTIPLIER = 0x9E3779B1U;
+
+
+/// @brief Calculates the amount of slots a Hash_Index requires for the given amount of entries,
+/// which is the smallest power of two that is atleast double the amount of entries, to keep the table atmost half full
+/// @param entries Maximum amount of entries that should be indexed
+/// @param slots Amount of slots that is checked, used for the recursion and should not be passed
+/// @return Amount of slots required
+constexpr size_t Get_Hash_Index_Slot_Amount(size_t entries, size_t slots = 2U) {
+    return slots >= 2U * entries ? slots : Get_Hash_Index_Slot_Amount(entries, slots * 2U);
+}
+
+
+/// @brief Slot of the Hash_Index, contains the full hash of the indexed entry, so that entries with a different hash can be skipped without comparing the entry itself
+struct Hash_Index_Slot {
+    uint32_t hash = {};                      // Hash of the entry this slot points to
+    uint16_t index = HASH_INDEX_EMPTY_SLOT;  // Position of the entry in the container that is indexed or HASH_INDEX_EMPTY_SLOT if the slot is unused
+};
+
+
+/// @brief Open addressed hash table, that maps the hash of an entry to the position of that entry in a seperate container, to replace linear searches through that container.
+/// The table is rebuilt completely whenever the indexed container changes, which is expected to be rare compared to the amount of lookups.
+/// When rebuilding, multiple seeds for the mapping of hashes to slots are tried and the seed that causes the least collisions is kept,
+/// meaning if there is a seed without any collisions, every lookup only ever checks a single slot (perfect hashing)
+#if THINGSBOARD_ENABLE_DYNAMIC
+class Hash_Index {
+#else
+/// @tparam MaxEntries Maximum amount of entries that can be indexed, the amount of slots is calculated from it at compile time.
+/// Once the maximum amount has been reached it is not possible to increase the size, this is done because it allows to allcoate the memory on the stack instead of the heap
+template<size_t MaxEntries>
+class Hash_Index {
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+  public:
+    /// @brief Constructor
+    Hash_Index()
+      : m_slots()
+      , m_seed(0U)
+      , m_shift(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Rebuilds the table for the given amount of entries, replacing all previously indexed entries
+    /// @tparam HashFunction Function that receives the position of an entry and returns its hash, is called multiple times for each entry
+    /// @param count Amount of entries that should be indexed, positions 0 up to count - 1 are passed to the hash function
+    /// @param get_hash Function that returns the hash of the entry at the given position
+    /// @return Whether rebuilding was successful or not, fails if the given amount exceeds the maximum amount of entries
+    template<typename HashFunction>
+    bool rebuild(size_t const & count, HashFunction get_hash) {
+        clear();
+        if (count == 0U) {
+            return true;
+        }
+#if THINGSBOARD_ENABLE_DYNAMIC
+        size_t const slot_amount = Get_Hash_Index_Slot_Amount(count);
+#else
+        if (count > MaxEntries) {
+            return false;
+        }
+        size_t constexpr slot_amount = Get_Hash_Index_Slot_Amount(MaxEntries);
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+        for (size_t i = 0U; i < slot_amount; ++i) {
+            m_slots.push_back(Hash_Index_Slot());
+        }
+        m_shift = 32U;
+        for (size_t slots = slot_amount; slots > 1U; slots >>= 1U) {
+            m_shift--;
+        }
+
+        uint32_t best_seed = 0U;
+        size_t best_displacement = SIZE_MAX;
+        for (uint32_t seed = 0U; seed < HASH_INDEX_MAX_SEED_ATTEMPTS && best_displacement != 0U; ++seed) {
+            size_t const displacement = fill(seed, count, get_hash);
+            if (displacement < best_displacement) {
+                best_displacement = displacement;
+                best_seed = seed;
+            }
+        }
+        if (m_seed != best_seed) {
+            (void)fill(best_seed, count, get_hash);
+        }
+        return true;
+    }
+
+    /// @brief Searches the entry with the given hash, that additionally fulfills the given predicate
+    /// @tparam Predicate Function that receives the position of an entry with the same hash and returns whether it is actually the searched entry, used to resolve hash collisions
+    /// @param hash Hash of the searched entry
+    /// @param matches Function that compares the entry at the given position with the searched entry
+    /// @return Position of the first inserted matching entry or HASH_INDEX_EMPTY_SLOT if there is none
+    template<typename Predicate>
+    uint16_t find(uint32_t const & hash, Predicate matches) const {
+        size_t const slot_amount = m_slots.size();
+        if (slot_amount == 0U) {
+            return HASH_INDEX_EMPTY_SLOT;
+        }
+        size_t position = get_slot(hash, m_seed);
+        for (size_t i = 0U; i < slot_amount; ++i) {
+            Hash_Index_Slot const & slot = m_slots[position];
+            if (slot.index == HASH_INDEX_EMPTY_SLOT) {
+                break;
+            }
+            else if (slot.hash == hash && matches(slot.index)) {
+                return slot.index;
+            }
+            position = (position + 1U) & (slot_amount - 1U);
+        }
+        return HASH_INDEX_EMPTY_SLOT;
+    }
+
+    /// @brief Removes all indexed entries
+    void clear() {
+        m_slots.clear();
+        m_seed = 0U;
+        m_shift = 0U;
+    }
+
+  private:
+    /// @brief Calculates the first slot an entry with the given hash is placed into, by multiplying the seeded hash with a constant
+    /// and using the highest bits of the result, which depend on all bits of the hash (Fibonacci hashing)
+    /// @param hash Hash of the entry
+    /// @param seed Seed that changes the mapping of hashes to slots
+    /// @return Position of the slot the entry is placed into, if it is not used yet
+    size_t get_slot(uint32_t const & hash, uint32_t const & seed) const {
+        return static_cast<uint32_t>((hash ^ (seed * HASH_INDEX_MULTIPLIER)) * HASH_INDEX_MULTIPLIER) >> m_shift;
+    }
+
+    /// @brief Empties all slots and inserts all entries with the given seed, colliding entries are placed into the next unused slot (linear probing)
+    /// @tparam HashFunction Function that receives the position of an entry and returns its hash
+    /// @param seed Seed that changes the mapping of hashes to slots
+    /// @param count Amount of entries that should be inserted
+    /// @param get_hash Function that returns the hash of the entry at the given position
+    /// @return Combined amount of slots all entries had to skip, because they were already used, 0 if there was not a single collision
+    template<typename HashFunction>
+    size_t fill(uint32_t const & seed, size_t const & count, HashFunction & get_hash) {
+        size_t const slot_amount = m_slots.size();
+        for (size_t i = 0U; i < slot_amount; ++i) {
+            m_slots[i] = Hash_Index_Slot();
+        }
+        m_seed = seed;
+        size_t displacement = 0U;
+        for (size_t i = 0U; i < count; ++i) {
+            uint32_t const hash = get_hash(i);
+            size_t position = get_slot(hash, seed);
+            while (m_slots[position].index != HASH_INDEX_EMPTY_SLOT) {
+                position = (position + 1U) & (slot_amount - 1U);
+                displacement++;
+            }
+            m_slots[position].hash = hash;
+            m_slots[position].index = i;
+        }
+        return displacement;
+    }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Hash_Index_Slot>                                            m_slots = {}; // Slots of the table, the amount is always a power of two
+#else
+    Array<Hash_Index_Slot, Get_Hash_Index_Slot_Amount(MaxEntries)>     m_slots = {}; // Slots of the table, the amount is always a power of two
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    uint32_t                                                           m_seed = {};  // Seed that causes the least collisions for the currently indexed entries
+    uint8_t                                                            m_shift = {}; // Amount of bits the multiplied hash is shifted, so that only the bits required to address all slots remain
+};
+
+#endif // Hash_Index_h
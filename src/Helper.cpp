@@ -7,6 +7,11 @@
 // Library includes.
 #include <string.h>
 
+
+uint32_t constexpr FNV_OFFSET_BASIS = 2166136261U;
+uint32_t constexpr FNV_PRIME = 16777619U;
+
+
 size_t Helper::getOccurences(uint8_t const * bytes, char symbol, unsigned int length) {
     size_t count = 0;
     if (bytes == nullptr) {
@@ -20,6 +25,126 @@ size_t Helper::getOccurences(uint8_t const * bytes, char symbol, unsigned int le
     return count;
 }
 
+size_t Helper::getJsonNodeCount(uint8_t const * bytes, unsigned int length) {
+    size_t count = 0;
+    if (bytes == nullptr) {
+        return count;
+    }
+
+    // Word that is read at once, each byte of it is compared against the searched symbols in parallel (SWAR)
+    using word = uintptr_t;
+    word constexpr ONES = ~static_cast<word>(0U) / 0xFFU;
+    word constexpr LOW_BITS = ONES * 0x7FU;
+    size_t constexpr WORD_SIZE = sizeof(word);
+    // Reads the next word so that the first byte of the payload is always in the lowest byte of the word independent of the endianness of the device,
+    // copied instead of cast, because the payload is not necessarily aligned and not all devices support unaligned reads (ESP8266)
+    auto const read_word = [](uint8_t const * position) -> word {
+        word value = 0U;
+#if defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        for (size_t i = WORD_SIZE; i > 0U; --i) {
+            value = (value << 8U) | position[i - 1U];
+        }
+#else
+        memcpy(&value, position, WORD_SIZE);
+#endif // defined(__BYTE_ORDER__) && __BYTE_ORDER__ == __ORDER_BIG_ENDIAN__
+        return value;
+    };
+    // Sets the highest bit of each byte that equals the given symbol and clears all other bits,
+    // the lower bits of each byte are checked with an addition that can never overflow into the next byte, which ensures there are no false positives
+    auto const find_symbol = [](word const & value, uint8_t const & symbol) -> word {
+        word const difference = value ^ (ONES * symbol);
+        return ~(((difference & LOW_BITS) + LOW_BITS) | difference | LOW_BITS);
+    };
+    // Because every byte contains at most the highest bit, the multiplication sums all of them up into the highest byte, without overflowing it
+    auto const count_symbols = [](word const & matches) -> size_t {
+        return ((matches >> 7U) * ONES) >> ((WORD_SIZE - 1U) * 8U);
+    };
+    // Mask of all bits up to and including the given single bit, wraps around to all bits if the given bit is the highest bit of the word
+    auto const bits_up_to = [](word const & bit) -> word {
+        return (bit << 1U) - 1U;
+    };
+
+    bool in_string = false;
+    bool escaped = false;
+    size_t index = 0U;
+    for (; index + WORD_SIZE <= length; index += WORD_SIZE) {
+        word const value = read_word(bytes + index);
+        word const symbols = find_symbol(value, ',') | find_symbol(value, '{') | find_symbol(value, '[');
+        word const quotes = find_symbol(value, '"');
+        word const backslashes = find_symbol(value, '\\');
+        // Highest bit of every byte in the word that has not been processed yet
+        word remaining = ~LOW_BITS;
+        if (escaped) {
+            escaped = false;
+            remaining &= ~static_cast<word>(0xFFU);
+        }
+
+        // Jumps from one start or end of a string to the next inside of the word, instead of processing each byte on its own
+        while (remaining != 0U) {
+            if (!in_string) {
+                word const quote = quotes & remaining;
+                if (quote == 0U) {
+                    count += count_symbols(symbols & remaining);
+                    break;
+                }
+                word const first = quote & (~quote + 1U);
+                count += count_symbols(symbols & remaining & (first - 1U));
+                remaining &= ~bits_up_to(first);
+                in_string = true;
+                continue;
+            }
+
+            word const special = (quotes | backslashes) & remaining;
+            if (special == 0U) {
+                break;
+            }
+            word const first = special & (~special + 1U);
+            remaining &= ~bits_up_to(first);
+            if ((first & quotes) != 0U) {
+                in_string = false;
+                continue;
+            }
+            // Skip the character following the backslash, because it is escaped, if that character is in the next word we skip it there instead
+            word const next = first << 8U;
+            if (next == 0U) {
+                escaped = true;
+                break;
+            }
+            remaining &= ~bits_up_to(next);
+        }
+    }
+
+    for (; index < length; ++index) {
+        uint8_t const byte = bytes[index];
+        if (escaped) {
+            escaped = false;
+        }
+        else if (in_string) {
+            in_string = byte != '"';
+            escaped = byte == '\\';
+        }
+        else if (byte == '"') {
+            in_string = true;
+        }
+        else if (byte == ',' || byte == '{' || byte == '[') {
+            count++;
+        }
+    }
+    return count;
+}
+
+uint32_t Helper::getHashValue(char const * str) {
+    uint32_t hash = FNV_OFFSET_BASIS;
+    if (str == nullptr) {
+        return hash;
+    }
+    for (; *str != '\0'; ++str) {
+        hash ^= static_cast<uint8_t>(*str);
+        hash *= FNV_PRIME;
+    }
+    return hash;
+}
+
 bool Helper::stringIsNullorEmpty(char const * str) {
     return str == nullptr || str[0] == '\0';
 }
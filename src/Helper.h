@@ -40,6 +40,20 @@ class Helper {
     /// @return Amount of occurences of the given symbol
     static size_t getOccurences(uint8_t const * bytes, char symbol, unsigned int length);
 
+    /// @brief Returns an upper bound of the amount of json nodes the given json payload contains, by counting the occurences of all ',' '{' and '[' symbols that are not inside of a string.
+    /// Every comma denotes the end of a key-value pair besides for the last element in an array or in an object, which is instead accounted for by the opening bracket of that array or object.
+    /// Compared to calling getOccurences once for each symbol, the payload is only read once and a full machine word at the time, as long as the word does not contain the start or the end of a string
+    /// @param bytes Byte payload containing the json that we want to count the nodes of
+    /// @param length Length of the byte payload, ensure to never pass a length that is longer than the actualy payload, because this will cause this method to read outside of the bounds of the buffer
+    /// @return Upper bound of the amount of json nodes, can be used to calculate the size of the JsonDocument required to deserialize the payload
+    static size_t getJsonNodeCount(uint8_t const * bytes, unsigned int length);
+
+    /// @brief Returns the 32-bit FNV-1a hash of the given string, which is fast to calculate for short strings like method names or keys
+    /// and distributes them well enough to be used as the key of an in-memory hash table. See http://www.isthe.com/chongo/tech/comp/fnv/ for more information
+    /// @param str String that we want to calculate the hash of, if it is a nullptr the hash of an empty string is returned
+    /// @return Hash of the given string
+    static uint32_t getHashValue(char const * str);
+
     /// @brief Returns wheter the given string is either a nullptr or is an empty string,
     /// meaning it only contains a null terminator and no other characters
     /// @param str String that we want to check for emptiness
@@ -0,0 +1,123 @@
+#ifndef IAPI_Client_Context_h
+#define IAPI_Client_Context_h
+
+// Local include.
+#include "Configuration.h"
+#include "Timer_Wheel.h"
+
+// Library include.
+#include <ArduinoJson.h>
+
+
+class IAPI_Implementation;
+
+
+/// @brief Functionality of the ThingsBoard client that API implementations require to communicate with the cloud.
+/// Passed to every API implementation once as a single non-owning reference, instead of a seperate callback for every method,
+/// which would require one Callback instance per method in every API implementation, each holding a copy of the bound client pointer
+class IAPI_Client_Context {
+  public:
+    /// @brief Subscribes additional API implementations, used by API implementations that consist of multiple other API implementations (OTA)
+    /// @param api Additional API implementation that should be handled, has to be kept alive for as long as the client
+    virtual void Subscribe_API_Implementation(IAPI_Implementation & api) = 0;
+
+    /// @brief Sends the given json document over the given topic
+    /// @param topic Topic the data should be sent over
+    /// @param source JsonDocument containing the data that should be sent
+    /// @param json_size Size of the serialized json document, calculated with Helper::Measure_Json
+    /// @return Whether sending the data was successful or not
+    virtual bool Send_Json(char const * topic, JsonDocument const & source, size_t const & json_size) = 0;
+
+    /// @brief Sends the given json string over the given topic
+    /// @param topic Topic the data should be sent over
+    /// @param json String containing valid json
+    /// @return Whether sending the data was successful or not
+    virtual bool Send_Json_String(char const * topic, char const * json) = 0;
+
+    /// @brief Subscribes the given topic with the underlying MQTT client
+    /// @param topic Topic that should be subscribed
+    /// @return Whether subscribing was successful or not
+    virtual bool Subscribe_Topic(char const * topic) = 0;
+
+    /// @brief Unsubscribes the given topic with the underlying MQTT client
+    /// @param topic Topic that should be unsubscribed
+    /// @return Whether unsubscribing was successful or not
+    virtual bool Unsubscribe_Topic(char const * topic) = 0;
+
+    /// @brief Gets the current receive buffer size of the underlying MQTT client
+    /// @return Current receive buffer size
+    virtual uint16_t Get_Receive_Buffer_Size() = 0;
+
+    /// @brief Gets the current send buffer size of the underlying MQTT client
+    /// @return Current send buffer size
+    virtual uint16_t Get_Send_Buffer_Size() = 0;
+
+    /// @brief Changes the receive and send buffer size of the underlying MQTT client
+    /// @param receive_buffer_size Maximum amount of data that can be received at once
+    /// @param send_buffer_size Maximum amount of data that can be sent at once
+    /// @return Whether changing the buffer size was successful or not
+    virtual bool Set_Buffer_Size(uint16_t receive_buffer_size, uint16_t send_buffer_size) = 0;
+
+    /// @brief Gets a mutable pointer to the request id shared by all request types, the current value is the id of the last sent request
+    /// @return Mutable pointer to the request id
+    virtual size_t * Get_Request_ID() = 0;
+
+    /// @brief Gets a mutable pointer to the timer wheel shared by all requests that can timeout
+    /// @return Mutable pointer to the timer wheel
+    virtual Timer_Wheel * Get_Timer_Wheel() = 0;
+};
+
+
+/// @brief Client context every API implementation uses before it has been subscribed to a ThingsBoard client.
+/// Fails every call, the same way an unset Callback returns a default constructed value, meaning API implementations never have to check for a missing context
+class Unbound_Client_Context : public IAPI_Client_Context {
+  public:
+    /// @brief Gets the instance shared by all API implementations, the class does not have any state
+    /// @return Reference to the shared instance
+    static Unbound_Client_Context & Get_Instance() {
+        static Unbound_Client_Context instance;
+        return instance;
+    }
+
+    void Subscribe_API_Implementation(IAPI_Implementation & api) override {
+        // Nothing to do
+    }
+
+    bool Send_Json(char const * topic, JsonDocument const & source, size_t const & json_size) override {
+        return false;
+    }
+
+    bool Send_Json_String(char const * topic, char const * json) override {
+        return false;
+    }
+
+    bool Subscribe_Topic(char const * topic) override {
+        return false;
+    }
+
+    bool Unsubscribe_Topic(char const * topic) override {
+        return false;
+    }
+
+    uint16_t Get_Receive_Buffer_Size() override {
+        return 0U;
+    }
+
+    uint16_t Get_Send_Buffer_Size() override {
+        return 0U;
+    }
+
+    bool Set_Buffer_Size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        return false;
+    }
+
+    size_t * Get_Request_ID() override {
+        return nullptr;
+    }
+
+    Timer_Wheel * Get_Timer_Wheel() override {
+        return nullptr;
+    }
+};
+
+#endif // IAPI_Client_Context_h
@@ -6,6 +6,8 @@
 #include "Constants.h"
 #include "DefaultLogger.h"
 #include "API_Process_Type.h"
+#include "Timer_Wheel.h"
+#include "IAPI_Client_Context.h"
 
 // Library include.
 #if THINGSBOARD_ENABLE_STL
@@ -22,6 +24,8 @@ char constexpr MAX_SUBSCRIPTIONS_EXCEEDED[] = "Too many (%s) subscriptions, incr
 char constexpr MAX_SUBSCRIPTIONS_TEMPLATE_NAME[] = "MaxSubscriptions";
 char constexpr SUBSCRIBE_TOPIC_FAILED[] = "Subscribing the given topic (%s) failed";
 char constexpr REQUEST_ID_NULL[] = "Internal request id is NULL";
+char constexpr TIMER_WHEEL_NULL[] = "Internal timer wheel is NULL";
+char constexpr UNABLE_TO_ARM_TIMEOUT_TIMER[] = "Unable to arm timeout timer, no free timer entry left (increase MaxTimers) or allocating a new one failed";
 // RPC data keys.
 char constexpr RPC_METHOD_KEY[] = "method";
 char constexpr RPC_PARAMS_KEY[] = "params";
@@ -55,6 +59,16 @@ class IAPI_Implementation {
     /// @param data Payload sent by the server over our given topic, that contains our key value pairs
     virtual void Process_Json_Response(char const * topic, JsonDocument const & data) = 0;
 
+    /// @brief Returns the constant part every response topic this api implementation handles responses on starts with,
+    /// used to route received responses to this api implementation without having to compare the topic against every other subscribed api implementation.
+    /// Is only read once when the api implementation is subscribed, therefore the returned string has to be kept alive and may not change for as long as the api implementation is subscribed.
+    /// Received responses are additionally compared with Compare_Response_Topic, meaning the prefix only needs to narrow down the possible topics.
+    /// Defaults to an empty prefix, which routes every received response to Compare_Response_Topic of this api implementation, so implementations that do not override it keep working unchanged
+    /// @return Prefix of all response topics this api implementation handles responses on
+    virtual char const * Get_Response_Topic_Prefix() const {
+        return "";
+    }
+
     /// @brief Compares received response topic and the topic this api implementation handles responses on,
     /// messages from all other topics are ignored and only messages from topics that match are handled.
     /// For the comparsion we either compare the full expected string with the null termination, if the response topic does not include additional parameters.
@@ -73,32 +87,22 @@ class IAPI_Implementation {
     /// @return Whether resubscribing was successfull or not
     virtual bool Resubscribe_Topic() = 0;
 
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Internal loop method to update inernal timers for API calls that can timeout.
-    /// Only exists on boards that can not use the ESP Timer, because that one uses the FreeRTOS timer in the background instead
-    /// and therefore does not require calling a loop method
+    /// @brief Internal loop method that allows API implementations to do periodic work, like publishing responses that were completed outside of the receive context.
+    /// Timeouts of API calls are not handled here, but by the Timer_Wheel that is shared between all API implementations and updated by the ThingsBoard client itself
     virtual void loop() = 0;
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
-    /// @brief Method that allows to construct internal objects, after the required callback member methods have been set already.
+    /// @brief Method that allows to construct internal objects, after the client context has been set already.
     /// Required for API Implementations that subscribe further API calls, because immediately calling in the constructor can lead,
-    /// to attempted subscriptions before the m_subscribe_api_callback is actually subscribed. Therefore we have to call methods like that,
+    /// to attempted subscriptions before the client context is actually set. Therefore we have to call methods like that,
     /// in this method instead, because it ensures all member methods are instantiated already
     virtual void Initialize() = 0;
 
-    /// @brief Sets the underlying callbacks that are required for the different API Implementation to communicate with the cloud.
-    /// Directly set by the used ThingsBoard client to its internal methods, therefore calling again and overriding
+    /// @brief Sets the client context that is required for the different API Implementation to communicate with the cloud.
+    /// Directly set by the used ThingsBoard client to itself, therefore calling again and overriding
     /// as a user ist not recommended, unless you know what you are doing
-    /// @param subscribe_api_callback Method which allows to subscribe additional API endpoints, points to Subscribe_API_Implementation per default
-    /// @param send_json_callback Method which allows to send arbitrary JSON payload, points to Send_Json per default
-    /// @param send_json_string_callback Method which allows to send arbitrary JSON string payload, points to Send_Json_String per default
-    /// @param subscribe_topic_callback Method which allows to subscribe to arbitrary topics, points to m_client.subscribe per default
-    /// @param unsubscribe_topic_callback Method which allows to unsubscribe from arbitrary topics, points to m_client.unsubscribe per default
-    /// @param get_receive_size_callback Method which allows to get the current underlying receive size of the buffer, points to m_client.get_receive_buffer_size per default
-    /// @param get_send_size_callback Method which allows to get the current underlying send size of the buffer, points to m_client.get_send_buffer_size per default
-    /// @param set_buffer_size_callback Method which allows to set the current underlying size of the buffer, points to m_client.set_buffer_size per default
-    /// @param get_request_id_callback Method which allows to get the current request id as a mutable reference, points to getRequestID per default
-    virtual void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) = 0;
+    /// @param context Client context which allows to subscribe additional API endpoints, send arbitrary json payloads, subscribe and unsubscribe arbitrary topics,
+    /// change the underlying buffer size and access the request id and timer wheel shared by all API implementations. Has to be kept alive for as long as this API implementation
+    virtual void Set_Client_Context(IAPI_Client_Context & context) = 0;
 };
 
 #endif // IAPI_Implementation_h
@@ -0,0 +1,32 @@
+#ifndef IAllocator_h
+#define IAllocator_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library include.
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Allocator interface that contains the methods a class has to implement, to be used for every memory allocation made by the library.
+/// See Allocator_Policy for how to install an implementation, Fixed_Block_Allocator and Bump_Allocator for the implementations that ship with the library
+class IAllocator {
+  public:
+    /// @brief Allocates uninitialized memory with the given size, aligned for any type
+    /// @param size Amount of bytes that should be allocated
+    /// @return Pointer to the allocated memory or nullptr if there is not enough memory left
+    virtual void * allocate(size_t size) = 0;
+
+    /// @brief Frees memory previously returned by allocate or reallocate
+    /// @param pointer Pointer to the memory that should be freed, may be nullptr
+    virtual void deallocate(void * pointer) = 0;
+
+    /// @brief Changes the size of memory previously returned by allocate or reallocate, keeping its content up to the smaller of both sizes
+    /// @param pointer Pointer to the memory that should be resized, allocates new memory if it is nullptr
+    /// @param size Amount of bytes the memory should have afterwards
+    /// @return Pointer to the resized memory, which might have moved, or nullptr if there is not enough memory left, in which case the given memory is still valid
+    virtual void * reallocate(void * pointer, size_t size) = 0;
+};
+
+#endif // IAllocator_h
@@ -0,0 +1,27 @@
+#ifndef IOTA_Checkpoint_Storage_h
+#define IOTA_Checkpoint_Storage_h
+
+// Local include.
+#include "OTA_Checkpoint.h"
+
+
+/// @brief Checkpoint storage interface that contains the methods that a class has to implement, to persist the progress of an ongoing OTA firmware update.
+/// Allows to continue a download from the last saved checkpoint instead of from the first chunk, after the connection was lost or the device restarted.
+/// Is optional and only used if it has been passed to the OTA_Update_Callback with Set_Checkpoint_Storage()
+class IOTA_Checkpoint_Storage {
+  public:
+    /// @brief Saves the given checkpoint into persistent memory, overwriting any previously saved checkpoint
+    /// @param checkpoint Progress of the ongoing OTA firmware update that should be saved
+    /// @return Whether saving the checkpoint was successful or not
+    virtual bool save(OTA_Checkpoint const & checkpoint) = 0;
+
+    /// @brief Loads the previously saved checkpoint from persistent memory
+    /// @param checkpoint Variable the previously saved checkpoint will be copied into
+    /// @return Whether a checkpoint was saved previously and loading it was successful or not
+    virtual bool load(OTA_Checkpoint & checkpoint) = 0;
+
+    /// @brief Removes the previously saved checkpoint from persistent memory, called once the update has finished or has to be restarted from the first chunk
+    virtual void clear() = 0;
+};
+
+#endif // IOTA_Checkpoint_Storage_h
@@ -0,0 +1,37 @@
+#ifndef ITelemetry_Spool_h
+#define ITelemetry_Spool_h
+
+// Library include.
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Spool interface that contains the methods that a class has to implement, to store telemetry and attribute data while the device is not connected to the server.
+/// The spool acts as a first in first out queue of binary records, whose content is created and interpreted by the ThingsBoard class.
+/// Is optional and only used if it has been passed to the ThingsBoard class with setTelemetrySpool()
+class ITelemetry_Spool {
+  public:
+    /// @brief Appends the given record at the end of the spool
+    /// @param record Pointer to the first byte of the record that should be stored
+    /// @param size Amount of bytes the record consists of
+    /// @return Whether storing the record was successful or not
+    virtual bool push(uint8_t const * record, size_t const & size) = 0;
+
+    /// @brief Copies the record at the given position of the spool, without removing it.
+    /// Allows to read multiple records and only remove them once they have actually been sent to the server
+    /// @param index Position of the record that should be copied, where 0 is the oldest record in the spool
+    /// @param buffer Buffer the record should be copied into
+    /// @param buffer_size Amount of bytes the given buffer can hold, if the record is bigger it is not copied
+    /// @return Size of the record at the given position, even if it was too big to be copied or 0 if there is no record at the given position
+    virtual size_t peek(size_t const & index, uint8_t * buffer, size_t const & buffer_size) = 0;
+
+    /// @brief Removes the given amount of oldest records from the spool
+    /// @param count Amount of records that should be removed
+    virtual void pop(size_t const & count) = 0;
+
+    /// @brief Gets the amount of records that are currently stored in the spool
+    /// @return Amount of stored records
+    virtual size_t size() = 0;
+};
+
+#endif // ITelemetry_Spool_h
@@ -17,6 +17,17 @@ class IUpdater {
     /// @param firmware_size Total size of the data that should be written, is done in multiple packets
     /// @return Whether initalizing the update was successful or not
     virtual bool begin(size_t const & firmware_size) = 0;
+
+    /// @brief Continues the writing of previously interrupted data, instead of initalizing it from the start with begin.
+    /// Is only called if a checkpoint of an interrupted OTA firmware update has been saved with an IOTA_Checkpoint_Storage,
+    /// the next call to write() has to append its data directly after the given offset, any data that was written after the offset previously has to be overwritten.
+    /// Optional to implement, the default implementation does not support resuming, which results in the update being restarted from the first chunk with begin instead
+    /// @param firmware_size Total size of the data that should be written, is done in multiple packets
+    /// @param offset Amount of bytes that have already been written successfully before the interruption
+    /// @return Whether continuing the update at the given offset was successful or not
+    virtual bool resume(size_t const & firmware_size, size_t const & offset) {
+        return false;
+    }
   
     /// @brief Writes the given amount of bytes of the packet data
     /// @param payload Firmware packet data that should be written
@@ -0,0 +1,189 @@
+#ifndef Inline_Delegate_h
+#define Inline_Delegate_h
+
+// Local includes.
+#include "Configuration.h"
+
+#if THINGSBOARD_ENABLE_STL
+
+// Library includes.
+#include <cstddef>
+#include <stdint.h>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+/// @brief Default amount of bytes an Inline_Delegate can store a functor in, large enough for a member function pointer together with the object pointer it is called on,
+/// which is what std::bind(&Class::method, this, std::placeholders::_1) results in, and for lambdas capturing atmost three pointers.
+/// Together with the pointer to the operations of the stored functor, an instance is therefore four pointers big, which is the same size as std::function in libstdc++
+size_t constexpr DEFAULT_INLINE_DELEGATE_CAPACITY = 3U * sizeof(void *);
+
+
+/// @brief Primary template, only the specialization for function signatures below is defined
+template <typename Signature, size_t Capacity = DEFAULT_INLINE_DELEGATE_CAPACITY>
+class Inline_Delegate;
+
+/// @brief Callable wrapper similar to std::function, but that stores the wrapped functor inside of the instance itself instead of on the heap.
+/// Therefore creating, copying and destroying a delegate never allocates any memory, at the cost of a fixed size per instance and a compile time error,
+/// if the wrapped functor is bigger than the given capacity. The functor type is erased into a pointer to a table of functions, that cast the internal buffer back into the functor,
+/// to call it or to copy and destroy it if it is not trivially copyable. The table is shared between all delegates storing the same functor type, calling the delegate therefore
+/// requires one additional load compared to a plain function pointer, in exchange for only storing one pointer next to the functor.
+/// Can be used as the function type of the Callback class instead of std::function, by setting THINGSBOARD_ENABLE_INLINE_DELEGATE
+/// @tparam return_typ Type the wrapped functor should return
+/// @tparam argument_types Types the wrapped functor should receive
+/// @tparam Capacity Maximum amount of bytes the wrapped functor may use, default = DEFAULT_INLINE_DELEGATE_CAPACITY (3 pointers)
+template <typename return_typ, typename... argument_types, size_t Capacity>
+class Inline_Delegate<return_typ(argument_types...), Capacity> {
+  public:
+    /// @brief Constructs empty delegate, converts to false and calling it is undefined behaviour
+    Inline_Delegate()
+      : m_storage()
+      , m_operations(nullptr)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Constructs empty delegate, allows to pass nullptr wherever a delegate is expected, like it is possible with std::function
+    Inline_Delegate(std::nullptr_t)
+      : Inline_Delegate()
+    {
+        // Nothing to do
+    }
+
+    /// @brief Constructs a delegate that stores a copy of the given functor inside of its internal buffer
+    /// @tparam Functor Type of the functor, has to be callable with the argument types and may not be bigger than the capacity
+    /// @param functor Function pointer, lambda or function object that should be wrapped, nullptr function pointers result in an empty delegate
+    template <typename Functor, typename = typename std::enable_if<!std::is_same<typename std::decay<Functor>::type, Inline_Delegate>::value>::type>
+    Inline_Delegate(Functor && functor)
+      : Inline_Delegate()
+    {
+        using stored_type = typename std::decay<Functor>::type;
+        static_assert(sizeof(stored_type) <= Capacity, "Functor is too big to be stored inline, capture less state or increase the capacity of the Inline_Delegate");
+        static_assert(alignof(stored_type) <= alignof(Storage), "Functor requires a bigger alignment than the internal buffer of the Inline_Delegate provides");
+        if (Is_Null(functor)) {
+            return;
+        }
+        new (&m_storage) stored_type(std::forward<Functor>(functor));
+        m_operations = Get_Operations<stored_type>();
+    }
+
+    /// @brief Copy constructor, copies the functor stored in the given delegate
+    /// @param other Delegate whose functor should be copied
+    Inline_Delegate(Inline_Delegate const & other)
+      : Inline_Delegate()
+    {
+        Copy_From(other);
+    }
+
+    /// @brief Destructor
+    ~Inline_Delegate() {
+        Reset();
+    }
+
+    /// @brief Copy assignment operator, destroys the currently stored functor and copies the functor stored in the given delegate
+    /// @param other Delegate whose functor should be copied
+    /// @return Reference to this delegate
+    Inline_Delegate & operator=(Inline_Delegate const & other) {
+        if (this != &other) {
+            Reset();
+            Copy_From(other);
+        }
+        return *this;
+    }
+
+    /// @brief Whether a functor is stored and the delegate can therefore be called
+    /// @return Whether the delegate is not empty
+    explicit operator bool() const {
+        return m_operations != nullptr;
+    }
+
+    /// @brief Calls the stored functor with the given arguments, has to be checked to not be empty beforehand
+    /// @param ...arguments Arguments that are forwarded to the stored functor
+    /// @return Value returned by the stored functor
+    return_typ operator()(argument_types... arguments) const {
+        return m_operations->invoke(&m_storage, std::forward<argument_types>(arguments)...);
+    }
+
+  private:
+    // Aligned like a pointer instead of std::max_align_t, which would otherwise pad the instance to a multiple of 16 bytes on most 64 bit platforms
+    using Storage = typename std::aligned_storage<Capacity, alignof(void *)>::type;
+
+    enum class Operation : uint8_t {
+        COPY,
+        DESTROY
+    };
+
+    /// @brief Functions of one stored functor type
+    struct Operations {
+        return_typ (*invoke)(void const *, argument_types &&...); // Calls the functor stored in the buffer
+        void (*manage)(Operation, void *, void const *);          // Copies or destroys the functor stored in the buffer or nullptr if it is trivially copyable
+    };
+
+    /// @brief Checks whether the given functor is a nullptr function pointer, which should result in an empty delegate
+    template <typename Functor>
+    static bool Is_Null(Functor const & functor) {
+        return Is_Null_Pointer(functor, std::is_pointer<Functor>());
+    }
+
+    template <typename Functor>
+    static bool Is_Null_Pointer(Functor const & functor, std::true_type) {
+        return functor == nullptr;
+    }
+
+    template <typename Functor>
+    static bool Is_Null_Pointer(Functor const & functor, std::false_type) {
+        return false;
+    }
+
+    /// @brief Casts the given buffer back into the stored functor type and calls it, a pointer to an instantiation of this method is what erases the type of the functor
+    template <typename Functor>
+    static return_typ Invoke(void const * storage, argument_types &&... arguments) {
+        Functor & functor = *const_cast<Functor *>(static_cast<Functor const *>(storage));
+        return functor(std::forward<argument_types>(arguments)...);
+    }
+
+    /// @brief Gets the table of functions for the given functor type, which is constant initialized and therefore does not require a guard to be accessed
+    template <typename Functor>
+    static Operations const * Get_Operations() {
+        static Operations const operations = { &Invoke<Functor>, std::is_trivially_copyable<Functor>::value ? nullptr : &Manage<Functor> };
+        return &operations;
+    }
+
+    /// @brief Copies the stored functor into the given destination or destroys it, only required for functors that are not trivially copyable
+    template <typename Functor>
+    static void Manage(Operation operation, void * destination, void const * source) {
+        if (operation == Operation::COPY) {
+            new (destination) Functor(*static_cast<Functor const *>(source));
+            return;
+        }
+        static_cast<Functor *>(destination)->~Functor();
+    }
+
+    /// @brief Copies the functor of the given delegate into this delegate, which has to be empty
+    /// @param other Delegate whose functor should be copied
+    void Copy_From(Inline_Delegate const & other) {
+        if (other.m_operations != nullptr && other.m_operations->manage != nullptr) {
+            other.m_operations->manage(Operation::COPY, &m_storage, &other.m_storage);
+        }
+        else {
+            m_storage = other.m_storage;
+        }
+        m_operations = other.m_operations;
+    }
+
+    /// @brief Destroys the stored functor, which leaves the delegate empty
+    void Reset() {
+        if (m_operations != nullptr && m_operations->manage != nullptr) {
+            m_operations->manage(Operation::DESTROY, &m_storage, nullptr);
+        }
+        m_operations = nullptr;
+    }
+
+    Storage            m_storage;         // Buffer the functor is constructed in
+    Operations const * m_operations = {}; // Functions of the functor stored in the buffer or nullptr if the delegate is empty
+};
+
+#endif // THINGSBOARD_ENABLE_STL
+
+#endif // Inline_Delegate_h
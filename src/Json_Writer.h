@@ -0,0 +1,61 @@
+#ifndef Json_Writer_h
+#define Json_Writer_h
+
+// Library include.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/// @brief Output for Telemetry::WriteKeyValue() that does not write the given bytes anywhere, but instead only counts them.
+/// Allows to measure the exact size of the serialized json with the same code that writes it afterwards
+class Json_Size_Counter {
+  public:
+    /// @brief Counts the given bytes
+    /// @param buffer Bytes that would be written
+    /// @param size Amount of bytes that would be written
+    /// @return Amount of bytes that would be written
+    size_t write(uint8_t const * buffer, size_t const & size) {
+        m_size += size;
+        return size;
+    }
+
+  private:
+    size_t m_size = {}; // Amount of bytes counted so far
+};
+
+
+/// @brief Output for Telemetry::WriteKeyValue() that copies the given bytes into a fixed size buffer passed to it
+class Json_Buffer_Writer {
+  public:
+    /// @brief Constructor
+    /// @param buffer Buffer the bytes should be copied into, has to be kept alive for as long as the instance of this class
+    /// @param capacity Amount of bytes the given buffer can hold
+    Json_Buffer_Writer(char * buffer, size_t const & capacity)
+      : m_buffer(buffer)
+      , m_capacity(capacity)
+      , m_size(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Copies the given bytes after the previously written bytes
+    /// @param buffer Bytes that should be written
+    /// @param size Amount of bytes that should be written
+    /// @return Amount of bytes written or 0 if the bytes would not fit into the remaining buffer
+    size_t write(uint8_t const * buffer, size_t const & size) {
+        if (size > m_capacity - m_size) {
+            return 0U;
+        }
+        memcpy(m_buffer + m_size, buffer, size);
+        m_size += size;
+        return size;
+    }
+
+  private:
+    char   *m_buffer = {};   // Buffer the bytes are copied into
+    size_t m_capacity = {};  // Amount of bytes the buffer can hold
+    size_t m_size = {};      // Amount of bytes written so far
+};
+
+#endif // Json_Writer_h
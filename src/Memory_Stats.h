@@ -0,0 +1,223 @@
+#ifndef Memory_Stats_h
+#define Memory_Stats_h
+
+// Local include.
+#include "Configuration.h"
+
+// Library include.
+#include <stddef.h>
+#include <stdint.h>
+
+
+/// @brief Parts of the library every allocation made through the Allocator_Policy is accounted to, if THINGSBOARD_ENABLE_MEMORY_STATS is set
+enum class Memory_Subsystem : uint8_t {
+    OTHER,            ///< Allocations that were not made by any of the subsystems below, for example JsonDocument instances allocated by the user
+    RECEIVE_DOCUMENT, ///< JsonDocument received messages are deserialized into, including everything allocated while the received message is processed by its callback
+    SEND_BUFFER,      ///< Buffers messages are serialized into before they are sent, including the records of the spool
+    RPC_RESPONSE,     ///< Pending server side RPC requests, their serialized responses and the JsonDocument the response is written into
+    CALLBACKS,        ///< Storage of all Vector instances that are not grown inside of a Memory_Scope, which mostly hold the subscribed callbacks
+    OTA,              ///< State of an ongoing OTA firmware update, for example the buffer used to reorder received chunks
+    TIMERS            ///< Entries of the timer wheel, used to arm timeouts and delayed callbacks
+};
+
+/// @brief Amount of values in Memory_Subsystem
+size_t constexpr MEMORY_SUBSYSTEM_AMOUNT = 7U;
+
+
+/// @brief Memory usage of a single Memory_Subsystem or of all of them combined, all sizes are the requested bytes without the Allocator_Stats_Header added in front of every allocation
+struct Memory_Subsystem_Stats {
+    size_t current_bytes = {};       // Amount of bytes that are currently allocated
+    size_t peak_bytes = {};          // Highest amount of bytes that were allocated at the same time, since startup or the last call to Reset_Peaks
+    size_t current_allocations = {}; // Amount of allocations that have not been freed yet
+    size_t total_allocations = {};   // Amount of allocations made since startup
+    size_t failed_allocations = {};  // Amount of allocations that failed because there was not enough memory left, since startup
+    size_t largest_allocation = {};  // Biggest single allocation, since startup or the last call to Reset_Peaks
+    size_t peak_stack_bytes = {};    // Biggest buffer that was placed onto the stack instead of the heap, because it was smaller than the maximum stack size or the library was not built with THINGSBOARD_ENABLE_DYNAMIC.
+                                     // For the RECEIVE_DOCUMENT subsystem the size the received message would have needed, even if it exceeded MaxResponse
+};
+
+
+/// @brief Accounts all allocations made through the Allocator_Policy to the Memory_Subsystem they were made for, and tracks their current and peak usage.
+/// Allows to right-size the buffer sizes, MaxResponse, the maximum stack size and the memory of an installed IAllocator from real data instead of estimations.
+/// If THINGSBOARD_ENABLE_MEMORY_STATS is not set, every method does nothing and all returned stats stay 0, so that the calls can be left in the code.
+/// Memory allocated directly onto psram, because THINGSBOARD_ENABLE_PSRAM is set and no allocator has been installed, is not accounted
+class Memory_Stats {
+  public:
+    /// @brief Gets the memory usage of the given subsystem
+    /// @param subsystem Subsystem we want to get the memory usage of
+    /// @return Memory usage of the given subsystem
+    static Memory_Subsystem_Stats const & Get(Memory_Subsystem const & subsystem) {
+        return Get_Entries()[static_cast<size_t>(subsystem)];
+    }
+
+    /// @brief Gets the combined memory usage of all subsystems, the peak is the highest amount of bytes that were allocated at the same time over all subsystems,
+    /// which is the heap high-water-mark of the library and can be lower than the sum of the peaks of every single subsystem
+    /// @return Combined memory usage of all subsystems
+    static Memory_Subsystem_Stats const & Get_Total() {
+        return Get_Entries()[MEMORY_SUBSYSTEM_AMOUNT];
+    }
+
+    /// @brief Resets the peak and largest values of all subsystems to their current usage, allows to measure the peak usage of a specific part of the program
+    static void Reset_Peaks() {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        for (size_t i = 0U; i <= MEMORY_SUBSYSTEM_AMOUNT; ++i) {
+            Memory_Subsystem_Stats & entry = Get_Entries()[i];
+            entry.peak_bytes = entry.current_bytes;
+            entry.largest_allocation = 0U;
+            entry.peak_stack_bytes = 0U;
+        }
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+    /// @brief Accounts a successful allocation to the given subsystem
+    /// @param subsystem Subsystem the memory was allocated for
+    /// @param size Amount of bytes that were allocated
+    static void Record_Allocation(Memory_Subsystem const & subsystem, size_t const & size) {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        Add(Get_Entries()[static_cast<size_t>(subsystem)], size);
+        Add(Get_Entries()[MEMORY_SUBSYSTEM_AMOUNT], size);
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+    /// @brief Accounts freeing memory to the given subsystem
+    /// @param subsystem Subsystem the memory was allocated for
+    /// @param size Amount of bytes that were freed
+    static void Record_Deallocation(Memory_Subsystem const & subsystem, size_t const & size) {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        Remove(Get_Entries()[static_cast<size_t>(subsystem)], size);
+        Remove(Get_Entries()[MEMORY_SUBSYSTEM_AMOUNT], size);
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+    /// @brief Accounts resizing previously allocated memory to the given subsystem, does not count as an additional allocation
+    /// @param subsystem Subsystem the memory was allocated for
+    /// @param previous_size Amount of bytes that were allocated before
+    /// @param size Amount of bytes that are allocated now
+    static void Record_Resize(Memory_Subsystem const & subsystem, size_t const & previous_size, size_t const & size) {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        Record_Deallocation(subsystem, previous_size);
+        Record_Allocation(subsystem, size);
+        Get_Entries()[static_cast<size_t>(subsystem)].total_allocations--;
+        Get_Entries()[MEMORY_SUBSYSTEM_AMOUNT].total_allocations--;
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+    /// @brief Accounts an allocation that failed because there was not enough memory left to the given subsystem
+    /// @param subsystem Subsystem the memory should have been allocated for
+    static void Record_Failure(Memory_Subsystem const & subsystem) {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        Get_Entries()[static_cast<size_t>(subsystem)].failed_allocations++;
+        Get_Entries()[MEMORY_SUBSYSTEM_AMOUNT].failed_allocations++;
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+    /// @brief Accounts a buffer that was placed onto the stack instead of the heap to the given subsystem
+    /// @param subsystem Subsystem the buffer was needed for
+    /// @param size Amount of bytes the buffer needed
+    static void Record_Stack(Memory_Subsystem const & subsystem, size_t const & size) {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        Memory_Subsystem_Stats & entry = Get_Entries()[static_cast<size_t>(subsystem)];
+        if (size > entry.peak_stack_bytes) {
+            entry.peak_stack_bytes = size;
+        }
+        Memory_Subsystem_Stats & total = Get_Entries()[MEMORY_SUBSYSTEM_AMOUNT];
+        if (size > total.peak_stack_bytes) {
+            total.peak_stack_bytes = size;
+        }
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+  private:
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+    /// @brief Adds the given allocation to the given entry and updates its peaks
+    /// @param entry Entry the allocation is accounted to
+    /// @param size Amount of bytes that were allocated
+    static void Add(Memory_Subsystem_Stats & entry, size_t const & size) {
+        entry.current_bytes += size;
+        entry.current_allocations++;
+        entry.total_allocations++;
+        if (entry.current_bytes > entry.peak_bytes) {
+            entry.peak_bytes = entry.current_bytes;
+        }
+        if (size > entry.largest_allocation) {
+            entry.largest_allocation = size;
+        }
+    }
+
+    /// @brief Removes the given allocation from the given entry
+    /// @param entry Entry the allocation was accounted to
+    /// @param size Amount of bytes that were freed
+    static void Remove(Memory_Subsystem_Stats & entry, size_t const & size) {
+        entry.current_bytes -= size;
+        entry.current_allocations--;
+    }
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+
+    /// @brief Gets the stats of every subsystem followed by the combined stats, a function local static is used so that the class can stay header only
+    /// @return Pointer to the first entry
+    static Memory_Subsystem_Stats * Get_Entries() {
+        static Memory_Subsystem_Stats entries[MEMORY_SUBSYSTEM_AMOUNT + 1U] = {};
+        return entries;
+    }
+};
+
+
+/// @brief Accounts all allocations made while an instance exists, that do not explicitly pass a Memory_Subsystem, to the given subsystem.
+/// Used for allocations that can not pass a subsystem themselves, like the internal memory of JsonDocument instances.
+/// Scopes can be nested, in which case the innermost one is used, and restore the previous subsystem once they are destroyed
+class Memory_Scope {
+  public:
+    /// @brief Constructor
+    /// @param subsystem Subsystem allocations are accounted to while this instance exists
+    explicit Memory_Scope(Memory_Subsystem const & subsystem)
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+      : m_previous(Get_Current())
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        Get_Current() = subsystem;
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+    /// @brief Destructor
+    ~Memory_Scope() {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        Get_Current() = m_previous;
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+    Memory_Scope(Memory_Scope const &) = delete;
+    Memory_Scope & operator=(Memory_Scope const &) = delete;
+
+    /// @brief Gets the subsystem of the innermost existing instance
+    /// @return Subsystem allocations are currently accounted to or Memory_Subsystem::OTHER if no instance exists
+    static Memory_Subsystem Current() {
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+        return Get_Current();
+#else
+        return Memory_Subsystem::OTHER;
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+    }
+
+    /// @brief Gets the subsystem of the innermost existing instance, for allocations that belong to a specific subsystem unless they are made inside of a scope
+    /// @param fallback Subsystem that is returned if no instance exists
+    /// @return Subsystem allocations are currently accounted to or the given fallback if no instance exists
+    static Memory_Subsystem Current_Or(Memory_Subsystem const & fallback) {
+        Memory_Subsystem const current = Current();
+        return current != Memory_Subsystem::OTHER ? current : fallback;
+    }
+
+  private:
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+    /// @brief Gets the storage of the current subsystem, a function local static is used so that the class can stay header only
+    /// @return Reference to the current subsystem
+    static Memory_Subsystem & Get_Current() {
+        static Memory_Subsystem current = Memory_Subsystem::OTHER;
+        return current;
+    }
+
+    Memory_Subsystem m_previous = {}; // Subsystem of the enclosing instance, restored once this instance is destroyed
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+};
+
+#endif // Memory_Stats_h
@@ -0,0 +1,25 @@
+#ifndef OTA_Checkpoint_h
+#define OTA_Checkpoint_h
+
+// Local include.
+#include "HashGenerator.h"
+
+
+size_t constexpr MAX_FW_INFO_SIZE = 32U;
+
+
+/// @brief Snapshot of the progress of an ongoing OTA firmware update, contains everything that is needed to continue the download after the connection was lost or the device restarted.
+/// Only consists of plain data, meaning it can be written into persistent memory as is and read back again later on, but the saved hash state is only valid for the same build of the firmware
+struct OTA_Checkpoint {
+    char              fw_title[MAX_FW_INFO_SIZE] = {};      // Title of the firmware that is being downloaded, truncated if it is longer than MAX_FW_INFO_SIZE - 1
+    char              fw_version[MAX_FW_INFO_SIZE] = {};    // Version of the firmware that is being downloaded, truncated if it is longer than MAX_FW_INFO_SIZE - 1
+    char              fw_checksum[FIRMWARE_HASH_SIZE] = {}; // Checksum of the complete firmware binary that is being downloaded
+    mbedtls_md_type_t fw_checksum_algorithm = {};           // Algorithm type used to hash the firmware binary
+    size_t            fw_size = {};                         // Total size of the firmware binary that is being downloaded
+    uint16_t          chunk_size = {};                      // Size of the chunks the firmware binary was split into when the checkpoint was saved, the download is continued with the same chunk size
+    size_t            committed_chunks = {};                // Amount of chunks that have been written with the IUpdater and added to the hash, is the index of the chunk the download continues with
+    size_t            hash_state_size = {};                 // Amount of bytes in the hash state
+    uint8_t           hash_state[MAX_HASH_STATE_SIZE] = {}; // Internal state of the hash calculation after committed_chunks have been added to it
+};
+
+#endif // OTA_Checkpoint_h
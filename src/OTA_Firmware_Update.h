@@ -14,6 +14,7 @@ char constexpr NO_FW_REQUEST_RESPONSE[] = "Did not receive requested shared attr
 // Firmware topics.
 char constexpr FIRMWARE_RESPONSE_TOPIC[] = "v2/fw/response/%u/chunk/";
 char constexpr FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC[] = "v2/fw/response/+";
+char constexpr FIRMWARE_RESPONSE_TOPIC_PREFIX[] = "v2/fw/response/";
 char constexpr FIRMWARE_REQUEST_TOPIC[] = "v2/fw/request/%u/chunk/%u";
 // Firmware data keys.
 char constexpr CURR_FW_TITLE_KEY[] = "current_fw_title";
@@ -53,22 +54,14 @@ class OTA_Firmware_Update : public IAPI_Implementation {
   public:
     /// @brief Constructor
     OTA_Firmware_Update()
-      : m_subscribe_api_callback()
-      , m_send_json_callback()
-      , m_send_json_string_callback()
-      , m_subscribe_topic_callback()
-      , m_unsubscribe_topic_callback()
-      , m_get_receive_size_callback()
-      , m_get_send_size_callback()
-      , m_set_buffer_size_callback()
-      , m_get_request_id_callback()
+      : m_client_context(&Unbound_Client_Context::Get_Instance())
       , m_fw_callback()
       , m_previous_buffer_size(0U)
       , m_changed_buffer_size(false)
 #if THINGSBOARD_ENABLE_STL
-      , m_ota(std::bind(&OTA_Firmware_Update::Publish_Chunk_Request, this, std::placeholders::_1, std::placeholders::_2), std::bind(&OTA_Firmware_Update::Firmware_Send_State, this, std::placeholders::_1, std::placeholders::_2), std::bind(&OTA_Firmware_Update::Firmware_OTA_Unsubscribe, this))
+      , m_ota(std::bind(&OTA_Firmware_Update::Publish_Chunk_Request, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), std::bind(&OTA_Firmware_Update::Firmware_Send_State, this, std::placeholders::_1, std::placeholders::_2), std::bind(&OTA_Firmware_Update::Firmware_OTA_Unsubscribe, this), std::bind(&OTA_Firmware_Update::Resize_Receive_Buffer, this, std::placeholders::_1))
 #else
-      , m_ota(OTA_Firmware_Update::staticPublishChunk, OTA_Firmware_Update::staticFirmwareSend, OTA_Firmware_Update::staticUnsubscribe)
+      , m_ota(OTA_Firmware_Update::staticPublishChunk, OTA_Firmware_Update::staticFirmwareSend, OTA_Firmware_Update::staticUnsubscribe, OTA_Firmware_Update::staticResizeBuffer)
 #endif // THINGSBOARD_ENABLE_STL
       , m_response_topic()
       , m_fw_attribute_update()
@@ -161,7 +154,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         StaticJsonDocument<JSON_OBJECT_SIZE(2)> current_firmware_info;
         current_firmware_info[CURR_FW_TITLE_KEY] = current_fw_title;
         current_firmware_info[CURR_FW_VER_KEY] = current_fw_version;
-        return m_send_json_callback.Call_Callback(TELEMETRY_TOPIC, current_firmware_info, Helper::Measure_Json(current_firmware_info));
+        return m_client_context->Send_Json(TELEMETRY_TOPIC, current_firmware_info, Helper::Measure_Json(current_firmware_info));
     }
 
     /// @brief Sends the given firmware state to the cloud.
@@ -174,7 +167,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         StaticJsonDocument<JSON_OBJECT_SIZE(2)> current_firmware_state;
         current_firmware_state[FW_ERROR_KEY] = fw_error;
         current_firmware_state[FW_STATE_KEY] = current_fw_state;
-        return m_send_json_callback.Call_Callback(TELEMETRY_TOPIC, current_firmware_state, Helper::Measure_Json(current_firmware_state));
+        return m_client_context->Send_Json(TELEMETRY_TOPIC, current_firmware_state, Helper::Measure_Json(current_firmware_state));
     }
 
     API_Process_Type Get_Process_Type() const override {
@@ -193,6 +186,10 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         // Nothing to do
     }
 
+    char const * Get_Response_Topic_Prefix() const override {
+        return FIRMWARE_RESPONSE_TOPIC_PREFIX;
+    }
+
     bool Compare_Response_Topic(char const * topic) const override {
         return strncmp(m_response_topic, topic, strlen(m_response_topic)) == 0;
     }
@@ -206,27 +203,17 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         return Firmware_OTA_Subscribe();
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
-        m_ota.update();
+        m_ota.loop();
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
-        m_subscribe_api_callback.Call_Callback(m_fw_attribute_update);
-        m_subscribe_api_callback.Call_Callback(m_fw_attribute_request);
+        m_client_context->Subscribe_API_Implementation(m_fw_attribute_update);
+        m_client_context->Subscribe_API_Implementation(m_fw_attribute_request);
     }
 
-    void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
-        m_subscribe_api_callback.Set_Callback(subscribe_api_callback);
-        m_send_json_callback.Set_Callback(send_json_callback);
-        m_send_json_string_callback.Set_Callback(send_json_string_callback);
-        m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
-        m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
-        m_get_receive_size_callback.Set_Callback(get_receive_size_callback);
-        m_get_send_size_callback.Set_Callback(get_send_size_callback);
-        m_set_buffer_size_callback.Set_Callback(set_buffer_size_callback);
-        m_get_request_id_callback.Set_Callback(get_request_id_callback);
+    void Set_Client_Context(IAPI_Client_Context & context) override {
+        m_client_context = &context;
     }
 
   private:
@@ -245,7 +232,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
             return false;
         }
 
-        size_t * p_request_id = m_get_request_id_callback.Call_Callback();
+        size_t * p_request_id = m_client_context->Get_Request_ID();
         if (p_request_id == nullptr) {
             Logger::printfln(REQUEST_ID_NULL);
             return false;
@@ -261,7 +248,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
     /// @brief Subscribes to the firmware response topic
     /// @return Whether subscribing to the firmware response topic was successful or not
     bool Firmware_OTA_Subscribe() {
-        if (!m_subscribe_topic_callback.Call_Callback(FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC)) {
+        if (!m_client_context->Subscribe_Topic(FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC)) {
             char message[strlen(SUBSCRIBE_TOPIC_FAILED) + strlen(FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC) + 2] = {};
             (void)snprintf(message, sizeof(message), SUBSCRIBE_TOPIC_FAILED, FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC);
             Logger::printfln(message);
@@ -279,30 +266,47 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         // to allow to receive ota chunck packets that might be much bigger than the normal
         // buffer size would allow, therefore we return to the previous value to decrease overall memory usage
         if (m_changed_buffer_size) {
-            (void)m_set_buffer_size_callback.Call_Callback(m_previous_buffer_size, m_get_send_size_callback.Call_Callback());
+            (void)m_client_context->Set_Buffer_Size(m_previous_buffer_size, m_client_context->Get_Send_Buffer_Size());
         }
         // Reset now not needed private member variables
         m_fw_callback = OTA_Update_Callback();
         // Unsubscribe from the topic
-        return m_unsubscribe_topic_callback.Call_Callback(FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC);
+        return m_client_context->Unsubscribe_Topic(FIRMWARE_RESPONSE_SUBSCRIBE_TOPIC);
     }
 
     /// @brief Publishes a request for the given firmware chunk
     /// @param request_id Request ID corresponding to the extact OTA update package we want to request chunks from
     /// @param request_chunck Chunk index that should be requested from the server
+    /// @param chunk_size Size of the chunks the server should split the firmware binary into, the requested chunk starts at the offset request_chunck * chunk_size
     /// @return Whether publishing the message was successful or not
-    bool Publish_Chunk_Request(size_t const & request_id, size_t const & request_chunck) {
-        // Calculate the number of chuncks we need to request,
-        // in order to download the complete firmware binary
-        uint16_t const & chunk_size = m_fw_callback.Get_Chunk_Size();
-
+    bool Publish_Chunk_Request(size_t const & request_id, size_t const & request_chunck, uint16_t const & chunk_size) {
         // Convert the interger size into a readable string
         char size[Helper::detectSize(NUMBER_PRINTF, chunk_size)] = {};
         (void)snprintf(size, sizeof(size), NUMBER_PRINTF, chunk_size);
 
         char topic[Helper::detectSize(FIRMWARE_REQUEST_TOPIC, request_id, request_chunck)] = {};
         (void)snprintf(topic, sizeof(topic), FIRMWARE_REQUEST_TOPIC, request_id, request_chunck);
-        return m_send_json_string_callback.Call_Callback(topic, size);
+        return m_client_context->Send_Json_String(topic, size);
+    }
+
+    /// @brief Increases the size of the receive buffer of the underlying client if it is too small to hold firmware chunks with the given size.
+    /// The buffer is never decreased during the update, the previously configured size is restored once the update has finished instead
+    /// @param chunk_size Size of the firmware chunks that have to fit into the receive buffer
+    /// @return Whether the receive buffer can hold firmware chunks with the given size, false if there is not enough heap memory to increase it
+    bool Resize_Receive_Buffer(uint16_t const & chunk_size) {
+        // Additional bytes are required for the response topic and the MQTT header of the firmware chunk
+        size_t const required_buffer_size = chunk_size + 50U;
+        if (required_buffer_size > UINT16_MAX) {
+            return false;
+        }
+        if (m_client_context->Get_Receive_Buffer_Size() >= required_buffer_size) {
+            return true;
+        }
+        if (!m_client_context->Set_Buffer_Size(required_buffer_size, m_client_context->Get_Send_Buffer_Size())) {
+            return false;
+        }
+        m_changed_buffer_size = true;
+        return true;
     }
 
     /// @brief Handler if the firmware shared attribute request times out without getting a response.
@@ -391,23 +395,28 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         Logger::printfln(DOWNLOADING_FW);
 #endif // THINGSBOARD_ENABLE_DEBUG
 
-        // Calculate the number of chuncks we need to request,
-        // in order to download the complete firmware binary
-        const uint16_t& chunk_size = m_fw_callback.Get_Chunk_Size();
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
+        if (timer_wheel == nullptr) {
+            Logger::printfln(TIMER_WHEEL_NULL);
+            Firmware_Send_State(FW_STATE_FAILED, TIMER_WHEEL_NULL);
+            m_fw_callback.Call_Callback(false);
+            return;
+        }
+        m_ota.Set_Timer_Wheel(*timer_wheel);
 
         // Get the previous buffer size and cache it so the previous settings can be restored.
-        m_previous_buffer_size = m_get_receive_size_callback.Call_Callback();
-        m_changed_buffer_size = m_previous_buffer_size < (chunk_size + 50U);
+        m_previous_buffer_size = m_client_context->Get_Receive_Buffer_Size();
+        m_changed_buffer_size = false;
 
-        // Increase size of receive buffer
-        if (m_changed_buffer_size && !m_set_buffer_size_callback.Call_Callback(chunk_size + 50U, m_get_send_size_callback.Call_Callback())) {
+        // Increase size of receive buffer, only to the size of the initial chunks, because the adaptive mode increases it further once bigger chunks are requested
+        if (!Resize_Receive_Buffer(m_fw_callback.Get_Chunk_Size())) {
             Logger::printfln(NOT_ENOUGH_RAM);
             Firmware_Send_State(FW_STATE_FAILED, NOT_ENOUGH_RAM);
             m_fw_callback.Call_Callback(false);
             return;
         }
 
-        m_ota.Start_Firmware_Update(m_fw_callback, fw_size, fw_checksum, fw_checksum_algorithm);
+        m_ota.Start_Firmware_Update(m_fw_callback, fw_title, fw_version, fw_size, fw_checksum, fw_checksum_algorithm);
     }
 
 #if !THINGSBOARD_ENABLE_STL
@@ -425,11 +434,18 @@ class OTA_Firmware_Update : public IAPI_Implementation {
         m_subscribedInstance->Request_Timeout();
     }
 
-    static bool staticPublishChunk(size_t const & request_id, size_t const & request_chunck) {
+    static bool staticPublishChunk(size_t const & request_id, size_t const & request_chunck, uint16_t const & chunk_size) {
+        if (m_subscribedInstance == nullptr) {
+            return false;
+        }
+        return m_subscribedInstance->Publish_Chunk_Request(request_id, request_chunck, chunk_size);
+    }
+
+    static bool staticResizeBuffer(uint16_t const & chunk_size) {
         if (m_subscribedInstance == nullptr) {
             return false;
         }
-        return m_subscribedInstance->Publish_Chunk_Request(request_id, request_chunck);
+        return m_subscribedInstance->Resize_Receive_Buffer(chunk_size);
     }
 
     static bool staticFirmwareSend(char const * current_fw_state, char const * fw_error = nullptr) {
@@ -452,15 +468,7 @@ class OTA_Firmware_Update : public IAPI_Implementation {
     static OTA_Firmware_Update                                               *m_subscribedInstance;
 #endif // !THINGSBOARD_ENABLE_STL
 
-    Callback<void, IAPI_Implementation &>                                    m_subscribe_api_callback = {};            // Subscribe additional api callback
-    Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};                // Send json document callback
-    Callback<bool, char const * const, char const * const>                   m_send_json_string_callback = {};         // Send json string callback
-    Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};          // Subscribe mqtt topic client callback
-    Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};        // Unubscribe mqtt topic client callback
-    Callback<uint16_t>                                                       m_get_receive_size_callback = {};         // Get client receive buffer size callback
-    Callback<uint16_t>                                                       m_get_send_size_callback = {};            // Get client send buffer size callback
-    Callback<bool, uint16_t, uint16_t>                                       m_set_buffer_size_callback = {};          // Set client buffer size callback
-    Callback<size_t *>                                                       m_get_request_id_callback = {};           // Get internal request id callback
+    IAPI_Client_Context *                                                    m_client_context = &Unbound_Client_Context::Get_Instance(); // Non-owning pointer to the client this API implementation communicates with the cloud over
 
     OTA_Update_Callback                                                      m_fw_callback = {};                       // OTA update response callback
     uint16_t                                                                 m_previous_buffer_size = {};              // Previous buffer size of the underlying client, used to revert to the previously configured buffer size if it was temporarily increased by the OTA update
@@ -5,11 +5,11 @@
 #include "Configuration.h"
 
 // Local include.
-#include "Callback_Watchdog.h"
 #include "HashGenerator.h"
 #include "OTA_Update_Callback.h"
 #include "OTA_Failure_Response.h"
 #include "Helper.h"
+#include "Timer_Wheel.h"
 
 // Library includes.
 #include <string.h>
@@ -25,7 +25,8 @@ char constexpr FW_STATE_UPDATED[] = "UPDATED";
 // Log messages.
 char constexpr OTA_CB_IS_NULL[] = "OTA update callback is NULL, has it been deleted";
 char constexpr UNABLE_TO_REQUEST_CHUNCKS[] = "Unable to request firmware chunk";
-char constexpr RECEIVED_UNEXPECTED_CHUNK[] = "Received chunk (%u), not the same as requested chunk (%u)";
+char constexpr RECEIVED_UNEXPECTED_CHUNK[] = "Received chunk (%u), outside of the currently requested chunks (%u) to (%u)";
+char constexpr RECEIVED_DUPLICATE_CHUNK[] = "Received chunk (%u), that has already been received and is waiting to be written";
 char constexpr RECEIVED_UNEXPECTED_CHUNK_SIZE[] = "Received chunk size (%u), not the same as expected chunk size (%u)";
 char constexpr ERROR_UPDATE_BEGIN[] = "Failed to initalize flash updater, ensure that the partition scheme has two app sections";
 char constexpr ERROR_UPDATE_WRITE[] = "Only wrote (%u) bytes of binary data instead of expected (%u)";
@@ -33,14 +34,22 @@ char constexpr ERROR_UPDATE_END[] = "Error during flash updater not all bytes wr
 char constexpr CHECKSUM_VERIFICATION_FAILED[] = "Calculated checksum (%s), not the same as expected checksum (%s)";
 char constexpr FW_UPDATE_ABORTED[] = "Firmware update aborted";
 char constexpr CHUNK_REQUEST_TIMED_OUT[] = "Failed to receive requested chunk (%u) in (%llu) us. Internet connection might have been lost";
+char constexpr SAVING_CHECKPOINT_FAILED[] = "Saving checkpoint of firmware update at chunk (%u) failed";
+char constexpr UNABLE_TO_ARM_CHUNK_TIMEOUT[] = "Unable to arm timeout timer for chunk (%u), retrying in the next loop() call";
+char constexpr UNABLE_TO_ALLOCATE_REORDER_BUFFER[] = "Allocating (%u) bytes to buffer chunks received out of order failed, falling back to requesting one chunk at a time";
+char constexpr UNABLE_TO_GROW_CHUNK_SIZE[] = "Growing chunk size to (%u) bytes failed because of insufficient memory, continuing with (%u) bytes";
 #if THINGSBOARD_ENABLE_DEBUG
 char constexpr FW_CHUNK[] = "Receive chunk (%u), with size (%u) bytes";
 char constexpr HASH_EXPECTED[] = "Expected checksum: (%s)";
 char constexpr CHECKSUM_VERIFICATION_SUCCESS[] = "Checksum is the same as expected";
 char constexpr FW_UPDATE_SUCCESS[] = "Update success";
+char constexpr RESUMING_FW_UPDATE[] = "Resuming firmware update from checkpoint at chunk (%u)";
+char constexpr CHANGED_CHUNK_SIZE[] = "Changed chunk size from (%u) to (%u) bytes at offset (%u)";
 #endif // THINGSBOARD_ENABLE_DEBUG
-// Maximum size consists of size required for byte representation of the hash * 2 because every byte is 2 hex characters + 1 for null termination
-size_t constexpr FIRMWARE_HASH_SIZE = (MBEDTLS_MD_MAX_SIZE * 2U) + 1;
+
+// Adaptive chunk size values.
+uint8_t constexpr ADAPTIVE_CHUNK_GROWTH_STREAK = 4U;
+uint8_t constexpr ADAPTIVE_CHUNK_LATENCY_DIVISOR = 4U;
 
 
 /// @brief Handles the complete processing of received binary firmware data, including flashing it onto the device,
@@ -50,39 +59,96 @@ template <typename Logger>
 class OTA_Handler {
   public:
     /// @brief Constructor
-    /// @param publish_callback Callback that is used to request the firmware chunk of the firmware binary with the given chunk number
+    /// @param publish_callback Callback that is used to request the firmware chunk of the firmware binary with the given chunk number and chunk size
     /// @param send_fw_state_callback Callback that is used to send information about the current state of the over the air update
     /// @param finish_callback Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
-    OTA_Handler(Callback<bool, size_t const &, size_t const &>::function publish_callback, Callback<bool, char const * const, char const * const>::function send_fw_state_callback, Callback<bool>::function finish_callback)
+    /// @param resize_callback Callback that is used to ensure chunks of the given size can be received, before the chunk size is grown in the adaptive mode
+    OTA_Handler(Callback<bool, size_t const &, size_t const &, uint16_t const &>::function publish_callback, Callback<bool, char const * const, char const * const>::function send_fw_state_callback, Callback<bool>::function finish_callback, Callback<bool, uint16_t const &>::function resize_callback)
       : m_fw_callback(nullptr)
       , m_publish_callback(publish_callback)
       , m_send_fw_state_callback(send_fw_state_callback)
       , m_finish_callback(finish_callback)
+      , m_resize_callback(resize_callback)
+      , m_fw_title()
+      , m_fw_version()
       , m_fw_size(0U)
       , m_fw_checksum()
       , m_fw_checksum_algorithm()
       , m_hash()
+      , m_chunk_size(0U)
+      , m_target_chunk_size(0U)
+      , m_max_chunk_size(0U)
+      , m_fast_chunks(0U)
+      , m_written_bytes(0U)
       , m_total_chunks(0U)
-      , m_requested_chunks(0U)
+      , m_next_chunk(0U)
+      , m_next_request(0U)
       , m_retries(0U)
-      , m_watchdog(std::bind(&OTA_Handler::Handle_Request_Timeout, this))
+      , m_window_size(0U)
+      , m_reorder_buffer(nullptr)
+      , m_used_buffers(0U)
+      , m_slots()
+      , m_timer_wheel(nullptr)
+      , m_timeout_callbacks()
+      , m_timeout_handles()
     {
-        // Nothing to do
+        for (size_t i = 0U; i < MAX_CHUNK_WINDOW_SIZE; i++) {
+            // Lambda instead of std::bind, because binding the slot index in addition to the member function pointer and this would not fit into an Inline_Delegate
+            m_timeout_callbacks[i].Set_Callback([this, i]() { Handle_Request_Timeout(i); });
+        }
+    }
+
+    /// @brief Sets the timer wheel that is used to arm the timeout timers of the outstanding chunk requests,
+    /// has to be called before the firmware update is started
+    /// @param timer_wheel Timer wheel that is shared by all requests that can timeout
+    void Set_Timer_Wheel(Timer_Wheel & timer_wheel) {
+        m_timer_wheel = &timer_wheel;
+    }
+
+    /// @brief Retries arming the timeout timers of chunk requests, whose timer could not be armed when the chunk was requested because the timer wheel was full.
+    /// Without the timer a lost chunk would never be requested again and the update would never finish. The timeout starts once the timer has been armed
+    void loop() {
+        if (m_timer_wheel == nullptr) {
+            return;
+        }
+        for (size_t i = 0U; i < MAX_CHUNK_WINDOW_SIZE; i++) {
+            if (m_slots[i].unarmed) {
+                Arm_Timeout_Timer(i);
+            }
+        }
     }
 
-    /// @brief Starts the firmware update with requesting the first firmware packet and initalizes the underlying needed components
+    /// @brief Destructor
+    ~OTA_Handler() {
+        Free_Reorder_Buffer();
+    }
+
+    /// @brief Starts the firmware update with requesting the first firmware packet and initalizes the underlying needed components.
+    /// If a checkpoint of a previously interrupted download of the same firmware has been saved, the download is continued from that checkpoint instead
     /// @param fw_callback Callback method that contains configuration information, about the over the air update
+    /// @param fw_title Title of the firmware binary that will be downloaded, used to ensure a saved checkpoint belongs to the same firmware
+    /// @param fw_version Version of the firmware binary that will be downloaded, used to ensure a saved checkpoint belongs to the same firmware
     /// @param fw_size Complete size of the firmware binary that will be downloaded and flashed onto this device
     /// @param fw_checksum Checksum of the complete firmware binary, should be the same as the actually written data in the end
     /// @param fw_checksum_algorithm Algorithm type used to hash the firmware binary
-    void Start_Firmware_Update(OTA_Update_Callback const & fw_callback, size_t const & fw_size, char const * fw_checksum, mbedtls_md_type_t const & fw_checksum_algorithm) {
+    void Start_Firmware_Update(OTA_Update_Callback const & fw_callback, char const * fw_title, char const * fw_version, size_t const & fw_size, char const * fw_checksum, mbedtls_md_type_t const & fw_checksum_algorithm) {
         m_fw_callback = &fw_callback;
+        (void)strncpy(m_fw_title, fw_title, sizeof(m_fw_title) - 1U);
+        (void)strncpy(m_fw_version, fw_version, sizeof(m_fw_version) - 1U);
         m_fw_size = fw_size;
-        m_total_chunks = (m_fw_size / m_fw_callback->Get_Chunk_Size()) + 1U;
         (void)strncpy(m_fw_checksum, fw_checksum, sizeof(m_fw_checksum));
         m_fw_checksum_algorithm = fw_checksum_algorithm;
         m_fw_updater = m_fw_callback->Get_Updater();
-        Request_First_Firmware_Packet();
+        uint16_t const chunk_size = m_fw_callback->Get_Chunk_Size();
+        uint16_t const max_chunk_size = m_fw_callback->Get_Max_Chunk_Size();
+        m_max_chunk_size = max_chunk_size > chunk_size ? max_chunk_size : chunk_size;
+        m_fast_chunks = 0U;
+        m_written_bytes = 0U;
+        Set_Chunk_Size(chunk_size);
+        Allocate_Reorder_Buffer();
+        if (!Resume_Firmware_Update()) {
+            Request_First_Firmware_Packet();
+        }
         (void)m_send_fw_state_callback.Call_Callback(FW_STATE_DOWNLOADING, "");
     }
 
@@ -90,7 +156,7 @@ class OTA_Handler {
     /// Be aware the written partition is not erased so the already written binary firmware data still remains in the flash partition,
     /// shouldn't really matter, because if we start the update process again the partition will be overwritten anyway and a partially written firmware will not be bootable
     void Stop_Firmware_Update()  {
-        m_watchdog.detach();
+        Cancel_Timeout_Timers();
         m_fw_updater->reset();
         Logger::printfln(FW_UPDATE_ABORTED);
         Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, FW_UPDATE_ABORTED);
@@ -98,31 +164,193 @@ class OTA_Handler {
     }
 
     /// @brief Uses the given firmware packet data and process it. Starting with writing the given amount of bytes of the packet data into flash memory and
-    /// into a hash function that will be used to compare the expected complete binary file and the actually received binary file
+    /// into a hash function that will be used to compare the expected complete binary file and the actually received binary file.
+    /// Chunks that arrive before all previous chunks have been written are copied into the reorder buffer instead and written as soon as the missing chunks have arrived,
+    /// because both the flash memory and the hash have to receive the firmware binary data strictly in order
     /// @param current_chunk Index of the chunk we recieved the binary data for
     /// @param payload Firmware packet data of the current chunk
     /// @param total_bytes Amount of bytes in the current firmware packet data
     void Process_Firmware_Packet(size_t const & current_chunk, uint8_t * payload, size_t const & total_bytes)  {
-        if (current_chunk != m_requested_chunks) {
-            Logger::printfln(RECEIVED_UNEXPECTED_CHUNK, current_chunk, m_requested_chunks);
+        // Only chunks inside of the current window have been requested, anything else is either a late response to a chunk we already wrote or a chunk we never requested
+        if (current_chunk < m_next_chunk || current_chunk >= m_next_request) {
+            Logger::printfln(RECEIVED_UNEXPECTED_CHUNK, current_chunk, m_next_chunk, m_next_request);
+            return;
+        }
+        size_t const slot_index = current_chunk % m_window_size;
+        Chunk_Slot & slot = m_slots[slot_index];
+        if (slot.data != nullptr) {
+            Logger::printfln(RECEIVED_DUPLICATE_CHUNK, current_chunk);
             return;
         }
         size_t expected_chunk_size = 0U;
-        if (!Received_Valid_Chunk_Size(total_bytes, expected_chunk_size)) {
-            Logger::printfln(RECEIVED_UNEXPECTED_CHUNK_SIZE, expected_chunk_size, total_bytes);
+        if (!Received_Valid_Chunk_Size(current_chunk, total_bytes, expected_chunk_size)) {
+            Logger::printfln(RECEIVED_UNEXPECTED_CHUNK_SIZE, total_bytes, expected_chunk_size);
             return;
         }
 
-        m_watchdog.detach();
+        Cancel_Timeout_Timer(slot_index);
+        Update_Chunk_Latency(Timer_Wheel::get_time_microseconds() - slot.requested);
     #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(FW_CHUNK, current_chunk, total_bytes);
     #endif // THINGSBOARD_ENABLE_DEBUG
 
-        if (current_chunk == 0U) {
+        // Chunk arrived before all of its predecessors, keep it until the missing chunks have been received and written.
+        // There is always a free buffer, because the chunk we are waiting for is never buffered and the window only ever contains m_window_size chunks
+        if (current_chunk != m_next_chunk) {
+            slot.data = Acquire_Reorder_Buffer();
+            slot.size = total_bytes;
+            (void)memcpy(slot.data, payload, total_bytes);
+            return;
+        }
+
+        if (!Write_Firmware_Packet(payload, total_bytes)) {
+            return;
+        }
+
+        // Write any directly following chunks that arrived out of order previously and are now next in line
+        while (m_next_chunk < m_next_request) {
+            Chunk_Slot & next_slot = m_slots[m_next_chunk % m_window_size];
+            if (next_slot.data == nullptr) {
+                break;
+            }
+            uint8_t * data = next_slot.data;
+            if (!Write_Firmware_Packet(data, next_slot.size)) {
+                // Writing failed and the failure handling already reset the complete window, including the reorder buffer
+                return;
+            }
+            next_slot.data = nullptr;
+            Release_Reorder_Buffer(data);
+        }
+
+        Request_Next_Firmware_Packets();
+    }
+
+  private:
+    /// @brief State of a single requested chunk inside of the current window of outstanding chunk requests
+    struct Chunk_Slot {
+        size_t   chunk;     // Index of the chunk that has been requested in this slot
+        size_t   size;      // Amount of bytes copied into the reorder buffer, only valid if data is not nullptr
+        uint8_t  *data;     // Pointer into the reorder buffer the chunk was copied into, nullptr as long as the chunk has not arrived yet
+        uint8_t  retries;   // Amount of request retries remaining for this specific chunk
+        uint32_t requested; // Time in microseconds the chunk was last requested at, used to measure the latency of the chunk in the adaptive mode
+        bool     unarmed;   // Whether arming the timeout timer of the request failed, because the timer wheel was full, and has to be retried in loop()
+    };
+
+    /// @brief Checks whether the received chunk size matches the expected chunk size, should be the current chunk size, which is the configured chunk size of the OTA_Update_Callback, CHUNK_SIZE (4096) per default, unless it was changed by the adaptive mode
+    /// and it should be the remaining bytes to fill the total firmware size with the last received chunk. If that is not the case then something went wrong with the request and we have to rerequest that specific chunk,
+    /// because if we do not do that we would write missing or only partial binary data to flash and into the hash, meaning the complete OTA update will be invalidated at the end and has to be restarted.
+    /// Late responses to chunks requested before the chunk size was changed are rejected here as well, because their size does not match the current chunk size
+    /// @param current_chunk Index of the chunk we received the binary data for
+    /// @param received_chunk_size Size in bytes of the received chunk
+    /// @param expected_chunk_size Variable the expected chunk size for the given chunk will be copied into
+    /// @return Whether the received chunk has the expected size or not
+    bool Received_Valid_Chunk_Size(size_t const & current_chunk, size_t const & received_chunk_size, size_t & expected_chunk_size) {
+        size_t const remaining_bytes = m_fw_size - (current_chunk * m_chunk_size);
+        expected_chunk_size = remaining_bytes < m_chunk_size ? remaining_bytes : m_chunk_size;
+        return received_chunk_size == expected_chunk_size;
+    }
+
+    /// @brief Changes the size of the chunks that are requested and recalculates the chunk indices for it, the server splits the firmware binary with the requested chunk size,
+    /// meaning the chunk with index i always starts at the offset i * chunk_size. Therefore the size may only be changed while no chunk is outstanding and the already written bytes have to be a multiple of the new chunk size
+    /// @param chunk_size Size of the chunks that are requested from now on
+    void Set_Chunk_Size(uint16_t const & chunk_size) {
+        m_chunk_size = chunk_size;
+        m_target_chunk_size = chunk_size;
+        m_total_chunks = (m_fw_size + chunk_size - 1U) / chunk_size;
+        m_next_chunk = m_written_bytes / chunk_size;
+        m_next_request = m_next_chunk;
+    }
+
+    /// @brief Checks whether the given chunk size can be used by the current update, which is either the configured chunk size of the OTA_Update_Callback
+    /// or in the adaptive mode the configured chunk size doubled any amount of times, as long as it does not exceed the maximum chunk size
+    /// @param chunk_size Chunk size that should be checked
+    /// @return Whether the given chunk size can be used by the current update
+    bool Is_Supported_Chunk_Size(uint16_t const & chunk_size) const {
+        size_t supported_chunk_size = m_fw_callback->Get_Chunk_Size();
+        while (supported_chunk_size < chunk_size && supported_chunk_size <= m_max_chunk_size) {
+            supported_chunk_size *= 2U;
+        }
+        return supported_chunk_size == chunk_size && chunk_size <= m_max_chunk_size;
+    }
+
+    /// @brief Updates the statistics used to decide whether the chunk size should be grown in the adaptive mode, with the latency of the chunk that has just been received.
+    /// Chunks count as fast, if they arrived in less than a ADAPTIVE_CHUNK_LATENCY_DIVISOR part of the timeout, which ensures that a chunk with double the size still arrives well before the timeout.
+    /// Once ADAPTIVE_CHUNK_GROWTH_STREAK fast chunks arrived after another, the chunk size is doubled as soon as the written bytes are a multiple of the doubled size
+    /// @param latency_microseconds Time in microseconds between requesting the chunk the last time and receiving it
+    void Update_Chunk_Latency(uint32_t const & latency_microseconds) {
+        if (m_chunk_size > m_max_chunk_size / 2U || m_target_chunk_size != m_chunk_size) {
+            return;
+        }
+        if (static_cast<uint64_t>(latency_microseconds) * ADAPTIVE_CHUNK_LATENCY_DIVISOR > m_fw_callback->Get_Timeout()) {
+            m_fast_chunks = 0U;
+            return;
+        }
+        m_fast_chunks++;
+        if (m_fast_chunks >= ADAPTIVE_CHUNK_GROWTH_STREAK) {
+            m_fast_chunks = 0U;
+            m_target_chunk_size = m_chunk_size * 2U;
+        }
+    }
+
+    /// @brief Changes the chunk size to the target chunk size decided by the adaptive mode, has to be called while no chunk is outstanding and the written bytes are a multiple of the target chunk size.
+    /// Growing the chunk size requires the client to be able to receive the bigger chunks and enough heap memory for the bigger reorder buffer. If either of them can not be allocated the memory is too tight,
+    /// the current chunk size is kept and the chunk size is not grown again for the remainder of the update
+    void Apply_Target_Chunk_Size() {
+        uint16_t const previous_chunk_size = m_chunk_size;
+        uint16_t const target_chunk_size = m_target_chunk_size;
+        bool const growing = target_chunk_size > previous_chunk_size;
+        if (growing && !m_resize_callback.Call_Callback(target_chunk_size)) {
+            Logger::printfln(UNABLE_TO_GROW_CHUNK_SIZE, target_chunk_size, previous_chunk_size);
+            m_max_chunk_size = previous_chunk_size;
+            m_target_chunk_size = previous_chunk_size;
+            return;
+        }
+
+        Set_Chunk_Size(target_chunk_size);
+        if (!Try_Allocate_Reorder_Buffer()) {
+            if (growing) {
+                Logger::printfln(UNABLE_TO_GROW_CHUNK_SIZE, target_chunk_size, previous_chunk_size);
+                m_max_chunk_size = previous_chunk_size;
+                Set_Chunk_Size(previous_chunk_size);
+            }
+            Allocate_Reorder_Buffer();
+        }
+    #if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(CHANGED_CHUNK_SIZE, previous_chunk_size, m_chunk_size, m_written_bytes);
+    #endif // THINGSBOARD_ENABLE_DEBUG
+    }
+
+    /// @brief Halves the chunk size in the adaptive mode after a chunk request timed out, because the bigger the chunk the more likely it is to not arrive in time on a bad connection.
+    /// If no chunk has been buffered the outstanding requests are discarded and the window is requested again with the smaller chunk size directly,
+    /// otherwise the buffered chunks are written first and the chunk size is changed once the window has been emptied
+    /// @return Whether the window has been requested again with the smaller chunk size, if not the timed out chunk still has to be requested again
+    bool Shrink_Chunk_Size() {
+        m_fast_chunks = 0U;
+        if (m_chunk_size / 2U < m_fw_callback->Get_Chunk_Size()) {
+            return false;
+        }
+        m_target_chunk_size = m_chunk_size / 2U;
+        if (m_used_buffers != 0U) {
+            return false;
+        }
+        Cancel_Timeout_Timers();
+        Reset_Window();
+        Apply_Target_Chunk_Size();
+        Request_Next_Firmware_Packets();
+        return true;
+    }
+
+    /// @brief Writes the binary data of the next chunk in line into flash memory and into the hash and informs the user about the increased progress
+    /// @param payload Firmware packet data of the next chunk in line
+    /// @param total_bytes Amount of bytes in the firmware packet data
+    /// @return Whether writing the chunk was successful, if it was not the failure has already been handled and the caller should stop processing
+    bool Write_Firmware_Packet(uint8_t * payload, size_t const & total_bytes) {
+        if (m_written_bytes == 0U) {
             // Initialize Flash
             if (!m_fw_updater->begin(m_fw_size)) {
                 Logger::printfln(ERROR_UPDATE_BEGIN);
-                return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_UPDATE_BEGIN);
+                Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, ERROR_UPDATE_BEGIN);
+                return false;
             }
         }
 
@@ -132,83 +360,275 @@ class OTA_Handler {
             char message[Helper::detectSize(ERROR_UPDATE_WRITE, written_bytes, total_bytes)] = {};
             (void)snprintf(message, sizeof(message), ERROR_UPDATE_WRITE, written_bytes, total_bytes);
             Logger::printfln(message);
-            return Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
+            Handle_Failure(OTA_Failure_Response::RETRY_UPDATE, message);
+            return false;
         }
 
         // Update value only if writing to flash was a success, result is ignored,
         // because it can only fail if the input parameters are invalid
         (void)m_hash.update(payload, total_bytes);
 
-        m_requested_chunks = current_chunk + 1;
-        m_fw_callback->Call_Progress_Callback(m_requested_chunks, m_total_chunks);
+        m_written_bytes += total_bytes;
+        m_next_chunk++;
+        m_fw_callback->Call_Progress_Callback(m_next_chunk, m_total_chunks);
 
         // Ensure to check if the update was cancelled during the progress callback,
         // if it was the callback variable was reset and there is no need to request the next firmware packet
         if (m_fw_callback == nullptr) {
             Logger::printfln(OTA_CB_IS_NULL);
-            return Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, OTA_CB_IS_NULL);
+            Handle_Failure(OTA_Failure_Response::RETRY_NOTHING, OTA_CB_IS_NULL);
+            return false;
         }
 
         // Reset retries as the current chunk has been downloaded and handled successfully
         m_retries = m_fw_callback->Get_Chunk_Retries();
-        Request_Next_Firmware_Packet();
-    }
-
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Used to update the watchdog timer which uses a simple software time in the background. Ensure to call recently often for higher precision.
-    /// Meaning the timer is actually triggered closer to the specified waiting time
-    void update() {
-        m_watchdog.update();
-    }
-#endif // !THINGSBOARD_USE_ESP_TIMER
-
-  private:
-    /// @brief Checks whether the received chunk size matches the expected chunk size, should be the configured chunk size of the OTA_Update_Callback, CHUNK_SIZE (4096) per default
-    /// and it should be the remaining bytes to fill the total firmware size with the last received chunk. If that is not the case then something went wrong with the request and we have to rerequest that specific chunk,
-    /// because if we do not do that we would write missing or only partial binary data to flash and into the hash, meaning the complete OTA update will be invalidated at the end and has to be restarted
-    /// @param received_chunk_size Size in bytes of the received chunk
-    /// @param expected_chunk_size Variable the expected chunk size for the currently requested chunk will be copied into
-    /// @return Whether the received chunk has the expected size or not
-    bool Received_Valid_Chunk_Size(size_t const & received_chunk_size, size_t & expected_chunk_size) {
-        bool const is_last_chunk = m_requested_chunks + 1 >= m_total_chunks;
-        if (is_last_chunk) {
-            size_t const last_chunk_expected_size = m_fw_size % m_fw_callback->Get_Chunk_Size();
-            expected_chunk_size = last_chunk_expected_size;
-            return received_chunk_size == last_chunk_expected_size;
-        }
-        expected_chunk_size = m_fw_callback->Get_Chunk_Size();
-        return received_chunk_size == m_fw_callback->Get_Chunk_Size();
+        Save_Checkpoint();
+        return true;
     }
 
-    /// @brief Restarts or starts the firmware update and its needed components and then requests the first firmware chunk
+    /// @brief Restarts or starts the firmware update and its needed components and then requests the first window of firmware chunks.
+    /// Any previously saved checkpoint is removed, because the already written data is not going to be used anymore
     void Request_First_Firmware_Packet()  {
-        m_requested_chunks = 0U;
+        Clear_Checkpoint();
+        m_written_bytes = 0U;
+        m_fast_chunks = 0U;
+        Set_Chunk_Size(m_chunk_size);
         m_retries = m_fw_callback->Get_Chunk_Retries();
         // Hash start result is ignored, because it can only fail if the input parameters are invalid
         (void)m_hash.start(m_fw_checksum_algorithm);
-        m_watchdog.detach();
+        Cancel_Timeout_Timers();
+        Reset_Window();
         m_fw_updater->reset();
-        Request_Next_Firmware_Packet();
+        Request_Next_Firmware_Packets();
     }
 
-    /// @brief Requests the next firmware chunk of the OTA firmware if there are any left
-    /// and starts the timer that ensures we request the same chunk again if we have not received a response yet
-    void Request_Next_Firmware_Packet()  {
+    /// @brief Attempts to continue the firmware update from the checkpoint saved with the checkpoint storage implementation, restores the hash calculation
+    /// and continues writing at the offset of the last written chunk and then requests the first window of firmware chunks following that chunk.
+    /// Only possible if the checkpoint belongs to the same firmware binary, was created with a chunk size the current update supports and the IUpdater supports resuming
+    /// @return Whether the firmware update is continued from the saved checkpoint, if not it has to be restarted from the first chunk instead
+    bool Resume_Firmware_Update() {
+        IOTA_Checkpoint_Storage * checkpoint_storage = m_fw_callback->Get_Checkpoint_Storage();
+        if (checkpoint_storage == nullptr) {
+            return false;
+        }
+        OTA_Checkpoint checkpoint = {};
+        if (!checkpoint_storage->load(checkpoint)) {
+            return false;
+        }
+
+        uint16_t const chunk_size = checkpoint.chunk_size;
+        bool const same_firmware = strncmp(checkpoint.fw_title, m_fw_title, sizeof(m_fw_title)) == 0 && strncmp(checkpoint.fw_version, m_fw_version, sizeof(m_fw_version)) == 0
+          && strncmp(checkpoint.fw_checksum, m_fw_checksum, sizeof(m_fw_checksum)) == 0 && checkpoint.fw_checksum_algorithm == m_fw_checksum_algorithm && checkpoint.fw_size == m_fw_size;
+        if (!same_firmware || !Is_Supported_Chunk_Size(chunk_size) || checkpoint.committed_chunks == 0U || checkpoint.committed_chunks * chunk_size >= m_fw_size) {
+            return false;
+        }
+        // Checkpoint was saved after the adaptive mode grew the chunk size, the download can only be continued with that chunk size if the client is able to receive chunks of that size
+        if (chunk_size > m_chunk_size && !m_resize_callback.Call_Callback(chunk_size)) {
+            return false;
+        }
+
+        // Result of starting the hash is checked together with the restored state, because restoring requires the context to have been setup for the same type
+        if (!m_hash.start(m_fw_checksum_algorithm) || !m_hash.restore_state(checkpoint.hash_state, checkpoint.hash_state_size)) {
+            return false;
+        }
+        Cancel_Timeout_Timers();
+        Reset_Window();
+        if (!m_fw_updater->resume(m_fw_size, checkpoint.committed_chunks * chunk_size)) {
+            return false;
+        }
+
+    #if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(RESUMING_FW_UPDATE, checkpoint.committed_chunks);
+    #endif // THINGSBOARD_ENABLE_DEBUG
+        bool const changed_chunk_size = chunk_size != m_chunk_size;
+        m_written_bytes = checkpoint.committed_chunks * chunk_size;
+        Set_Chunk_Size(chunk_size);
+        if (changed_chunk_size) {
+            Allocate_Reorder_Buffer();
+        }
+        m_retries = m_fw_callback->Get_Chunk_Retries();
+        Request_Next_Firmware_Packets();
+        return true;
+    }
+
+    /// @brief Saves the progress of the firmware update with the checkpoint storage implementation, if one has been set and the configured checkpoint interval of written chunks has been reached
+    void Save_Checkpoint() {
+        IOTA_Checkpoint_Storage * checkpoint_storage = m_fw_callback->Get_Checkpoint_Storage();
+        uint16_t const checkpoint_interval = m_fw_callback->Get_Checkpoint_Interval();
+        if (checkpoint_storage == nullptr || checkpoint_interval == 0U || (m_next_chunk % checkpoint_interval) != 0U || m_written_bytes >= m_fw_size) {
+            return;
+        }
+
+        OTA_Checkpoint checkpoint = {};
+        checkpoint.hash_state_size = m_hash.save_state(checkpoint.hash_state, sizeof(checkpoint.hash_state));
+        // Saving the hash state is not supported for the used checksum algorithm, meaning the download could not be continued from the checkpoint anyway
+        if (checkpoint.hash_state_size == 0U) {
+            return;
+        }
+        (void)strncpy(checkpoint.fw_title, m_fw_title, sizeof(checkpoint.fw_title) - 1U);
+        (void)strncpy(checkpoint.fw_version, m_fw_version, sizeof(checkpoint.fw_version) - 1U);
+        (void)strncpy(checkpoint.fw_checksum, m_fw_checksum, sizeof(checkpoint.fw_checksum) - 1U);
+        checkpoint.fw_checksum_algorithm = m_fw_checksum_algorithm;
+        checkpoint.fw_size = m_fw_size;
+        checkpoint.chunk_size = m_chunk_size;
+        checkpoint.committed_chunks = m_next_chunk;
+
+        if (!checkpoint_storage->save(checkpoint)) {
+            Logger::printfln(SAVING_CHECKPOINT_FAILED, m_next_chunk);
+        }
+    }
+
+    /// @brief Removes any previously saved checkpoint with the checkpoint storage implementation, if one has been set
+    void Clear_Checkpoint() {
+        IOTA_Checkpoint_Storage * checkpoint_storage = m_fw_callback->Get_Checkpoint_Storage();
+        if (checkpoint_storage != nullptr) {
+            checkpoint_storage->clear();
+        }
+    }
+
+    /// @brief Requests firmware chunks of the OTA firmware until the window of outstanding requests is full or there are no chunks left to request.
+    /// Finishes the update instead if we have already received and handled the last remaining chunk.
+    /// If the adaptive mode decided to change the chunk size, chunks are only requested up to the next offset that is a multiple of the new chunk size and the chunk size is changed once all of them have been written
+    void Request_Next_Firmware_Packets()  {
         // Check if we have already requested and handled the last remaining chunk
-        if (m_requested_chunks >= m_total_chunks) {
-            Finish_Firmware_Update();   
+        if (m_written_bytes >= m_fw_size) {
+            Finish_Firmware_Update();
             return;
         }
 
-        if (!m_publish_callback.Call_Callback(m_fw_callback->Get_Request_ID(), m_requested_chunks)) {
+        if (m_target_chunk_size != m_chunk_size && m_next_chunk == m_next_request && (m_written_bytes % m_target_chunk_size) == 0U) {
+            Apply_Target_Chunk_Size();
+        }
+
+        while (m_next_request < m_total_chunks && m_next_request < m_next_chunk + m_window_size && (m_target_chunk_size == m_chunk_size || ((m_next_request * m_chunk_size) % m_target_chunk_size) != 0U)) {
+            size_t const slot_index = m_next_request % m_window_size;
+            Chunk_Slot & slot = m_slots[slot_index];
+            slot.chunk = m_next_request;
+            slot.size = 0U;
+            slot.data = nullptr;
+            slot.retries = m_fw_callback->Get_Chunk_Retries();
+            m_next_request++;
+            Request_Firmware_Packet(slot_index);
+        }
+    }
+
+    /// @brief Requests the firmware chunk of the given slot and starts the timer that ensures we request the same chunk again if we have not received a response yet
+    /// @param slot_index Index of the slot in the window that contains the chunk that should be requested
+    void Request_Firmware_Packet(size_t const & slot_index)  {
+        m_slots[slot_index].requested = Timer_Wheel::get_time_microseconds();
+        if (!m_publish_callback.Call_Callback(m_fw_callback->Get_Request_ID(), m_slots[slot_index].chunk, m_chunk_size)) {
             Logger::printfln(UNABLE_TO_REQUEST_CHUNCKS);
         }
 
-        // Watchdog gets started no matter if publishing request was successful or not in hopes,
+        // Timeout timer gets started no matter if publishing request was successful or not in hopes,
         // that after the given timeout the callback calls this method again and can then publish the request successfully.
         // This works because the request fails most of the time, because the internet connection might have been temporarily disconnected.
         // Therefore waiting a while and then retrying, means we might be reconnected again
-        m_watchdog.once(m_fw_callback->Get_Timeout());
+        if (m_timer_wheel == nullptr) {
+            return;
+        }
+        (void)m_timer_wheel->cancel(m_timeout_handles[slot_index]);
+        Arm_Timeout_Timer(slot_index);
+        if (m_slots[slot_index].unarmed) {
+            Logger::printfln(UNABLE_TO_ARM_CHUNK_TIMEOUT, m_slots[slot_index].chunk);
+        }
+    }
+
+    /// @brief Arms the timeout timer of the chunk request in the given slot, if that fails the slot is marked so that arming is retried in loop()
+    /// @param slot_index Index of the slot in the window that contains the requested chunk
+    void Arm_Timeout_Timer(size_t const & slot_index) {
+        m_timeout_handles[slot_index] = m_timer_wheel->arm(m_fw_callback->Get_Timeout(), m_timeout_callbacks[slot_index]);
+        m_slots[slot_index].unarmed = m_timeout_handles[slot_index] == INVALID_TIMER_HANDLE;
+    }
+
+    /// @brief Requests all chunks in the current window again, that have been requested but not received yet
+    void Request_Outstanding_Firmware_Packets() {
+        for (size_t chunk = m_next_chunk; chunk < m_next_request; chunk++) {
+            size_t const slot_index = chunk % m_window_size;
+            if (m_slots[slot_index].data == nullptr) {
+                Cancel_Timeout_Timer(slot_index);
+                Request_Firmware_Packet(slot_index);
+            }
+        }
+    }
+
+    /// @brief Allocates the reorder buffer for the configured window size and the current chunk size, which has to be able to hold every chunk in the window besides the one we are currently waiting for.
+    /// If the allocation fails we fall back to a window size of 1, which does not require any reorder buffer, because chunks can then never arrive out of order
+    void Allocate_Reorder_Buffer() {
+        if (!Try_Allocate_Reorder_Buffer()) {
+            Logger::printfln(UNABLE_TO_ALLOCATE_REORDER_BUFFER, (m_window_size - 1U) * m_chunk_size);
+            m_window_size = 1U;
+        }
+    }
+
+    /// @brief Attempts to allocate the reorder buffer for the configured window size and the current chunk size, any previously allocated reorder buffer is freed beforehand
+    /// @return Whether the reorder buffer could be allocated or is not required, because the window only contains one chunk
+    bool Try_Allocate_Reorder_Buffer() {
+        Free_Reorder_Buffer();
+        uint8_t window_size = m_fw_callback->Get_Window_Size();
+        if (window_size > MAX_CHUNK_WINDOW_SIZE) {
+            window_size = MAX_CHUNK_WINDOW_SIZE;
+        }
+        if (window_size > m_total_chunks) {
+            window_size = m_total_chunks;
+        }
+        m_window_size = window_size > 0U ? window_size : 1U;
+        if (m_window_size == 1U) {
+            return true;
+        }
+
+        m_reorder_buffer = Allocator_Policy::Create_Array<uint8_t>((m_window_size - 1U) * m_chunk_size, Memory_Subsystem::OTA);
+        return m_reorder_buffer != nullptr;
+    }
+
+    /// @brief Frees the reorder buffer, should be called once the update has finished because the buffer can be relatively big
+    void Free_Reorder_Buffer() {
+        Allocator_Policy::Destroy_Array(m_reorder_buffer);
+        m_reorder_buffer = nullptr;
+        m_used_buffers = 0U;
+    }
+
+    /// @brief Gets a currently unused chunk sized part of the reorder buffer
+    /// @return Pointer to the start of the unused chunk sized part of the reorder buffer
+    uint8_t * Acquire_Reorder_Buffer() {
+        size_t index = 0U;
+        while ((m_used_buffers & (1U << index)) != 0U) {
+            index++;
+        }
+        m_used_buffers |= (1U << index);
+        return m_reorder_buffer + (index * m_chunk_size);
+    }
+
+    /// @brief Marks the given chunk sized part of the reorder buffer as unused again, so it can be reused for another chunk that arrives out of order
+    /// @param data Pointer to the start of the chunk sized part of the reorder buffer, previously returned by Acquire_Reorder_Buffer
+    void Release_Reorder_Buffer(uint8_t const * data) {
+        size_t const index = (data - m_reorder_buffer) / m_chunk_size;
+        m_used_buffers &= ~(1U << index);
+    }
+
+    /// @brief Discards all buffered chunks and resets the state of all slots in the window
+    void Reset_Window() {
+        for (auto & slot : m_slots) {
+            slot = Chunk_Slot();
+        }
+        m_used_buffers = 0U;
+    }
+
+    /// @brief Cancels the timeout timer of the outstanding chunk request in the given slot
+    /// @param slot_index Index of the slot in the window that contains the chunk whose timer should be cancelled
+    void Cancel_Timeout_Timer(size_t const & slot_index) {
+        m_slots[slot_index].unarmed = false;
+        if (m_timer_wheel == nullptr) {
+            return;
+        }
+        (void)m_timer_wheel->cancel(m_timeout_handles[slot_index]);
+    }
+
+    /// @brief Cancels all currently running timeout timers of the outstanding chunk requests
+    void Cancel_Timeout_Timers() {
+        for (size_t i = 0U; i < MAX_CHUNK_WINDOW_SIZE; i++) {
+            Cancel_Timeout_Timer(i);
+        }
     }
 
     /// @brief Completes the firmware update, which consists of checking the complete hash of the firmware binary if the initally received value,
@@ -223,6 +643,8 @@ class OTA_Handler {
         (void)m_hash.finish(calculated_checksum);
 
         if (strncmp(m_fw_checksum, calculated_checksum, strlen(m_fw_checksum)) != 0) {
+            // Data written since the first chunk is invalid, so continuing from a saved checkpoint would only result in the same invalid checksum again
+            Clear_Checkpoint();
             char message[Helper::detectSize(CHECKSUM_VERIFICATION_FAILED, calculated_checksum, m_fw_checksum)] = {};
             (void)snprintf(message, sizeof(message), CHECKSUM_VERIFICATION_FAILED, calculated_checksum, m_fw_checksum);
             Logger::printfln(message);
@@ -242,6 +664,8 @@ class OTA_Handler {
         Logger::printfln(FW_UPDATE_SUCCESS);
     #endif // THINGSBOARD_ENABLE_DEBUG
 
+        Clear_Checkpoint();
+        Free_Reorder_Buffer();
         (void)m_send_fw_state_callback.Call_Callback(FW_STATE_UPDATING, "");
         m_fw_callback->Call_Callback(true);
         (void)m_finish_callback.Call_Callback();
@@ -253,9 +677,7 @@ class OTA_Handler {
     /// @param error_message Error message that should be printed if we abort the update
     void Handle_Failure(OTA_Failure_Response const & failure_response, char const * error_message)  {
         if (m_retries <= 0) {
-            (void)m_send_fw_state_callback.Call_Callback(FW_STATE_FAILED, error_message);
-            m_fw_callback->Call_Callback(false);
-            (void)m_finish_callback.Call_Callback();
+            Abort_Firmware_Update(error_message);
             return;
         }
 
@@ -265,15 +687,13 @@ class OTA_Handler {
 
         switch (failure_response) {
             case OTA_Failure_Response::RETRY_CHUNK:
-                Request_Next_Firmware_Packet();
+                Request_Outstanding_Firmware_Packets();
                 break;
             case OTA_Failure_Response::RETRY_UPDATE:
                 Request_First_Firmware_Packet();
                 break;
             case OTA_Failure_Response::RETRY_NOTHING:
-                (void)m_send_fw_state_callback.Call_Callback(FW_STATE_FAILED, error_message);
-                m_fw_callback->Call_Callback(false);
-                (void)m_finish_callback.Call_Callback();
+                Abort_Firmware_Update(error_message);
                 break;
             default:
                 // Nothing to do
@@ -281,28 +701,65 @@ class OTA_Handler {
         }
     }
 
-    /// @brief Callback that will be called if we did not receive the firmware chunk response in the given timeout time
-    void Handle_Request_Timeout()  {
+    /// @brief Stops any outstanding chunk request and informs the user and the cloud that the update has failed
+    /// @param error_message Error message that describes why the update failed
+    void Abort_Firmware_Update(char const * error_message) {
+        Cancel_Timeout_Timers();
+        Free_Reorder_Buffer();
+        (void)m_send_fw_state_callback.Call_Callback(FW_STATE_FAILED, error_message);
+        m_fw_callback->Call_Callback(false);
+        (void)m_finish_callback.Call_Callback();
+    }
+
+    /// @brief Callback that will be called if we did not receive the firmware chunk response in the given timeout time.
+    /// Each chunk in the window has its own amount of retries, if they are used up the complete update is aborted. In the adaptive mode the chunk size is additionally halved
+    /// @param slot_index Index of the slot in the window that contains the chunk that timed out
+    void Handle_Request_Timeout(size_t const & slot_index)  {
+        Chunk_Slot & slot = m_slots[slot_index];
         uint64_t const & timeout = m_fw_callback->Get_Timeout();
-        char message[Helper::detectSize(CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout)] = {};
-        (void)snprintf(message, sizeof(message), CHUNK_REQUEST_TIMED_OUT, m_requested_chunks, timeout);
+        char message[Helper::detectSize(CHUNK_REQUEST_TIMED_OUT, slot.chunk, timeout)] = {};
+        (void)snprintf(message, sizeof(message), CHUNK_REQUEST_TIMED_OUT, slot.chunk, timeout);
         Logger::printfln(message);
-        Handle_Failure(OTA_Failure_Response::RETRY_CHUNK, message);
-    }
-
-    const OTA_Update_Callback                              *m_fw_callback = {};                    // Callback method that contains configuration information, about the over the air update
-    Callback<bool, size_t const &, size_t const &>         m_publish_callback = {};                // Callback that is used to request the firmware chunk of the firmware binary with the given chunk number
-    Callback<bool, char const * const, char const * const> m_send_fw_state_callback = {};          // Callback that is used to send information about the current state of the over the air update
-    Callback<bool>                                         m_finish_callback = {};                 // Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
-    size_t                                                 m_fw_size = {};                         // Total size of the firmware binary we will receive. Allows for a binary size of up to theoretically 4 GB
-    char                                                   m_fw_checksum[FIRMWARE_HASH_SIZE] = {}; // Checksum of the complete firmware binary, should be the same as the actually written data in the end
-    mbedtls_md_type_t                                      m_fw_checksum_algorithm = {};           // Algorithm type used to hash the firmware binary
-    IUpdater                                               *m_fw_updater = {};                     // Interface implementation that writes received firmware binary data onto the given device
-    HashGenerator                                          m_hash = {};                            // Class instance that allows to generate a hash from received firmware binary data
-    size_t                                                 m_total_chunks = {};                    // Total amount of chunks that need to be received to get the complete firmware binary
-    size_t                                                 m_requested_chunks = {};                // Amount of successfully requested and received firmware binary chunks
-    uint8_t                                                m_retries = {};                         // Amount of request retries we attempt for each chunk, increasing makes the connection more stable
-    Callback_Watchdog                                      m_watchdog = {};                        // Class instances that allows to timeout if we do not receive a response for a requested chunk in the given time
+
+        if (slot.retries <= 0) {
+            Abort_Firmware_Update(message);
+            return;
+        }
+        slot.retries--;
+        if (Shrink_Chunk_Size()) {
+            return;
+        }
+        Request_Firmware_Packet(slot_index);
+    }
+
+    const OTA_Update_Callback                              *m_fw_callback = {};                             // Callback method that contains configuration information, about the over the air update
+    Callback<bool, size_t const &, size_t const &, uint16_t const &> m_publish_callback = {};               // Callback that is used to request the firmware chunk of the firmware binary with the given chunk number and chunk size
+    Callback<bool, char const * const, char const * const> m_send_fw_state_callback = {};                   // Callback that is used to send information about the current state of the over the air update
+    Callback<bool>                                         m_finish_callback = {};                          // Callback that is called once the update has been finished and the user should be informed of the failure or success of the over the air update
+    Callback<bool, uint16_t const &>                       m_resize_callback = {};                          // Callback that is used to ensure chunks of the given size can be received, before the chunk size is grown
+    char                                                   m_fw_title[MAX_FW_INFO_SIZE] = {};               // Title of the firmware binary we will receive, truncated to the size that is saved in a checkpoint
+    char                                                   m_fw_version[MAX_FW_INFO_SIZE] = {};             // Version of the firmware binary we will receive, truncated to the size that is saved in a checkpoint
+    size_t                                                 m_fw_size = {};                                  // Total size of the firmware binary we will receive. Allows for a binary size of up to theoretically 4 GB
+    char                                                   m_fw_checksum[FIRMWARE_HASH_SIZE] = {};          // Checksum of the complete firmware binary, should be the same as the actually written data in the end
+    mbedtls_md_type_t                                      m_fw_checksum_algorithm = {};                    // Algorithm type used to hash the firmware binary
+    IUpdater                                               *m_fw_updater = {};                              // Interface implementation that writes received firmware binary data onto the given device
+    HashGenerator                                          m_hash = {};                                     // Class instance that allows to generate a hash from received firmware binary data
+    uint16_t                                               m_chunk_size = {};                               // Size of the chunks that are currently requested, only differs from the configured chunk size in the adaptive mode
+    uint16_t                                               m_target_chunk_size = {};                        // Chunk size the adaptive mode decided to change to, applied once the window has been emptied at an offset that is a multiple of it
+    uint16_t                                               m_max_chunk_size = {};                           // Maximum chunk size the adaptive mode may grow to, lowered if growing failed because of insufficient memory
+    uint8_t                                                m_fast_chunks = {};                              // Amount of chunks that arrived well before the timeout after another, the chunk size is grown once it reaches ADAPTIVE_CHUNK_GROWTH_STREAK
+    size_t                                                 m_written_bytes = {};                            // Amount of firmware binary bytes that have been written so far, is the offset the next chunk that has to be written starts at
+    size_t                                                 m_total_chunks = {};                             // Total amount of chunks with the current chunk size that need to be received to get the complete firmware binary
+    size_t                                                 m_next_chunk = {};                               // Amount of written firmware binary chunks with the current chunk size, is the index of the next chunk that has to be written
+    size_t                                                 m_next_request = {};                             // Index of the next chunk that has not been requested yet, every chunk between m_next_chunk and this index is currently in the window
+    uint8_t                                                m_retries = {};                                  // Amount of retries we attempt to restart the update if writing the received data fails, increasing makes the update more stable
+    uint8_t                                                m_window_size = {};                              // Amount of chunk requests that may be outstanding at the same time, clamped to MAX_CHUNK_WINDOW_SIZE and the total amount of chunks
+    uint8_t                                                *m_reorder_buffer = {};                          // Buffer that can hold (m_window_size - 1) chunks, that arrived before all previous chunks have been written
+    uint8_t                                                m_used_buffers = {};                             // Bitmask of the chunk sized parts of the reorder buffer that currently contain a received chunk
+    Chunk_Slot                                             m_slots[MAX_CHUNK_WINDOW_SIZE] = {};             // State of each chunk in the window of outstanding chunk requests, the chunk with index i is always kept in slot i % m_window_size
+    Timer_Wheel                                            *m_timer_wheel = {};                             // Shared timer wheel the timeout timers of the outstanding chunk requests are armed in
+    Callback<void>                                         m_timeout_callbacks[MAX_CHUNK_WINDOW_SIZE] = {}; // Callbacks that are called if we do not receive a response for a requested chunk in the given time, one for each slot in the window
+    Timer_Handle                                           m_timeout_handles[MAX_CHUNK_WINDOW_SIZE] = {};   // Handles of the currently armed timeout timers, one for each slot in the window
 };
 
 #endif // OTA_Handler_h
@@ -6,12 +6,16 @@
 
 // Local includes.
 #include "IUpdater.h"
+#include "IOTA_Checkpoint_Storage.h"
 
 
 // OTA default values.
 uint8_t constexpr CHUNK_RETRIES = 12U;
 uint16_t constexpr CHUNK_SIZE = (4U * 1024U);
 uint64_t constexpr REQUEST_TIMEOUT = (5U * 1000U * 1000U);
+uint8_t constexpr CHUNK_WINDOW_SIZE = 1U;
+uint8_t constexpr MAX_CHUNK_WINDOW_SIZE = 8U;
+uint16_t constexpr CHECKPOINT_INTERVAL = 16U;
 
 
 /// @brief Over the air firmware update callback wrapper,
@@ -45,7 +49,11 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     // because the whole chunk is saved into the heap before it can be processed and is then erased again after it has been used, default = CHUNK_SIZE
     /// @param timeout Maximum amount of time in microseconds for the OTA firmware update for each seperate chunk,
     /// until that chunk counts as a timeout, retries is then subtraced by one and the download is retried, default = REQUEST_TIMEOUT
-    OTA_Update_Callback(char const * current_fw_title, char const * current_fw_version, IUpdater * updater, function finished_callback, Callback<void, size_t const &, size_t const &>::function progress_callback = nullptr, Callback<void>::function update_starting_callback = nullptr, uint8_t chunk_retries = CHUNK_RETRIES, uint16_t chunk_size = CHUNK_SIZE, uint64_t const & timeout_microseconds = REQUEST_TIMEOUT);
+    /// @param window_size Amount of chunks that are requested from the server at the same time, without waiting for the previous chunk to arrive first.
+    /// Increasing the window size hides the round trip time of each chunk request, which massively speeds up the update on connections with a high latency,
+    /// but requires (window_size - 1) * chunk_size additional heap memory, because chunks that arrive out of order have to be buffered until all previous chunks have been written.
+    /// Is clamped to MAX_CHUNK_WINDOW_SIZE, default = CHUNK_WINDOW_SIZE (1), which results in only ever requesting one chunk at a time
+    OTA_Update_Callback(char const * current_fw_title, char const * current_fw_version, IUpdater * updater, function finished_callback, Callback<void, size_t const &, size_t const &>::function progress_callback = nullptr, Callback<void>::function update_starting_callback = nullptr, uint8_t chunk_retries = CHUNK_RETRIES, uint16_t chunk_size = CHUNK_SIZE, uint64_t const & timeout_microseconds = REQUEST_TIMEOUT, uint8_t window_size = CHUNK_WINDOW_SIZE);
 
     /// @brief Gets the current firmware title, used to decide if an OTA firmware update is already installed and therefore should not be downladed,
     /// this is only done if the title of the update and the current firmware title are the same because if they are not then this firmware is meant for another device type
@@ -135,6 +143,18 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     /// @param chunk_size Size of each single chunk to be downloaded
     void Set_Chunk_Size(uint16_t chunk_size);
 
+    /// @brief Gets the maximum size the chunks may grow to in the adaptive mode, which is enabled if the maximum chunk size is at least double the chunk size.
+    /// The update then starts with the conservative chunk size and doubles it whenever multiple chunks after another arrived well before the timeout and the memory for the bigger chunks could be allocated,
+    /// each timeout halves the chunk size again, but it never gets smaller than the chunk size
+    /// @return Maximum size of each single chunk to be downloaded, 0 if the adaptive mode is disabled
+    uint16_t Get_Max_Chunk_Size() const;
+
+    /// @brief Sets the maximum size the chunks may grow to in the adaptive mode, which is enabled if the maximum chunk size is at least double the chunk size.
+    /// The update then starts with the conservative chunk size and doubles it whenever multiple chunks after another arrived well before the timeout and the memory for the bigger chunks could be allocated,
+    /// each timeout halves the chunk size again, but it never gets smaller than the chunk size. Because the chunk size changes during the update, the total amount of chunks passed to the progress callback changes as well
+    /// @param max_chunk_size Maximum size of each single chunk to be downloaded, 0 to disable the adaptive mode, default = 0
+    void Set_Max_Chunk_Size(uint16_t max_chunk_size);
+
     /// @brief Gets the time in microseconds we wait until we declare a single chunk we attempted to download as a failure
     /// @return Timeout time until we expect a response from the server
     uint64_t const & Get_Timeout() const;
@@ -143,6 +163,38 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     /// @param timeout_microseconds Timeout time until we expect a response from the server
     void Set_Timeout(uint64_t const & timeout_microseconds);
 
+    /// @brief Gets the amount of chunks that are requested from the server at the same time, without waiting for the previous chunk to arrive first.
+    /// Increasing the window size hides the round trip time of each chunk request, but requires (window_size - 1) * chunk_size additional heap memory,
+    /// because chunks that arrive out of order have to be buffered until all previous chunks have been written
+    /// @return Amount of chunk requests that may be outstanding at the same time
+    uint8_t Get_Window_Size() const;
+
+    /// @brief Sets the amount of chunks that are requested from the server at the same time, without waiting for the previous chunk to arrive first.
+    /// Increasing the window size hides the round trip time of each chunk request, but requires (window_size - 1) * chunk_size additional heap memory,
+    /// because chunks that arrive out of order have to be buffered until all previous chunks have been written. Is clamped to MAX_CHUNK_WINDOW_SIZE
+    /// @param window_size Amount of chunk requests that may be outstanding at the same time
+    void Set_Window_Size(uint8_t window_size);
+
+    /// @brief Gets the checkpoint storage implementation, used to persist the progress of the ongoing update,
+    /// so that the download can be continued from the last checkpoint instead of the first chunk, if the connection was lost or the device restarted
+    /// @return Checkpoint storage implementation that persists the progress of the update, nullptr if the progress is not persisted
+    IOTA_Checkpoint_Storage * Get_Checkpoint_Storage() const;
+
+    /// @brief Sets the checkpoint storage implementation, used to persist the progress of the ongoing update,
+    /// so that the download can be continued from the last checkpoint instead of the first chunk, if the connection was lost or the device restarted.
+    /// Continuing the download additionally requires the IUpdater implementation to support resume(), if it does not the update is restarted from the first chunk
+    /// @param checkpoint_storage Checkpoint storage implementation that persists the progress of the update, nullptr to not persist the progress, default = nullptr
+    void Set_Checkpoint_Storage(IOTA_Checkpoint_Storage * checkpoint_storage);
+
+    /// @brief Gets the amount of successfully written chunks after which the progress of the update is saved with the checkpoint storage implementation
+    /// @return Amount of chunks between two saved checkpoints
+    uint16_t Get_Checkpoint_Interval() const;
+
+    /// @brief Sets the amount of successfully written chunks after which the progress of the update is saved with the checkpoint storage implementation.
+    /// Decreasing the interval means less chunks have to be downloaded again after an interruption, but increases the amount of writes to persistent memory
+    /// @param checkpoint_interval Amount of chunks between two saved checkpoints, default = CHECKPOINT_INTERVAL
+    void Set_Checkpoint_Interval(uint16_t checkpoint_interval);
+
   private:
     char const                                     *m_current_fw_title = {};        // Current firmware title of device
     char const                                     *m_current_fw_version = {};      // Current firmware version of device
@@ -152,7 +204,11 @@ class OTA_Update_Callback : public Callback<void, bool const &> {
     Callback<void>                                 m_update_starting_callback = {}; // Callback called when update is about to start (moment before topic subscription)
     uint8_t                                        m_chunk_retries = {};            // Maximum amount of retries for a single chunk to be downloaded and flashed successfully
     uint16_t                                       m_chunk_size = {};               // Size of chunks the firmware data will be split into
+    uint16_t                                       m_max_chunk_size = {};           // Maximum size the chunks may grow to in the adaptive mode
     uint64_t                                       m_timeout_microseconds = {};     // How long we wait for each chunck to arrive before declaring it as failed
+    uint8_t                                        m_window_size = {};              // Amount of chunk requests that may be outstanding at the same time
+    IOTA_Checkpoint_Storage                        *m_checkpoint_storage = {};      // Checkpoint storage implementation used to persist the progress of the update
+    uint16_t                                       m_checkpoint_interval = {};      // Amount of chunks between two saved checkpoints
 };
 
 #endif // OTA_Update_Callback_h
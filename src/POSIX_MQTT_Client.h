@@ -0,0 +1,767 @@
+#ifndef POSIX_MQTT_Client_h
+#define POSIX_MQTT_Client_h
+
+// Local include.
+#include "Configuration.h"
+
+#if THINGSBOARD_USE_POSIX_SOCKETS
+
+// Local includes.
+#include "IMQTT_Client.h"
+#include "Allocator_Policy.h"
+
+// Library includes.
+#include <errno.h>
+#include <fcntl.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <poll.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/socket.h>
+#include <time.h>
+#include <unistd.h>
+
+
+// MQTT 3.1.1 control packet types, already shifted into the upper nibble of the first byte of the fixed header,
+// includes the reserved flags that have to be set for SUBSCRIBE and UNSUBSCRIBE (see https://docs.oasis-open.org/mqtt/mqtt/v3.1.1/os/mqtt-v3.1.1-os.html#_Toc398718020)
+uint8_t constexpr MQTT_PACKET_CONNECT = 0x10U;
+uint8_t constexpr MQTT_PACKET_CONNACK = 0x20U;
+uint8_t constexpr MQTT_PACKET_PUBLISH = 0x30U;
+uint8_t constexpr MQTT_PACKET_PUBACK = 0x40U;
+uint8_t constexpr MQTT_PACKET_SUBSCRIBE = 0x82U;
+uint8_t constexpr MQTT_PACKET_SUBACK = 0x90U;
+uint8_t constexpr MQTT_PACKET_UNSUBSCRIBE = 0xA2U;
+uint8_t constexpr MQTT_PACKET_UNSUBACK = 0xB0U;
+uint8_t constexpr MQTT_PACKET_PINGREQ = 0xC0U;
+uint8_t constexpr MQTT_PACKET_PINGRESP = 0xD0U;
+uint8_t constexpr MQTT_PACKET_DISCONNECT = 0xE0U;
+uint8_t constexpr MQTT_PACKET_TYPE_MASK = 0xF0U;
+uint8_t constexpr MQTT_PROTOCOL_LEVEL = 4U;
+uint8_t constexpr MQTT_CONNECT_FLAG_CLEAN_SESSION = 0x02U;
+uint8_t constexpr MQTT_CONNECT_FLAG_PASSWORD = 0x40U;
+uint8_t constexpr MQTT_CONNECT_FLAG_USER_NAME = 0x80U;
+uint8_t constexpr MQTT_SUBACK_FAILURE = 0x80U;
+// Fixed header is the packet type and the remaining length, which is encoded with up to 4 bytes
+size_t constexpr MQTT_MAX_FIXED_HEADER_SIZE = 5U;
+// Protocol name, protocol level, connect flags and keep alive
+size_t constexpr MQTT_CONNECT_VARIABLE_HEADER_SIZE = 10U;
+// Amount of bytes read with a single call to recv, while a packet that is too big for the receive buffer is discarded
+size_t constexpr MQTT_DISCARD_CHUNK_SIZE = 64U;
+// Maximum amount of calls to recv in a single call to loop(), ensures a sender that never stops can not block the loop forever
+size_t constexpr MQTT_MAX_READS_PER_LOOP = 16U;
+int constexpr POSIX_INVALID_SOCKET = -1;
+#ifdef MSG_NOSIGNAL
+// Writing to a connection that was closed by the server would otherwise raise SIGPIPE and terminate the process
+int constexpr POSIX_SEND_FLAGS = MSG_NOSIGNAL;
+#else
+int constexpr POSIX_SEND_FLAGS = 0;
+#endif // MSG_NOSIGNAL
+uint16_t constexpr DEFAULT_MQTT_KEEP_ALIVE = 15U;
+uint32_t constexpr DEFAULT_MQTT_SOCKET_TIMEOUT = 15000U;
+char constexpr MQTT_BUFFERS_NOT_ALLOCATED[] = "Send and receive buffer have to be allocated with set_buffer_size before connecting";
+char constexpr MQTT_SERVER_NOT_SET[] = "Server has to be configured with set_server before connecting";
+char constexpr UNABLE_TO_RESOLVE_SERVER[] = "Unable to resolve server (%s) with error (%s)";
+char constexpr UNABLE_TO_OPEN_CONNECTION[] = "Unable to open connection to server (%s) on port (%u)";
+char constexpr MQTT_CONNECTION_REFUSED[] = "Connection refused by the server with return code (%u)";
+char constexpr MQTT_CONNECTION_TIMEOUT[] = "Did not receive a response from the server within the timeout (%u ms)";
+char constexpr MQTT_KEEP_ALIVE_TIMEOUT[] = "Did not receive a ping response from the server within the keep alive interval (%u s), closing connection";
+char constexpr MQTT_MALFORMED_PACKET[] = "Received malformed packet, closing connection";
+char constexpr MQTT_SUBSCRIBE_REFUSED[] = "Subscribing to a topic was refused by the server";
+char constexpr MQTT_PACKET_EXCEEDS_RECEIVE_BUFFER[] = "Received packet (%u) is bigger than current receive buffer size (%u), increase accordingly";
+char constexpr MQTT_PACKET_EXCEEDS_SEND_BUFFER[] = "Packet (%u) is bigger than current send buffer size (%u), increase accordingly";
+char constexpr MQTT_RECEIVE_BUFFER_TOO_SMALL[] = "Receive buffer size (%u) can not be smaller than the amount of currently received data (%u)";
+
+
+/// @brief MQTT Client interface implementation that speaks MQTT 3.1.1 directly over POSIX sockets, without depending on any further library.
+/// Allows to use the library natively on Linux or other POSIX systems, for example on edge gateways, or to run it against a local broker on a workstation to measure the real throughput.
+/// The socket is non-blocking, all received data is read and the received messages are passed to the data callback in loop(), which therefore has to be called regularly.
+/// Sending waits at most for the configured timeout if the kernel send buffer is full. Messages are published and subscribed with QoS 0, received messages with QoS 1 are acknowledged,
+/// QoS 2 is not supported. The connection is unencrypted, if encryption is required tunnel the connection or use a broker on the same host
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class POSIX_MQTT_Client : public IMQTT_Client {
+  public:
+    /// @brief Constructs a IMQTT_Client implementation without any allocated buffers, they are allocated once set_buffer_size is called, which the ThingsBoard client does in its constructor
+    POSIX_MQTT_Client()
+      : m_received_data_callback()
+      , m_connected_callback()
+      , m_domain(nullptr)
+      , m_port(0U)
+      , m_socket(POSIX_INVALID_SOCKET)
+      , m_connected(false)
+      , m_ping_outstanding(false)
+      , m_processing(false)
+      , m_keep_alive(DEFAULT_MQTT_KEEP_ALIVE)
+      , m_timeout(DEFAULT_MQTT_SOCKET_TIMEOUT)
+      , m_last_inbound(0U)
+      , m_last_outbound(0U)
+      , m_packet_id(0U)
+      , m_receive_buffer(nullptr)
+      , m_retired_receive_buffer(nullptr)
+      , m_receive_buffer_size(0U)
+      , m_receive_length(0U)
+      , m_discard_length(0U)
+      , m_send_buffer(nullptr)
+      , m_send_buffer_size(0U)
+      , m_publish_remaining(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Destructor
+    ~POSIX_MQTT_Client() {
+        Close_Socket();
+        Allocator_Policy::Destroy_Array(m_receive_buffer);
+        Allocator_Policy::Destroy_Array(m_retired_receive_buffer);
+        Allocator_Policy::Destroy_Array(m_send_buffer);
+    }
+
+    POSIX_MQTT_Client(POSIX_MQTT_Client const &) = delete;
+    POSIX_MQTT_Client & operator=(POSIX_MQTT_Client const &) = delete;
+
+    /// @brief Sets the keep alive interval sent to the server when connecting, if no packet was sent or received for that long a ping is sent,
+    /// and if the server does not respond to it within another interval the connection is closed. Has to be called before connect() to be applied
+    /// @param keep_alive Keep alive interval in seconds, 0 disables the keep alive mechanism, default = DEFAULT_MQTT_KEEP_ALIVE (15)
+    void set_keep_alive(uint16_t const & keep_alive) {
+        m_keep_alive = keep_alive;
+    }
+
+    /// @brief Sets the maximum amount of time connecting and sending waits for the server, before the connection is seen as failed
+    /// @param timeout Timeout in milliseconds, default = DEFAULT_MQTT_SOCKET_TIMEOUT (15000)
+    void set_timeout(uint32_t const & timeout) {
+        m_timeout = timeout;
+    }
+
+    void set_data_callback(Callback<void, char *, uint8_t *, unsigned int>::function callback) override {
+        m_received_data_callback.Set_Callback(callback);
+    }
+
+    void set_connect_callback(Callback<void>::function callback) override {
+        m_connected_callback.Set_Callback(callback);
+    }
+
+    bool set_buffer_size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        if (receive_buffer_size < m_receive_length) {
+            Logger::printfln(MQTT_RECEIVE_BUFFER_TOO_SMALL, receive_buffer_size, m_receive_length);
+            return false;
+        }
+        uint8_t * receive_buffer = Allocator_Policy::Create_Array<uint8_t>(receive_buffer_size, Memory_Subsystem::RECEIVE_DOCUMENT);
+        uint8_t * send_buffer = Allocator_Policy::Create_Array<uint8_t>(send_buffer_size, Memory_Subsystem::SEND_BUFFER);
+        if (receive_buffer == nullptr || send_buffer == nullptr) {
+            Allocator_Policy::Destroy_Array(receive_buffer);
+            Allocator_Policy::Destroy_Array(send_buffer);
+            return false;
+        }
+        if (m_receive_length != 0U) {
+            memcpy(receive_buffer, m_receive_buffer, m_receive_length);
+        }
+        // The buffer might be changed by the data callback, for example to receive bigger OTA chunks, while the topic and payload it was called with still point into the current buffer.
+        // Therefore the current buffer is only freed once the callback returned
+        if (m_processing) {
+            Allocator_Policy::Destroy_Array(m_retired_receive_buffer);
+            m_retired_receive_buffer = m_receive_buffer;
+        }
+        else {
+            Allocator_Policy::Destroy_Array(m_receive_buffer);
+        }
+        Allocator_Policy::Destroy_Array(m_send_buffer);
+        m_receive_buffer = receive_buffer;
+        m_receive_buffer_size = receive_buffer_size;
+        m_send_buffer = send_buffer;
+        m_send_buffer_size = send_buffer_size;
+        return true;
+    }
+
+    uint16_t get_receive_buffer_size() override {
+        return m_receive_buffer_size;
+    }
+
+    uint16_t get_send_buffer_size() override {
+        return m_send_buffer_size;
+    }
+
+    void set_server(char const * domain, uint16_t port) override {
+        m_domain = domain;
+        m_port = port;
+    }
+
+    bool connect(char const * client_id, char const * user_name, char const * password) override {
+        if (m_domain == nullptr) {
+            Logger::printfln(MQTT_SERVER_NOT_SET);
+            return false;
+        }
+        else if (m_receive_buffer == nullptr || m_send_buffer == nullptr) {
+            Logger::printfln(MQTT_BUFFERS_NOT_ALLOCATED);
+            return false;
+        }
+        Close_Socket();
+        if (!Open_Socket()) {
+            return false;
+        }
+
+        // The password can only be sent together with a user name (see https://docs.oasis-open.org/mqtt/mqtt/v3.1.1/os/mqtt-v3.1.1-os.html#_Toc398718030)
+        client_id = client_id != nullptr ? client_id : "";
+        password = user_name != nullptr ? password : nullptr;
+        size_t const client_id_length = strlen(client_id);
+        size_t const user_name_length = user_name != nullptr ? strlen(user_name) : 0U;
+        size_t const password_length = password != nullptr ? strlen(password) : 0U;
+        size_t remaining_length = MQTT_CONNECT_VARIABLE_HEADER_SIZE + 2U + client_id_length;
+        uint8_t flags = MQTT_CONNECT_FLAG_CLEAN_SESSION;
+        if (user_name != nullptr) {
+            remaining_length += 2U + user_name_length;
+            flags |= MQTT_CONNECT_FLAG_USER_NAME;
+        }
+        if (password != nullptr) {
+            remaining_length += 2U + password_length;
+            flags |= MQTT_CONNECT_FLAG_PASSWORD;
+        }
+        size_t position = 0U;
+        if (!Begin_Packet(MQTT_PACKET_CONNECT, remaining_length, remaining_length, position)) {
+            Close_Socket();
+            return false;
+        }
+        position += Write_String(m_send_buffer + position, "MQTT", 4U);
+        m_send_buffer[position++] = MQTT_PROTOCOL_LEVEL;
+        m_send_buffer[position++] = flags;
+        m_send_buffer[position++] = static_cast<uint8_t>(m_keep_alive >> 8U);
+        m_send_buffer[position++] = static_cast<uint8_t>(m_keep_alive);
+        position += Write_String(m_send_buffer + position, client_id, client_id_length);
+        if (user_name != nullptr) {
+            position += Write_String(m_send_buffer + position, user_name, user_name_length);
+        }
+        if (password != nullptr) {
+            position += Write_String(m_send_buffer + position, password, password_length);
+        }
+        if (!Send(m_send_buffer, position)) {
+            return false;
+        }
+
+        // Wait for the CONNACK of the server, which sets the connected flag if the connection was accepted or closes the socket if it was refused
+        uint64_t const start = Get_Milliseconds();
+        while (!m_connected && m_socket != POSIX_INVALID_SOCKET) {
+            uint64_t const elapsed = Get_Milliseconds() - start;
+            if (elapsed >= m_timeout || !Wait_For_Socket(POLLIN, m_timeout - elapsed)) {
+                Logger::printfln(MQTT_CONNECTION_TIMEOUT, m_timeout);
+                Close_Socket();
+                return false;
+            }
+            (void)Receive_Available();
+        }
+        if (!m_connected) {
+            return false;
+        }
+        m_last_inbound = m_last_outbound = Get_Milliseconds();
+        m_connected_callback.Call_Callback();
+        return true;
+    }
+
+    void disconnect() override {
+        if (m_connected) {
+            uint8_t const packet[2U] = { MQTT_PACKET_DISCONNECT, 0U };
+            (void)Send(packet, sizeof(packet));
+        }
+        Close_Socket();
+    }
+
+    bool loop() override {
+        if (!m_connected) {
+            return false;
+        }
+        uint64_t const now = Get_Milliseconds();
+        uint64_t const interval = m_keep_alive * 1000ULL;
+        if (interval != 0U && (now - m_last_inbound >= interval || now - m_last_outbound >= interval)) {
+            if (m_ping_outstanding) {
+                Logger::printfln(MQTT_KEEP_ALIVE_TIMEOUT, m_keep_alive);
+                Close_Socket();
+                return false;
+            }
+            uint8_t const packet[2U] = { MQTT_PACKET_PINGREQ, 0U };
+            if (!Send(packet, sizeof(packet))) {
+                return false;
+            }
+            // Gives the server another keep alive interval to respond, before the connection is closed
+            m_last_inbound = now;
+            m_ping_outstanding = true;
+        }
+        return Receive_Available();
+    }
+
+    bool publish(char const * topic, uint8_t const * payload, size_t const & length) override {
+        if (!m_connected) {
+            return false;
+        }
+        size_t const topic_length = strlen(topic);
+        size_t position = 0U;
+        if (!Begin_Packet(MQTT_PACKET_PUBLISH, 2U + topic_length + length, 2U + topic_length + length, position)) {
+            return false;
+        }
+        position += Write_String(m_send_buffer + position, topic, topic_length);
+        if (length != 0U) {
+            memcpy(m_send_buffer + position, payload, length);
+        }
+        return Send(m_send_buffer, position + length);
+    }
+
+    bool subscribe(char const * topic) override {
+        return Send_Subscription(MQTT_PACKET_SUBSCRIBE, topic);
+    }
+
+    bool unsubscribe(char const * topic) override {
+        return Send_Subscription(MQTT_PACKET_UNSUBSCRIBE, topic);
+    }
+
+    bool connected() override {
+        return m_connected;
+    }
+
+    // The streaming publish methods are always available, but only part of the IMQTT_Client interface if THINGSBOARD_ENABLE_STREAM_UTILS is set
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+
+    bool begin_publish(char const * topic, size_t const & length) override {
+        return Begin_Publish(topic, length);
+    }
+
+    bool end_publish() override {
+        return End_Publish();
+    }
+
+    //----------------------------------------------------------------------------
+    // Print interface
+    //----------------------------------------------------------------------------
+
+    size_t write(uint8_t payload_byte) override {
+        return Write_Payload(&payload_byte, 1U);
+    }
+
+    size_t write(uint8_t const * buffer, size_t const & size) override {
+        return Write_Payload(buffer, size);
+    }
+
+#else
+
+    /// @brief Start to publish a message over a given topic, without being restricted to the internal buffer size.
+    /// To use this feature first call begin_publish(), followed by multiple calls to write() and then ending with a call to end_publish()
+    /// @param topic Topic that the message is sent over
+    /// @param length Length of the complete payload in bytes, that will be written with write() afterwards
+    /// @return Whether starting to publish on the given topic was successful or not
+    bool begin_publish(char const * topic, size_t const & length) {
+        return Begin_Publish(topic, length);
+    }
+
+    /// @brief Finishes any publish message started with begin_publish(), closes the connection if less payload was written than announced,
+    /// because the server would otherwise interpret the following packets as part of the payload
+    /// @return Whether the complete packet was sent successfully or not
+    bool end_publish() {
+        return End_Publish();
+    }
+
+    /// @brief Sends a single byte of payload to be published, is meant to be used after having calling begin_publish()
+    /// @param payload_byte Byte containing part of the payload that should be sent
+    /// @return The amount of bytes successfully written
+    size_t write(uint8_t payload_byte) {
+        return Write_Payload(&payload_byte, 1U);
+    }
+
+    /// @brief Sends a buffer containing multiple bytes of payload to be published, is meant to be used after having calling begin_publish().
+    /// Bytes exceeding the length announced in begin_publish() are not sent
+    /// @param buffer Buffer containing part of the payload that should be sent
+    /// @param size Amount of bytes contained in the buffer that should be sent
+    /// @return The amount of bytes successfully written
+    size_t write(uint8_t const * buffer, size_t const & size) {
+        return Write_Payload(buffer, size);
+    }
+
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+  private:
+    /// @brief Gets the time since an arbitrary point in the past, which is not affected by changes to the system time
+    /// @return Monotonic time in milliseconds
+    static uint64_t Get_Milliseconds() {
+        timespec time = {};
+        (void)clock_gettime(CLOCK_MONOTONIC, &time);
+        return static_cast<uint64_t>(time.tv_sec) * 1000ULL + static_cast<uint64_t>(time.tv_nsec) / 1000000ULL;
+    }
+
+    /// @brief Writes the given string with its length as a two byte prefix into the given buffer, like expected by MQTT for all strings
+    /// @param buffer Buffer the string should be written into, has to be big enough to hold the length and the string
+    /// @param string String that should be written, does not have to be null terminated
+    /// @param length Amount of characters in the string
+    /// @return Amount of bytes written into the buffer
+    static size_t Write_String(uint8_t * buffer, char const * string, size_t const & length) {
+        buffer[0U] = static_cast<uint8_t>(length >> 8U);
+        buffer[1U] = static_cast<uint8_t>(length);
+        memcpy(buffer + 2U, string, length);
+        return 2U + length;
+    }
+
+    /// @brief Resolves the configured server and opens a non-blocking connection to the first address that accepts it within the timeout
+    /// @return Whether a connection could be opened or not
+    bool Open_Socket() {
+        char port[6U] = {};
+        (void)snprintf(port, sizeof(port), "%u", m_port);
+        addrinfo hints = {};
+        hints.ai_family = AF_UNSPEC;
+        hints.ai_socktype = SOCK_STREAM;
+        addrinfo * addresses = nullptr;
+        int const error = getaddrinfo(m_domain, port, &hints, &addresses);
+        if (error != 0) {
+            Logger::printfln(UNABLE_TO_RESOLVE_SERVER, m_domain, gai_strerror(error));
+            return false;
+        }
+
+        for (addrinfo * address = addresses; address != nullptr && m_socket == POSIX_INVALID_SOCKET; address = address->ai_next) {
+            int const socket_handle = socket(address->ai_family, address->ai_socktype, address->ai_protocol);
+            if (socket_handle == POSIX_INVALID_SOCKET) {
+                continue;
+            }
+            (void)fcntl(socket_handle, F_SETFL, fcntl(socket_handle, F_GETFL, 0) | O_NONBLOCK);
+            m_socket = socket_handle;
+            if (::connect(socket_handle, address->ai_addr, address->ai_addrlen) == 0) {
+                break;
+            }
+            int socket_error = errno;
+            if (socket_error == EINPROGRESS && Wait_For_Socket(POLLOUT, m_timeout)) {
+                socklen_t error_length = sizeof(socket_error);
+                (void)getsockopt(socket_handle, SOL_SOCKET, SO_ERROR, &socket_error, &error_length);
+                if (socket_error == 0) {
+                    break;
+                }
+            }
+            (void)close(socket_handle);
+            m_socket = POSIX_INVALID_SOCKET;
+        }
+        freeaddrinfo(addresses);
+
+        if (m_socket == POSIX_INVALID_SOCKET) {
+            Logger::printfln(UNABLE_TO_OPEN_CONNECTION, m_domain, m_port);
+            return false;
+        }
+        // Most packets are small and sent at once, waiting to combine them with following packets would only add latency
+        int const enabled = 1;
+        (void)setsockopt(m_socket, IPPROTO_TCP, TCP_NODELAY, &enabled, sizeof(enabled));
+#ifdef SO_NOSIGPIPE
+        (void)setsockopt(m_socket, SOL_SOCKET, SO_NOSIGPIPE, &enabled, sizeof(enabled));
+#endif // SO_NOSIGPIPE
+        return true;
+    }
+
+    /// @brief Closes the socket and resets all state of the connection, received data that has not been processed yet is discarded
+    void Close_Socket() {
+        if (m_socket != POSIX_INVALID_SOCKET) {
+            (void)close(m_socket);
+        }
+        m_socket = POSIX_INVALID_SOCKET;
+        m_connected = false;
+        m_ping_outstanding = false;
+        m_receive_length = 0U;
+        m_discard_length = 0U;
+        m_publish_remaining = 0U;
+    }
+
+    /// @brief Waits until the socket is ready for the given events
+    /// @param events Events that should be waited for, POLLIN to receive or POLLOUT to send
+    /// @param timeout Maximum amount of time to wait in milliseconds
+    /// @return Whether the socket is ready or not, false if the timeout elapsed or the connection failed
+    bool Wait_For_Socket(short const & events, uint64_t const & timeout) const {
+        pollfd descriptor = {};
+        descriptor.fd = m_socket;
+        descriptor.events = events;
+        int result = 0;
+        do {
+            result = poll(&descriptor, 1U, static_cast<int>(timeout));
+        } while (result < 0 && errno == EINTR);
+        return result > 0 && (descriptor.revents & events) != 0;
+    }
+
+    /// @brief Sends the given data completly, waits at most for the configured timeout each time the kernel send buffer is full and closes the connection if sending fails
+    /// @param data Data that should be sent
+    /// @param length Amount of bytes that should be sent
+    /// @return Whether all data was sent or not
+    bool Send(uint8_t const * data, size_t length) {
+        if (m_socket == POSIX_INVALID_SOCKET) {
+            return false;
+        }
+        while (length != 0U) {
+            ssize_t const sent = send(m_socket, data, length, POSIX_SEND_FLAGS);
+            if (sent > 0) {
+                data += sent;
+                length -= static_cast<size_t>(sent);
+                continue;
+            }
+            else if (sent < 0 && errno == EINTR) {
+                continue;
+            }
+            else if (sent < 0 && (errno == EAGAIN || errno == EWOULDBLOCK) && Wait_For_Socket(POLLOUT, m_timeout)) {
+                continue;
+            }
+            Close_Socket();
+            return false;
+        }
+        m_last_outbound = Get_Milliseconds();
+        return true;
+    }
+
+    /// @brief Writes the fixed header of a packet into the send buffer, if the given amount of bytes fits into it afterwards
+    /// @param type Packet type and flags of the fixed header
+    /// @param remaining_length Remaining length of the packet, meaning the variable header and payload
+    /// @param buffered_length Amount of bytes following the fixed header that have to fit into the send buffer
+    /// @param position Position after the fixed header, where the variable header has to be written
+    /// @return Whether the packet fits into the send buffer or not
+    bool Begin_Packet(uint8_t const & type, size_t remaining_length, size_t const & buffered_length, size_t & position) {
+        uint8_t header[MQTT_MAX_FIXED_HEADER_SIZE] = { type };
+        size_t header_length = 1U;
+        do {
+            uint8_t encoded = static_cast<uint8_t>(remaining_length % 128U);
+            remaining_length /= 128U;
+            if (remaining_length != 0U) {
+                encoded |= 0x80U;
+            }
+            header[header_length++] = encoded;
+        } while (remaining_length != 0U && header_length < MQTT_MAX_FIXED_HEADER_SIZE);
+
+        if (header_length + buffered_length > m_send_buffer_size) {
+            Logger::printfln(MQTT_PACKET_EXCEEDS_SEND_BUFFER, header_length + buffered_length, m_send_buffer_size);
+            return false;
+        }
+        memcpy(m_send_buffer, header, header_length);
+        position = header_length;
+        return true;
+    }
+
+    /// @brief Sends a SUBSCRIBE or UNSUBSCRIBE packet for the given topic with QoS 0
+    /// @param type Either MQTT_PACKET_SUBSCRIBE or MQTT_PACKET_UNSUBSCRIBE
+    /// @param topic Topic that should be subscribed or unsubscribed
+    /// @return Whether sending the packet was successful or not
+    bool Send_Subscription(uint8_t const & type, char const * topic) {
+        if (!m_connected) {
+            return false;
+        }
+        size_t const topic_length = strlen(topic);
+        // Packet identifier, topic and for SUBSCRIBE the requested QoS
+        size_t const remaining_length = 2U + 2U + topic_length + (type == MQTT_PACKET_SUBSCRIBE ? 1U : 0U);
+        size_t position = 0U;
+        if (!Begin_Packet(type, remaining_length, remaining_length, position)) {
+            return false;
+        }
+        // Packet identifier 0 is not allowed
+        if (++m_packet_id == 0U) {
+            ++m_packet_id;
+        }
+        m_send_buffer[position++] = static_cast<uint8_t>(m_packet_id >> 8U);
+        m_send_buffer[position++] = static_cast<uint8_t>(m_packet_id);
+        position += Write_String(m_send_buffer + position, topic, topic_length);
+        if (type == MQTT_PACKET_SUBSCRIBE) {
+            m_send_buffer[position++] = 0U;
+        }
+        return Send(m_send_buffer, position);
+    }
+
+    /// @brief Sends the fixed header and topic of a PUBLISH packet, the payload has to be sent with Write_Payload afterwards
+    /// @param topic Topic that the message is sent over
+    /// @param length Length of the complete payload in bytes
+    /// @return Whether sending the header was successful or not
+    bool Begin_Publish(char const * topic, size_t const & length) {
+        if (!m_connected || m_publish_remaining != 0U) {
+            return false;
+        }
+        size_t const topic_length = strlen(topic);
+        size_t position = 0U;
+        if (!Begin_Packet(MQTT_PACKET_PUBLISH, 2U + topic_length + length, 2U + topic_length, position)) {
+            return false;
+        }
+        position += Write_String(m_send_buffer + position, topic, topic_length);
+        if (!Send(m_send_buffer, position)) {
+            return false;
+        }
+        m_publish_remaining = length;
+        return true;
+    }
+
+    /// @brief Sends part of the payload of a packet started with Begin_Publish directly from the given buffer
+    /// @param buffer Buffer containing part of the payload that should be sent
+    /// @param size Amount of bytes contained in the buffer that should be sent
+    /// @return The amount of bytes successfully written
+    size_t Write_Payload(uint8_t const * buffer, size_t size) {
+        size = size < m_publish_remaining ? size : m_publish_remaining;
+        if (size == 0U || !Send(buffer, size)) {
+            return 0U;
+        }
+        m_publish_remaining -= size;
+        return size;
+    }
+
+    /// @brief Finishes a packet started with Begin_Publish
+    /// @return Whether the complete payload was sent or not
+    bool End_Publish() {
+        if (m_publish_remaining != 0U) {
+            Close_Socket();
+            return false;
+        }
+        return m_connected;
+    }
+
+    /// @brief Reads all data that is currently available on the socket into the receive buffer and processes every complete packet
+    /// @return Whether the connection is still open or not
+    bool Receive_Available() {
+        for (size_t reads = 0U; reads < MQTT_MAX_READS_PER_LOOP && m_socket != POSIX_INVALID_SOCKET; ++reads) {
+            ssize_t received = 0;
+            if (m_discard_length != 0U) {
+                uint8_t discarded[MQTT_DISCARD_CHUNK_SIZE] = {};
+                received = recv(m_socket, discarded, m_discard_length < sizeof(discarded) ? m_discard_length : sizeof(discarded), 0);
+                if (received > 0) {
+                    m_discard_length -= static_cast<size_t>(received);
+                }
+            }
+            else {
+                received = recv(m_socket, m_receive_buffer + m_receive_length, m_receive_buffer_size - m_receive_length, 0);
+                if (received > 0) {
+                    m_receive_length += static_cast<size_t>(received);
+                }
+            }
+
+            if (received > 0) {
+                m_last_inbound = Get_Milliseconds();
+                Process_Packets();
+                continue;
+            }
+            else if (received < 0 && errno == EINTR) {
+                continue;
+            }
+            else if (received < 0 && (errno == EAGAIN || errno == EWOULDBLOCK)) {
+                break;
+            }
+            // Connection has been closed by the server or failed
+            Close_Socket();
+        }
+        return m_connected;
+    }
+
+    /// @brief Processes every complete packet at the start of the receive buffer and removes them from it afterwards
+    void Process_Packets() {
+        while (m_receive_length >= 2U && m_discard_length == 0U) {
+            size_t remaining_length = 0U;
+            size_t header_length = 0U;
+            for (size_t i = 1U; i < MQTT_MAX_FIXED_HEADER_SIZE && i < m_receive_length; ++i) {
+                remaining_length |= static_cast<size_t>(m_receive_buffer[i] & 0x7FU) << (7U * (i - 1U));
+                if ((m_receive_buffer[i] & 0x80U) == 0U) {
+                    header_length = i + 1U;
+                    break;
+                }
+            }
+            if (header_length == 0U) {
+                // Remaining length is encoded with more than 4 bytes, which is not allowed, otherwise the rest of the remaining length has simply not been received yet
+                if (m_receive_length >= MQTT_MAX_FIXED_HEADER_SIZE) {
+                    Logger::printfln(MQTT_MALFORMED_PACKET);
+                    Close_Socket();
+                }
+                return;
+            }
+
+            size_t const packet_length = header_length + remaining_length;
+            if (packet_length > m_receive_buffer_size) {
+                Logger::printfln(MQTT_PACKET_EXCEEDS_RECEIVE_BUFFER, packet_length, m_receive_buffer_size);
+                m_discard_length = packet_length - m_receive_length;
+                m_receive_length = 0U;
+                return;
+            }
+            else if (packet_length > m_receive_length) {
+                return;
+            }
+
+            m_processing = true;
+            Handle_Packet(m_receive_buffer[0U], m_receive_buffer + header_length, remaining_length);
+            m_processing = false;
+            Allocator_Policy::Destroy_Array(m_retired_receive_buffer);
+            m_retired_receive_buffer = nullptr;
+
+            // Connection might have been closed while handling the packet, which already discarded all received data
+            if (packet_length >= m_receive_length) {
+                m_receive_length = 0U;
+                return;
+            }
+            m_receive_length -= packet_length;
+            memmove(m_receive_buffer, m_receive_buffer + packet_length, m_receive_length);
+        }
+    }
+
+    /// @brief Handles a single complete packet received from the server
+    /// @param type Packet type and flags of the fixed header
+    /// @param body Variable header and payload of the packet, writeable so that the topic of a PUBLISH packet can be null terminated in place
+    /// @param length Amount of bytes in the body
+    void Handle_Packet(uint8_t const & type, uint8_t * body, size_t const & length) {
+        switch (type & MQTT_PACKET_TYPE_MASK) {
+            case MQTT_PACKET_CONNACK:
+                if (length < 2U) {
+                    break;
+                }
+                else if (body[1U] != 0U) {
+                    Logger::printfln(MQTT_CONNECTION_REFUSED, body[1U]);
+                    Close_Socket();
+                    break;
+                }
+                m_connected = true;
+                m_ping_outstanding = false;
+                break;
+            case MQTT_PACKET_PUBLISH: {
+                uint8_t const qos = (type >> 1U) & 0x03U;
+                if (length < 2U) {
+                    break;
+                }
+                size_t const topic_length = (static_cast<size_t>(body[0U]) << 8U) | body[1U];
+                size_t const payload_start = 2U + topic_length + (qos != 0U ? 2U : 0U);
+                if (payload_start > length) {
+                    break;
+                }
+                uint8_t const packet_id[2U] = { qos != 0U ? body[2U + topic_length] : static_cast<uint8_t>(0U), qos != 0U ? body[3U + topic_length] : static_cast<uint8_t>(0U) };
+                // Moves the topic one byte to the front, over the second byte of its length, which leaves space for the null termination between topic and payload
+                memmove(body + 1U, body + 2U, topic_length);
+                body[1U + topic_length] = '\0';
+                m_received_data_callback.Call_Callback(reinterpret_cast<char *>(body + 1U), body + payload_start, static_cast<unsigned int>(length - payload_start));
+                if (qos == 1U) {
+                    uint8_t const packet[4U] = { MQTT_PACKET_PUBACK, 2U, packet_id[0U], packet_id[1U] };
+                    (void)Send(packet, sizeof(packet));
+                }
+                break;
+            }
+            case MQTT_PACKET_SUBACK:
+                if (length >= 3U && body[length - 1U] == MQTT_SUBACK_FAILURE) {
+                    Logger::printfln(MQTT_SUBSCRIBE_REFUSED);
+                }
+                break;
+            case MQTT_PACKET_PINGRESP:
+                m_ping_outstanding = false;
+                break;
+            default:
+                // PUBACK and UNSUBACK do not require any handling, because we only publish and unsubscribe with QoS 0
+                break;
+        }
+    }
+
+    Callback<void, char *, uint8_t *, unsigned int> m_received_data_callback = {}; // Callback that will be called as soon as the mqtt client receives any data
+    Callback<void>                                  m_connected_callback = {};     // Callback that will be called as soon as the mqtt client has connected
+    char const                                      *m_domain = {};                // Server instance name the client connects to, has to be kept alive by the user like with the other IMQTT_Client implementations
+    uint16_t                                        m_port = {};                   // Port the client connects to
+    int                                             m_socket = {};                 // Handle of the socket the connection uses or POSIX_INVALID_SOCKET if there is none
+    bool                                            m_connected = {};              // Whether the server accepted the connection and it has not been closed since
+    bool                                            m_ping_outstanding = {};       // Whether a ping has been sent that the server did not respond to yet
+    bool                                            m_processing = {};             // Whether a received packet is currently handled and the topic and payload passed to the data callback point into the receive buffer
+    uint16_t                                        m_keep_alive = {};             // Keep alive interval in seconds
+    uint32_t                                        m_timeout = {};                // Maximum amount of time connecting and sending waits for the server in milliseconds
+    uint64_t                                        m_last_inbound = {};           // Time data has last been received in milliseconds
+    uint64_t                                        m_last_outbound = {};          // Time data has last been sent in milliseconds
+    uint16_t                                        m_packet_id = {};              // Packet identifier of the last sent SUBSCRIBE or UNSUBSCRIBE packet
+    uint8_t                                         *m_receive_buffer = {};        // Buffer received data is read into until it contains a complete packet
+    uint8_t                                         *m_retired_receive_buffer = {}; // Previous receive buffer, if it was replaced while a received packet was handled, freed once handling the packet is finished
+    uint16_t                                        m_receive_buffer_size = {};    // Size of the receive buffer, bigger packets are discarded
+    size_t                                          m_receive_length = {};         // Amount of received bytes in the receive buffer, that have not been processed yet
+    size_t                                          m_discard_length = {};         // Amount of bytes that still have to be discarded, because they belong to a packet that was too big for the receive buffer
+    uint8_t                                         *m_send_buffer = {};           // Buffer packets are created in before they are sent
+    uint16_t                                        m_send_buffer_size = {};       // Size of the send buffer, bigger packets can only be sent with begin_publish
+    size_t                                          m_publish_remaining = {};      // Amount of payload bytes that still have to be written to finish the packet started with begin_publish
+};
+
+#endif // THINGSBOARD_USE_POSIX_SOCKETS
+
+#endif // POSIX_MQTT_Client_h
@@ -0,0 +1,252 @@
+#ifndef Pending_Request_Table_h
+#define Pending_Request_Table_h
+
+// Local includes.
+#include "Hash_Index.h"
+
+
+/// @brief Slot of the Pending_Request_Table, maps the request id of a pending request to the position its entry is stored at
+struct Pending_Request_Slot {
+    size_t   request_id = {};               // Request id the entry was inserted with
+    uint16_t entry = HASH_INDEX_EMPTY_SLOT; // Position of the entry in the container of entries or HASH_INDEX_EMPTY_SLOT if the slot is unused
+};
+
+
+/// @brief Table of requests that wait for a response from the server, keyed by the request id the request was sent with.
+/// Entries are stored in a seperate container and never moved once inserted, removed entries leave a gap that is reused by the next inserted entry.
+/// The request ids are mapped to the entries with an open addressed hash table using linear probing, where removing an entry moves the following colliding slots back,
+/// instead of leaving a marker in the removed slot. Therefore inserting, searching and removing an entry is O(1) independent of the amount of pending requests,
+/// in comparison to searching the request id linearly and then erasing the entry from the middle of the container, which moves every following entry
+/// @tparam T Type of the stored entries, has to be default constructible and copy assignable
+#if THINGSBOARD_ENABLE_DYNAMIC
+template <typename T>
+#else
+/// @tparam MaxRequests Maximum amount of simultaneously pending requests.
+/// Once the maximum amount has been reached it is not possible to increase the size, this is done because it allows to allcoate the memory on the stack instead of the heap
+template <typename T, size_t MaxRequests>
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+class Pending_Request_Table {
+  public:
+    /// @brief Constructor
+    Pending_Request_Table()
+      : m_entries()
+      , m_free_entries()
+      , m_free_amount(0U)
+      , m_slots()
+      , m_shift(0U)
+      , m_size(0U)
+    {
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        reset_slots(Get_Hash_Index_Slot_Amount(MaxRequests));
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+    }
+
+    /// @brief Gets the amount of pending requests
+    /// @return Amount of inserted entries
+    size_t size() const {
+        return m_size;
+    }
+
+    /// @brief Whether there are no pending requests
+    /// @return Whether the table is empty or not
+    bool empty() const {
+        return m_size == 0U;
+    }
+
+#if !THINGSBOARD_ENABLE_DYNAMIC
+    /// @brief Gets the maximum amount of pending requests
+    /// @return Maximum amount of entries that can be inserted
+    size_t constexpr capacity() const {
+        return MaxRequests;
+    }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+
+    /// @brief Copies the given entry into the table, replacing the entry previously inserted with the same request id
+    /// @param request_id Request id the request has been sent with and the response will be received with
+    /// @param entry Entry that should be copied into the table
+    /// @return Pointer to the copied entry, which stays valid until it is removed or further entries are inserted, or nullptr if the table is full
+    T * insert(size_t const & request_id, T const & entry) {
+        (void)remove(request_id);
+#if THINGSBOARD_ENABLE_DYNAMIC
+        // Keep the table atmost half full, so that the probe sequences stay short
+        if (2U * (m_size + 1U) > m_slots.size()) {
+            grow();
+        }
+#else
+        if (m_size >= MaxRequests) {
+            return nullptr;
+        }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+        uint16_t position = HASH_INDEX_EMPTY_SLOT;
+        if (m_free_amount > 0U) {
+            position = m_free_entries[--m_free_amount];
+            m_entries[position] = entry;
+        }
+        else {
+            m_entries.push_back(entry);
+            position = m_entries.size() - 1U;
+        }
+        place(request_id, position);
+        m_size++;
+        return &m_entries[position];
+    }
+
+    /// @brief Searches the entry that has been inserted with the given request id
+    /// @param request_id Request id the response has been received with
+    /// @return Pointer to the matching entry or nullptr if there is none
+    T * find(size_t const & request_id) {
+        size_t const slot = find_slot(request_id);
+        if (slot == m_slots.size()) {
+            return nullptr;
+        }
+        return &m_entries[m_slots[slot].entry];
+    }
+
+    /// @brief Removes the entry that has been inserted with the given request id
+    /// @param request_id Request id the entry has been inserted with
+    /// @return Whether an entry with the given request id existed and has been removed
+    bool remove(size_t const & request_id) {
+        size_t hole = find_slot(request_id);
+        size_t const slot_amount = m_slots.size();
+        if (hole == slot_amount) {
+            return false;
+        }
+        uint16_t const position = m_slots[hole].entry;
+        // Release everything the removed entry still holds, instead of keeping it alive until the gap is reused
+        m_entries[position] = T();
+        if (m_free_amount < m_free_entries.size()) {
+            m_free_entries[m_free_amount] = position;
+        }
+        else {
+            m_free_entries.push_back(position);
+        }
+        m_free_amount++;
+        m_size--;
+
+        // Move following slots back into the hole, if the hole is between the slot they would have been placed into and the slot they are in
+        size_t next = (hole + 1U) & (slot_amount - 1U);
+        while (m_slots[next].entry != HASH_INDEX_EMPTY_SLOT) {
+            size_t const home = get_slot(m_slots[next].request_id);
+            if (((next - home) & (slot_amount - 1U)) >= ((next - hole) & (slot_amount - 1U))) {
+                m_slots[hole] = m_slots[next];
+                hole = next;
+            }
+            next = (next + 1U) & (slot_amount - 1U);
+        }
+        m_slots[hole] = Pending_Request_Slot();
+        return true;
+    }
+
+    /// @brief Calls the given function for every pending request, in no particular order
+    /// @tparam Function Function that receives a reference to an entry
+    /// @param function Function that should be called for every entry, may not insert or remove entries
+    template <typename Function>
+    void for_each(Function function) {
+        for (auto const & slot : m_slots) {
+            if (slot.entry != HASH_INDEX_EMPTY_SLOT) {
+                function(m_entries[slot.entry]);
+            }
+        }
+    }
+
+    /// @brief Removes all pending requests
+    void clear() {
+        m_entries.clear();
+        m_free_entries.clear();
+        m_free_amount = 0U;
+        m_size = 0U;
+#if THINGSBOARD_ENABLE_DYNAMIC
+        m_slots.clear();
+        m_shift = 0U;
+#else
+        for (auto & slot : m_slots) {
+            slot = Pending_Request_Slot();
+        }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    }
+
+  private:
+    /// @brief Calculates the first slot a request id is placed into, request ids are increasing sequentially, which Fibonacci hashing spreads evenly over all slots
+    /// @param request_id Request id of the entry
+    /// @return Position of the slot the entry is placed into, if it is not used yet
+    size_t get_slot(size_t const & request_id) const {
+        return static_cast<uint32_t>(static_cast<uint32_t>(request_id) * HASH_INDEX_MULTIPLIER) >> m_shift;
+    }
+
+    /// @brief Searches the slot containing the given request id
+    /// @param request_id Request id that should be searched
+    /// @return Position of the matching slot or the amount of slots if there is none
+    size_t find_slot(size_t const & request_id) const {
+        size_t const slot_amount = m_slots.size();
+        if (m_size == 0U) {
+            return slot_amount;
+        }
+        for (size_t position = get_slot(request_id); m_slots[position].entry != HASH_INDEX_EMPTY_SLOT; position = (position + 1U) & (slot_amount - 1U)) {
+            if (m_slots[position].request_id == request_id) {
+                return position;
+            }
+        }
+        return slot_amount;
+    }
+
+    /// @brief Places the given request id into the first unused slot, starting at the slot it maps to
+    /// @param request_id Request id of the entry
+    /// @param entry Position of the entry in the container of entries
+    void place(size_t const & request_id, uint16_t const & entry) {
+        size_t const slot_amount = m_slots.size();
+        size_t position = get_slot(request_id);
+        while (m_slots[position].entry != HASH_INDEX_EMPTY_SLOT) {
+            position = (position + 1U) & (slot_amount - 1U);
+        }
+        m_slots[position].request_id = request_id;
+        m_slots[position].entry = entry;
+    }
+
+    /// @brief Replaces all slots with the given amount of unused slots
+    /// @param slot_amount Amount of slots, has to be a power of two
+    void reset_slots(size_t const & slot_amount) {
+        m_slots.clear();
+        for (size_t i = 0U; i < slot_amount; ++i) {
+            m_slots.push_back(Pending_Request_Slot());
+        }
+        m_shift = 32U;
+        for (size_t slots = slot_amount; slots > 1U; slots >>= 1U) {
+            m_shift--;
+        }
+    }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @brief Doubles the amount of slots and places all pending requests again, the entries themselves are not moved
+    void grow() {
+        Vector<Pending_Request_Slot> used_slots = {};
+        for (auto const & slot : m_slots) {
+            if (slot.entry != HASH_INDEX_EMPTY_SLOT) {
+                used_slots.push_back(slot);
+            }
+        }
+        reset_slots(Get_Hash_Index_Slot_Amount(m_size + 1U));
+        for (auto const & slot : used_slots) {
+            place(slot.request_id, slot.entry);
+        }
+    }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<T>                                                           m_entries = {};      // Entries of the pending requests, including gaps of removed entries
+    Vector<uint16_t>                                                    m_free_entries = {}; // Positions of the gaps left by removed entries
+#else
+    Array<T, MaxRequests>                                               m_entries = {};      // Entries of the pending requests, including gaps of removed entries
+    Array<uint16_t, MaxRequests>                                        m_free_entries = {}; // Positions of the gaps left by removed entries
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    size_t                                                              m_free_amount = {};  // Amount of positions in the container of gaps that are currently valid
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Pending_Request_Slot>                                        m_slots = {};        // Slots of the table, the amount is always a power of two
+#else
+    Array<Pending_Request_Slot, Get_Hash_Index_Slot_Amount(MaxRequests)> m_slots = {};       // Slots of the table, the amount is always a power of two
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    uint8_t                                                             m_shift = {};        // Amount of bits the multiplied request id is shifted, so that only the bits required to address all slots remain
+    size_t                                                              m_size = {};         // Amount of pending requests
+};
+
+#endif // Pending_Request_Table_h
@@ -87,8 +87,16 @@ class Provision : public IAPI_Implementation {
         }
         request_buffer[PROV_DEVICE_KEY] = provision_device_key;
         request_buffer[PROV_DEVICE_SECRET_KEY] = provision_device_secret;
-        m_provision_callback.Start_Timeout_Timer();
-        return m_send_json_callback.Call_Callback(PROV_REQUEST_TOPIC, request_buffer, Helper::Measure_Json(request_buffer));
+
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
+        if (timer_wheel == nullptr) {
+            Logger::printfln(TIMER_WHEEL_NULL);
+            return false;
+        }
+        if (!m_provision_callback.Start_Timeout_Timer(*timer_wheel)) {
+            Logger::printfln(UNABLE_TO_ARM_TIMEOUT_TIMER);
+        }
+        return m_client_context->Send_Json(PROV_REQUEST_TOPIC, request_buffer, Helper::Measure_Json(request_buffer));
     }
 
     API_Process_Type Get_Process_Type() const override {
@@ -100,13 +108,20 @@ class Provision : public IAPI_Implementation {
     }
 
     void Process_Json_Response(char const * topic, JsonDocument const & data) override {
-        m_provision_callback.Stop_Timeout_Timer();
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
+        if (timer_wheel != nullptr) {
+            m_provision_callback.Stop_Timeout_Timer(*timer_wheel);
+        }
         m_provision_callback.Call_Callback(data);
         // Unsubscribe from the provision response topic,
         // Will be resubscribed if another request is sent anyway
         (void)Provision_Unsubscribe();
     }
 
+    char const * Get_Response_Topic_Prefix() const override {
+        return PROV_RESPONSE_TOPIC;
+    }
+
     bool Compare_Response_Topic(char const * topic) const override {
         return strncmp(PROV_RESPONSE_TOPIC, topic, strlen(PROV_RESPONSE_TOPIC) + 1) == 0;
     }
@@ -118,25 +133,21 @@ class Provision : public IAPI_Implementation {
     bool Resubscribe_Topic() override {
         // Unsubscription required only if we are currently subscribed to the topic
         if (m_provision_callback.Get_Device_Key() != nullptr) {
-            return Unsubscribe() && m_subscribe_topic_callback.Call_Callback(PROV_RESPONSE_TOPIC);
+            return Unsubscribe() && m_client_context->Subscribe_Topic(PROV_RESPONSE_TOPIC);
         }
         return true;
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
-        m_provision_callback.Update_Timeout_Timer();
+        // Nothing to do
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
     }
 
-    void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
-        m_send_json_callback.Set_Callback(send_json_callback);
-        m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
-        m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
+    void Set_Client_Context(IAPI_Client_Context & context) override {
+        m_client_context = &context;
     }
 
 private:
@@ -145,7 +156,7 @@ private:
     /// @param callback Callback method that will be called
     /// @return Whether requesting the given callback was successful or not
     bool Provision_Subscribe(Provision_Callback const & callback) {
-        if (!m_subscribe_topic_callback.Call_Callback(PROV_RESPONSE_TOPIC)) {
+        if (!m_client_context->Subscribe_Topic(PROV_RESPONSE_TOPIC)) {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, PROV_RESPONSE_TOPIC);
             return false;
         }
@@ -157,13 +168,15 @@ private:
     /// @return Whether unsubcribing the previously subscribed callback
     /// and from the provision response topic, was successful or not
     bool Provision_Unsubscribe() {
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
+        if (timer_wheel != nullptr) {
+            m_provision_callback.Stop_Timeout_Timer(*timer_wheel);
+        }
         m_provision_callback = Provision_Callback();
-        return m_unsubscribe_topic_callback.Call_Callback(PROV_RESPONSE_TOPIC);
+        return m_client_context->Unsubscribe_Topic(PROV_RESPONSE_TOPIC);
     }
 
-    Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};         // Send json document callback
-    Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};   // Subscribe mqtt topic client callback
-    Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {}; // Unubscribe mqtt topic client callback
+    IAPI_Client_Context *                                                    m_client_context = &Unbound_Client_Context::Get_Instance(); // Non-owning pointer to the client this API implementation communicates with the cloud over
 
     Provision_Callback                                                       m_provision_callback = {};         // Provision response callback
 };
@@ -5,7 +5,7 @@ constexpr char ACCESS_TOKEN_CRED_TYPE[] = "ACCESS_TOKEN";
 constexpr char MQTT_BASIC_CRED_TYPE[] = "MQTT_BASIC";
 constexpr char X509_CERTIFICATE_CRED_TYPE[] = "X509_CERTIFICATE";
 
-Provision_Callback::Provision_Callback(Access_Token, function callback, char const * provision_device_key, char const * provision_device_secret, char const * device_name, uint64_t const & timeout_microseconds, Callback_Watchdog::function timeout_callback)
+Provision_Callback::Provision_Callback(Access_Token, function callback, char const * provision_device_key, char const * provision_device_secret, char const * device_name, uint64_t const & timeout_microseconds, Callback<void>::function timeout_callback)
   : Callback(callback)
   , m_device_key(provision_device_key)
   , m_device_secret(provision_device_secret)
@@ -16,13 +16,14 @@ Provision_Callback::Provision_Callback(Access_Token, function callback, char con
   , m_cred_client_id(nullptr)
   , m_hash(nullptr)
   , m_credentials_type(nullptr)
-  , m_timeout_microseconds(0U)
-  , m_timeout_callback()
+  , m_timeout_microseconds(timeout_microseconds)
+  , m_timeout_callback(timeout_callback)
+  , m_timeout_handle(INVALID_TIMER_HANDLE)
 {
     // Nothing to do
 }
 
-Provision_Callback::Provision_Callback(Device_Access_Token, function callback, char const * provision_device_key, char const * provision_device_secret, char const * access_token, char const * device_name, uint64_t const & timeout_microseconds, Callback_Watchdog::function timeout_callback)
+Provision_Callback::Provision_Callback(Device_Access_Token, function callback, char const * provision_device_key, char const * provision_device_secret, char const * access_token, char const * device_name, uint64_t const & timeout_microseconds, Callback<void>::function timeout_callback)
   : Callback(callback)
   , m_device_key(provision_device_key)
   , m_device_secret(provision_device_secret)
@@ -33,13 +34,14 @@ Provision_Callback::Provision_Callback(Device_Access_Token, function callback, c
   , m_cred_client_id(nullptr)
   , m_hash(nullptr)
   , m_credentials_type(ACCESS_TOKEN_CRED_TYPE)
-  , m_timeout_microseconds(0U)
-  , m_timeout_callback()
+  , m_timeout_microseconds(timeout_microseconds)
+  , m_timeout_callback(timeout_callback)
+  , m_timeout_handle(INVALID_TIMER_HANDLE)
 {
     // Nothing to do
 }
 
-Provision_Callback::Provision_Callback(Basic_MQTT_Credentials, function callback, char const * provision_device_key, char const * provision_device_secret, char const * username, char const * password, char const * client_id, char const * device_name, uint64_t const & timeout_microseconds, Callback_Watchdog::function timeout_callback)
+Provision_Callback::Provision_Callback(Basic_MQTT_Credentials, function callback, char const * provision_device_key, char const * provision_device_secret, char const * username, char const * password, char const * client_id, char const * device_name, uint64_t const & timeout_microseconds, Callback<void>::function timeout_callback)
   : Callback(callback)
   , m_device_key(provision_device_key)
   , m_device_secret(provision_device_secret)
@@ -50,13 +52,14 @@ Provision_Callback::Provision_Callback(Basic_MQTT_Credentials, function callback
   , m_cred_client_id(client_id)
   , m_hash(nullptr)
   , m_credentials_type(MQTT_BASIC_CRED_TYPE)
-  , m_timeout_microseconds(0U)
-  , m_timeout_callback()
+  , m_timeout_microseconds(timeout_microseconds)
+  , m_timeout_callback(timeout_callback)
+  , m_timeout_handle(INVALID_TIMER_HANDLE)
 {
     // Nothing to do
 }
 
-Provision_Callback::Provision_Callback(X509_Certificate, function callback, char const * provision_device_key, char const * provision_device_secret, char const * hash, char const * device_name, uint64_t const & timeout_microseconds, Callback_Watchdog::function timeout_callback)
+Provision_Callback::Provision_Callback(X509_Certificate, function callback, char const * provision_device_key, char const * provision_device_secret, char const * hash, char const * device_name, uint64_t const & timeout_microseconds, Callback<void>::function timeout_callback)
   : Callback(callback)
   , m_device_key(provision_device_key)
   , m_device_secret(provision_device_secret)
@@ -67,8 +70,9 @@ Provision_Callback::Provision_Callback(X509_Certificate, function callback, char
   , m_cred_client_id(nullptr)
   , m_hash(hash)
   , m_credentials_type(X509_CERTIFICATE_CRED_TYPE)
-  , m_timeout_microseconds(0U)
-  , m_timeout_callback()
+  , m_timeout_microseconds(timeout_microseconds)
+  , m_timeout_callback(timeout_callback)
+  , m_timeout_handle(INVALID_TIMER_HANDLE)
 {
     // Nothing to do
 }
@@ -149,23 +153,19 @@ void Provision_Callback::Set_Timeout(uint64_t const & timeout_microseconds) {
     m_timeout_microseconds = timeout_microseconds;
 }
 
-#if !THINGSBOARD_USE_ESP_TIMER
-void Provision_Callback::Update_Timeout_Timer() {
-    m_timeout_callback.update();
-}
-#endif // !THINGSBOARD_USE_ESP_TIMER
-
-void Provision_Callback::Start_Timeout_Timer() {
+bool Provision_Callback::Start_Timeout_Timer(Timer_Wheel & timer_wheel) {
     if (m_timeout_microseconds == 0U) {
-        return;
+        return true;
     }
-    m_timeout_callback.once(m_timeout_microseconds);
+    (void)timer_wheel.cancel(m_timeout_handle);
+    m_timeout_handle = timer_wheel.arm(m_timeout_microseconds, m_timeout_callback);
+    return m_timeout_handle != INVALID_TIMER_HANDLE;
 }
 
-void Provision_Callback::Stop_Timeout_Timer() {
-    m_timeout_callback.detach();
+void Provision_Callback::Stop_Timeout_Timer(Timer_Wheel & timer_wheel) {
+    (void)timer_wheel.cancel(m_timeout_handle);
 }
 
-void Provision_Callback::Set_Timeout_Callback(Callback_Watchdog::function timeout_callback) {
+void Provision_Callback::Set_Timeout_Callback(Callback<void>::function timeout_callback) {
     m_timeout_callback.Set_Callback(timeout_callback);
 }
@@ -2,7 +2,7 @@
 #define Provision_Callback_h
 
 // Local includes.
-#include "Callback_Watchdog.h"
+#include "Timer_Wheel.h"
 
 
 // Struct dispatch tags, to differentiate between constructors, allows the same paramter types to be passed
@@ -28,7 +28,7 @@ class Provision_Callback : public Callback<void, JsonDocument const &> {
     /// @param provision_device_secret Device profile provisioning secret of the device profile that should be used to create the device under
     /// @param device_name Name the created device should have on the cloud,
     /// pass nullptr or an empty string if a random string should be used as a name instead
-    Provision_Callback(Access_Token, function callback, char const * provision_device_key, char const * provision_device_secret, char const * device_name = nullptr, uint64_t const & timeout_microseconds = 0U, Callback_Watchdog::function timeout_callback = nullptr);
+    Provision_Callback(Access_Token, function callback, char const * provision_device_key, char const * provision_device_secret, char const * device_name = nullptr, uint64_t const & timeout_microseconds = 0U, Callback<void>::function timeout_callback = nullptr);
 
     /// @brief Constructs callback that will be fired upon a provision request arrival,
     /// where the requested credentials were sent by the cloud and received by the client.
@@ -43,7 +43,7 @@ class Provision_Callback : public Callback<void, JsonDocument const &> {
     /// If the value is 0 we will not start the timer and therefore never call the timeout callback method, default = 0
     /// @param timeout_callback Optional callback method that will be called upon request timeout (did not receive a response in the given timeout time). Can happen if the requested method does not exist on the cloud,
     /// or if the connection could not be established, default = nullptr
-    Provision_Callback(Device_Access_Token, function callback, char const * provision_device_key, char const * provision_device_secret, char const * access_token, char const * device_name = nullptr, uint64_t const & timeout_microseconds = 0U, Callback_Watchdog::function timeout_callback = nullptr);
+    Provision_Callback(Device_Access_Token, function callback, char const * provision_device_key, char const * provision_device_secret, char const * access_token, char const * device_name = nullptr, uint64_t const & timeout_microseconds = 0U, Callback<void>::function timeout_callback = nullptr);
 
     /// @brief Constructs callback that will be fired upon a provision request arrival,
     /// where the requested credentials were sent by the cloud and received by the client.
@@ -60,7 +60,7 @@ class Provision_Callback : public Callback<void, JsonDocument const &> {
     /// If the value is 0 we will not start the timer and therefore never call the timeout callback method, default = 0
     /// @param timeout_callback Optional callback method that will be called upon request timeout (did not receive a response in the given timeout time). Can happen if the requested method does not exist on the cloud,
     /// or if the connection could not be established, default = nullptr
-    Provision_Callback(Basic_MQTT_Credentials, function callback, char const * provision_device_key, char const * provision_device_secret, char const * username, char const * password, char const * client_id, char const * device_name = nullptr, uint64_t const & timeout_microseconds = 0U, Callback_Watchdog::function timeout_callback = nullptr);
+    Provision_Callback(Basic_MQTT_Credentials, function callback, char const * provision_device_key, char const * provision_device_secret, char const * username, char const * password, char const * client_id, char const * device_name = nullptr, uint64_t const & timeout_microseconds = 0U, Callback<void>::function timeout_callback = nullptr);
 
     /// @brief Constructs callback that will be fired upon a provision request arrival,
     /// where the requested credentials were sent by the cloud and received by the client.
@@ -75,7 +75,7 @@ class Provision_Callback : public Callback<void, JsonDocument const &> {
     /// If the value is 0 we will not start the timer and therefore never call the timeout callback method, default = 0
     /// @param timeout_callback Optional callback method that will be called upon request timeout (did not receive a response in the given timeout time). Can happen if the requested method does not exist on the cloud,
     /// or if the connection could not be established, default = nullptr
-    Provision_Callback(X509_Certificate, function callback, char const * provision_device_key, char const * provision_device_secret, char const * hash, char const * device_name = nullptr, uint64_t const & timeout_microseconds = 0U, Callback_Watchdog::function timeout_callback = nullptr);
+    Provision_Callback(X509_Certificate, function callback, char const * provision_device_key, char const * provision_device_secret, char const * hash, char const * device_name = nullptr, uint64_t const & timeout_microseconds = 0U, Callback<void>::function timeout_callback = nullptr);
 
     /// @brief Gets the device profile provisioning key of the device profile,
     /// that should be used to create the device under
@@ -164,22 +164,20 @@ class Provision_Callback : public Callback<void, JsonDocument const &> {
     /// @param timeout_microseconds Timeout time until timeout callback is called
     void Set_Timeout(uint64_t const & timeout_microseconds);
 
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Updates the internal timeout timer
-    void Update_Timeout_Timer();
-#endif // !THINGSBOARD_USE_ESP_TIMER
-
-    /// @brief Starts the internal timeout timer if we actually received a configured valid timeout time and a valid callback.
+    /// @brief Arms the timeout timer in the given shared timer wheel, if we actually received a configured valid timeout time.
     /// Is called as soon as the request is actually sent
-    void Start_Timeout_Timer();
+    /// @param timer_wheel Timer wheel that is shared by all requests and calls the timeout callback if the timer is not stopped in time
+    /// @return Whether the timer was armed or no timer was required, false if the timer wheel had no space for another timer
+    bool Start_Timeout_Timer(Timer_Wheel & timer_wheel);
 
-    /// @brief Stops the internal timeout timer, is called as soon as an answer is received from the cloud
+    /// @brief Cancels the timeout timer in the given shared timer wheel, is called as soon as an answer is received from the cloud
     /// if it isn't we call the previously subscribed callback instead
-    void Stop_Timeout_Timer();
+    /// @param timer_wheel Timer wheel the timeout timer was previously armed in
+    void Stop_Timeout_Timer(Timer_Wheel & timer_wheel);
 
     /// @brief Sets the callback method that will be called upon request timeout (did not receive a response in the given timeout time)
     /// @param timeout_callback Callback function that will be called
-    void Set_Timeout_Callback(Callback_Watchdog::function timeout_callback);
+    void Set_Timeout_Callback(Callback<void>::function timeout_callback);
 
   private:
     char const        *m_device_key = {};          // Device profile provisioning key
@@ -192,7 +190,8 @@ class Provision_Callback : public Callback<void, JsonDocument const &> {
     char const        *m_hash = {};                // X.509 certificate hash, if the X.509 certificate authentication method is used
     char const        *m_credentials_type = {};    // Credentials type we are requesting from the server, nullptr for the default option (Credentials generated by the ThingsBoard server)
     uint64_t          m_timeout_microseconds = {}; // Timeout time until we expect response to request
-    Callback_Watchdog m_timeout_callback = {};     // Handles callback that will be called if request times out
+    Callback<void>    m_timeout_callback = {};     // Callback that will be called if request times out
+    Timer_Handle      m_timeout_handle = {};       // Handle of the timeout timer armed in the shared timer wheel
 };
 
 #endif // Provision_Callback_h
@@ -0,0 +1,119 @@
+#ifndef RAM_Telemetry_Spool_h
+#define RAM_Telemetry_Spool_h
+
+// Local include.
+#include "ITelemetry_Spool.h"
+
+// Library include.
+#include <string.h>
+
+
+size_t constexpr RAM_SPOOL_LENGTH_SIZE = sizeof(uint16_t);
+
+
+/// @brief ITelemetry_Spool implementation that stores the records in a ring buffer in RAM, which is passed to the constructor and therefore can be allocated on the stack or the heap.
+/// Each record is prefixed with its length and can wrap around the end of the buffer. If there is not enough space left for a new record,
+/// the oldest records are removed until there is, because for long disconnects the most recent data is assumed to be more relevant than the oldest data.
+/// The stored records do not survive a restart of the device, use a file based spool like SDCard_Telemetry_Spool instead if that is required
+class RAM_Telemetry_Spool : public ITelemetry_Spool {
+  public:
+    /// @brief Constructor
+    /// @param buffer Pointer to the first byte of the buffer that should be used to store the records, has to be kept alive for as long as the instance of this class
+    /// @param capacity Amount of bytes the given buffer can hold, each record additionally requires RAM_SPOOL_LENGTH_SIZE bytes to store its length
+    RAM_Telemetry_Spool(uint8_t * buffer, size_t const & capacity)
+      : m_buffer(buffer)
+      , m_capacity(capacity)
+      , m_head(0U)
+      , m_used(0U)
+      , m_count(0U)
+    {
+        // Nothing to do
+    }
+
+    bool push(uint8_t const * record, size_t const & size) override {
+        size_t const required = RAM_SPOOL_LENGTH_SIZE + size;
+        if (m_buffer == nullptr || record == nullptr || size > UINT16_MAX || required > m_capacity) {
+            return false;
+        }
+        while (m_capacity - m_used < required) {
+            pop(1U);
+        }
+        uint16_t const length = size;
+        size_t const tail = (m_head + m_used) % m_capacity;
+        write(tail, reinterpret_cast<uint8_t const *>(&length), RAM_SPOOL_LENGTH_SIZE);
+        write((tail + RAM_SPOOL_LENGTH_SIZE) % m_capacity, record, size);
+        m_used += required;
+        m_count++;
+        return true;
+    }
+
+    size_t peek(size_t const & index, uint8_t * buffer, size_t const & buffer_size) override {
+        if (index >= m_count) {
+            return 0U;
+        }
+        size_t offset = m_head;
+        for (size_t i = 0U; i < index; ++i) {
+            offset = (offset + RAM_SPOOL_LENGTH_SIZE + read_length(offset)) % m_capacity;
+        }
+        uint16_t const length = read_length(offset);
+        if (buffer != nullptr && length <= buffer_size) {
+            read((offset + RAM_SPOOL_LENGTH_SIZE) % m_capacity, buffer, length);
+        }
+        return length;
+    }
+
+    void pop(size_t const & count) override {
+        for (size_t i = 0U; i < count && m_count > 0U; ++i) {
+            size_t const required = RAM_SPOOL_LENGTH_SIZE + read_length(m_head);
+            m_head = (m_head + required) % m_capacity;
+            m_used -= required;
+            m_count--;
+        }
+        // Restart at the beginning of the buffer once it is empty, reduces the amount of records that wrap around the end of the buffer
+        if (m_count == 0U) {
+            m_head = 0U;
+        }
+    }
+
+    size_t size() override {
+        return m_count;
+    }
+
+  private:
+    /// @brief Copies the given bytes into the ring buffer, wrapping around the end of the buffer if required
+    /// @param offset Position in the ring buffer the first byte should be copied to
+    /// @param source Bytes that should be copied
+    /// @param size Amount of bytes that should be copied
+    void write(size_t const & offset, uint8_t const * source, size_t const & size) {
+        size_t const first = size < m_capacity - offset ? size : m_capacity - offset;
+        memcpy(m_buffer + offset, source, first);
+        memcpy(m_buffer, source + first, size - first);
+    }
+
+    /// @brief Copies bytes out of the ring buffer, wrapping around the end of the buffer if required
+    /// @param offset Position in the ring buffer the first byte should be copied from
+    /// @param destination Buffer the bytes should be copied into
+    /// @param size Amount of bytes that should be copied
+    void read(size_t const & offset, uint8_t * destination, size_t const & size) const {
+        size_t const first = size < m_capacity - offset ? size : m_capacity - offset;
+        memcpy(destination, m_buffer + offset, first);
+        memcpy(destination + first, m_buffer, size - first);
+    }
+
+    /// @brief Reads the length prefix of the record starting at the given position
+    /// @param offset Position in the ring buffer the record starts at
+    /// @return Amount of bytes the record consists of, without the length prefix itself
+    uint16_t read_length(size_t const & offset) const {
+        uint16_t length = 0U;
+        read(offset, reinterpret_cast<uint8_t *>(&length), RAM_SPOOL_LENGTH_SIZE);
+        return length;
+    }
+
+    uint8_t * m_buffer = {};   // Ring buffer the records are stored in
+    size_t    m_capacity = {}; // Amount of bytes the ring buffer can hold
+    size_t    m_head = {};     // Position of the oldest record in the ring buffer
+    size_t    m_used = {};     // Amount of bytes currently used by records and their length prefix
+    size_t    m_count = {};    // Amount of records currently stored
+};
+
+#endif // RAM_Telemetry_Spool_h
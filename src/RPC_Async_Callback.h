@@ -0,0 +1,54 @@
+#ifndef RPC_Async_Callback_h
+#define RPC_Async_Callback_h
+
+// Local includes.
+#include "Callback.h"
+
+
+/// @brief Identifies one asynchronous server side RPC request that has not been completed yet.
+/// Is passed to the RPC_Async_Callback and has to be passed back to Server_Side_RPC::RPC_Complete() once the response is ready.
+/// Consists only of plain values and can therefore be copied freely and passed to other tasks
+struct RPC_Completion_Token {
+    size_t   request_id = {}; // Id the server sent the request with, is required to build the topic the response has to be sent over
+    uint16_t slot = {};       // Position of the pending request in the table of the Server_Side_RPC instance that received it
+    uint16_t generation = {}; // Generation of the slot when the request was received, ensures a token of an abandoned request can not complete a later request in the same slot
+};
+
+
+/// @brief Asynchronous server-side RPC callback wrapper, in comparison to the RPC_Callback the subscribed method does not have to create the response immediately.
+/// Instead it receives a completion token and the response is passed to Server_Side_RPC::RPC_Complete() later on, possibly from another task.
+/// The completed response is then sent in the next loop() call of the ThingsBoard client, meaning slow peripherals do not block the processing of further received messages.
+/// Documentation about the specific use of Server-side RPC in ThingsBoard can be found here https://thingsboard.io/docs/user-guide/rpc/#server-side-rpc
+class RPC_Async_Callback : public Callback<void, JsonVariantConst const &, RPC_Completion_Token const &> {
+  public:
+    /// @brief Constructs empty callback, will result in never being called. Internals are simply default constructed as nullptr
+    RPC_Async_Callback() = default;
+
+    /// @brief Constructs callback, will be called upon server-side RPC request arrival with the given method name
+    /// @param method_name Name we expect to be sent via. server-side RPC so that this method callback will be called
+    /// @param callback Callback method that will be called upon data arrival with the given parameters and the token that completes the request.
+    /// The parameters are only valid during the call, copy everything that is still needed once the request is completed
+    RPC_Async_Callback(char const * method_name, function callback)
+      : Callback(callback)
+      , m_method_name(method_name)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Gets the poiner to the underlying name we expect to be sent via. server-side RPC so that this method callback will be called
+    /// @return Pointer to the passed method name
+    char const * Get_Name() const {
+        return m_method_name;
+    }
+
+    /// @brief Sets the poiner to the underlying name we expect to be sent via. server-side RPC so that this method callback will be called
+    /// @param method_name Pointer to the passed method name
+    void Set_Name(char const * method_name) {
+        m_method_name = method_name;
+    }
+
+  private:
+    char const *m_method_name = {}; // Method name
+};
+
+#endif // RPC_Async_Callback_h
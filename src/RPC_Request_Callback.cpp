@@ -1,13 +1,14 @@
 // Header include.
 #include "RPC_Request_Callback.h"
 
-RPC_Request_Callback::RPC_Request_Callback(char const * method_name, function received_callback, JsonArray const * parameters, uint64_t const & timeout_microseconds, Callback_Watchdog::function timeout_callback) :
+RPC_Request_Callback::RPC_Request_Callback(char const * method_name, function received_callback, JsonArray const * parameters, uint64_t const & timeout_microseconds, Callback<void>::function timeout_callback) :
     Callback(received_callback),
     m_method_name(method_name),
     m_parameters(parameters),
     m_request_id(0U),
     m_timeout_microseconds(timeout_microseconds),
-    m_timeout_callback(timeout_callback)
+    m_timeout_callback(timeout_callback),
+    m_timeout_handle(INVALID_TIMER_HANDLE)
 {
     // Nothing to do
 }
@@ -44,23 +45,19 @@ void RPC_Request_Callback::Set_Timeout(uint64_t const & timeout_microseconds) {
     m_timeout_microseconds = timeout_microseconds;
 }
 
-#if !THINGSBOARD_USE_ESP_TIMER
-void RPC_Request_Callback::Update_Timeout_Timer() {
-    m_timeout_callback.update();
-}
-#endif // !THINGSBOARD_USE_ESP_TIMER
-
-void RPC_Request_Callback::Start_Timeout_Timer() {
+bool RPC_Request_Callback::Start_Timeout_Timer(Timer_Wheel & timer_wheel) {
     if (m_timeout_microseconds == 0U) {
-        return;
+        return true;
     }
-    m_timeout_callback.once(m_timeout_microseconds);
+    (void)timer_wheel.cancel(m_timeout_handle);
+    m_timeout_handle = timer_wheel.arm(m_timeout_microseconds, m_timeout_callback);
+    return m_timeout_handle != INVALID_TIMER_HANDLE;
 }
 
-void RPC_Request_Callback::Stop_Timeout_Timer() {
-    m_timeout_callback.detach();
+void RPC_Request_Callback::Stop_Timeout_Timer(Timer_Wheel & timer_wheel) {
+    (void)timer_wheel.cancel(m_timeout_handle);
 }
 
-void RPC_Request_Callback::Set_Timeout_Callback(Callback_Watchdog::function timeout_callback) {
-    m_timeout_callback = Callback_Watchdog(timeout_callback);
+void RPC_Request_Callback::Set_Timeout_Callback(Callback<void>::function timeout_callback) {
+    m_timeout_callback.Set_Callback(timeout_callback);
 }
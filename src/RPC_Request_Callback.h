@@ -2,7 +2,7 @@
 #define RPC_Request_Callback_h
 
 // Local includes.
-#include "Callback_Watchdog.h"
+#include "Timer_Wheel.h"
 
 
 /// @brief Client-side RPC callback wrapper,
@@ -22,7 +22,7 @@ class RPC_Request_Callback : public Callback<void, JsonDocument const &> {
     /// If the value is 0 we will not start the timer and therefore never call the timeout callback method, default = 0
     /// @param timeout_callback Optional callback method that will be called upon request timeout (did not receive a response in the given timeout time). Can happen if the requested method does not exist on the cloud,
     /// or if the connection could not be established, default = nullptr
-    RPC_Request_Callback(char const * method_name, function received_callback, JsonArray const * parameters = nullptr, uint64_t const & timeout_microseconds = 0U, Callback_Watchdog::function timeout_callback = nullptr);
+    RPC_Request_Callback(char const * method_name, function received_callback, JsonArray const * parameters = nullptr, uint64_t const & timeout_microseconds = 0U, Callback<void>::function timeout_callback = nullptr);
 
     /// @brief Gets the unique request identifier that is connected to the original request,
     /// and will be later used to verifiy which RPC_Request_Callback
@@ -60,29 +60,28 @@ class RPC_Request_Callback : public Callback<void, JsonDocument const &> {
     /// @param timeout_microseconds Timeout time until timeout callback is called
     void Set_Timeout(uint64_t const & timeout_microseconds);
 
-#if !THINGSBOARD_USE_ESP_TIMER
-    /// @brief Updates the internal timeout timer
-    void Update_Timeout_Timer();
-#endif // !THINGSBOARD_USE_ESP_TIMER
-
-    /// @brief Starts the internal timeout timer if we actually received a configured valid timeout time and a valid callback.
+    /// @brief Arms the timeout timer in the given shared timer wheel, if we actually received a configured valid timeout time.
     /// Is called as soon as the request is actually sent
-    void Start_Timeout_Timer();
+    /// @param timer_wheel Timer wheel that is shared by all requests and calls the timeout callback if the timer is not stopped in time
+    /// @return Whether the timer was armed or no timer was required, false if the timer wheel had no space for another timer
+    bool Start_Timeout_Timer(Timer_Wheel & timer_wheel);
 
-    /// @brief Stops the internal timeout timer, is called as soon as an answer is received from the cloud
+    /// @brief Cancels the timeout timer in the given shared timer wheel, is called as soon as an answer is received from the cloud
     /// if it isn't we call the previously subscribed callback instead
-    void Stop_Timeout_Timer();
+    /// @param timer_wheel Timer wheel the timeout timer was previously armed in
+    void Stop_Timeout_Timer(Timer_Wheel & timer_wheel);
 
     /// @brief Sets the callback method that will be called upon request timeout (did not receive a response in the given timeout time)
     /// @param timeout_callback Callback function that will be called
-    void Set_Timeout_Callback(Callback_Watchdog::function timeout_callback);
+    void Set_Timeout_Callback(Callback<void>::function timeout_callback);
 
   private:
     char const                    *m_method_name = {};          // Method name
     JsonArray const               *m_parameters = {};          // Parameter json
     size_t                        m_request_id = {};           // Id the request was called with
     uint64_t                      m_timeout_microseconds = {}; // Timeout time until we expect response to request
-    Callback_Watchdog             m_timeout_callback = {};     // Handles callback that will be called if request times out
+    Callback<void>                m_timeout_callback = {};     // Callback that will be called if request times out
+    Timer_Handle                  m_timeout_handle = {};       // Handle of the timeout timer armed in the shared timer wheel
 };
 
 #endif // RPC_Request_Callback_h
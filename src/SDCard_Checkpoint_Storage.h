@@ -0,0 +1,61 @@
+#ifndef SDCard_Checkpoint_Storage_h
+#define SDCard_Checkpoint_Storage_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "IOTA_Checkpoint_Storage.h"
+#include "DefaultLogger.h"
+
+// Library include.
+#include <stdio.h>
+
+
+constexpr char OPEN_CHECKPOINT_FILE_FAILED[] = "Failed to open checkpoint file (%s), ensure path is correct and SD card exist and is initalized";
+
+
+/// @brief IOTA_Checkpoint_Storage implementation that uses the c fopen function (https://cplusplus.com/reference/cstdio/fopen/),
+/// under the hood to write the given checkpoint into a file. Can be used in combination with the SDCard_Updater to continue an interrupted download from the SD card
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class SDCard_Checkpoint_Storage : public IOTA_Checkpoint_Storage {
+  public:
+    SDCard_Checkpoint_Storage(char const * file_path)
+      : m_path(file_path)
+    {
+        // Nothing to do
+    }
+
+    bool save(OTA_Checkpoint const & checkpoint) override {
+        FILE* file = fopen(m_path, "wb");
+        if (file == nullptr) {
+            Logger::printfln(OPEN_CHECKPOINT_FILE_FAILED, m_path);
+            return false;
+        }
+        size_t const written = fwrite(&checkpoint, sizeof(checkpoint), 1U, file);
+        // Closing the file flushes the written data, if that fails the checkpoint might not have been persisted completely
+        bool const closed = fclose(file) == 0;
+        return written == 1U && closed;
+    }
+
+    bool load(OTA_Checkpoint & checkpoint) override {
+        FILE* file = fopen(m_path, "rb");
+        if (file == nullptr) {
+            // Not an error, simply means that there is no previous checkpoint to continue from
+            return false;
+        }
+        size_t const read = fread(&checkpoint, sizeof(checkpoint), 1U, file);
+        fclose(file);
+        return read == 1U;
+    }
+
+    void clear() override {
+        (void)remove(m_path);
+    }
+
+  private:
+    char const * m_path = {}; // Path to the file the checkpoint is written into
+};
+
+#endif // SDCard_Checkpoint_Storage_h
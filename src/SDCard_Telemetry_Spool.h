@@ -0,0 +1,242 @@
+#ifndef SDCard_Telemetry_Spool_h
+#define SDCard_Telemetry_Spool_h
+
+// Local include.
+#include "Configuration.h"
+
+// Local include.
+#include "ITelemetry_Spool.h"
+#include "DefaultLogger.h"
+
+// Library include.
+#include <stdio.h>
+
+
+constexpr char OPEN_SPOOL_FILE_FAILED[] = "Failed to open spool file (%s), ensure path is correct and SD card exist and is initalized";
+size_t constexpr DEFAULT_SPOOL_FILE_SIZE = 1048576U;
+size_t constexpr SPOOL_FILE_COPY_BUFFER_SIZE = 64U;
+
+
+/// @brief Header at the start of the spool file, keeps track of the records that have already been removed,
+/// because removing data from the start of a file is not possible without rewriting the whole file
+struct Spool_File_Header {
+    uint32_t read_offset;  // Position in the file the oldest record that has not been removed yet starts at
+    uint32_t write_offset; // Position in the file the next record will be appended at, data after it is left over from before a compaction
+    uint32_t count;        // Amount of records between the read and the write offset
+};
+
+
+/// @brief ITelemetry_Spool implementation that uses the c fopen function (https://cplusplus.com/reference/cstdio/fopen/),
+/// under the hood to append the records to a file. Works with any path fopen supports, meaning a file on a POSIX file system or on a mounted SD card.
+/// Records are appended and removed records are skipped with the read offset in the header, once all records have been removed the file is truncated.
+/// Once the removed records take up more space than the remaining ones or a new record would grow the file past its maximum size, the remaining records are moved to the start of the file instead.
+/// If there is not enough space left for a new record, the oldest records are removed until there is, same as in the RAM_Telemetry_Spool.
+/// In comparison to the RAM_Telemetry_Spool the records survive a restart of the device and the amount of records can be a lot bigger
+/// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
+template <typename Logger = DefaultLogger>
+class SDCard_Telemetry_Spool : public ITelemetry_Spool {
+  public:
+    /// @brief Constructor
+    /// @param file_path Path to the file the records should be written into, has to be kept alive for as long as the instance of this class
+    /// @param max_size Maximum amount of bytes the file is allowed to grow to, including the header and the length prefix of each record, default = DEFAULT_SPOOL_FILE_SIZE
+    SDCard_Telemetry_Spool(char const * file_path, size_t const & max_size = DEFAULT_SPOOL_FILE_SIZE)
+      : m_path(file_path)
+      , m_max_size(max_size)
+    {
+        // Nothing to do
+    }
+
+    bool push(uint8_t const * record, size_t const & size) override {
+        uint16_t const length = size;
+        size_t const required = sizeof(length) + size;
+        if (record == nullptr || size > UINT16_MAX || sizeof(Spool_File_Header) + required > m_max_size) {
+            return false;
+        }
+        Spool_File_Header header = {};
+        FILE* file = fopen(m_path, "r+b");
+        if (file == nullptr || !read_header(file, header)) {
+            if (file != nullptr) {
+                fclose(file);
+            }
+            file = create_file(header);
+            if (file == nullptr) {
+                return false;
+            }
+        }
+        // Remove the oldest records until the new record fits, because for long disconnects the most recent data is assumed to be more relevant than the oldest data
+        while (header.count > 0U && sizeof(Spool_File_Header) + (header.write_offset - header.read_offset) + required > m_max_size) {
+            if (!skip_record(file, header)) {
+                fclose(file);
+                return false;
+            }
+        }
+        if (header.count == 0U) {
+            header.read_offset = sizeof(Spool_File_Header);
+            header.write_offset = sizeof(Spool_File_Header);
+        }
+        else if (header.write_offset + required > m_max_size && !compact(file, header)) {
+            fclose(file);
+            return false;
+        }
+        bool const written = fseek(file, header.write_offset, SEEK_SET) == 0 && fwrite(&length, sizeof(length), 1U, file) == 1U && fwrite(record, 1U, size, file) == size;
+        if (written) {
+            header.write_offset += required;
+            header.count++;
+        }
+        bool const updated = written && write_header(file, header);
+        // Closing the file flushes the written data, if that fails the record might not have been persisted completely
+        bool const closed = fclose(file) == 0;
+        return updated && closed;
+    }
+
+    size_t peek(size_t const & index, uint8_t * buffer, size_t const & buffer_size) override {
+        FILE* file = fopen(m_path, "rb");
+        if (file == nullptr) {
+            // Not an error, simply means that nothing has been spooled yet
+            return 0U;
+        }
+        Spool_File_Header header = {};
+        uint16_t length = 0U;
+        if (!read_header(file, header) || index >= header.count || fseek(file, header.read_offset, SEEK_SET) != 0) {
+            fclose(file);
+            return 0U;
+        }
+        for (size_t i = 0U; i <= index; ++i) {
+            if (i != 0U && fseek(file, length, SEEK_CUR) != 0) {
+                length = 0U;
+                break;
+            }
+            else if (fread(&length, sizeof(length), 1U, file) != 1U) {
+                length = 0U;
+                break;
+            }
+        }
+        if (buffer != nullptr && length != 0U && length <= buffer_size && fread(buffer, 1U, length, file) != length) {
+            length = 0U;
+        }
+        fclose(file);
+        return length;
+    }
+
+    void pop(size_t const & count) override {
+        FILE* file = fopen(m_path, "r+b");
+        if (file == nullptr) {
+            return;
+        }
+        Spool_File_Header header = {};
+        if (!read_header(file, header)) {
+            fclose(file);
+            return;
+        }
+        for (size_t i = 0U; i < count && header.count > 0U; ++i) {
+            if (!skip_record(file, header)) {
+                break;
+            }
+        }
+        if (header.count != 0U) {
+            // Only move the remaining records once they are smaller than the removed ones, ensures each byte is copied at most once for every byte that has been removed
+            if (header.read_offset - sizeof(Spool_File_Header) < header.write_offset - header.read_offset || !compact(file, header)) {
+                (void)write_header(file, header);
+            }
+            fclose(file);
+            return;
+        }
+        // Every record has been removed, therefore we can truncate the file, to free up the space used by the already removed records
+        fclose(file);
+        file = create_file(header);
+        if (file == nullptr) {
+            return;
+        }
+        fclose(file);
+    }
+
+    size_t size() override {
+        FILE* file = fopen(m_path, "rb");
+        if (file == nullptr) {
+            return 0U;
+        }
+        Spool_File_Header header = {};
+        bool const read = read_header(file, header);
+        fclose(file);
+        return read ? header.count : 0U;
+    }
+
+  private:
+    /// @brief Creates a new empty spool file or truncates the existing one and writes an empty header into it
+    /// @param header Variable the written empty header will be copied into
+    /// @return Opened file positioned after the header or nullptr if opening the file failed
+    FILE* create_file(Spool_File_Header & header) {
+        FILE* file = fopen(m_path, "w+b");
+        if (file == nullptr) {
+            Logger::printfln(OPEN_SPOOL_FILE_FAILED, m_path);
+            return nullptr;
+        }
+        header.read_offset = sizeof(Spool_File_Header);
+        header.write_offset = sizeof(Spool_File_Header);
+        header.count = 0U;
+        if (!write_header(file, header)) {
+            fclose(file);
+            return nullptr;
+        }
+        return file;
+    }
+
+    /// @brief Removes the oldest record by moving the read offset past it, does not write the changed header into the file
+    /// @param file Opened spool file
+    /// @param header Header of the given file, the read offset and count are updated if successful
+    /// @return Whether reading the length of the oldest record was successful or not
+    static bool skip_record(FILE* file, Spool_File_Header & header) {
+        uint16_t length = 0U;
+        if (fseek(file, header.read_offset, SEEK_SET) != 0 || fread(&length, sizeof(length), 1U, file) != 1U) {
+            return false;
+        }
+        header.read_offset += sizeof(length) + length;
+        header.count--;
+        return true;
+    }
+
+    /// @brief Moves the remaining records to the start of the file directly after the header, to reuse the space of the already removed records.
+    /// Copies in small chunks from the front, which is safe because the destination is always before the source
+    /// @param file Opened spool file
+    /// @param header Header of the given file, the read and write offset are updated and written into the file if successful
+    /// @return Whether moving the records and writing the header was successful or not
+    static bool compact(FILE* file, Spool_File_Header & header) {
+        uint8_t buffer[SPOOL_FILE_COPY_BUFFER_SIZE] = {};
+        uint32_t source = header.read_offset;
+        uint32_t destination = sizeof(Spool_File_Header);
+        while (source < header.write_offset) {
+            size_t const remaining = header.write_offset - source;
+            size_t const chunk = remaining < sizeof(buffer) ? remaining : sizeof(buffer);
+            if (fseek(file, source, SEEK_SET) != 0 || fread(buffer, 1U, chunk, file) != chunk ||
+                fseek(file, destination, SEEK_SET) != 0 || fwrite(buffer, 1U, chunk, file) != chunk) {
+                return false;
+            }
+            source += chunk;
+            destination += chunk;
+        }
+        header.read_offset = sizeof(Spool_File_Header);
+        header.write_offset = destination;
+        return write_header(file, header);
+    }
+
+    /// @brief Reads the header from the start of the given file
+    /// @param file Opened spool file
+    /// @param header Variable the read header will be copied into
+    /// @return Whether reading the header was successful or not
+    static bool read_header(FILE* file, Spool_File_Header & header) {
+        return fseek(file, 0, SEEK_SET) == 0 && fread(&header, sizeof(header), 1U, file) == 1U;
+    }
+
+    /// @brief Overwrites the header at the start of the given file
+    /// @param file Opened spool file
+    /// @param header Header that should be written
+    /// @return Whether writing the header was successful or not
+    static bool write_header(FILE* file, Spool_File_Header const & header) {
+        return fseek(file, 0, SEEK_SET) == 0 && fwrite(&header, sizeof(header), 1U, file) == 1U;
+    }
+
+    char const * m_path = {};     // Path to the file the records are written into
+    size_t       m_max_size = {}; // Maximum amount of bytes the file is allowed to grow to
+};
+
+#endif // SDCard_Telemetry_Spool_h
@@ -18,6 +18,7 @@ class SDCard_Updater : public IUpdater {
   public:
     SDCard_Updater(char const * file_path)
       : m_path(file_path)
+      , m_offset(0U)
     {
         // Nothing to do
     }
@@ -29,17 +30,41 @@ class SDCard_Updater : public IUpdater {
             return false;
         }
         fclose(file);
+        m_offset = 0U;
+        return true;
+    }
+
+    bool resume(size_t const & firmware_size, size_t const & offset) override {
+        FILE* file = fopen(m_path, "rb");
+        if (file == nullptr) {
+            Logger::printfln(OPEN_FILE_FAILED, m_path);
+            return false;
+        }
+        // The file has to contain at least all bytes up to the given offset, if it does not the file was changed since the checkpoint was saved
+        bool const seeked = fseek(file, 0, SEEK_END) == 0;
+        long const file_size = ftell(file);
+        fclose(file);
+        if (!seeked || file_size < 0 || static_cast<size_t>(file_size) < offset) {
+            return false;
+        }
+        m_offset = offset;
         return true;
     }
   
     size_t write(uint8_t * payload, size_t const & total_bytes) override {
-        FILE* file = fopen(m_path, "a");
+        // Opened for updating instead of appending, because after resuming the file might still contain data written after the checkpoint, which has to be overwritten
+        FILE* file = fopen(m_path, "r+b");
         if (file == nullptr) {
             Logger::printfln(OPEN_FILE_FAILED, m_path);
             return 0;
         }
+        if (fseek(file, m_offset, SEEK_SET) != 0) {
+            fclose(file);
+            return 0;
+        }
         size_t const bytes_written = fwrite(payload, 1, total_bytes, file);
         fclose(file);
+        m_offset += bytes_written;
         return bytes_written;
     }
 
@@ -52,7 +77,8 @@ class SDCard_Updater : public IUpdater {
     }
 
   private:
-    char const * m_path = {}; // Path to the file the binary data is written into
+    char const * m_path = {};   // Path to the file the binary data is written into
+    size_t       m_offset = {}; // Position in the file the next received binary data is written to
 };
 
 #endif // SDCard_Updater_h
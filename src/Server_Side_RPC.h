@@ -3,7 +3,14 @@
 
 // Local includes.
 #include "RPC_Callback.h"
+#include "RPC_Async_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Hash_Index.h"
+
+// Library includes.
+#if THINGSBOARD_ENABLE_STL
+#include <atomic>
+#endif // THINGSBOARD_ENABLE_STL
 
 
 // Server side RPC topics.
@@ -12,6 +19,8 @@ char constexpr RPC_REQUEST_TOPIC[] = "v1/devices/me/rpc/request/";
 char constexpr RPC_SEND_RESPONSE_TOPIC[] = "v1/devices/me/rpc/response/%u";
 // Log messages.
 char constexpr RPC_RESPONSE_OVERFLOWED[] = "Server-side RPC response overflowed, increase MaxRPC (%u)";
+char constexpr MAX_PENDING_RPC_EXCEEDED[] = "Too many pending asynchronous server-side RPC requests, increase MaxPendingRPC (%u)";
+char constexpr PENDING_RPC_ABANDONED[] = "Asynchronous server-side RPC request (%u) was not completed in time and has been abandoned";
 #if !THINGSBOARD_ENABLE_DYNAMIC
 char constexpr SERVER_SIDE_RPC_SUBSCRIPTIONS[] = "server-side RPC";
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
@@ -21,6 +30,32 @@ char constexpr RPC_RESPONSE_NULL[] = "Response JsonDocument is NULL, skipping se
 char constexpr NO_RPC_PARAMS_PASSED[] = "No parameters passed with RPC, passing null JSON";
 char constexpr CALLING_RPC_CB[] = "Calling subscribed callback for rpc with methodname (%s)";
 #endif // THINGSBOARD_ENABLE_DEBUG
+uint16_t constexpr PENDING_RPC_INVALID_SLOT = UINT16_MAX;
+uint8_t constexpr PENDING_RPC_SWEEP_STEPS = 4U;
+
+
+/// @brief States of a slot in the table of pending asynchronous server side RPC requests
+enum class Pending_RPC_State : uint8_t {
+    FREE,       ///< Slot is not used and can be used for the next received request
+    PENDING,    ///< Request has been passed to the subscribed callback and waits for its completion
+    COMPLETING, ///< Response is currently being copied into the slot by RPC_Complete(), possibly from another task
+    COMPLETED   ///< Response has been copied and is sent in the next loop() call
+};
+
+
+/// @brief Slot of the table of pending asynchronous server side RPC requests.
+/// The state is the only member that is accessed from multiple tasks, all other members are only written by the task that owns the slot in its current state
+struct Pending_RPC {
+#if THINGSBOARD_ENABLE_STL
+    std::atomic<uint8_t> state;       // Current Pending_RPC_State, atomic so that RPC_Complete() can be called from any task
+#else
+    volatile uint8_t     state;       // Current Pending_RPC_State, without the STL atomics are not available, therefore RPC_Complete() has to be called from the same task as loop()
+#endif // THINGSBOARD_ENABLE_STL
+    uint16_t             generation;  // Incremented every time the slot is used for another request, to detect tokens of abandoned requests
+    uint8_t              age;         // Amount of timeout sweeps the request has been pending for
+    size_t               request_id;  // Id the server sent the request with
+    char                 *response;   // Serialized response allocated by RPC_Complete() or nullptr if no response should be sent
+};
 
 
 /// @brief Handles the internal implementation of the ThingsBoard server side RPC API.
@@ -34,12 +69,68 @@ template <typename Logger = DefaultLogger>
 /// @tparam MaxRPC Maximum amount of key-value pairs that will ever be sent in the subscribed callback method of an RPC_Callback, allows to use a StaticJsonDocument on the stack in the background.
 /// If we simply use .to<JsonVariant>(); on the received document and use .set() to change the internal value then the size requirements are 0.
 /// However if we attempt to send multiple key-value pairs, we have to adjust the size accordingly. See https://arduinojson.org/v6/assistant/ for more information on how to estimate the required size and divide the result by 16 to receive the required MaxRPC value, default = Default_RPC_Amount (0)
-template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxRPC = Default_RPC_Amount, typename Logger = DefaultLogger>
+/// @tparam MaxPendingRPC Maximum amount of asynchronous server side rpc requests that can wait for their completion at the same time, further requests are ignored until a pending request is completed or abandoned, default = Default_Pending_RPC_Amount (2)
+template<size_t MaxSubscriptions = Default_Subscriptions_Amount, size_t MaxRPC = Default_RPC_Amount, typename Logger = DefaultLogger, size_t MaxPendingRPC = Default_Pending_RPC_Amount>
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 class Server_Side_RPC : public IAPI_Implementation {
   public:
     /// @brief Constructor
-    Server_Side_RPC() = default;
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @param max_pending_rpc Maximum amount of asynchronous server side rpc requests that can wait for their completion at the same time,
+    /// further requests are ignored until a pending request is completed or abandoned, default = Default_Pending_RPC_Amount (2)
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    /// @param pending_timeout_microseconds Amount of microseconds after which asynchronous server side rpc requests that have not been completed are abandoned,
+    /// to free their slot for further requests. Should match the timeout configured for the RPC on the server, because the server does not accept the response afterwards anyway.
+    /// If the value is 0 pending requests are never abandoned, default = Default_Pending_RPC_Timeout (10000000)
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Server_Side_RPC(size_t const & max_pending_rpc = Default_Pending_RPC_Amount, uint64_t const & pending_timeout_microseconds = Default_Pending_RPC_Timeout)
+#else
+    Server_Side_RPC(uint64_t const & pending_timeout_microseconds = Default_Pending_RPC_Timeout)
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+      : m_client_context(&Unbound_Client_Context::Get_Instance())
+      , m_rpc_callbacks()
+      , m_method_index()
+      , m_rpc_async_callbacks()
+      , m_async_method_index()
+#if THINGSBOARD_ENABLE_DYNAMIC
+      , m_pending_rpc(Allocator_Policy::Create_Array<Pending_RPC>(max_pending_rpc, Memory_Subsystem::RPC_RESPONSE))
+      , m_max_pending_rpc(m_pending_rpc != nullptr ? max_pending_rpc : 0U)
+#else
+      , m_pending_rpc()
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+      , m_pending_timeout(pending_timeout_microseconds)
+      , m_sweep_callback()
+      , m_sweep_handle(INVALID_TIMER_HANDLE)
+    {
+#if THINGSBOARD_ENABLE_STL
+        m_sweep_callback.Set_Callback(std::bind(&Server_Side_RPC::Sweep_Pending_RPC, this));
+#else
+        m_sweep_callback.Set_Callback(Server_Side_RPC::staticSweepPendingRPC);
+        m_subscribedInstance = this;
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Destructor
+    ~Server_Side_RPC() {
+        Stop_Pending_Sweep();
+        for (size_t i = 0U; i < Get_Max_Pending_RPC(); ++i) {
+            Allocator_Policy::Destroy_Array(m_pending_rpc[i].response);
+        }
+#if THINGSBOARD_ENABLE_DYNAMIC
+        Allocator_Policy::Destroy_Array(m_pending_rpc);
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+#if !THINGSBOARD_ENABLE_STL
+        if (m_subscribedInstance == this) {
+            m_subscribedInstance = nullptr;
+        }
+#endif // !THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Copy constructor, deleted because the table of pending requests is owned by the instance and referenced by the completion tokens
+    Server_Side_RPC(Server_Side_RPC const &) = delete;
+
+    /// @brief Copy assignment operator, deleted because the table of pending requests is owned by the instance and referenced by the completion tokens
+    Server_Side_RPC & operator=(Server_Side_RPC const &) = delete;
 
     /// @brief Subscribes multiple server side RPC callbacks,
     /// that will be called if a request from the server for the method with the given name is received.
@@ -64,10 +155,10 @@ class Server_Side_RPC : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        (void)m_client_context->Subscribe_Topic(RPC_SUBSCRIBE_TOPIC);
         // Push back complete vector into our local m_rpc_callbacks vector.
         m_rpc_callbacks.insert(m_rpc_callbacks.end(), first, last);
-        return true;
+        return Rebuild_Method_Index();
     }
 
     /// @brief Subscribe one server side RPC callback,
@@ -87,9 +178,66 @@ class Server_Side_RPC : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        (void)m_client_context->Subscribe_Topic(RPC_SUBSCRIBE_TOPIC);
         m_rpc_callbacks.push_back(callback);
-        return true;
+        return Rebuild_Method_Index();
+    }
+
+    /// @brief Subscribe one asynchronous server side RPC callback,
+    /// that will be called if a request from the server for the method with the given name is received.
+    /// In comparison to the RPC_Callback the response does not have to be created immediately, instead the callback receives a completion token
+    /// that has to be passed to RPC_Complete() once the response is ready, which allows to e.g. read slow peripherals without blocking the processing of further messages.
+    /// Synchronous callbacks subscribed with the same method name take precedence.
+    /// See https://thingsboard.io/docs/user-guide/rpc/#server-side-rpc for more information
+    /// @param callback Callback method that will be called
+    /// @return Whether subscribing the given callback was successful or not
+    bool RPC_Subscribe(RPC_Async_Callback const & callback) {
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        if (m_rpc_async_callbacks.size() + 1 > m_rpc_async_callbacks.capacity()) {
+            Logger::printfln(MAX_SUBSCRIPTIONS_EXCEEDED, MAX_SUBSCRIPTIONS_TEMPLATE_NAME, SERVER_SIDE_RPC_SUBSCRIPTIONS);
+            return false;
+        }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+        (void)m_client_context->Subscribe_Topic(RPC_SUBSCRIBE_TOPIC);
+        m_rpc_async_callbacks.push_back(callback);
+        return m_async_method_index.rebuild(m_rpc_async_callbacks.size(), [this](size_t const & index) {
+            return Helper::getHashValue(m_rpc_async_callbacks[index].Get_Name());
+        });
+    }
+
+    /// @brief Completes the asynchronous server side RPC request identified by the given token, by copying the given response.
+    /// The response is not sent immediately, but in the next loop() call of the ThingsBoard client, therefore this method can be called from any task if the STL is available.
+    /// Fails if the request has already been completed or has been abandoned, because it was not completed in time
+    /// @param token Token that was passed to the RPC_Async_Callback together with the request
+    /// @param response JsonDocument containing the response that should be sent to the server, nothing is sent to the server if it is null
+    /// @return Whether the request was still pending and the response could be copied
+    bool RPC_Complete(RPC_Completion_Token const & token, JsonDocument const & response) {
+        if (token.slot >= Get_Max_Pending_RPC()) {
+            return false;
+        }
+        Pending_RPC & pending = m_pending_rpc[token.slot];
+        // Claim the slot before checking the generation, so that the slot can not be reused for another request while we are checking it
+        if (!Transition_Pending_RPC(pending, Pending_RPC_State::PENDING, Pending_RPC_State::COMPLETING)) {
+            return false;
+        }
+        else if (pending.generation != token.generation) {
+            (void)Transition_Pending_RPC(pending, Pending_RPC_State::COMPLETING, Pending_RPC_State::PENDING);
+            return false;
+        }
+
+        if (!response.isNull()) {
+            size_t const json_size = Helper::Measure_Json(response);
+            pending.response = Allocator_Policy::Create_Array<char>(json_size, Memory_Subsystem::RPC_RESPONSE);
+            if (pending.response == nullptr) {
+                Logger::printfln(UNABLE_TO_ALLOCATE_MEMORY, json_size);
+            }
+            else if (serializeJson(response, pending.response, json_size) < json_size - 1) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+                Allocator_Policy::Destroy_Array(pending.response);
+                pending.response = nullptr;
+            }
+        }
+        return Transition_Pending_RPC(pending, Pending_RPC_State::COMPLETING, Pending_RPC_State::COMPLETED);
     }
 
     /// @brief Unsubcribes all server side RPC callbacks.
@@ -97,8 +245,12 @@ class Server_Side_RPC : public IAPI_Implementation {
     /// @return Whether unsubcribing all the previously subscribed callbacks
     /// and from the rpc topic, was successful or not
     bool RPC_Unsubscribe() {
+        Stop_Pending_Sweep();
         m_rpc_callbacks.clear();
-        return m_unsubscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC);
+        m_method_index.clear();
+        m_rpc_async_callbacks.clear();
+        m_async_method_index.clear();
+        return m_client_context->Unsubscribe_Topic(RPC_SUBSCRIBE_TOPIC);
     }
 
     API_Process_Type Get_Process_Type() const override {
@@ -118,20 +270,13 @@ class Server_Side_RPC : public IAPI_Implementation {
         }
         char const * method_name = data[RPC_METHOD_KEY];
 
-#if THINGSBOARD_ENABLE_STL
-        auto it = std::find_if(m_rpc_callbacks.begin(), m_rpc_callbacks.end(), [&method_name](RPC_Callback const & rpc) {
-            char const * subscribedMethodName = rpc.Get_Name();
-            return (!Helper::stringIsNullorEmpty(subscribedMethodName) && strncmp(subscribedMethodName, method_name, strlen(subscribedMethodName)) == 0);
+        // Method names have to match exactly, the index only narrows the comparison down to callbacks whose method name has the same hash
+        uint16_t const index = m_method_index.find(Helper::getHashValue(method_name), [this, &method_name](uint16_t const & position) {
+            char const * subscribedMethodName = m_rpc_callbacks[position].Get_Name();
+            return method_name != nullptr && !Helper::stringIsNullorEmpty(subscribedMethodName) && strcmp(subscribedMethodName, method_name) == 0;
         });
-        if (it != m_rpc_callbacks.end()) {
-            auto & rpc = *it;
-#else
-        for (auto const & rpc : m_rpc_callbacks) {
-            char const * subscribedMethodName = rpc.Get_Name();
-            if (Helper::stringIsNullorEmpty(subscribedMethodName) || strncmp(subscribedMethodName, method_name, strlen(subscribedMethodName)) != 0) {
-              continue;
-            }
-#endif // THINGSBOARD_ENABLE_STL
+        if (index != HASH_INDEX_EMPTY_SLOT) {
+            auto & rpc = m_rpc_callbacks[index];
 #if THINGSBOARD_ENABLE_DEBUG
             if (!data.containsKey(RPC_PARAMS_KEY)) {
                 Logger::printfln(NO_RPC_PARAMS_PASSED);
@@ -145,6 +290,7 @@ class Server_Side_RPC : public IAPI_Implementation {
             JsonVariantConst const param = data[RPC_PARAMS_KEY];
 #if THINGSBOARD_ENABLE_DYNAMIC
             size_t const & rpc_response_size = rpc.Get_Response_Size();
+            Memory_Scope const scope(Memory_Subsystem::RPC_RESPONSE);
             TBJsonDocument json_buffer(rpc_response_size);
 #else
             size_t constexpr rpc_response_size = MaxRPC;
@@ -166,9 +312,35 @@ class Server_Side_RPC : public IAPI_Implementation {
             size_t const request_id = Helper::parseRequestId(RPC_REQUEST_TOPIC, topic);
             char responseTopic[Helper::detectSize(RPC_SEND_RESPONSE_TOPIC, request_id)] = {};
             (void)snprintf(responseTopic, sizeof(responseTopic), RPC_SEND_RESPONSE_TOPIC, request_id);
-            (void)m_send_json_callback.Call_Callback(responseTopic, json_buffer, Helper::Measure_Json(json_buffer));
+            (void)m_client_context->Send_Json(responseTopic, json_buffer, Helper::Measure_Json(json_buffer));
             return;
         }
+
+        uint16_t const async_index = m_async_method_index.find(Helper::getHashValue(method_name), [this, &method_name](uint16_t const & position) {
+            char const * subscribedMethodName = m_rpc_async_callbacks[position].Get_Name();
+            return method_name != nullptr && !Helper::stringIsNullorEmpty(subscribedMethodName) && strcmp(subscribedMethodName, method_name) == 0;
+        });
+        if (async_index == HASH_INDEX_EMPTY_SLOT) {
+            return;
+        }
+        RPC_Completion_Token token = {};
+        token.request_id = Helper::parseRequestId(RPC_REQUEST_TOPIC, topic);
+        token.slot = Allocate_Pending_RPC(token.request_id);
+        if (token.slot == PENDING_RPC_INVALID_SLOT) {
+            Logger::printfln(MAX_PENDING_RPC_EXCEEDED, Get_Max_Pending_RPC());
+            return;
+        }
+        token.generation = m_pending_rpc[token.slot].generation;
+        Start_Pending_Sweep();
+
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(CALLING_RPC_CB, method_name);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        m_rpc_async_callbacks[async_index].Call_Callback(data[RPC_PARAMS_KEY], token);
+    }
+
+    char const * Get_Response_Topic_Prefix() const override {
+        return RPC_REQUEST_TOPIC;
     }
 
     bool Compare_Response_Topic(char const * topic) const override {
@@ -180,33 +352,155 @@ class Server_Side_RPC : public IAPI_Implementation {
     }
 
     bool Resubscribe_Topic() override {
-        if (!m_rpc_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(RPC_SUBSCRIBE_TOPIC)) {
+        if ((!m_rpc_callbacks.empty() || !m_rpc_async_callbacks.empty()) && !m_client_context->Subscribe_Topic(RPC_SUBSCRIBE_TOPIC)) {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, RPC_SUBSCRIBE_TOPIC);
             return false;
         }
         return true;
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
-        // Nothing to do
+        for (size_t i = 0U; i < Get_Max_Pending_RPC(); ++i) {
+            Pending_RPC & pending = m_pending_rpc[i];
+            if (pending.state != static_cast<uint8_t>(Pending_RPC_State::COMPLETED)) {
+                continue;
+            }
+            if (pending.response != nullptr) {
+                char responseTopic[Helper::detectSize(RPC_SEND_RESPONSE_TOPIC, pending.request_id)] = {};
+                (void)snprintf(responseTopic, sizeof(responseTopic), RPC_SEND_RESPONSE_TOPIC, pending.request_id);
+                (void)m_client_context->Send_Json_String(responseTopic, pending.response);
+                Allocator_Policy::Destroy_Array(pending.response);
+                pending.response = nullptr;
+            }
+            pending.state = static_cast<uint8_t>(Pending_RPC_State::FREE);
+        }
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
     }
 
-    void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
-        m_send_json_callback.Set_Callback(send_json_callback);
-        m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
-        m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
+    void Set_Client_Context(IAPI_Client_Context & context) override {
+        m_client_context = &context;
     }
 
   private:
-    Callback<bool, char const * const, JsonDocument const &, size_t const &> m_send_json_callback = {};         // Send json document callback
-    Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};   // Subscribe mqtt topic client callback
-    Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {}; // Unubscribe mqtt topic client callback
+    /// @brief Rebuilds the index from the hash of each subscribed method name to the position of its callback,
+    /// called whenever callbacks are subscribed, because that is expected to happen rarely compared to the amount of received requests
+    /// @return Whether rebuilding the index was successful or not
+    bool Rebuild_Method_Index() {
+        return m_method_index.rebuild(m_rpc_callbacks.size(), [this](size_t const & index) {
+            return Helper::getHashValue(m_rpc_callbacks[index].Get_Name());
+        });
+    }
+
+    /// @brief Gets the amount of slots in the table of pending asynchronous requests
+    /// @return Maximum amount of simultaneously pending asynchronous requests
+    size_t Get_Max_Pending_RPC() const {
+#if THINGSBOARD_ENABLE_DYNAMIC
+        return m_max_pending_rpc;
+#else
+        return MaxPendingRPC;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    }
+
+    /// @brief Changes the state of the given slot, but only if it is currently in the expected state
+    /// @param pending Slot whose state should be changed
+    /// @param expected State the slot has to be in currently
+    /// @param desired State the slot should be changed to
+    /// @return Whether the slot was in the expected state and has been changed
+    static bool Transition_Pending_RPC(Pending_RPC & pending, Pending_RPC_State const & expected, Pending_RPC_State const & desired) {
+#if THINGSBOARD_ENABLE_STL
+        uint8_t current = static_cast<uint8_t>(expected);
+        return pending.state.compare_exchange_strong(current, static_cast<uint8_t>(desired));
+#else
+        if (pending.state != static_cast<uint8_t>(expected)) {
+            return false;
+        }
+        pending.state = static_cast<uint8_t>(desired);
+        return true;
+#endif // THINGSBOARD_ENABLE_STL
+    }
+
+    /// @brief Reserves a free slot for the received asynchronous request
+    /// @param request_id Id the server sent the request with
+    /// @return Position of the reserved slot or PENDING_RPC_INVALID_SLOT if all slots are in use
+    uint16_t Allocate_Pending_RPC(size_t const & request_id) {
+        for (size_t i = 0U; i < Get_Max_Pending_RPC(); ++i) {
+            Pending_RPC & pending = m_pending_rpc[i];
+            if (pending.state != static_cast<uint8_t>(Pending_RPC_State::FREE)) {
+                continue;
+            }
+            pending.generation++;
+            pending.age = 0U;
+            pending.request_id = request_id;
+            pending.response = nullptr;
+            pending.state = static_cast<uint8_t>(Pending_RPC_State::PENDING);
+            return i;
+        }
+        return PENDING_RPC_INVALID_SLOT;
+    }
+
+    /// @brief Arms the timer that checks for abandoned requests, if it is not already armed. Instead of one timer per request,
+    /// one timer is armed for a fraction of the timeout and counts the age of each pending request, which abandons them between 100% and 125% of the configured timeout
+    void Start_Pending_Sweep() {
+        if (m_pending_timeout == 0U || m_sweep_handle != INVALID_TIMER_HANDLE) {
+            return;
+        }
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
+        if (timer_wheel == nullptr) {
+            return;
+        }
+        m_sweep_handle = timer_wheel->arm(m_pending_timeout / PENDING_RPC_SWEEP_STEPS, m_sweep_callback);
+    }
+
+    /// @brief Cancels the timer that checks for abandoned requests, so that the timer wheel does not call into an instance that has been unsubscribed or destroyed
+    void Stop_Pending_Sweep() {
+        if (m_sweep_handle == INVALID_TIMER_HANDLE) {
+            return;
+        }
+        Timer_Wheel * timer_wheel = m_client_context->Get_Timer_Wheel();
+        if (timer_wheel != nullptr) {
+            (void)timer_wheel->cancel(m_sweep_handle);
+        }
+        m_sweep_handle = INVALID_TIMER_HANDLE;
+    }
+
+    /// @brief Ages all pending requests and abandons the ones that have been pending for longer than the timeout, called by the timer wheel
+    void Sweep_Pending_RPC() {
+        m_sweep_handle = INVALID_TIMER_HANDLE;
+        bool remaining = false;
+        for (size_t i = 0U; i < Get_Max_Pending_RPC(); ++i) {
+            Pending_RPC & pending = m_pending_rpc[i];
+            if (pending.state != static_cast<uint8_t>(Pending_RPC_State::PENDING)) {
+                continue;
+            }
+            else if (++pending.age > PENDING_RPC_SWEEP_STEPS && Transition_Pending_RPC(pending, Pending_RPC_State::PENDING, Pending_RPC_State::FREE)) {
+                Logger::printfln(PENDING_RPC_ABANDONED, pending.request_id);
+                continue;
+            }
+            remaining = true;
+        }
+        if (remaining) {
+            Start_Pending_Sweep();
+        }
+    }
+
+#if !THINGSBOARD_ENABLE_STL
+    static void staticSweepPendingRPC() {
+        if (m_subscribedInstance == nullptr) {
+            return;
+        }
+        m_subscribedInstance->Sweep_Pending_RPC();
+    }
+
+    // Used API Implementation cannot call a instanced method when the timer expires.
+    // Only free-standing function is allowed.
+    // To be able to forward event to an instance, rather than to a function, this pointer exists.
+    static Server_Side_RPC                                                   *m_subscribedInstance;
+#endif // !THINGSBOARD_ENABLE_STL
+
+    IAPI_Client_Context *                                                    m_client_context = &Unbound_Client_Context::Get_Instance(); // Non-owning pointer to the client this API implementation communicates with the cloud over
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
@@ -221,6 +515,34 @@ class Server_Side_RPC : public IAPI_Implementation {
 #else
     Array<RPC_Callback, MaxSubscriptions>                                    m_rpc_callbacks = {};              // Server side RPC callbacks array
 #endif // THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Hash_Index                                                               m_method_index = {};               // Index from the hash of the method name to the position of the server side RPC callback
+#else
+    Hash_Index<MaxSubscriptions>                                             m_method_index = {};               // Index from the hash of the method name to the position of the server side RPC callback
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<RPC_Async_Callback>                                               m_rpc_async_callbacks = {};        // Asynchronous server side RPC callbacks vector
+    Hash_Index                                                               m_async_method_index = {};         // Index from the hash of the method name to the position of the asynchronous server side RPC callback
+    Pending_RPC                                                              *m_pending_rpc = {};               // Table of asynchronous requests waiting for their completion, allocated once with the maximum amount of pending requests
+    size_t                                                                   m_max_pending_rpc = {};            // Amount of slots in the table of pending requests
+#else
+    Array<RPC_Async_Callback, MaxSubscriptions>                              m_rpc_async_callbacks = {};        // Asynchronous server side RPC callbacks array
+    Hash_Index<MaxSubscriptions>                                             m_async_method_index = {};         // Index from the hash of the method name to the position of the asynchronous server side RPC callback
+    Pending_RPC                                                              m_pending_rpc[MaxPendingRPC] = {}; // Table of asynchronous requests waiting for their completion
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    uint64_t                                                                 m_pending_timeout = {};            // Amount of microseconds after which pending requests are abandoned, 0 if they are never abandoned
+    Callback<void>                                                           m_sweep_callback = {};             // Callback armed in the timer wheel to check for abandoned requests
+    Timer_Handle                                                             m_sweep_handle = {};               // Handle of the armed timer that checks for abandoned requests
 };
 
+#if !THINGSBOARD_ENABLE_STL
+#if THINGSBOARD_ENABLE_DYNAMIC
+template <typename Logger>
+Server_Side_RPC<Logger> *Server_Side_RPC<Logger>::m_subscribedInstance = nullptr;
+#else
+template<size_t MaxSubscriptions, size_t MaxRPC, typename Logger, size_t MaxPendingRPC>
+Server_Side_RPC<MaxSubscriptions, MaxRPC, Logger, MaxPendingRPC> *Server_Side_RPC<MaxSubscriptions, MaxRPC, Logger, MaxPendingRPC>::m_subscribedInstance = nullptr;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+#endif // !THINGSBOARD_ENABLE_STL
+
 #endif // Server_Side_RPC_h
@@ -4,6 +4,7 @@
 // Local includes.
 #include "Shared_Attribute_Callback.h"
 #include "IAPI_Implementation.h"
+#include "Hash_Index.h"
 
 
 // Log messages.
@@ -12,6 +13,15 @@ char constexpr SHARED_ATTRIBUTE_UPDATE_SUBSCRIPTIONS[] = "shared attribute updat
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
 
 
+/// @brief Distinct attribute key at least one shared attribute callback is subscribed to,
+/// the positions of the subscribed callbacks are stored contiguously in a seperate container, so that the key can be resolved to all its subscribers with a single lookup
+struct Shared_Attribute_Key {
+    char const * key = {};         // Attribute key, points to the key stored in the first subscribed callback
+    uint16_t     first = {};       // Position of the first subscriber of this key in the container of subscribers
+    uint16_t     count = {};       // Amount of subscribers of this key
+};
+
+
 /// @brief Handles the internal implementation of the ThingsBoard shared attribute update API.
 /// See https://thingsboard.io/docs/reference/mqtt-api/#subscribe-to-attribute-updates-from-the-server for more information
 /// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
@@ -51,10 +61,10 @@ class Shared_Attribute_Update : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
+        (void)m_client_context->Subscribe_Topic(ATTRIBUTE_TOPIC);
         // Push back complete vector into our local m_shared_attribute_update_callbacks vector.
         m_shared_attribute_update_callbacks.insert(m_shared_attribute_update_callbacks.end(), first, last);
-        return true;
+        return Rebuild_Attribute_Index();
     }
 
     /// @brief Subscribe one shared attribute callback,
@@ -78,9 +88,9 @@ class Shared_Attribute_Update : public IAPI_Implementation {
             return false;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-        (void)m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
+        (void)m_client_context->Subscribe_Topic(ATTRIBUTE_TOPIC);
         m_shared_attribute_update_callbacks.push_back(callback);
-        return true;
+        return Rebuild_Attribute_Index();
     }
 
     /// @brief Unsubcribes all shared attribute callbacks.
@@ -89,7 +99,11 @@ class Shared_Attribute_Update : public IAPI_Implementation {
     /// and from the attribute topic, was successful or not
     bool Shared_Attributes_Unsubscribe() {
         m_shared_attribute_update_callbacks.clear();
-        return m_unsubscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC);
+        m_attribute_keys.clear();
+        m_key_subscribers.clear();
+        m_dispatch_marks.clear();
+        m_key_index.clear();
+        return m_client_context->Unsubscribe_Topic(ATTRIBUTE_TOPIC);
     }
 
     API_Process_Type Get_Process_Type() const override {
@@ -106,60 +120,41 @@ class Shared_Attribute_Update : public IAPI_Implementation {
             object = object[SHARED_RESPONSE_KEY];
         }
 
-#if THINGSBOARD_ENABLE_STL
-#if THINGSBOARD_ENABLE_CXX20
-#if THINGSBOARD_ENABLE_DYNAMIC
-        auto filtered_shared_attribute_update_callbacks = m_shared_attribute_update_callbacks | std::views::filter([&object](Shared_Attribute_Callback const & shared_attribute) {
-#else
-        auto filtered_shared_attribute_update_callbacks = m_shared_attribute_update_callbacks | std::views::filter([&object](Shared_Attribute_Callback<MaxAttributes> const & shared_attribute) {
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-#else
-#if THINGSBOARD_ENABLE_DYNAMIC
-        Vector<Shared_Attribute_Callback> filtered_shared_attribute_update_callbacks = {};
-        std::copy_if(m_shared_attribute_update_callbacks.begin(), m_shared_attribute_update_callbacks.end(), std::back_inserter(filtered_shared_attribute_update_callbacks), [&object](Shared_Attribute_Callback const & shared_attribute) {
-#else
-        Array<Shared_Attribute_Callback<MaxAttributes>, MaxSubscriptions> filtered_shared_attribute_update_callbacks = {};
-        std::copy_if(m_shared_attribute_update_callbacks.begin(), m_shared_attribute_update_callbacks.end(), std::back_inserter(filtered_shared_attribute_update_callbacks), [&object](Shared_Attribute_Callback<MaxAttributes> const & shared_attribute) {
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-#endif // THINGSBOARD_ENABLE_CXX20
-            return (shared_attribute.Get_Attributes().empty() || std::find_if(shared_attribute.Get_Attributes().begin(), shared_attribute.Get_Attributes().end(), [&object](const char * att) {
-                return object.containsKey(att);
-            }) != shared_attribute.Get_Attributes().end());
-        });
-
-        for (auto const & shared_attribute : filtered_shared_attribute_update_callbacks) {
-#else
-        for (auto const & shared_attribute : m_shared_attribute_update_callbacks) {
-            if (shared_attribute.Get_Attributes().empty()) {
-                // No specifc keys were subscribed so we call the callback anyway, assumed to be subscribed to any update
-                shared_attribute.Call_Callback(object);
+        // Every received key is resolved to its subscribers with a single lookup, instead of checking every subscribed key of every callback with containsKey,
+        // which is a linear search through the received object itself. Callbacks are only marked while iterating, so that each callback is called atmost once
+        // and in the order it was subscribed in, even if multiple of its keys have been received
+        m_dispatch_generation++;
+        for (JsonPairConst const pair : object) {
+            char const * key = pair.key().c_str();
+            if (Helper::stringIsNullorEmpty(key)) {
                 continue;
             }
-
-            char const * requested_att = nullptr;
-
-            for (auto const & att : shared_attribute.Get_Attributes()) {
-                if (Helper::stringIsNullorEmpty(att)) {
-                    continue;
-                }
-                // Check if the request contained any of our requested keys and
-                // break early if the key was requested from this callback.
-                if (object.containsKey(att)) {
-                    requested_att = att;
-                    break;
-                }
+            uint16_t const index = m_key_index.find(Helper::getHashValue(key), [this, &key](uint16_t const & position) {
+                return strcmp(m_attribute_keys[position].key, key) == 0;
+            });
+            if (index == HASH_INDEX_EMPTY_SLOT) {
+                continue;
+            }
+            Shared_Attribute_Key const & attribute_key = m_attribute_keys[index];
+            for (size_t i = attribute_key.first; i < attribute_key.first + attribute_key.count; ++i) {
+                m_dispatch_marks[m_key_subscribers[i]] = m_dispatch_generation;
             }
+        }
 
-            // Check if this callback did not request any keys that were in this response,
-            // if there were not we simply continue with the next subscribed callback.
-            if (requested_att == nullptr) {
+        for (size_t i = 0U; i < m_shared_attribute_update_callbacks.size(); ++i) {
+            auto const & shared_attribute = m_shared_attribute_update_callbacks[i];
+            // No specifc keys were subscribed so we call the callback anyway, assumed to be subscribed to any update
+            if (!shared_attribute.Get_Attributes().empty() && m_dispatch_marks[i] != m_dispatch_generation) {
                 continue;
             }
-#endif // THINGSBOARD_ENABLE_STL
             shared_attribute.Call_Callback(object);
         }
     }
 
+    char const * Get_Response_Topic_Prefix() const override {
+        return ATTRIBUTE_TOPIC;
+    }
+
     bool Compare_Response_Topic(char const * topic) const override {
         return strncmp(ATTRIBUTE_TOPIC, topic, strlen(ATTRIBUTE_TOPIC) + 1) == 0;
     }
@@ -169,31 +164,87 @@ class Shared_Attribute_Update : public IAPI_Implementation {
     }
 
     bool Resubscribe_Topic() override {
-        if (!m_shared_attribute_update_callbacks.empty() && !m_subscribe_topic_callback.Call_Callback(ATTRIBUTE_TOPIC)) {
+        if (!m_shared_attribute_update_callbacks.empty() && !m_client_context->Subscribe_Topic(ATTRIBUTE_TOPIC)) {
             Logger::printfln(SUBSCRIBE_TOPIC_FAILED, ATTRIBUTE_TOPIC);
             return false;
         }
         return true;
     }
 
-#if !THINGSBOARD_USE_ESP_TIMER
     void loop() override {
         // Nothing to do
     }
-#endif // !THINGSBOARD_USE_ESP_TIMER
 
     void Initialize() override {
         // Nothing to do
     }
 
-    void Set_Client_Callbacks(Callback<void, IAPI_Implementation &>::function subscribe_api_callback, Callback<bool, char const * const, JsonDocument const &, size_t const &>::function send_json_callback, Callback<bool, char const * const, char const * const>::function send_json_string_callback, Callback<bool, char const * const>::function subscribe_topic_callback, Callback<bool, char const * const>::function unsubscribe_topic_callback, Callback<uint16_t>::function get_receive_size_callback, Callback<uint16_t>::function get_send_size_callback, Callback<bool, uint16_t, uint16_t>::function set_buffer_size_callback, Callback<size_t *>::function get_request_id_callback) override {
-        m_subscribe_topic_callback.Set_Callback(subscribe_topic_callback);
-        m_unsubscribe_topic_callback.Set_Callback(unsubscribe_topic_callback);
+    void Set_Client_Context(IAPI_Client_Context & context) override {
+        m_client_context = &context;
     }
 
   private:
-    Callback<bool, char const * const>                                       m_subscribe_topic_callback = {};          // Subscribe mqtt topic client callback
-    Callback<bool, char const * const>                                       m_unsubscribe_topic_callback = {};        // Unubscribe mqtt topic client callback
+    /// @brief Rebuilds the index from each subscribed attribute key to the callbacks subscribed to it, called whenever callbacks are subscribed.
+    /// Keys subscribed by multiple callbacks are only stored once, with the positions of all its subscribers stored contiguously
+    /// @return Whether rebuilding the index was successful or not
+    bool Rebuild_Attribute_Index() {
+        m_attribute_keys.clear();
+        m_key_subscribers.clear();
+        m_dispatch_marks.clear();
+
+        // Count the subscribers of each distinct key first, so that the subscribers of each key can be placed next to each other afterwards
+        for (size_t i = 0U; i < m_shared_attribute_update_callbacks.size(); ++i) {
+            m_dispatch_marks.push_back(0U);
+            for (auto const & att : m_shared_attribute_update_callbacks[i].Get_Attributes()) {
+                if (Helper::stringIsNullorEmpty(att)) {
+                    continue;
+                }
+                Shared_Attribute_Key * attribute_key = Find_Attribute_Key(att);
+                if (attribute_key == nullptr) {
+                    Shared_Attribute_Key new_key = {};
+                    new_key.key = att;
+                    m_attribute_keys.push_back(new_key);
+                    attribute_key = &m_attribute_keys[m_attribute_keys.size() - 1U];
+                }
+                attribute_key->count++;
+                m_key_subscribers.push_back(0U);
+            }
+        }
+
+        size_t offset = 0U;
+        for (auto & attribute_key : m_attribute_keys) {
+            attribute_key.first = offset;
+            offset += attribute_key.count;
+            attribute_key.count = 0U;
+        }
+        for (size_t i = 0U; i < m_shared_attribute_update_callbacks.size(); ++i) {
+            for (auto const & att : m_shared_attribute_update_callbacks[i].Get_Attributes()) {
+                if (Helper::stringIsNullorEmpty(att)) {
+                    continue;
+                }
+                Shared_Attribute_Key * attribute_key = Find_Attribute_Key(att);
+                m_key_subscribers[attribute_key->first + attribute_key->count++] = i;
+            }
+        }
+
+        return m_key_index.rebuild(m_attribute_keys.size(), [this](size_t const & index) {
+            return Helper::getHashValue(m_attribute_keys[index].key);
+        });
+    }
+
+    /// @brief Searches the distinct attribute key with the given name, only used while rebuilding the index
+    /// @param key Attribute key that should be searched
+    /// @return Pointer to the matching distinct attribute key or nullptr if it has not been added yet
+    Shared_Attribute_Key * Find_Attribute_Key(char const * key) {
+        for (auto & attribute_key : m_attribute_keys) {
+            if (strcmp(attribute_key.key, key) == 0) {
+                return &attribute_key;
+            }
+        }
+        return nullptr;
+    }
+
+    IAPI_Client_Context *                                                    m_client_context = &Unbound_Client_Context::Get_Instance(); // Non-owning pointer to the client this API implementation communicates with the cloud over
 
     // Vectors or array (depends on wheter if THINGSBOARD_ENABLE_DYNAMIC is set to 1 or 0), hold copy of the actual passed data, this is to ensure they stay valid,
     // even if the user only temporarily created the object before the method was called.
@@ -208,6 +259,18 @@ class Shared_Attribute_Update : public IAPI_Implementation {
 #else
     Array<Shared_Attribute_Callback<MaxAttributes>, MaxSubscriptions>        m_shared_attribute_update_callbacks = {}; // Shared attribute update callbacks array
 #endif // THINGSBOARD_ENABLE_DYNAMIC
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Shared_Attribute_Key>                                             m_attribute_keys = {};                    // Distinct attribute keys the callbacks are subscribed to
+    Vector<uint16_t>                                                         m_key_subscribers = {};                   // Positions of the callbacks subscribed to each distinct key, grouped by key
+    Vector<uint32_t>                                                         m_dispatch_marks = {};                    // Generation of the last received message that contained a key the callback at the same position is subscribed to
+    Hash_Index                                                               m_key_index = {};                         // Index from the hash of the attribute key to the position of the distinct key
+#else
+    Array<Shared_Attribute_Key, MaxSubscriptions * MaxAttributes>            m_attribute_keys = {};                    // Distinct attribute keys the callbacks are subscribed to
+    Array<uint16_t, MaxSubscriptions * MaxAttributes>                        m_key_subscribers = {};                   // Positions of the callbacks subscribed to each distinct key, grouped by key
+    Array<uint32_t, MaxSubscriptions>                                        m_dispatch_marks = {};                    // Generation of the last received message that contained a key the callback at the same position is subscribed to
+    Hash_Index<MaxSubscriptions * MaxAttributes>                             m_key_index = {};                         // Index from the hash of the attribute key to the position of the distinct key
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+    uint32_t                                                                 m_dispatch_generation = {};               // Incremented for every received message, so that the marks do not have to be reset
 };
 
 #endif // Shared_Attribute_Update_h
@@ -1,6 +1,9 @@
 // Header include.
 #include "Telemetry.h"
 
+// Library includes.
+#include <math.h>
+
 Telemetry::Telemetry()
   : m_type(DataType::TYPE_NONE)
   , m_key(nullptr)
@@ -28,3 +31,121 @@ Telemetry::Telemetry(char const * key, char const * value)
 bool Telemetry::IsEmpty() const {
     return (m_key == nullptr) && m_type == DataType::TYPE_NONE;
 }
+
+char Telemetry::Get_Escape_Character(char const & character) {
+    switch (character) {
+        case '"':
+            return '"';
+        case '\\':
+            return '\\';
+        case '\b':
+            return 'b';
+        case '\f':
+            return 'f';
+        case '\n':
+            return 'n';
+        case '\r':
+            return 'r';
+        case '\t':
+            return 't';
+        default:
+            // Nothing to do
+            break;
+    }
+    return '\0';
+}
+
+size_t Telemetry::Format_Integer(int64_t const & value, char * buffer) {
+    size_t length = 0U;
+    // Calculated with unsigned arithmetic, because the magnitude of the smallest possible value does not fit into a signed integer
+    uint64_t magnitude = static_cast<uint64_t>(value);
+    if (value < 0) {
+        buffer[length++] = '-';
+        magnitude = 0U - magnitude;
+    }
+    // Digits are created from the lowest to the highest, therefore they are written from the end of a temporary buffer backwards
+    char digits[MAX_NUMBER_STRING_LENGTH] = {};
+    size_t position = sizeof(digits);
+    do {
+        digits[--position] = '0' + (magnitude % 10U);
+        magnitude /= 10U;
+    } while (magnitude != 0U);
+    memcpy(buffer + length, digits + position, sizeof(digits) - position);
+    return length + sizeof(digits) - position;
+}
+
+size_t Telemetry::Format_Real(double value, char * buffer) {
+    if (isnan(value) || isinf(value)) {
+        memcpy(buffer, JSON_NULL, strlen(JSON_NULL));
+        return strlen(JSON_NULL);
+    }
+    size_t length = 0U;
+    if (value < 0.0) {
+        buffer[length++] = '-';
+        value = -value;
+    }
+
+    // Bring very big or small values into a range where the integral part fits into 32 bits and the decimal places are still significant,
+    // by dividing or multiplying with the binary decomposition of the exponent, which requires atmost 9 steps instead of one step per power of ten
+    static double constexpr POSITIVE_POWERS[] = { 1e1, 1e2, 1e4, 1e8, 1e16, 1e32, 1e64, 1e128, 1e256 };
+    static double constexpr NEGATIVE_POWERS[] = { 1e-1, 1e-2, 1e-4, 1e-8, 1e-16, 1e-32, 1e-64, 1e-128, 1e-256 };
+    size_t constexpr POWERS_AMOUNT = sizeof(POSITIVE_POWERS) / sizeof(POSITIVE_POWERS[0]);
+    int16_t exponent = 0;
+    if (value >= 1e7) {
+        for (size_t i = POWERS_AMOUNT; i > 0U; --i) {
+            if (value >= POSITIVE_POWERS[i - 1U]) {
+                value /= POSITIVE_POWERS[i - 1U];
+                exponent += 1 << (i - 1U);
+            }
+        }
+    }
+    if (value > 0.0 && value <= 1e-5) {
+        for (size_t i = POWERS_AMOUNT; i > 0U; --i) {
+            if (value < NEGATIVE_POWERS[i - 1U]) {
+                value *= POSITIVE_POWERS[i - 1U];
+                exponent -= 1 << (i - 1U);
+            }
+        }
+        if (value < 1.0) {
+            value *= 10.0;
+            exponent--;
+        }
+    }
+
+    uint32_t integral = static_cast<uint32_t>(value);
+    double remainder = (value - integral) * 1e9;
+    uint32_t decimal = static_cast<uint32_t>(remainder);
+    remainder -= decimal;
+    // Round to the nearest decimal place, which might carry over into the integral part and the exponent
+    if (remainder >= 0.5) {
+        decimal++;
+        if (decimal >= 1000000000U) {
+            decimal = 0U;
+            integral++;
+            if (exponent != 0 && integral >= 10U) {
+                exponent++;
+                integral = 1U;
+            }
+        }
+    }
+    uint8_t decimal_places = 9U;
+    while (decimal_places > 0U && decimal % 10U == 0U) {
+        decimal /= 10U;
+        decimal_places--;
+    }
+
+    length += Format_Integer(integral, buffer + length);
+    if (decimal_places > 0U) {
+        buffer[length++] = '.';
+        for (uint8_t i = decimal_places; i > 0U; --i) {
+            buffer[length + i - 1U] = '0' + (decimal % 10U);
+            decimal /= 10U;
+        }
+        length += decimal_places;
+    }
+    if (exponent != 0) {
+        buffer[length++] = 'e';
+        length += Format_Integer(exponent, buffer + length);
+    }
+    return length;
+}
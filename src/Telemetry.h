@@ -6,11 +6,18 @@
 
 // Library includes.
 #include <ArduinoJson.h>
+#include <string.h>
 #if THINGSBOARD_ENABLE_STL
 #include <type_traits>
 #endif // THINGSBOARD_ENABLE_STL
 
 
+size_t constexpr MAX_NUMBER_STRING_LENGTH = 32U;
+char constexpr JSON_NULL[] = "null";
+char constexpr JSON_TRUE[] = "true";
+char constexpr JSON_FALSE[] = "false";
+
+
 /// @brief Telemetry record class, allows to store different data using a common interface,
 /// is used to allow to easily create a key-value pair of multiple different types that can then be deserialized into a json message
 class Telemetry {
@@ -112,7 +119,100 @@ class Telemetry {
         return false;
     }
 
+    /// @brief Writes the key value pair as serialized json ("key":value) directly into the given output, without creating an intermediate JsonDocument.
+    /// The key and string values are escaped the same way ArduinoJson escapes them, numbers are formatted without using printf.
+    /// Passing an output that only counts the written bytes allows to measure the exact size the serialized key value pair requires
+    /// @tparam TOutput Output class the serialized key value pair should be written into, requires a size_t write(uint8_t const *, size_t) method that returns the amount of bytes written
+    /// @param output Output the serialized key value pair should be written into
+    /// @return Amount of bytes written into the output or 0 if this record has no key or value
+    template <typename TOutput>
+    size_t WriteKeyValue(TOutput & output) const {
+        if (m_key == nullptr || m_type == DataType::TYPE_NONE) {
+            return 0U;
+        }
+        size_t const written = Write_String(output, m_key) + Write_Text(output, ":", 1U);
+        return written + WriteValue(output);
+    }
+
+    /// @brief Writes only the value as serialized json directly into the given output, ignoring the key.
+    /// Allows to fill the value slots of a json object whose keys have already been written, like the Telemetry_Schema does
+    /// @tparam TOutput Output class the serialized value should be written into, requires a size_t write(uint8_t const *, size_t) method that returns the amount of bytes written
+    /// @param output Output the serialized value should be written into
+    /// @return Amount of bytes written into the output or 0 if this record has no value
+    template <typename TOutput>
+    size_t WriteValue(TOutput & output) const {
+        char number[MAX_NUMBER_STRING_LENGTH] = {};
+        switch (m_type) {
+            case DataType::TYPE_BOOL:
+                return m_value.boolean ? Write_Text(output, JSON_TRUE, strlen(JSON_TRUE)) : Write_Text(output, JSON_FALSE, strlen(JSON_FALSE));
+            case DataType::TYPE_INT:
+                return Write_Text(output, number, Format_Integer(m_value.integer, number));
+            case DataType::TYPE_REAL:
+                return Write_Text(output, number, Format_Real(m_value.real, number));
+            case DataType::TYPE_STR:
+                return m_value.str != nullptr ? Write_String(output, m_value.str) : Write_Text(output, JSON_NULL, strlen(JSON_NULL));
+            default:
+                // Nothing to do
+                break;
+        }
+        return 0U;
+    }
+
   private:
+    /// @brief Writes the given characters unchanged into the given output
+    /// @tparam TOutput Output class the characters should be written into
+    /// @param output Output the characters should be written into
+    /// @param text Characters that should be written
+    /// @param length Amount of characters that should be written
+    /// @return Amount of bytes written into the output
+    template <typename TOutput>
+    static size_t Write_Text(TOutput & output, char const * text, size_t const & length) {
+        return output.write(reinterpret_cast<uint8_t const *>(text), length);
+    }
+
+    /// @brief Writes the given string surrounded by quotes and with all characters escaped that json requires to be escaped into the given output.
+    /// Characters that do not need to be escaped are written in runs, instead of one write per character
+    /// @tparam TOutput Output class the string should be written into
+    /// @param output Output the string should be written into
+    /// @param str Null-terminated string that should be written
+    /// @return Amount of bytes written into the output
+    template <typename TOutput>
+    static size_t Write_String(TOutput & output, char const * str) {
+        size_t written = Write_Text(output, "\"", 1U);
+        char const * run = str;
+        for (; *str != '\0'; ++str) {
+            char const escaped = Get_Escape_Character(*str);
+            if (escaped == '\0') {
+                continue;
+            }
+            char const sequence[2] = { '\\', escaped };
+            written += Write_Text(output, run, str - run);
+            written += Write_Text(output, sequence, sizeof(sequence));
+            run = str + 1U;
+        }
+        written += Write_Text(output, run, str - run);
+        written += Write_Text(output, "\"", 1U);
+        return written;
+    }
+
+    /// @brief Gets the character that follows the backslash in the json escape sequence of the given character
+    /// @param character Character that should be checked
+    /// @return Character of the escape sequence or \0 if the given character does not need to be escaped
+    static char Get_Escape_Character(char const & character);
+
+    /// @brief Formats the given integer as decimal digits
+    /// @param value Integer that should be formatted
+    /// @param buffer Buffer the digits are written into, has to be atleast MAX_NUMBER_STRING_LENGTH bytes big
+    /// @return Amount of characters written
+    static size_t Format_Integer(int64_t const & value, char * buffer);
+
+    /// @brief Formats the given floating point the same way ArduinoJson does, with up to 9 decimal places and an exponent for very big or small values,
+    /// NaN and infinity are formatted as null, because json does not support them
+    /// @param value Floating point that should be formatted
+    /// @param buffer Buffer the characters are written into, has to be atleast MAX_NUMBER_STRING_LENGTH bytes big
+    /// @return Amount of characters written
+    static size_t Format_Real(double value, char * buffer);
+
     /// @brief Data container, which contains one of the possibly passed values
     union Data {
         const char  *str;
@@ -0,0 +1,186 @@
+#ifndef Telemetry_Coalescer_h
+#define Telemetry_Coalescer_h
+
+// Library include.
+#include <stddef.h>
+#include <stdint.h>
+#include <string.h>
+
+
+/// @brief Header in front of each entry of the Telemetry_Coalescer, the entry text itself directly follows the header
+struct Coalesced_Entry_Header {
+    uint16_t key_length;  // Amount of characters at the start of the entry text that contain the serialized key including its quotes
+    uint16_t text_length; // Amount of characters in the entry text, which contains the serialized key value pair ("key":value)
+};
+
+
+/// @brief Accumulates serialized telemetry key value pairs in a buffer passed to it, so that they can be sent as one json object instead of one message per key value pair.
+/// Inserting a key that has already been inserted, removes the previous key value pair, so that only the most recent value of each key is sent.
+/// The entries are stored as their serialized text, which means the key and values are copied and do not need to be kept alive after they have been inserted
+class Telemetry_Coalescer {
+  public:
+    /// @brief Constructor
+    Telemetry_Coalescer()
+      : m_buffer(nullptr)
+      , m_capacity(0U)
+      , m_used(0U)
+      , m_count(0U)
+      , m_text_size(0U)
+    {
+        // Nothing to do
+    }
+
+    /// @brief Sets the buffer the entries are stored in, removes all previously inserted entries
+    /// @param buffer Pointer to the first byte of the buffer, has to be kept alive for as long as it is used. Passing nullptr disables coalescing
+    /// @param capacity Amount of bytes the given buffer can hold, each entry additionally requires sizeof(Coalesced_Entry_Header) bytes
+    void set_buffer(uint8_t * buffer, size_t const & capacity) {
+        m_buffer = buffer;
+        m_capacity = buffer != nullptr ? capacity : 0U;
+        clear();
+    }
+
+    /// @brief Whether a buffer has been set and key value pairs should therefore be coalesced
+    /// @return Whether coalescing is enabled or not
+    bool enabled() const {
+        return m_buffer != nullptr;
+    }
+
+    /// @brief Whether there are no inserted entries
+    /// @return Whether the coalescer is empty or not
+    bool empty() const {
+        return m_count == 0U;
+    }
+
+    /// @brief Gets the amount of characters the json object created by serialize() would have, without the null termination
+    /// @return Amount of characters in the serialized json object
+    size_t json_size() const {
+        return json_size(m_count, m_text_size);
+    }
+
+    /// @brief Gets the amount of characters the json object created by serialize() would have, if the given entry were to be inserted
+    /// @param text Serialized key value pair ("key":value)
+    /// @param key_length Amount of characters at the start of the text that contain the serialized key including its quotes
+    /// @param text_length Amount of characters in the text
+    /// @return Amount of characters in the serialized json object, without the null termination
+    size_t json_size_with(char const * text, size_t const & key_length, size_t const & text_length) const {
+        size_t const existing = find(text, key_length);
+        if (existing == m_used) {
+            return json_size(m_count + 1U, m_text_size + text_length);
+        }
+        return json_size(m_count, m_text_size - read_header(existing).text_length + text_length);
+    }
+
+    /// @brief Inserts the given serialized key value pair, replacing the previously inserted pair with the same key
+    /// @param text Serialized key value pair ("key":value)
+    /// @param key_length Amount of characters at the start of the text that contain the serialized key including its quotes
+    /// @param text_length Amount of characters in the text
+    /// @return Whether there was enough space left in the buffer to insert the given key value pair
+    bool insert(char const * text, size_t const & key_length, size_t const & text_length) {
+        if (text == nullptr || key_length > text_length || text_length > UINT16_MAX) {
+            return false;
+        }
+        size_t const existing = find(text, key_length);
+        size_t const removed = existing != m_used ? sizeof(Coalesced_Entry_Header) + read_header(existing).text_length : 0U;
+        size_t const required = sizeof(Coalesced_Entry_Header) + text_length;
+        if (m_used - removed + required > m_capacity) {
+            return false;
+        }
+        if (existing != m_used) {
+            remove(existing);
+        }
+        Coalesced_Entry_Header header = {};
+        header.key_length = key_length;
+        header.text_length = text_length;
+        memcpy(m_buffer + m_used, &header, sizeof(header));
+        memcpy(m_buffer + m_used + sizeof(header), text, text_length);
+        m_used += required;
+        m_count++;
+        m_text_size += text_length;
+        return true;
+    }
+
+    /// @brief Writes all inserted key value pairs as one json object into the given buffer
+    /// @param destination Buffer the json object should be written into
+    /// @param size Amount of bytes the given buffer can hold, has to be atleast json_size() + 1 to fit the null termination
+    /// @return Amount of characters written, without the null termination or 0 if the given buffer was too small
+    size_t serialize(char * destination, size_t const & size) const {
+        size_t const length = json_size();
+        if (destination == nullptr || size <= length) {
+            return 0U;
+        }
+        size_t written = 0U;
+        destination[written++] = '{';
+        for (size_t offset = 0U; offset < m_used;) {
+            Coalesced_Entry_Header const header = read_header(offset);
+            if (written != 1U) {
+                destination[written++] = ',';
+            }
+            memcpy(destination + written, m_buffer + offset + sizeof(header), header.text_length);
+            written += header.text_length;
+            offset += sizeof(header) + header.text_length;
+        }
+        destination[written++] = '}';
+        destination[written] = '\0';
+        return written;
+    }
+
+    /// @brief Removes all inserted entries
+    void clear() {
+        m_used = 0U;
+        m_count = 0U;
+        m_text_size = 0U;
+    }
+
+  private:
+    /// @brief Calculates the size of a json object containing the given amount of entries, with the given combined text length
+    /// @param count Amount of entries in the json object
+    /// @param text_size Combined length of the text of all entries
+    /// @return Amount of characters in the json object, consisting of the braces, the entries and the commas between them
+    static size_t json_size(size_t const & count, size_t const & text_size) {
+        return 2U + text_size + (count > 0U ? count - 1U : 0U);
+    }
+
+    /// @brief Copies the header of the entry at the given offset, copied instead of cast, because entries are not necessarily aligned
+    /// @param offset Position in the buffer the entry starts at
+    /// @return Header of the entry
+    Coalesced_Entry_Header read_header(size_t const & offset) const {
+        Coalesced_Entry_Header header = {};
+        memcpy(&header, m_buffer + offset, sizeof(header));
+        return header;
+    }
+
+    /// @brief Searches the entry with the same serialized key as the given text
+    /// @param text Serialized key value pair ("key":value)
+    /// @param key_length Amount of characters at the start of the text that contain the serialized key including its quotes
+    /// @return Position in the buffer the matching entry starts at or the amount of used bytes if there is none
+    size_t find(char const * text, size_t const & key_length) const {
+        size_t offset = 0U;
+        while (offset < m_used) {
+            Coalesced_Entry_Header const header = read_header(offset);
+            if (header.key_length == key_length && memcmp(m_buffer + offset + sizeof(header), text, key_length) == 0) {
+                break;
+            }
+            offset += sizeof(header) + header.text_length;
+        }
+        return offset;
+    }
+
+    /// @brief Removes the entry at the given offset and moves all following entries to close the gap
+    /// @param offset Position in the buffer the entry starts at
+    void remove(size_t const & offset) {
+        Coalesced_Entry_Header const header = read_header(offset);
+        size_t const size = sizeof(header) + header.text_length;
+        memmove(m_buffer + offset, m_buffer + offset + size, m_used - offset - size);
+        m_used -= size;
+        m_count--;
+        m_text_size -= header.text_length;
+    }
+
+    uint8_t * m_buffer = {};    // Buffer the entries are stored in
+    size_t    m_capacity = {};  // Amount of bytes the buffer can hold
+    size_t    m_used = {};      // Amount of bytes currently used by entries and their headers
+    size_t    m_count = {};     // Amount of entries currently stored
+    size_t    m_text_size = {}; // Combined length of the text of all entries
+};
+
+#endif // Telemetry_Coalescer_h
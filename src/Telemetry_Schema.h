@@ -0,0 +1,219 @@
+#ifndef Telemetry_Schema_h
+#define Telemetry_Schema_h
+
+// Local includes.
+#include "Telemetry.h"
+#include "Json_Writer.h"
+
+// Library includes.
+#include <string.h>
+
+
+// Longest possible result of formatting a real, which is either a sign, atmost 8 integral digits (rounding 9999999.9999999999 up), a decimal point and 9 decimal places
+// or a sign, 1 integral digit, a decimal point, 9 decimal places, the exponent character and an exponent with a sign and atmost 3 digits, whichever is longer
+size_t constexpr MAX_REAL_STRING_LENGTH = 19U;
+size_t constexpr JSON_NULL_LENGTH = 4U;
+size_t constexpr JSON_FALSE_LENGTH = 5U;
+
+
+/// @brief Calculates the length of the given null-terminated string at compile time
+/// @param str Null-terminated string, has to be a constant expression
+/// @return Amount of characters in the given string, without the null termination
+constexpr size_t Get_Schema_Key_Length(char const * str) {
+    return *str == '\0' ? 0U : 1U + Get_Schema_Key_Length(str + 1U);
+}
+
+/// @brief Checks at compile time whether the given key can be written into the json skeleton as is, meaning it contains no characters that json requires to be escaped
+/// @param str Null-terminated string, has to be a constant expression
+/// @return Whether the given key does not need to be escaped and is not empty
+constexpr bool Is_Valid_Schema_Key(char const * str) {
+    return *str != '\0' && *str != '"' && *str != '\\' && static_cast<unsigned char>(*str) >= 0x20U && (str[1] == '\0' || Is_Valid_Schema_Key(str + 1U));
+}
+
+/// @brief Calculates the longest possible amount of characters an integral of the given size can be formatted as
+/// @param size Amount of bytes the integral consists of
+/// @param is_signed Whether the integral can be negative, which requires an additional character for the sign
+/// @return Amount of characters the digits and the possible sign require
+constexpr size_t Get_Max_Integer_Length(size_t size, bool is_signed) {
+    return (size == 1U ? 3U : (size == 2U ? 5U : (size == 4U ? 10U : 20U))) + (is_signed ? 1U : 0U);
+}
+
+
+/// @brief Describes how values of the given type are formatted in the json skeleton of a Telemetry_Schema, the primary template is used for all integral types
+/// @tparam T Type of the value, has to be integral, floating point, bool or char const *
+/// @tparam MaxStringLength Maximum amount of characters a string value may contain, ignored for all other types
+template <typename T, size_t MaxStringLength>
+struct Schema_Value {
+#if THINGSBOARD_ENABLE_STL
+    static_assert(std::is_integral<T>::value, "Schema values have to be integral, floating point, bool or char const *");
+#else
+    static_assert(ArduinoJson::ARDUINOJSON_VERSION_NAMESPACE::detail::is_integral<T>::value, "Schema values have to be integral, floating point, bool or char const *");
+#endif // THINGSBOARD_ENABLE_STL
+    static size_t constexpr MAX_LENGTH = Get_Max_Integer_Length(sizeof(T), static_cast<T>(-1) < static_cast<T>(0));
+
+    static bool Fits(T const & value) {
+        return true;
+    }
+};
+
+template <size_t MaxStringLength>
+struct Schema_Value<bool, MaxStringLength> {
+    static size_t constexpr MAX_LENGTH = JSON_FALSE_LENGTH;
+
+    static bool Fits(bool const & value) {
+        return true;
+    }
+};
+
+template <size_t MaxStringLength>
+struct Schema_Value<float, MaxStringLength> {
+    static size_t constexpr MAX_LENGTH = MAX_REAL_STRING_LENGTH;
+
+    static bool Fits(float const & value) {
+        return true;
+    }
+};
+
+template <size_t MaxStringLength>
+struct Schema_Value<double, MaxStringLength> {
+    static size_t constexpr MAX_LENGTH = MAX_REAL_STRING_LENGTH;
+
+    static bool Fits(double const & value) {
+        return true;
+    }
+};
+
+template <size_t MaxStringLength>
+struct Schema_Value<char const *, MaxStringLength> {
+    static_assert(MaxStringLength > 0U, "String schema values require the maximum string length to be set");
+    // Each character might have to be escaped, which doubles its length, additionally the string is surrounded by quotes or written as null if it does not exist
+    static size_t constexpr MAX_LENGTH = (2U * MaxStringLength + 2U) > JSON_NULL_LENGTH ? (2U * MaxStringLength + 2U) : JSON_NULL_LENGTH;
+
+    static bool Fits(char const * value) {
+        return value == nullptr || strlen(value) <= MaxStringLength;
+    }
+};
+
+
+/// @brief Single key of a Telemetry_Schema, with the type of the value that is sent with the key
+/// @tparam Key Key of the key value pair, has to be a constexpr char array with static storage duration (constexpr char TEMPERATURE_KEY[] = "temperature";),
+/// because the key is checked and measured at compile time it may not contain characters that json requires to be escaped
+/// @tparam T Type of the value that is sent with the key, has to be integral, floating point, bool or char const *
+/// @tparam MaxStringLength Maximum amount of characters a char const * value may contain, required for string values to calculate the maximum payload size, default = 0
+template <char const * Key, typename T, size_t MaxStringLength = 0U>
+struct Telemetry_Field {
+    static_assert(Is_Valid_Schema_Key(Key), "Schema keys may not be empty and may not contain quotes, backslashes or control characters");
+
+    using value_type = T;
+    using value_format = Schema_Value<T, MaxStringLength>;
+
+    static size_t constexpr KEY_LENGTH = Get_Schema_Key_Length(Key);
+    // Quotes around the key and the colon seperating it from the value
+    static size_t constexpr MAX_SIZE = KEY_LENGTH + 3U + value_format::MAX_LENGTH;
+
+    static char const * key() {
+        return Key;
+    }
+};
+
+template <char const * Key, typename T, size_t MaxStringLength>
+size_t constexpr Telemetry_Field<Key, T, MaxStringLength>::KEY_LENGTH;
+
+template <char const * Key, typename T, size_t MaxStringLength>
+size_t constexpr Telemetry_Field<Key, T, MaxStringLength>::MAX_SIZE;
+
+
+/// @brief Recursively writes the fields of a Telemetry_Schema, specialized below for the last field and the empty schema
+/// @tparam Fields Telemetry_Field instances that have not been written yet
+template <typename... Fields>
+struct Schema_Writer;
+
+template <>
+struct Schema_Writer<> {
+    static size_t constexpr MAX_SIZE = 0U;
+
+    static size_t Write(Json_Buffer_Writer & writer, bool first) {
+        return 0U;
+    }
+};
+
+template <typename Field, typename... Remaining>
+struct Schema_Writer<Field, Remaining...> {
+    // Every field besides the first one is preceeded by a comma
+    static size_t constexpr MAX_SIZE = Field::MAX_SIZE + Schema_Writer<Remaining...>::MAX_SIZE + (sizeof...(Remaining) > 0U ? 1U : 0U);
+
+    template <typename Value, typename... Values>
+    static size_t Write(Json_Buffer_Writer & writer, bool first, Value const & value, Values const &... values) {
+        typename Field::value_type const converted = value;
+        if (!Field::value_format::Fits(converted)) {
+            return 0U;
+        }
+        uint8_t const separator = ',';
+        uint8_t const quote = '"';
+        uint8_t const key_end[2] = { '"', ':' };
+        size_t written = first ? 0U : writer.write(&separator, 1U);
+        written += writer.write(&quote, 1U);
+        written += writer.write(reinterpret_cast<uint8_t const *>(Field::key()), Field::KEY_LENGTH);
+        written += writer.write(key_end, sizeof(key_end));
+        size_t const value_size = Telemetry(nullptr, converted).WriteValue(writer);
+        if (value_size == 0U) {
+            return 0U;
+        }
+        size_t const remaining_size = Schema_Writer<Remaining...>::Write(writer, false, values...);
+        if (sizeof...(Remaining) > 0U && remaining_size == 0U) {
+            return 0U;
+        }
+        return written + value_size + remaining_size;
+    }
+};
+
+
+/// @brief Compile-time description of a fixed set of telemetry keys and the types of their values, for devices that send the same keys every time.
+/// Calculates the exact maximum size of the resulting json object at compile time, meaning the buffer the values are formatted into can be allocated with exactly that size,
+/// instead of estimating the size of an intermediate JsonDocument. Because the keys are checked at compile time they are copied as is, only the values are formatted at runtime.
+/// Can be sent with the sendTelemetry() overload of the ThingsBoard class that receives a schema and the values for all of its fields in the same order
+/// @tparam Fields Telemetry_Field instances, one for each key of the resulting json object
+template <typename... Fields>
+class Telemetry_Schema {
+  public:
+    static_assert(sizeof...(Fields) > 0U, "Telemetry schemas require atleast one field");
+
+    /// @brief Amount of key value pairs in the resulting json object
+    static size_t constexpr FIELD_AMOUNT = sizeof...(Fields);
+    /// @brief Maximum amount of characters the resulting json object can consist of including the surrounding braces, without the null termination
+    static size_t constexpr MAX_JSON_SIZE = Schema_Writer<Fields...>::MAX_SIZE + 2U;
+
+    /// @brief Writes the given values into the json skeleton of this schema
+    /// @tparam Values Types of the given values, each has to be convertible to the type of the field at the same position
+    /// @param buffer Buffer the json object is written into
+    /// @param buffer_size Amount of bytes the given buffer can hold, has to be atleast MAX_JSON_SIZE, to ensure every possible value fits
+    /// @param values Values of all fields in the same order as the fields of this schema
+    /// @return Amount of characters written or 0 if the buffer was smaller than MAX_JSON_SIZE or a string value exceeded its maximum length
+    template <typename... Values>
+    static size_t Write(char * buffer, size_t const & buffer_size, Values const &... values) {
+        static_assert(sizeof...(Values) == sizeof...(Fields), "Telemetry schemas require exactly one value for each field");
+        // Ensures every write succeeds, because the maximum size already accounts for the longest possible formatting of every value
+        if (buffer == nullptr || buffer_size < MAX_JSON_SIZE) {
+            return 0U;
+        }
+        Json_Buffer_Writer writer(buffer, buffer_size);
+        uint8_t const object_begin = '{';
+        uint8_t const object_end = '}';
+        size_t written = writer.write(&object_begin, 1U);
+        size_t const fields_size = Schema_Writer<Fields...>::Write(writer, true, values...);
+        if (fields_size == 0U) {
+            return 0U;
+        }
+        written += fields_size;
+        written += writer.write(&object_end, 1U);
+        return written;
+    }
+};
+
+template <typename... Fields>
+size_t constexpr Telemetry_Schema<Fields...>::FIELD_AMOUNT;
+
+template <typename... Fields>
+size_t constexpr Telemetry_Schema<Fields...>::MAX_JSON_SIZE;
+
+#endif // Telemetry_Schema_h
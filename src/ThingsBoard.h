@@ -7,8 +7,15 @@
 #include "IMQTT_Client.h"
 #include "DefaultLogger.h"
 #include "Telemetry.h"
+#include "Topic_Router.h"
+#include "ITelemetry_Spool.h"
+#include "Telemetry_Coalescer.h"
+#include "Json_Writer.h"
+#include "Telemetry_Schema.h"
+#include "API_Pack.h"
 
 // Library includes.
+#include <ctype.h>
 #if THINGSBOARD_ENABLE_STREAM_UTILS
 #include <StreamUtils.h>
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
@@ -21,16 +28,32 @@ char constexpr UNABLE_TO_DE_SERIALIZE_JSON[] = "Unable to de-serialize received
 char constexpr INVALID_BUFFER_SIZE[] = "Send buffer size (%u) to small for the given payloads size (%u), increase with setBufferSize accordingly or install the StreamUtils library";
 char constexpr UNABLE_TO_ALLOCATE_BUFFER[] = "Allocating memory for the internal MQTT buffer failed";
 char constexpr MAX_ENDPOINTS_AMOUNT_TEMPLATE_NAME[] = "MaxEndpointsAmount";
+char constexpr UNABLE_TO_SPOOL[] = "Unable to spool (%u) bytes of data while disconnected, data is lost";
+char constexpr SPOOL_RECORD_TOO_BIG[] = "Dropping spooled record with size (%u), because it does not fit into the send buffer size (%u)";
 #if THINGSBOARD_ENABLE_DYNAMIC
 char constexpr MAXIMUM_RESPONSE_EXCEEDED[] = "Prevented allocation on the heap (%u) for JsonDocument. Discarding message that is bigger than maximum response size (%u)";
 char constexpr HEAP_ALLOCATION_FAILED[] = "Failed allocating required size (%u) for JsonDocument. Ensure there is enough heap memory left";
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 #if THINGSBOARD_ENABLE_DEBUG
+#if THINGSBOARD_ENABLE_DYNAMIC
+char constexpr RESIZING_RECEIVE_ARENA[] = "Resizing internal receive arena from size (%u) to size (%u)";
+#endif // THINGSBOARD_ENABLE_DYNAMIC
 char constexpr RECEIVE_MESSAGE[] = "Received (%u) bytes of data from server over topic (%s)";
 char constexpr ALLOCATING_JSON[] = "Allocated internal JsonDocument for MQTT server response with size (%u)";
 char constexpr SEND_MESSAGE[] = "Sending data to server over topic (%s) with data (%s)";
 char constexpr SEND_SERIALIZED[] = "Hidden, because json data is bigger than buffer, therefore showing in console is skipped";
+char constexpr SPOOLING_DATA[] = "Not connected, spooling data (%s)";
+char constexpr DRAINING_SPOOL[] = "Sending (%u) spooled records, (%u) records remaining";
 #endif // THINGSBOARD_ENABLE_DEBUG
+// Spool keys.
+char constexpr SPOOL_TIMESTAMP_PREFIX[] = "{\"ts\":";
+char constexpr SPOOL_VALUES_PREFIX[] = ",\"values\":";
+char constexpr SPOOL_TIMESTAMP_KEY[] = "ts";
+size_t constexpr SPOOL_RECORD_HEADER_SIZE = sizeof(uint8_t) + sizeof(uint64_t);
+// Spool record types.
+uint8_t constexpr SPOOL_RECORD_ATTRIBUTES = 0U;
+uint8_t constexpr SPOOL_RECORD_TELEMETRY = 1U;
+uint8_t constexpr SPOOL_RECORD_TIMESTAMPED_TELEMETRY = 2U;
 // Claim topics.
 char constexpr CLAIM_TOPIC[] = "v1/devices/me/claim";
 // Claim data keys.
@@ -47,7 +70,9 @@ char constexpr DURATION_KEY[] = "durationMs";
 /// If this feature of automatic deduction, is not needed, or not wanted because it allocates memory on the heap, then the values can be set once as template arguements.
 /// Simply set THINGSBOARD_ENABLE_DYNAMIC to 0, before including ThingsBoard.h
 /// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
-template <typename Logger = DefaultLogger>
+/// @tparam StaticAPIs API_Pack containing the API implementations that are owned by this instance and known at compile time, calls to them are dispatched without virtual calls.
+/// Additional API implementations can still be subscribed at runtime, default = API_Pack<> (none)
+template <typename Logger = DefaultLogger, typename StaticAPIs = API_Pack<>>
 #else
 /// @brief Wrapper around any arbitrary MQTT Client implementing the IMQTT_Client interface, to allow connecting and sending / retrieving data from ThingsBoard over the MQTT or MQTT with TLS/SSL protocol.
 /// BufferSize of the underlying data buffer can be changed during the runtime and the maximum amount of data points that can ever be can be set once as template argument.
@@ -59,9 +84,13 @@ template <typename Logger = DefaultLogger>
 /// @tparam MaxResponse Maximum amount of key value pair that will ever be received by ThingsBoard in one call, default = Default_Response_Amount (8)
 /// @tparam MaxEndpointsAmount Maximum amount of subscribed API endpoints, Default_Endpoints_Amount is used as the default value because it is big enough to hold one instance of every possible API Implementation, default = Default_Endpoints_Amount (7)
 /// @tparam Logger Implementation that should be used to print error messages generated by internal processes and additional debugging messages if THINGSBOARD_ENABLE_DEBUG is set, default = DefaultLogger
-template<size_t MaxResponse = Default_Response_Amount, size_t MaxEndpointsAmount = Default_Endpoints_Amount, typename Logger = DefaultLogger>
+/// @tparam MaxTimers Maximum amount of timeout timers that can be armed at the same time in the internal Timer_Wheel, shared by all requests that can timeout (attribute requests, client-side RPC, provisioning, firmware chunk requests) and the delayed work of the client (server-side RPC sweep, spool drain, coalescing flush).
+/// A full firmware chunk window alone arms up to MAX_CHUNK_WINDOW_SIZE (8) timers at the same time, default = Default_Timers_Amount (16)
+/// @tparam StaticAPIs API_Pack containing the API implementations that are owned by this instance and known at compile time, calls to them are dispatched without virtual calls.
+/// They do not count towards MaxEndpointsAmount, which only limits the API implementations subscribed at runtime, default = API_Pack<> (none)
+template<size_t MaxResponse = Default_Response_Amount, size_t MaxEndpointsAmount = Default_Endpoints_Amount, typename Logger = DefaultLogger, size_t MaxTimers = Default_Timers_Amount, typename StaticAPIs = API_Pack<>>
 #endif // THINGSBOARD_ENABLE_DYNAMIC
-class ThingsBoardSized {
+class ThingsBoardSized : public IAPI_Client_Context {
   public:
     /// @brief Constructs a ThingsBoardSized instance with the given network client that should be used to establish the connection to ThingsBoard.
     /// Directly forwards the last given arguments to the overloaded Array or Vector (THINGSBOARD_ENABLE_DYNAMIC) constructor,
@@ -116,30 +145,59 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
 #if THINGSBOARD_ENABLE_DYNAMIC
        , m_max_response_size(max_response_size)
+      , m_receive_arena_enabled(false)
+      , m_max_receive_arena_size(Default_Max_Receive_Arena_Size)
+      , m_receive_arena_shrink_interval(Default_Receive_Arena_Shrink_Interval)
+      , m_receive_arena_interval_messages(0U)
+      , m_receive_arena_interval_peak(0U)
+      , m_receive_arena_peak_size(0U)
+      , m_receive_arena_in_use(false)
+      , m_receive_arena(0U)
 #endif // THINGSBOARD_ENABLE_DYNAMIC
       , m_api_implementations(args...)
+#if !THINGSBOARD_ENABLE_DYNAMIC
+      , m_timer_entries()
+      , m_timer_wheel(m_timer_entries, MaxTimers)
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
     {
-        for (auto & api : m_api_implementations) {
+        // Iterated by index over the initially passed API implementations, because initializing one can subscribe further API implementations (OTA),
+        // which are appended to the same container and would invalidate iterators when it grows. Those are already bound and initialized when they are subscribed
+        size_t const passed_amount = m_api_implementations.size();
+        for (size_t i = 0U; i < passed_amount; ++i) {
+            IAPI_Implementation * api = m_api_implementations[i];
             if (api == nullptr) {
                 continue;
             }
-#if THINGSBOARD_ENABLE_STL
-            api->Set_Client_Callbacks(std::bind(&ThingsBoardSized::Subscribe_API_Implementation, this, std::placeholders::_1), std::bind(&ThingsBoardSized::Send_Json, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), std::bind(&ThingsBoardSized::Send_Json_String, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::clientSubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::clientUnsubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::getClientReceiveBufferSize, this), std::bind(&ThingsBoardSized::getClientSendBufferSize, this), std::bind(&ThingsBoardSized::setBufferSize, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::getRequestID, this));
-#else
-            api->Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
-#endif // THINGSBOARD_ENABLE_STL
+            Bind_API_Implementation(*api);
             api->Initialize();
+            (void)m_topic_router.insert(*api);
         }
         (void)setBufferSize(receive_buffer_size, send_buffer_size);
         // Initialize callback.
 #if THINGSBOARD_ENABLE_STL
         m_client.set_data_callback(std::bind(&ThingsBoardSized::onMQTTMessage, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3));
         m_client.set_connect_callback(std::bind(&ThingsBoardSized::Resubscribe_Topics, this));
+        m_spool_drain_callback.Set_Callback(std::bind(&ThingsBoardSized::Drain_Spool, this));
+        m_coalescing_flush_callback.Set_Callback(std::bind(&ThingsBoardSized::Flush_Coalesced_Telemetry, this));
 #else
         m_client.set_data_callback(ThingsBoardSized::onStaticMQTTMessage);
         m_client.set_connect_callback(ThingsBoardSized::staticMQTTConnect);
+        m_spool_drain_callback.Set_Callback(ThingsBoardSized::staticDrainSpool);
+        m_coalescing_flush_callback.Set_Callback(ThingsBoardSized::staticFlushCoalescedTelemetry);
         m_subscribedInstance = this;
 #endif // THINGSBOARD_ENABLE_STL
+        // Initialized last, so that API implementations subscribing further API implementations while being initialized (OTA) can already reach this instance
+        Static_API_Initializer initializer = { *this };
+        m_static_apis.for_each(initializer);
+    }
+
+    /// @brief Gets the API implementation of the given type that has been passed as part of the StaticAPIs template argument.
+    /// Allows to call its methods (RPC_Subscribe, Shared_Attributes_Subscribe, ...) directly, without having to keep a seperate instance alive and subscribe it
+    /// @tparam API Type of the API implementation, has to be contained in the StaticAPIs template argument, otherwise compilation fails
+    /// @return Reference to the API implementation owned by this instance
+    template <typename API>
+    API & getAPI() {
+        return m_static_apis.get(API_Pack_Tag<API>());
     }
 
     /// @brief Gets the currently connected MQTT Client implementation as a reference.
@@ -177,8 +235,62 @@ class ThingsBoardSized {
     void setMaxResponseSize(size_t const & max_response_size) {
         m_max_response_size = max_response_size;
     }
+
+    /// @brief Enables or disables the persistent receive arena, which is one internal JsonDocument that is reused for the payload received by all attribute requests, shared attribute updates, server-side or client-side rpc.
+    /// Instead of allocating and freeing a new JsonDocument on the heap for every received message, the arena is only reallocated once a message requires more memory than any message before it.
+    /// This prevents the heap from fragmenting on long running devices, but in exchange keeps the memory required by the largest received message allocated.
+    /// Messages that would exceed the maximum size of the arena or that are received while the arena is still in use, fall back to allocating their own JsonDocument like when the arena is disabled
+    /// @param enabled Whether received messages should be deserialized into the persistent receive arena, disabling it frees the currently allocated memory
+    /// @param max_arena_size Maximum amount of bytes the arena will grow to, 0 means the arena will grow to the size of the largest received message, which is still limited by the maximum response size, default = Default_Max_Receive_Arena_Size (0)
+    /// @param shrink_interval Amount of received messages after which the arena is shrunk to the size of the largest message received in that interval, if that size is less than half of the current arena size.
+    /// Allows to free memory again, that was only required for a few rare large messages. 0 means the arena is never shrunk, default = Default_Receive_Arena_Shrink_Interval (0)
+    void setReceiveArena(bool const & enabled, size_t const & max_arena_size = Default_Max_Receive_Arena_Size, size_t const & shrink_interval = Default_Receive_Arena_Shrink_Interval) {
+        m_receive_arena_enabled = enabled;
+        m_max_receive_arena_size = max_arena_size;
+        m_receive_arena_shrink_interval = shrink_interval;
+        m_receive_arena_interval_messages = 0U;
+        m_receive_arena_interval_peak = 0U;
+        if (!m_receive_arena_enabled || (m_max_receive_arena_size != 0U && m_receive_arena.capacity() > m_max_receive_arena_size)) {
+            Resize_Receive_Arena(0U);
+        }
+    }
+
+    /// @brief Gets the amount of bytes that are currently allocated for the persistent receive arena
+    /// @return Current size of the receive arena in bytes
+    size_t getReceiveArenaSize() const {
+        return m_receive_arena.capacity();
+    }
+
+    /// @brief Gets the highest amount of bytes that have ever been allocated for the persistent receive arena at the same time,
+    /// allows to choose a fitting maximum arena or maximum response size for the messages the device actually receives
+    /// @return Peak size of the receive arena in bytes
+    size_t getReceiveArenaPeakSize() const {
+        return m_receive_arena_peak_size;
+    }
 #endif // THINGSBOARD_ENABLE_DYNAMIC
 
+#if THINGSBOARD_ENABLE_MEMORY_STATS
+    /// @brief Gets the memory usage of the given part of the library, meaning the current and peak amount of allocated bytes and the amount of allocations.
+    /// Allows to right-size MaxResponse, the buffer sizes, the maximum stack size and the memory of an installed IAllocator from real data.
+    /// The stats are shared between all instances, because every allocation is made through the same Allocator_Policy
+    /// @param subsystem Part of the library we want to get the memory usage of
+    /// @return Memory usage of the given subsystem
+    Memory_Subsystem_Stats const & getMemoryStats(Memory_Subsystem const & subsystem) const {
+        return Memory_Stats::Get(subsystem);
+    }
+
+    /// @brief Gets the combined memory usage of all parts of the library, where the peak is the heap high-water-mark of the library
+    /// @return Memory usage of all subsystems combined
+    Memory_Subsystem_Stats const & getTotalMemoryStats() const {
+        return Memory_Stats::Get_Total();
+    }
+
+    /// @brief Resets the peak values of all subsystems to their current usage, allows to measure the peak usage of a specific part of the program
+    void resetMemoryPeaks() {
+        Memory_Stats::Reset_Peaks();
+    }
+#endif // THINGSBOARD_ENABLE_MEMORY_STATS
+
     /// @brief Sets the size of the buffer for the underlying network client that will be used to establish the connection to ThingsBoard.
     /// The internal values can be changed later again, at any time with the setBufferSize() method. Is split into two arguments, because it allows seperating the buffer that received data from the one that sends data.
     /// This makes it possible to optimize the memory used and to handle received data without copying it, while sending data in between.
@@ -214,6 +326,8 @@ class ThingsBoardSized {
             }
             (void)api->Unsubscribe();
         }
+        Static_API_Unsubscriber unsubscriber = {};
+        m_static_apis.for_each(unsubscriber);
     }
 
     /// @brief Connects to the specified ThingsBoard server over the given port as the given device.
@@ -248,18 +362,34 @@ class ThingsBoardSized {
     }
 
     /// @brief Receives / sends any outstanding messages from and to the MQTT broker.
-    /// Additionally when not being able to use the ESP Timer, it updates the internal timeout timers
-    /// @return Whether sending or receiving the oustanding the messages was successful or not
+    /// Additionally it updates the internal timer wheel, which calls the timeout callbacks of all requests that did not receive a response in time
+    /// and flushes the coalesced telemetry data if coalescing is enabled without a time window.
+    /// Lastly it lets every subscribed API implementation do its periodic work, like publishing asynchronously completed server side RPC responses
+    /// @return Whether sending or receiving the oustanding the messages, including the coalesced telemetry data, was successful or not
     bool loop() {
-#if !THINGSBOARD_USE_ESP_TIMER
+        m_timer_wheel.update();
+        bool flushed = true;
+        if (m_coalescer.enabled() && m_coalescing_window == 0U) {
+            flushed = flushTelemetry();
+        }
         for (auto & api : m_api_implementations) {
             if (api == nullptr) {
                 continue;
             }
             api->loop();
         }
-#endif // !THINGSBOARD_USE_ESP_TIMER
-        return m_client.loop();
+        Static_API_Looper looper = {};
+        m_static_apis.for_each(looper);
+        bool const received = m_client.loop();
+        return received && flushed;
+    }
+
+    /// @brief Gets the amount of microseconds until the next timeout timer of any ongoing request could expire,
+    /// allows to sleep or block for that long before loop() has to be called again, without delaying any timeout callback
+    /// @return Amount of microseconds until loop() should be called again at the latest, 0 if timeouts are already overdue
+    /// or NO_PENDING_TIMEOUT if no request is currently waiting for a response with a timeout
+    uint64_t getTimeUntilNextTimeout() const {
+        return m_timer_wheel.time_until_next_timeout();
     }
 
     /// @brief Attempts to send key value pairs from custom source over the given topic to the server
@@ -268,7 +398,7 @@ class ThingsBoardSized {
     /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
     /// @param json_size Size of the data inside the source
     /// @return Whether sending the data was successful or not
-    bool Send_Json(char const * topic, JsonDocument const & source, size_t const & json_size) {
+    bool Send_Json(char const * topic, JsonDocument const & source, size_t const & json_size) override {
         // Check if allocating needed memory failed when trying to create the JsonDocument,
         // if it did the isNull() method will return true. See https://arduinojson.org/v6/api/jsonvariant/isnull/ for more information
         if (source.isNull()) {
@@ -297,19 +427,24 @@ class ThingsBoardSized {
         else
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
         if (json_size > getMaximumStackSize()) {
-            char* json = new char[json_size]();
+            char* json = Allocator_Policy::Create_Array<char>(json_size, Memory_Subsystem::SEND_BUFFER);
+            if (json == nullptr) {
+                Logger::printfln(UNABLE_TO_ALLOCATE_MEMORY, json_size);
+                return false;
+            }
             if (serializeJson(source, json, json_size) < json_size - 1) {
                 Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
             }
             else {
                 result = Send_Json_String(topic, json);
             }
-            // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+            // Ensure to actually free the allocated memory, to make sure we do not create a memory leak
             // and set the pointer to null so we do not have a dangling reference.
-            delete[] json;
+            Allocator_Policy::Destroy_Array(json);
             json = nullptr;
         }
         else {
+            Memory_Stats::Record_Stack(Memory_Subsystem::SEND_BUFFER, json_size);
             char json[json_size] = {};
             if (serializeJson(source, json, json_size) < json_size - 1) {
                 Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
@@ -325,13 +460,21 @@ class ThingsBoardSized {
     /// @param topic Topic we want to send the data over
     /// @param json String containing our json key value pairs we want to attempt to send
     /// @return Whether sending the data was successful or not
-    bool Send_Json_String(char const * topic, char const * json) {
+    bool Send_Json_String(char const * topic, char const * json) override {
         if (json == nullptr) {
             return false;
         }
 
+        return Send_Json_Buffer(topic, json, strlen(json));
+    }
+
+    /// @brief Attempts to send the given json characters over the given topic to the server
+    /// @param topic Topic we want to send the data over
+    /// @param json Null-terminated string containing our json key value pairs we want to attempt to send
+    /// @param json_size Amount of characters in the given json, without the null termination
+    /// @return Whether sending the data was successful or not
+    bool Send_Json_Buffer(char const * topic, char const * json, size_t const & json_size) {
         uint16_t current_send_buffer_size = m_client.get_send_buffer_size();
-        size_t const json_size = strlen(json);
 
         if (current_send_buffer_size < json_size) {
             Logger::printfln(INVALID_BUFFER_SIZE, current_send_buffer_size, json_size);
@@ -347,19 +490,16 @@ class ThingsBoardSized {
     /// @brief Copies a non-owning pointer to the given API implementation, into the local data container.
     /// Ensure the actual variable is kept alive for as long as the instance of this class
     /// @param api Additional API that we want to be handled
-    void Subscribe_API_Implementation(IAPI_Implementation & api) {
+    void Subscribe_API_Implementation(IAPI_Implementation & api) override {
 #if !THINGSBOARD_ENABLE_DYNAMIC
         if (m_api_implementations.size() + 1 > m_api_implementations.capacity()) {
             Logger::printfln(MAX_SUBSCRIPTIONS_EXCEEDED, MAX_ENDPOINTS_AMOUNT_TEMPLATE_NAME, MaxEndpointsAmount);
             return;
         }
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
-#if THINGSBOARD_ENABLE_STL
-        api.Set_Client_Callbacks(std::bind(&ThingsBoardSized::Subscribe_API_Implementation, this, std::placeholders::_1), std::bind(&ThingsBoardSized::Send_Json, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), std::bind(&ThingsBoardSized::Send_Json_String, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::clientSubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::clientUnsubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::getClientReceiveBufferSize, this), std::bind(&ThingsBoardSized::getClientSendBufferSize, this), std::bind(&ThingsBoardSized::setBufferSize, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::getRequestID, this));
-#else
-        api.Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
-#endif // THINGSBOARD_ENABLE_STL
+        Bind_API_Implementation(api);
         api.Initialize();
+        (void)m_topic_router.insert(api);
         m_api_implementations.push_back(&api);
     }
 
@@ -385,12 +525,9 @@ class ThingsBoardSized {
             if (api == nullptr) {
                 continue;
             }
-#if THINGSBOARD_ENABLE_STL
-            api->Set_Client_Callbacks(std::bind(&ThingsBoardSized::Subscribe_API_Implementation, this, std::placeholders::_1), std::bind(&ThingsBoardSized::Send_Json, this, std::placeholders::_1, std::placeholders::_2, std::placeholders::_3), std::bind(&ThingsBoardSized::Send_Json_String, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::clientSubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::clientUnsubscribe, this, std::placeholders::_1), std::bind(&ThingsBoardSized::getClientReceiveBufferSize, this), std::bind(&ThingsBoardSized::getClientSendBufferSize, this), std::bind(&ThingsBoardSized::setBufferSize, this, std::placeholders::_1, std::placeholders::_2), std::bind(&ThingsBoardSized::getRequestID, this));
-#else
-            api->Set_Client_Callbacks(ThingsBoardSized::staticSubscribeImplementation, ThingsBoardSized::staticSendJson, ThingsBoardSized::staticSendJsonString, ThingsBoardSized::staticClientSubscribe, ThingsBoardSized::staticClientUnsubscribe, ThingsBoardSized::staticGetClientReceiveBufferSize, ThingsBoardSized::staticGetClientSendBufferSize, ThingsBoardSized::staticSetBufferSize, ThingsBoardSized::staticGetRequestID);
-#endif // THINGSBOARD_ENABLE_STL
+            Bind_API_Implementation(*api);
             api->Initialize();
+            (void)m_topic_router.insert(*api);
         }
         m_api_implementations.insert(m_api_implementations.end(), first, last);
     }
@@ -419,6 +556,73 @@ class ThingsBoardSized {
     //----------------------------------------------------------------------------
     // Telemetry API
 
+    /// @brief Sets the spool that stores telemetry and attribute data, which is sent while the device is not connected to the server, instead of discarding it.
+    /// Each stored record additionally contains the time it was sent at, so that it is displayed at the correct time once it reaches the server.
+    /// Once the connection is established again the spooled telemetry data is sent in batches as an array of {"ts":...,"values":{...}} objects,
+    /// where each batch is as big as the send buffer allows. Spooled attribute data is sent as is, because attributes do not support timestamps.
+    /// To not exceed the rate limits of the server, only one batch is sent per drain interval, the sending is done in loop() and does not block
+    /// @param spool Non-owning pointer to the storage the data should be spooled into, ensure it is kept alive for as long as the instance of this class.
+    /// Use the RAM_Telemetry_Spool to store the records in RAM or the SDCard_Telemetry_Spool to store them in a file, passing nullptr disables spooling
+    /// @param get_timestamp_callback Callback that returns the current unix timestamp in milliseconds, which is stored together with the spooled data
+    /// @param drain_interval_microseconds Amount of microseconds between sending two batches of spooled data, default = Default_Spool_Drain_Interval (250000)
+    void setTelemetrySpool(ITelemetry_Spool * spool, Callback<uint64_t>::function get_timestamp_callback, uint64_t const & drain_interval_microseconds = Default_Spool_Drain_Interval) {
+        m_timer_wheel.cancel(m_spool_drain_handle);
+        m_spool = spool;
+        m_get_timestamp_callback.Set_Callback(get_timestamp_callback);
+        m_spool_drain_interval = drain_interval_microseconds;
+        if (connected()) {
+            Start_Spool_Drain();
+        }
+    }
+
+    /// @brief Enables coalescing of telemetry data, where each key value pair sent with sendTelemetryData() or sendTelemetry() is not sent immediately,
+    /// but instead accumulated in the given buffer and then sent together as one json object. Sending a key that has already been accumulated overwrites the previous value.
+    /// The accumulated data is flushed on every loop() call or once the given time window has passed since the first key value pair was accumulated,
+    /// additionally it is flushed before it would exceed the send buffer size or the given buffer. Calling this method flushes all previously accumulated data
+    /// @param buffer Pointer to the first byte of the buffer the key value pairs are accumulated in, ensure it is kept alive for as long as the instance of this class. Passing nullptr disables coalescing
+    /// @param buffer_size Amount of bytes the given buffer can hold, each key value pair additionally requires sizeof(Coalesced_Entry_Header) bytes
+    /// @param window_microseconds Amount of microseconds after the first accumulated key value pair the data is flushed, 0 means the data is flushed on every loop() call, default = Default_Coalescing_Window (0)
+    void setTelemetryCoalescing(uint8_t * buffer, size_t const & buffer_size, uint64_t const & window_microseconds = Default_Coalescing_Window) {
+        (void)flushTelemetry();
+        m_coalescer.set_buffer(buffer, buffer_size);
+        m_coalescing_window = window_microseconds;
+    }
+
+    /// @brief Sends all telemetry data that has been accumulated because coalescing is enabled, as one json object.
+    /// The accumulated data is only removed once it has been sent or spooled successfully, otherwise it is kept and sent again with the next flush
+    /// @return Whether sending the data was successful or not, is also successful if there was no accumulated data
+    bool flushTelemetry() {
+        m_timer_wheel.cancel(m_coalescing_flush_handle);
+        if (m_coalescer.empty()) {
+            return true;
+        }
+        size_t const json_size = m_coalescer.json_size() + 1U;
+        bool result = false;
+
+        if (json_size > getMaximumStackSize()) {
+            char* json = Allocator_Policy::Create_Array<char>(json_size, Memory_Subsystem::SEND_BUFFER);
+            if (json == nullptr) {
+                Logger::printfln(UNABLE_TO_ALLOCATE_MEMORY, json_size);
+                return false;
+            }
+            result = Send_Coalesced_Telemetry(json, json_size);
+            // Ensure to actually free the allocated memory, to make sure we do not create a memory leak
+            // and set the pointer to null so we do not have a dangling reference.
+            Allocator_Policy::Destroy_Array(json);
+            json = nullptr;
+        }
+        else {
+            Memory_Stats::Record_Stack(Memory_Subsystem::SEND_BUFFER, json_size);
+            char json[json_size] = {};
+            result = Send_Coalesced_Telemetry(json, json_size);
+        }
+        // Ensure the kept data is flushed again once the time window has passed, without a time window it is flushed again in the next loop() call anyway
+        if (!result && m_coalescing_window != 0U) {
+            m_coalescing_flush_handle = m_timer_wheel.arm(m_coalescing_window, m_coalescing_flush_callback);
+        }
+        return result;
+    }
+
     /// @brief Attempts to send telemetry data with the given key and value of the given type.
     /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
     /// @tparam T Type of the passed value
@@ -453,21 +657,67 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_DYNAMIC
     }
 
+    /// @brief Attempts to send the given values with the keys of the given compile-time schema as telemetry data.
+    /// In comparison to the sendTelemetry() overload that receives iterators, no intermediate key value pairs are created and the size of the resulting json is known at compile time,
+    /// therefore the buffer it is written into is allocated with exactly the maximum size the schema can ever require, instead of relying on the MaxKeyValuePairAmount template parameter.
+    /// Is never coalesced, instead any previously coalesced telemetry data is flushed beforehand, so that the data arrives in the order it was sent in.
+    /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
+    /// @tparam Fields Telemetry_Field instances of the given schema
+    /// @tparam Values Types of the given values, each has to be convertible to the type of the field at the same position
+    /// @param schema Schema describing the keys and the types of their values
+    /// @param values Values of all fields in the same order as the fields of the given schema
+    /// @return Whether sending the data was successful or not
+    template<typename... Fields, typename... Values>
+    bool sendTelemetry(Telemetry_Schema<Fields...> const & schema, Values const &... values) {
+        size_t constexpr buffer_size = Telemetry_Schema<Fields...>::MAX_JSON_SIZE + 1U;
+        bool result = false;
+        (void)flushTelemetry();
+
+        if (buffer_size > getMaximumStackSize()) {
+            char* json = Allocator_Policy::Create_Array<char>(buffer_size, Memory_Subsystem::SEND_BUFFER);
+            if (json == nullptr) {
+                Logger::printfln(UNABLE_TO_ALLOCATE_MEMORY, buffer_size);
+                return false;
+            }
+            result = Send_Schema(schema, json, buffer_size, values...);
+            // Ensure to actually free the allocated memory, to make sure we do not create a memory leak
+            // and set the pointer to null so we do not have a dangling reference.
+            Allocator_Policy::Destroy_Array(json);
+            json = nullptr;
+        }
+        else {
+            Memory_Stats::Record_Stack(Memory_Subsystem::SEND_BUFFER, buffer_size);
+            char json[buffer_size] = {};
+            result = Send_Schema(schema, json, buffer_size, values...);
+        }
+        return result;
+    }
+
     /// @brief Attempts to send custom json telemetry string.
+    /// Is never coalesced, instead any previously coalesced telemetry data is flushed beforehand, so that the data arrives in the order it was sent in.
     /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
     /// @param json String containing our json key value pairs we want to attempt to send
     /// @return Whether sending the data was successful or not
     bool sendTelemetryString(char const * json) {
+        (void)flushTelemetry();
+        if (Should_Spool()) {
+            return Spool_String(true, json);
+        }
         return Send_Json_String(TELEMETRY_TOPIC, json);
     }
 
     /// @brief Attempts to send telemetry key value pairs from custom source to the server.
+    /// Is never coalesced, instead any previously coalesced telemetry data is flushed beforehand, so that the data arrives in the order it was sent in.
     /// See https://thingsboard.io/docs/user-guide/telemetry/ for more information
     /// @param source JsonDocument containing our json key value pairs we want to send,
     /// is checked before usage for any possible occuring internal errors. See https://arduinojson.org/v6/api/jsondocument/ for more information
     /// @param json_size Size of the data inside the source
     /// @return Whether sending the data was successful or not
     bool sendTelemetryJson(JsonDocument const & source, size_t const & json_size) {
+        (void)flushTelemetry();
+        if (Should_Spool()) {
+            return Spool_Json(true, source, json_size);
+        }
         return Send_Json(TELEMETRY_TOPIC, source, json_size);
     }
 
@@ -513,6 +763,9 @@ class ThingsBoardSized {
     /// @param json String containing our json key value pairs we want to attempt to send
     /// @return Whether sending the data was successful or not
     bool sendAttributeString(char const * json) {
+        if (Should_Spool()) {
+            return Spool_String(false, json);
+        }
         return Send_Json_String(ATTRIBUTE_TOPIC, json);
     }
 
@@ -523,6 +776,9 @@ class ThingsBoardSized {
     /// @param json_size Size of the data inside the source
     /// @return Whether sending the data was successful or not
     bool sendAttributeJson(JsonDocument const & source, size_t const & json_size) {
+        if (Should_Spool()) {
+            return Spool_Json(false, source, json_size);
+        }
         return Send_Json(ATTRIBUTE_TOPIC, source, json_size);
     }
 
@@ -559,27 +815,27 @@ class ThingsBoardSized {
 
     /// @brief Returns the current receive buffer size of the underlying client interface
     /// @return Current internal send buffer size
-    uint16_t getClientReceiveBufferSize() {
+    uint16_t Get_Receive_Buffer_Size() override {
         return m_client.get_receive_buffer_size();
     }
 
     /// @brief Returns the current send buffer size of the underlying client interface
     /// @return Current internal receive buffer size
-    uint16_t getClientSendBufferSize() {
+    uint16_t Get_Send_Buffer_Size() override {
         return m_client.get_send_buffer_size();
     }
 
     /// @brief Subscribes the given topic with the underlying client interface
     /// @param topic Topic that should be subscribed
     /// @return Whether subscribing was successfull or not
-    bool clientSubscribe(char const * topic) {
+    bool Subscribe_Topic(char const * topic) override {
         return m_client.subscribe(topic);
     }
 
     /// @brief Unsubscribes the given topic with the underlying client interface
     /// @param topic Topic that should be unsubscribed
     /// @return Whether unsubscribing was successfull or not
-    bool clientUnsubscribe(char const * topic) {
+    bool Unsubscribe_Topic(char const * topic) override {
         return m_client.unsubscribe(topic);
     }
 
@@ -587,10 +843,25 @@ class ThingsBoardSized {
     /// Is used because each request to the cloud of the same type (attribute request, rpc request, over the air firmware update), has to use a different id to differentiate request and response.
     /// To ensure that we therefore simply provide a global request id that can be used and incremented by all request types
     /// @return Mutable reference to the request id
-    size_t * getRequestID() {
+    size_t * Get_Request_ID() override {
         return &m_request_id;
     }
 
+    /// @brief Gets a mutable pointer to the timer wheel, that is shared by all requests that can timeout.
+    /// Is used so that each request does not need to own a separate timer, but instead simply arms and cancels an entry in the shared wheel
+    /// @return Mutable pointer to the timer wheel
+    Timer_Wheel * Get_Timer_Wheel() override {
+        return &m_timer_wheel;
+    }
+
+    /// @brief Changes the receive and send buffer size of the underlying client interface, see setBufferSize for more information
+    /// @param receive_buffer_size Maximum amount of data that can be received by this device at once
+    /// @param send_buffer_size Maximum amount of data that can be sent from this device at once
+    /// @return Whether allocating the needed memory for the given buffer sizes was successful or not
+    bool Set_Buffer_Size(uint16_t receive_buffer_size, uint16_t send_buffer_size) override {
+        return setBufferSize(receive_buffer_size, send_buffer_size);
+    }
+
 #if THINGSBOARD_ENABLE_STREAM_UTILS
     /// @brief Returns the amount of bytes that can be allocated to speed up fall back serialization with the StreamUtils class
     /// See https://github.com/bblanchon/ArduinoStreamUtils for more information on the underlying class used
@@ -627,6 +898,338 @@ class ThingsBoardSized {
             }
             (void)api->Resubscribe_Topic();
         }
+        Static_API_Resubscriber resubscriber = {};
+        m_static_apis.for_each(resubscriber);
+        Start_Spool_Drain();
+    }
+
+    /// @brief Whether data that is sent should be spooled instead, because a spool has been set and the device is currently not connected
+    /// @return Whether the data should be spooled or not
+    bool Should_Spool() {
+        return m_spool != nullptr && !connected();
+    }
+
+    /// @brief Spools the given json string, so that it can be sent once the connection has been established again
+    /// @param telemetry Whether the data should be sent over the telemetry or the attribute topic
+    /// @param json String containing our json key value pairs we want to spool
+    /// @return Whether spooling the data was successful or not
+    bool Spool_String(bool const & telemetry, char const * json) {
+        if (json == nullptr) {
+            return false;
+        }
+        size_t const json_size = strlen(json);
+        return Spool_Data(telemetry, json_size, [&](char * destination) {
+            memcpy(destination, json, json_size);
+            return true;
+        });
+    }
+
+    /// @brief Spools the key value pairs from the given source, so that they can be sent once the connection has been established again
+    /// @param telemetry Whether the data should be sent over the telemetry or the attribute topic
+    /// @param source JsonDocument containing our json key value pairs we want to spool
+    /// @param json_size Size of the data inside the source, including the null termination
+    /// @return Whether spooling the data was successful or not
+    bool Spool_Json(bool const & telemetry, JsonDocument const & source, size_t const & json_size) {
+        if (source.isNull()) {
+            Logger::printfln(UNABLE_TO_ALLOCATE_JSON);
+            return false;
+        }
+        if (source.overflowed()) {
+            Logger::printfln(JSON_SIZE_TO_SMALL);
+            return false;
+        }
+        // Spooled records do not contain the null termination, because their size is already stored by the spool
+        return Spool_Data(telemetry, json_size - 1U, [&](char * destination) {
+            if (serializeJson(source, destination, json_size) < json_size - 1U) {
+                Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+                return false;
+            }
+            return true;
+        });
+    }
+
+    /// @brief Creates a spool record consisting of the record type, the current timestamp and the data written by the given function and appends it to the spool.
+    /// The record is created on the stack or if it exceeds the maximum stack size on the heap instead
+    /// @tparam Writer Function that receives a pointer to the memory the data should be written into and returns whether writing the data was successful or not
+    /// @param telemetry Whether the data should be sent over the telemetry or the attribute topic
+    /// @param data_size Amount of bytes the data consists of, the memory passed to the writer has one additional byte to allow writing a null termination
+    /// @param writer Function that writes the data into the record
+    /// @return Whether spooling the data was successful or not
+    template<typename Writer>
+    bool Spool_Data(bool const & telemetry, size_t const & data_size, Writer const & writer) {
+        size_t const record_size = SPOOL_RECORD_HEADER_SIZE + data_size + 1U;
+        uint64_t const timestamp = m_get_timestamp_callback.Call_Callback();
+        bool result = false;
+
+        if (record_size > getMaximumStackSize()) {
+            uint8_t* record = Allocator_Policy::Create_Array<uint8_t>(record_size, Memory_Subsystem::SEND_BUFFER);
+            if (record == nullptr) {
+                Logger::printfln(UNABLE_TO_ALLOCATE_MEMORY, record_size);
+                return false;
+            }
+            result = Push_Spool_Record(telemetry, timestamp, record, record_size, writer);
+            // Ensure to actually free the allocated memory, to make sure we do not create a memory leak
+            // and set the pointer to null so we do not have a dangling reference.
+            Allocator_Policy::Destroy_Array(record);
+            record = nullptr;
+        }
+        else {
+            Memory_Stats::Record_Stack(Memory_Subsystem::SEND_BUFFER, record_size);
+            uint8_t record[record_size] = {};
+            result = Push_Spool_Record(telemetry, timestamp, record, record_size, writer);
+        }
+        return result;
+    }
+
+    /// @brief Writes the spool record header and the data into the given memory and appends the record to the spool
+    /// @tparam Writer Function that receives a pointer to the memory the data should be written into and returns whether writing the data was successful or not
+    /// @param telemetry Whether the data should be sent over the telemetry or the attribute topic
+    /// @param timestamp Unix timestamp in milliseconds the data was sent at
+    /// @param record Memory the record should be created in
+    /// @param record_size Amount of bytes in the given memory, including the additional byte for the null termination
+    /// @param writer Function that writes the data into the record
+    /// @return Whether spooling the data was successful or not
+    template<typename Writer>
+    bool Push_Spool_Record(bool const & telemetry, uint64_t const & timestamp, uint8_t * record, size_t const & record_size, Writer const & writer) {
+        memcpy(record + sizeof(uint8_t), &timestamp, sizeof(timestamp));
+        char * data = reinterpret_cast<char *>(record + SPOOL_RECORD_HEADER_SIZE);
+        if (!writer(data)) {
+            return false;
+        }
+        size_t const data_size = record_size - SPOOL_RECORD_HEADER_SIZE - 1U;
+        record[0U] = !telemetry ? SPOOL_RECORD_ATTRIBUTES : (Has_Own_Timestamp(data, data_size) ? SPOOL_RECORD_TIMESTAMPED_TELEMETRY : SPOOL_RECORD_TELEMETRY);
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(SPOOLING_DATA, data);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        if (!m_spool->push(record, record_size - 1U)) {
+            Logger::printfln(UNABLE_TO_SPOOL, record_size - 1U);
+            return false;
+        }
+        return true;
+    }
+
+    /// @brief Checks whether the given telemetry json is already in a form that contains its own timestamp and can therefore not be wrapped into {"ts":...,"values":...},
+    /// which is the case for an array of telemetry objects and for an object that contains the top-level key "ts"
+    /// @param data Json data that should be checked, does not need to be null terminated
+    /// @param data_size Amount of bytes in the given data
+    /// @return Whether the data has to be sent unchanged, instead of being wrapped with the time it was spooled at
+    static bool Has_Own_Timestamp(char const * data, size_t const & data_size) {
+        size_t depth = 0U;
+        bool in_string = false;
+        bool escaped = false;
+        bool expect_key = false;
+        bool is_key = false;
+        size_t string_start = 0U;
+        for (size_t i = 0U; i < data_size; ++i) {
+            char const symbol = data[i];
+            if (in_string) {
+                if (escaped) {
+                    escaped = false;
+                }
+                else if (symbol == '\\') {
+                    escaped = true;
+                }
+                else if (symbol == '"') {
+                    in_string = false;
+                    if (is_key && i - string_start == strlen(SPOOL_TIMESTAMP_KEY) && strncmp(data + string_start, SPOOL_TIMESTAMP_KEY, strlen(SPOOL_TIMESTAMP_KEY)) == 0) {
+                        return true;
+                    }
+                }
+                continue;
+            }
+            switch (symbol) {
+                case '"':
+                    in_string = true;
+                    is_key = depth == 1U && expect_key;
+                    expect_key = false;
+                    string_start = i + 1U;
+                    break;
+                case '[':
+                    if (depth == 0U) {
+                        return true;
+                    }
+                    depth++;
+                    break;
+                case '{':
+                    depth++;
+                    expect_key = depth == 1U;
+                    break;
+                case '}': // Fallthrough same behaviour
+                case ']':
+                    depth--;
+                    break;
+                case ',':
+                    expect_key = depth == 1U;
+                    break;
+                default:
+                    // Nothing to do
+                    break;
+            }
+        }
+        return false;
+    }
+
+    /// @brief Starts sending the spooled records in the next loop() call, if there are any and the sending has not already been started
+    void Start_Spool_Drain() {
+        if (m_spool == nullptr || m_spool_drain_handle != INVALID_TIMER_HANDLE || m_spool->size() == 0U) {
+            return;
+        }
+        m_spool_drain_handle = m_timer_wheel.arm(0U, m_spool_drain_callback);
+    }
+
+    /// @brief Sends one batch of spooled records and if any remain, schedules the next batch after the drain interval.
+    /// Consecutive telemetry records are combined into one array of {"ts":...,"values":{...}} objects as long as they fit into the send buffer,
+    /// records that already contain their own timestamp are added to that array unchanged, or in case of an array with their elements instead.
+    /// Attribute records are sent one at a time. Records are only removed from the spool once they have been sent successfully
+    void Drain_Spool() {
+        m_spool_drain_handle = INVALID_TIMER_HANDLE;
+        if (m_spool == nullptr || !connected() || m_spool->size() == 0U) {
+            return;
+        }
+
+        size_t const batch_capacity = Get_Send_Buffer_Size();
+        size_t const record_capacity = SPOOL_RECORD_HEADER_SIZE + batch_capacity;
+        char* batch = Allocator_Policy::Create_Array<char>(batch_capacity + 1U, Memory_Subsystem::SEND_BUFFER);
+        uint8_t* record = Allocator_Policy::Create_Array<uint8_t>(record_capacity, Memory_Subsystem::SEND_BUFFER);
+        if (batch == nullptr || record == nullptr) {
+            Logger::printfln(UNABLE_TO_ALLOCATE_MEMORY, batch_capacity + 1U + record_capacity);
+            Allocator_Policy::Destroy_Array(batch);
+            Allocator_Policy::Destroy_Array(record);
+            m_spool_drain_handle = m_timer_wheel.arm(m_spool_drain_interval, m_spool_drain_callback);
+            return;
+        }
+        size_t batch_size = 0U;
+        size_t records = 0U;
+        size_t elements = 0U;
+        bool telemetry_batch = false;
+
+        while (true) {
+            size_t const record_size = m_spool->peek(records, record, record_capacity);
+            if (record_size == 0U) {
+                break;
+            }
+            // Records that can never fit into the send buffer, would otherwise block the spool forever
+            else if (record_size > record_capacity || record_size < SPOOL_RECORD_HEADER_SIZE) {
+                if (records != 0U) {
+                    break;
+                }
+                Logger::printfln(SPOOL_RECORD_TOO_BIG, record_size, batch_capacity);
+                m_spool->pop(1U);
+                continue;
+            }
+            bool const telemetry = record[0U] != SPOOL_RECORD_ATTRIBUTES;
+            bool const timestamped = record[0U] == SPOOL_RECORD_TIMESTAMPED_TELEMETRY;
+            size_t data_size = record_size - SPOOL_RECORD_HEADER_SIZE;
+            char const * data = reinterpret_cast<char const *>(record + SPOOL_RECORD_HEADER_SIZE);
+            if (records != 0U && (!telemetry || !telemetry_batch)) {
+                break;
+            }
+
+            if (timestamped) {
+                // Arrays are added with their elements instead, so that the batch stays a flat array of telemetry objects
+                Trim_Whitespace(data, data_size);
+                if (data_size >= 2U && data[0U] == '[') {
+                    data++;
+                    data_size -= 2U;
+                    Trim_Whitespace(data, data_size);
+                }
+            }
+
+            size_t entry_size = data_size;
+            char timestamp[21U] = {};
+            if (timestamped) {
+                // Each entry needs either the opening bracket of the array or a comma
+                entry_size += 1U;
+            }
+            else if (telemetry) {
+                uint64_t value = 0U;
+                memcpy(&value, record + sizeof(uint8_t), sizeof(value));
+                // Formatted manually, because not all printf implementations (newlib nano) support 64 bit integers
+                size_t digits = 0U;
+                do {
+                    timestamp[digits++] = '0' + (value % 10U);
+                    value /= 10U;
+                } while (value != 0U);
+                for (size_t i = 0U; i < digits / 2U; ++i) {
+                    char const digit = timestamp[i];
+                    timestamp[i] = timestamp[digits - i - 1U];
+                    timestamp[digits - i - 1U] = digit;
+                }
+                // Each entry needs the timestamp and values keys, the closing bracket of the object and either the opening bracket of the array or a comma
+                entry_size += strlen(SPOOL_TIMESTAMP_PREFIX) + digits + strlen(SPOOL_VALUES_PREFIX) + 2U;
+            }
+
+            if (batch_size + entry_size + (telemetry ? 1U : 0U) > batch_capacity) {
+                if (records != 0U) {
+                    break;
+                }
+                Logger::printfln(SPOOL_RECORD_TOO_BIG, record_size, batch_capacity);
+                m_spool->pop(1U);
+                continue;
+            }
+
+            if (!telemetry) {
+                memcpy(batch, data, data_size);
+                batch_size = data_size;
+                records++;
+                break;
+            }
+            telemetry_batch = true;
+            records++;
+            // Empty arrays do not contain any telemetry and are therefore only removed from the spool
+            if (data_size == 0U) {
+                continue;
+            }
+            batch[batch_size++] = elements == 0U ? '[' : ',';
+            if (!timestamped) {
+                batch_size += snprintf(batch + batch_size, batch_capacity + 1U - batch_size, "%s%s%s", SPOOL_TIMESTAMP_PREFIX, timestamp, SPOOL_VALUES_PREFIX);
+            }
+            memcpy(batch + batch_size, data, data_size);
+            batch_size += data_size;
+            if (!timestamped) {
+                batch[batch_size++] = '}';
+            }
+            elements++;
+        }
+
+        if (records != 0U && telemetry_batch && elements == 0U) {
+            m_spool->pop(records);
+        }
+        else if (records != 0U) {
+            if (telemetry_batch) {
+                batch[batch_size++] = ']';
+            }
+            batch[batch_size] = '\0';
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(DRAINING_SPOOL, records, m_spool->size() - records);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            if (Send_Json_String(telemetry_batch ? TELEMETRY_TOPIC : ATTRIBUTE_TOPIC, batch)) {
+                m_spool->pop(records);
+            }
+        }
+        // Ensure to actually free the allocated memory, to make sure we do not create a memory leak
+        // and set the pointer to null so we do not have a dangling reference.
+        Allocator_Policy::Destroy_Array(batch);
+        batch = nullptr;
+        Allocator_Policy::Destroy_Array(record);
+        record = nullptr;
+
+        if (connected() && m_spool->size() != 0U) {
+            m_spool_drain_handle = m_timer_wheel.arm(m_spool_drain_interval, m_spool_drain_callback);
+        }
+    }
+
+    /// @brief Removes leading and trailing whitespace from the given json data, by moving the start of the data and decreasing its size
+    /// @param data Start of the json data, is moved past any leading whitespace
+    /// @param data_size Amount of bytes in the json data, is decreased by the amount of removed whitespace
+    static void Trim_Whitespace(char const *& data, size_t & data_size) {
+        while (data_size != 0U && isspace(static_cast<unsigned char>(data[0U]))) {
+            data++;
+            data_size--;
+        }
+        while (data_size != 0U && isspace(static_cast<unsigned char>(data[data_size - 1U]))) {
+            data_size--;
+        }
     }
 
     /// @brief Attempts to send a single key-value pair with the given key and value of the given type
@@ -647,9 +1250,84 @@ class ThingsBoardSized {
             Logger::printfln(UNABLE_TO_SERIALIZE);
             return false;
         }
+        else if (telemetry && m_coalescer.enabled()) {
+            return Coalesce_Telemetry(json_buffer);
+        }
         return telemetry ? sendTelemetryJson(json_buffer, Helper::Measure_Json(json_buffer)) : sendAttributeJson(json_buffer, Helper::Measure_Json(json_buffer));
     }
 
+    /// @brief Accumulates the single key value pair in the given source in the coalescing buffer, instead of sending it immediately.
+    /// Flushes the previously accumulated data beforehand, if adding the key value pair would exceed the send buffer size or the coalescing buffer
+    /// @param source JsonDocument containing exactly one key value pair
+    /// @return Whether accumulating or sending the data was successful or not
+    bool Coalesce_Telemetry(JsonDocument const & source) {
+        size_t const json_size = Helper::Measure_Json(source);
+        // Key value pairs that would not even fit onto the stack are sent immediately instead, because they would fill most of the send buffer anyway.
+        // Sending them flushes the previously accumulated data first, so that they do not overtake it
+        if (json_size > getMaximumStackSize()) {
+            return sendTelemetryJson(source, json_size);
+        }
+        Memory_Stats::Record_Stack(Memory_Subsystem::SEND_BUFFER, json_size);
+        char json[json_size] = {};
+        if (serializeJson(source, json, json_size) < json_size - 1U) {
+            Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+            return false;
+        }
+
+        // Skip the braces of the serialized object, leaving only the serialized key value pair ("key":value),
+        // the key ends at the first quote that is not escaped, after the quote the key starts with
+        char const * text = json + 1U;
+        size_t const text_length = json_size - 3U;
+        size_t key_length = 1U;
+        for (bool escaped = false; key_length < text_length; ++key_length) {
+            if (escaped) {
+                escaped = false;
+            }
+            else if (text[key_length] == '\\') {
+                escaped = true;
+            }
+            else if (text[key_length] == '"') {
+                break;
+            }
+        }
+        key_length++;
+
+        // Data kept because of a failed flush must not grow past the send buffer, because it could then never be sent, instead the new data is sent on its own
+        if (!m_coalescer.empty() && m_coalescer.json_size_with(text, key_length, text_length) > Get_Send_Buffer_Size() && !flushTelemetry()) {
+            return Should_Spool() ? Spool_String(true, json) : Send_Json_String(TELEMETRY_TOPIC, json);
+        }
+        if (!m_coalescer.insert(text, key_length, text_length)) {
+            (void)flushTelemetry();
+            if (!m_coalescer.insert(text, key_length, text_length)) {
+                return sendTelemetryString(json);
+            }
+        }
+        if (m_coalescing_window != 0U && m_coalescing_flush_handle == INVALID_TIMER_HANDLE) {
+            m_coalescing_flush_handle = m_timer_wheel.arm(m_coalescing_window, m_coalescing_flush_callback);
+        }
+        return true;
+    }
+
+    /// @brief Serializes the coalesced telemetry data into the given buffer and sends or spools it, sent directly instead of with sendTelemetryString(),
+    /// because that would flush the coalesced data again. The coalesced data is only cleared if sending or spooling it was successful
+    /// @param json Buffer the coalesced data is serialized into
+    /// @param json_size Amount of bytes the given buffer can hold, has to be atleast the size of the coalesced data + 1
+    /// @return Whether sending or spooling the data was successful or not
+    bool Send_Coalesced_Telemetry(char * json, size_t const & json_size) {
+        (void)m_coalescer.serialize(json, json_size);
+        bool const result = Should_Spool() ? Spool_String(true, json) : Send_Json_String(TELEMETRY_TOPIC, json);
+        if (result) {
+            m_coalescer.clear();
+        }
+        return result;
+    }
+
+    /// @brief Flushes the coalesced telemetry data once the time window has passed, called by the timer wheel
+    void Flush_Coalesced_Telemetry() {
+        m_coalescing_flush_handle = INVALID_TIMER_HANDLE;
+        (void)flushTelemetry();
+    }
+
     /// @brief Attempts to send aggregated attribute or telemetry data
     /// @tparam InputIterator Class that points to the begin and end iterator
     /// of the given data container, allows for using / passing either std::vector or std::array.
@@ -666,37 +1344,167 @@ class ThingsBoardSized {
     template<size_t MaxKeyValuePairAmount, typename InputIterator>
 #endif // THINGSBOARD_ENABLE_DYNAMIC
     bool sendDataArray(InputIterator const & first, InputIterator const & last, bool telemetry) {
+        if (telemetry && m_coalescer.enabled()) {
+            for (auto it = first; it != last; ++it) {
+                auto const & data = *it;
+                StaticJsonDocument<JSON_OBJECT_SIZE(1)> json_buffer;
+                if (!data.SerializeKeyValue(json_buffer)) {
+                    Logger::printfln(UNABLE_TO_SERIALIZE);
+                    return false;
+                }
+                else if (!Coalesce_Telemetry(json_buffer)) {
+                    return false;
+                }
+            }
+            return true;
+        }
+#if !THINGSBOARD_ENABLE_DYNAMIC
         size_t const size = Helper::distance(first, last);
-#if THINGSBOARD_ENABLE_DYNAMIC
-        // char const * are stored as only a pointer inside the JsonDocument --> zero copy, meaning the size for the strings is 0 bytes.
-        // Data structure size, therefore only depends on the amount of key value pairs passed.
-        // See https://arduinojson.org/v6/assistant/ for more information on the needed size for the JsonDocument
-        TBJsonDocument json_buffer(JSON_OBJECT_SIZE(size));
-#else
         if (size > MaxKeyValuePairAmount) {
             Logger::printfln(TOO_MANY_JSON_FIELDS, size, "MaxKeyValuePairAmount", MaxKeyValuePairAmount);
             return false;
         }
-        StaticJsonDocument<JSON_OBJECT_SIZE(MaxKeyValuePairAmount)> json_buffer;
-#endif // THINGSBOARD_ENABLE_DYNAMIC
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
 
-#if THINGSBOARD_ENABLE_STL
-        if (std::any_of(first, last, [&json_buffer](Telemetry const & data) { return !data.SerializeKeyValue(json_buffer); })) {
+        // The key value pairs are written directly as json, instead of copying them into a JsonDocument first and then measuring and serializing that document.
+        // Measuring uses the same method that writes the json afterwards, therefore the measured size is exact and the data is only walked twice
+        Json_Size_Counter counter;
+        size_t const json_size = Write_Data_Array(first, last, counter);
+        if (json_size == 0U) {
             Logger::printfln(UNABLE_TO_SERIALIZE);
             return false;
         }
-#else
+        char const * topic = telemetry ? TELEMETRY_TOPIC : ATTRIBUTE_TOPIC;
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+        // Check if the size of the given message would be too big for the actual client,
+        // if it is write the json directly into the client, so that the internal client buffer can be circumvented
+        if (!Should_Spool() && m_client.get_send_buffer_size() < json_size) {
+#if THINGSBOARD_ENABLE_DEBUG
+            Logger::printfln(SEND_MESSAGE, topic, SEND_SERIALIZED);
+#endif // THINGSBOARD_ENABLE_DEBUG
+            return Stream_Data_Array(topic, first, last, json_size);
+        }
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
+        bool result = false;
+        if (json_size + 1U > getMaximumStackSize()) {
+            char* json = Allocator_Policy::Create_Array<char>(json_size + 1U, Memory_Subsystem::SEND_BUFFER);
+            if (json == nullptr) {
+                Logger::printfln(UNABLE_TO_ALLOCATE_MEMORY, json_size + 1U);
+                return false;
+            }
+            result = Send_Data_Array(topic, telemetry, first, last, json, json_size);
+            // Ensure to actually free the allocated memory, to make sure we do not create a memory leak
+            // and set the pointer to null so we do not have a dangling reference.
+            Allocator_Policy::Destroy_Array(json);
+            json = nullptr;
+        }
+        else {
+            Memory_Stats::Record_Stack(Memory_Subsystem::SEND_BUFFER, json_size + 1U);
+            char json[json_size + 1U] = {};
+            result = Send_Data_Array(topic, telemetry, first, last, json, json_size);
+        }
+        return result;
+    }
+
+    /// @brief Writes the given key value pairs as one json object into the given output
+    /// @tparam InputIterator Class that points to the begin and end iterator of the given data container
+    /// @tparam TOutput Output class the json object should be written into, requires a size_t write(uint8_t const *, size_t) method
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param output Output the json object should be written into
+    /// @return Amount of bytes written into the output or 0 if any of the key value pairs could not be written
+    template<typename InputIterator, typename TOutput>
+    static size_t Write_Data_Array(InputIterator const & first, InputIterator const & last, TOutput & output) {
+        uint8_t const object_begin = '{';
+        uint8_t const separator = ',';
+        uint8_t const object_end = '}';
+        size_t written = output.write(&object_begin, 1U);
         for (auto it = first; it != last; ++it) {
+            if (it != first) {
+                written += output.write(&separator, 1U);
+            }
             auto const & data = *it;
-            if (!data.SerializeKeyValue(json_buffer)) {
-                Logger::printfln(UNABLE_TO_SERIALIZE);
-                return false;
+            size_t const key_value_size = data.WriteKeyValue(output);
+            if (key_value_size == 0U) {
+                return 0U;
             }
+            written += key_value_size;
         }
-#endif // THINGSBOARD_ENABLE_STL
-        return telemetry ? sendTelemetryJson(json_buffer, Helper::Measure_Json(json_buffer)) : sendAttributeJson(json_buffer, Helper::Measure_Json(json_buffer));
+        written += output.write(&object_end, 1U);
+        return written;
     }
 
+    /// @brief Writes the given key value pairs as one json object into the given buffer and sends or spools it afterwards
+    /// @tparam InputIterator Class that points to the begin and end iterator of the given data container
+    /// @param topic Topic we want to send the data over
+    /// @param telemetry Whether the data is telemetry or attribute data, used if the data is spooled
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param json Buffer the json object is written into, has to hold atleast json_size + 1 bytes and be zero initialized, so that it is null-terminated
+    /// @param json_size Previously measured size of the json object
+    /// @return Whether sending or spooling the data was successful or not
+    template<typename InputIterator>
+    bool Send_Data_Array(char const * topic, bool telemetry, InputIterator const & first, InputIterator const & last, char * json, size_t const & json_size) {
+        Json_Buffer_Writer writer(json, json_size);
+        if (Write_Data_Array(first, last, writer) != json_size) {
+            Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+            return false;
+        }
+        else if (Should_Spool()) {
+            return Spool_String(telemetry, json);
+        }
+        return Send_Json_Buffer(topic, json, json_size);
+    }
+
+    /// @brief Writes the given values into the json skeleton of the given schema and sends or spools the resulting telemetry data afterwards
+    /// @tparam Fields Telemetry_Field instances of the given schema
+    /// @tparam Values Types of the given values
+    /// @param schema Schema describing the keys and the types of their values
+    /// @param json Buffer the json object is written into, has to be zero initialized, so that it is null-terminated
+    /// @param buffer_size Amount of bytes the given buffer can hold, has to be atleast the maximum json size of the schema + 1
+    /// @param values Values of all fields in the same order as the fields of the given schema
+    /// @return Whether sending or spooling the data was successful or not
+    template<typename... Fields, typename... Values>
+    bool Send_Schema(Telemetry_Schema<Fields...> const & schema, char * json, size_t const & buffer_size, Values const &... values) {
+        size_t const json_size = schema.Write(json, buffer_size - 1U, values...);
+        if (json_size == 0U) {
+            Logger::printfln(UNABLE_TO_SERIALIZE);
+            return false;
+        }
+        else if (Should_Spool()) {
+            return Spool_String(true, json);
+        }
+        return Send_Json_Buffer(TELEMETRY_TOPIC, json, json_size);
+    }
+
+#if THINGSBOARD_ENABLE_STREAM_UTILS
+    /// @brief Writes the given key value pairs as one json object directly into the underlying client.
+    /// Sends the given bytes to the client without requiring any temporary buffer at the cost of hugely increased send times
+    /// @tparam InputIterator Class that points to the begin and end iterator of the given data container
+    /// @param topic Topic we want to send the data over
+    /// @param first Iterator pointing to the first element in the data container
+    /// @param last Iterator pointing to the end of the data container (last element + 1)
+    /// @param json_size Previously measured size of the json object
+    /// @return Whether sending the data was successful or not
+    template<typename InputIterator>
+    bool Stream_Data_Array(char const * topic, InputIterator const & first, InputIterator const & last, size_t const & json_size) {
+        if (!m_client.begin_publish(topic, json_size)) {
+            Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+            return false;
+        }
+        BufferingPrint buffered_print(m_client, getBufferingSize());
+        size_t const bytes_serialized = Write_Data_Array(first, last, buffered_print);
+        if (bytes_serialized < json_size) {
+            Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
+            return false;
+        }
+        buffered_print.flush();
+        return m_client.end_publish();
+    }
+#endif // THINGSBOARD_ENABLE_STREAM_UTILS
+
     /// @brief MQTT callback that will be called if a publish message is received from the server
     /// Payload contains data from the internal buffer of the MQTT client,
     /// therefore the buffer and the specific memory region the payload points too and the following length bytes need to live on for as long as this method has not finished.
@@ -712,48 +1520,24 @@ class ThingsBoardSized {
         Logger::printfln(RECEIVE_MESSAGE, length, topic);
 #endif // THINGSBOARD_ENABLE_DEBUG
 
-#if THINGSBOARD_ENABLE_STL
-#if THINGSBOARD_ENABLE_CXX20
-        auto filtered_raw_api_implementations = m_api_implementations | std::views::filter([&topic](IAPI_Implementation const * api) {
-#else
-#if THINGSBOARD_ENABLE_DYNAMIC
-        Vector<IAPI_Implementation *> filtered_raw_api_implementations = {};
-#else
-        Array<IAPI_Implementation *, MaxEndpointsAmount> filtered_raw_api_implementations = {};
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-        std::copy_if(m_api_implementations.begin(), m_api_implementations.end(), std::back_inserter(filtered_raw_api_implementations), [&topic](IAPI_Implementation const * api) {
-#endif // THINGSBOARD_ENABLE_CXX20
-            return (api != nullptr && api->Get_Process_Type() == API_Process_Type::RAW && api->Compare_Response_Topic(topic));
+        // Walk the routing tree only once and reuse the resulting node for the raw and the json processing, because both are routed with the same received topic
+        uint16_t const route = m_topic_router.find(topic);
+        Static_API_Raw_Dispatcher raw_dispatcher = { topic, payload, length, 0U };
+        m_static_apis.for_each(raw_dispatcher);
+        size_t const processed_as_raw = raw_dispatcher.matched + m_topic_router.for_each_match(route, API_Process_Type::RAW, topic, [&](IAPI_Implementation & api) {
+            api.Process_Response(topic, payload, length);
         });
 
-        for (auto & api : filtered_raw_api_implementations) {
-            api->Process_Response(topic, payload, length);
-        }
-
-        // If the filtered api implementations was not emtpy it means the response was processed as its raw bytes representation atleast once,
+        // If atleast one api implementation matched it means the response was processed as its raw bytes representation atleast once,
         // and because we interpreted it as raw bytes instead of json, we skip the further processing of those raw bytes as json.
         // We do that because the received response is in that case not even valid json in the first place and would therefore simply fail deserialization
-        if (!filtered_raw_api_implementations.empty()) {
+        if (processed_as_raw != 0U) {
             return;
         }
-#else
-        bool processed_response_as_raw = false;
-        for (auto & api : m_api_implementations) {
-            if (api == nullptr || api->Get_Process_Type() != API_Process_Type::RAW || !api->Compare_Response_Topic(topic)) {
-                continue;
-            }
-            api->Process_Response(topic, payload, length);
-            processed_response_as_raw = true;
-        }
-
-        if (processed_response_as_raw) {
-            return;
-        }
-#endif // THINGSBOARD_ENABLE_STL
 
         // Calculate size with the total amount of commas, always denotes the end of a key-value pair besides for the last element in an array or in an object where the comma is not permitted,
-        // therfore we have to add the space for another key-value pair for all the occurences of thoose symbols as well
-        size_t const size = Helper::getOccurences(payload, ',', length) + Helper::getOccurences(payload, '{', length) + Helper::getOccurences(payload, '[', length);
+        // therfore we have to add the space for another key-value pair for all the occurences of thoose symbols as well. Symbols inside of strings are ignored, because they do not create any additional nodes
+        size_t const size = Helper::getJsonNodeCount(payload, length);
 #if THINGSBOARD_ENABLE_DYNAMIC
         // Buffer that we deserialize is writeable and not read only and therefore stored as a pointer inside the JsonDocument --> zero copy, meaning the size for the received payload is 0 bytes.
         // Data structure size, therefore only depends on the amount of key value pairs received.
@@ -763,6 +1547,14 @@ class ThingsBoardSized {
             Logger::printfln(MAXIMUM_RESPONSE_EXCEEDED, document_size, m_max_response_size);
             return;
         }
+        // Accounts the received document and everything allocated while the callbacks process it to the receive subsystem, unless they use their own subsystem
+        Memory_Scope const scope(Memory_Subsystem::RECEIVE_DOCUMENT);
+        JsonDocument * const receive_arena = Acquire_Receive_Arena(document_size);
+        if (receive_arena != nullptr) {
+            Process_Json_Response(topic, payload, length, route, *receive_arena);
+            Release_Receive_Arena(document_size);
+            return;
+        }
         TBJsonDocument json_buffer(document_size);
         // Because we calcualte the allocation dynamically fromt he payload, which is user input, it could theoretically be malicious ({ "malicious" : "{{{{{{{{{..."}) and contain a lot of the symbols used to calculate the size.
         // But if that is the case adn the allocation still succeeds we delete the allocated memory relatively fast again so it shouldn't be a problem and if the allocation fails we simply return at this point with an appropriate error message
@@ -771,6 +1563,8 @@ class ThingsBoardSized {
             return;
         }
 #else
+        // Records the size the received message requires instead of the size of the StaticJsonDocument, so that MaxResponse can be right-sized from it
+        Memory_Stats::Record_Stack(Memory_Subsystem::RECEIVE_DOCUMENT, JSON_OBJECT_SIZE(size));
         if (size > MaxResponse) {
             Logger::printfln(TOO_MANY_JSON_FIELDS, size, "MaxResponse", MaxResponse);
             return;
@@ -781,7 +1575,16 @@ class ThingsBoardSized {
 #if THINGSBOARD_ENABLE_DEBUG
         Logger::printfln(ALLOCATING_JSON, document_size);
 #endif // THINGSBOARD_ENABLE_DEBUG
+        Process_Json_Response(topic, payload, length, route, json_buffer);
+    }
 
+    /// @brief Deserializes the received payload into the given JsonDocument and passes it to all API implementations that process the received topic as json
+    /// @param topic Previously subscribed topic, we got the response over
+    /// @param payload Payload that was sent over the cloud and received over the given topic
+    /// @param length Total length of the received payload
+    /// @param route Node of the topic router previously found for the received topic
+    /// @param json_buffer JsonDocument with enough capacity to hold all json nodes contained in the received payload
+    void Process_Json_Response(char * topic, uint8_t * payload, unsigned int length, uint16_t const & route, JsonDocument & json_buffer) {
         // The deserializeJson method we use, can use the zero copy mode because a writeable input was passed,
         // if that were not the case the needed allocated memory would drastically increase, because the keys would need to be copied as well.
         // See https://arduinojson.org/v6/doc/deserialization/ for more info on ArduinoJson deserialization
@@ -791,109 +1594,173 @@ class ThingsBoardSized {
             return;
         }
 
-#if THINGSBOARD_ENABLE_STL
-#if THINGSBOARD_ENABLE_CXX20
-        auto filtered_json_api_implementations = m_api_implementations | std::views::filter([&topic](IAPI_Implementation const * api) {
-#else
-#if THINGSBOARD_ENABLE_DYNAMIC
-        Vector<IAPI_Implementation *> filtered_json_api_implementations = {};
-#else
-        Array<IAPI_Implementation *, MaxEndpointsAmount> filtered_json_api_implementations = {};
-#endif // THINGSBOARD_ENABLE_DYNAMIC
-        std::copy_if(m_api_implementations.begin(), m_api_implementations.end(), std::back_inserter(filtered_json_api_implementations), [&topic](IAPI_Implementation const * api) {
-#endif // THINGSBOARD_ENABLE_CXX20
-            return (api != nullptr && api->Get_Process_Type() == API_Process_Type::JSON && api->Compare_Response_Topic(topic));
+        Static_API_Json_Dispatcher json_dispatcher = { topic, json_buffer };
+        m_static_apis.for_each(json_dispatcher);
+        (void)m_topic_router.for_each_match(route, API_Process_Type::JSON, topic, [&](IAPI_Implementation & api) {
+            api.Process_Json_Response(topic, json_buffer);
         });
+    }
+
+    /// @brief Passes this instance as the client context to the given API implementation, which it uses to send and receive data and to access the shared internal state
+    /// @param api API implementation that should be connected to this instance
+    void Bind_API_Implementation(IAPI_Implementation & api) {
+        api.Set_Client_Context(*this);
+    }
+
+    // Function objects passed to the for_each method of the StaticAPIs. Each receives the API implementation as its actual type and calls the method qualified with that type,
+    // which resolves the call at compile time instead of through the virtual table. Seperate structs are used instead of lambdas, because C++11 does not support generic lambdas
+
+    /// @brief Connects and initializes every static API implementation
+    struct Static_API_Initializer {
+        ThingsBoardSized & client;
 
-        for (auto & api : filtered_json_api_implementations) {
-            api->Process_Json_Response(topic, json_buffer);
+        template <typename API>
+        void operator()(API & api) {
+            client.Bind_API_Implementation(api);
+            api.API::Initialize();
         }
-#else
-        for (auto & api : m_api_implementations) {
-            if (api == nullptr || api->Get_Process_Type() != API_Process_Type::JSON || !api->Compare_Response_Topic(topic)) {
-                continue;
-            }
-            api->Process_Json_Response(topic, json_buffer);
+    };
+
+    /// @brief Unsubscribes every static API implementation
+    struct Static_API_Unsubscriber {
+        template <typename API>
+        void operator()(API & api) {
+            (void)api.API::Unsubscribe();
         }
-#endif // THINGSBOARD_ENABLE_STL
-    }
+    };
 
-#if !THINGSBOARD_ENABLE_STL
-    static void onStaticMQTTMessage(char * topic, uint8_t * payload, unsigned int length) {
-        if (m_subscribedInstance == nullptr) {
-            return;
+    /// @brief Lets every static API implementation do its periodic work
+    struct Static_API_Looper {
+        template <typename API>
+        void operator()(API & api) {
+            api.API::loop();
         }
-        m_subscribedInstance->onMQTTMessage(topic, payload, length);
-    }
+    };
 
-    static void staticMQTTConnect() {
-        if (m_subscribedInstance == nullptr) {
-            return;
+    /// @brief Resubscribes the topics of every static API implementation
+    struct Static_API_Resubscriber {
+        template <typename API>
+        void operator()(API & api) {
+            (void)api.API::Resubscribe_Topic();
         }
-        m_subscribedInstance->Resubscribe_Topics();
-    }
+    };
+
+    /// @brief Passes a received response to every static API implementation that processes it as raw bytes and handles the received topic
+    struct Static_API_Raw_Dispatcher {
+        char *       topic;
+        uint8_t *    payload;
+        unsigned int length;
+        size_t       matched;
+
+        template <typename API>
+        void operator()(API & api) {
+            if (api.API::Get_Process_Type() != API_Process_Type::RAW || !api.API::Compare_Response_Topic(topic)) {
+                return;
+            }
+            api.API::Process_Response(topic, payload, length);
+            matched++;
+        }
+    };
 
-    static void staticSubscribeImplementation(IAPI_Implementation & api) {
-        if (m_subscribedInstance == nullptr) {
-            return;
+    /// @brief Passes a deserialized response to every static API implementation that processes it as json and handles the received topic
+    struct Static_API_Json_Dispatcher {
+        char *               topic;
+        JsonDocument const & data;
+
+        template <typename API>
+        void operator()(API & api) {
+            if (api.API::Get_Process_Type() != API_Process_Type::JSON || !api.API::Compare_Response_Topic(topic)) {
+                return;
+            }
+            api.API::Process_Json_Response(topic, data);
         }
-        m_subscribedInstance->Subscribe_API_Implementation(api);
-    }
+    };
 
-    static bool staticSendJson(char const * topic, JsonDocument const & source, size_t const & json_size) {
-        if (m_subscribedInstance == nullptr) {
-            return false;
+#if THINGSBOARD_ENABLE_DYNAMIC
+    /// @brief Reserves the persistent receive arena for one received message and grows it if the message requires more memory than the arena currently has
+    /// @param document_size Amount of bytes the JsonDocument needs to be able to hold the received message
+    /// @return Pointer to the receive arena or nullptr if the arena is disabled, already in use, the message exceeds the maximum arena size or growing the arena failed
+    JsonDocument * Acquire_Receive_Arena(size_t const & document_size) {
+        if (!m_receive_arena_enabled || m_receive_arena_in_use || (m_max_receive_arena_size != 0U && document_size > m_max_receive_arena_size)) {
+            return nullptr;
         }
-        return m_subscribedInstance->Send_Json(topic, source, json_size);
+        else if (m_receive_arena.capacity() < document_size && !Resize_Receive_Arena(document_size)) {
+            return nullptr;
+        }
+        m_receive_arena_in_use = true;
+        return &m_receive_arena;
     }
 
-    static bool staticSendJsonString(char const * topic, char const * json) {
-        if (m_subscribedInstance == nullptr) {
-            return false;
+    /// @brief Clears the persistent receive arena once the received message has been processed, so it can be reused by the next message.
+    /// Additionally shrinks the arena if all messages in the last shrink interval required less than half of its size
+    /// @param document_size Amount of bytes the JsonDocument needed to be able to hold the received message
+    void Release_Receive_Arena(size_t const & document_size) {
+        m_receive_arena.clear();
+        m_receive_arena_in_use = false;
+        if (m_receive_arena_shrink_interval == 0U) {
+            return;
         }
-        return m_subscribedInstance->Send_Json_String(topic, json);
-    }
 
-    static bool staticClientSubscribe(char const * topic) {
-        if (m_subscribedInstance == nullptr) {
-            return false;
+        if (document_size > m_receive_arena_interval_peak) {
+            m_receive_arena_interval_peak = document_size;
+        }
+        if (++m_receive_arena_interval_messages < m_receive_arena_shrink_interval) {
+            return;
+        }
+        if (m_receive_arena_interval_peak < m_receive_arena.capacity() / 2U) {
+            (void)Resize_Receive_Arena(m_receive_arena_interval_peak);
         }
-        return m_subscribedInstance->clientSubscribe(topic);
+        m_receive_arena_interval_messages = 0U;
+        m_receive_arena_interval_peak = 0U;
     }
 
-    static bool staticClientUnsubscribe(char const * topic) {
-        if (m_subscribedInstance == nullptr) {
+    /// @brief Replaces the persistent receive arena with a newly allocated one of the given size
+    /// @param arena_size Amount of bytes the receive arena should be able to hold
+    /// @return Whether allocating the receive arena with the given size was successful or not
+    bool Resize_Receive_Arena(size_t const & arena_size) {
+#if THINGSBOARD_ENABLE_DEBUG
+        Logger::printfln(RESIZING_RECEIVE_ARENA, m_receive_arena.capacity(), arena_size);
+#endif // THINGSBOARD_ENABLE_DEBUG
+        Memory_Scope const scope(Memory_Subsystem::RECEIVE_DOCUMENT);
+        m_receive_arena = TBJsonDocument(arena_size);
+        if (m_receive_arena.capacity() < arena_size) {
+            Logger::printfln(HEAP_ALLOCATION_FAILED, arena_size);
             return false;
         }
-        return m_subscribedInstance->clientUnsubscribe(topic);
+        if (m_receive_arena.capacity() > m_receive_arena_peak_size) {
+            m_receive_arena_peak_size = m_receive_arena.capacity();
+        }
+        return true;
     }
+#endif // THINGSBOARD_ENABLE_DYNAMIC
 
-    static size_t * staticGetRequestID() {
+#if !THINGSBOARD_ENABLE_STL
+    static void onStaticMQTTMessage(char * topic, uint8_t * payload, unsigned int length) {
         if (m_subscribedInstance == nullptr) {
-            return nullptr;
+            return;
         }
-        return m_subscribedInstance->getRequestID();
+        m_subscribedInstance->onMQTTMessage(topic, payload, length);
     }
 
-    static uint16_t staticGetClientReceiveBufferSize() {
+    static void staticMQTTConnect() {
         if (m_subscribedInstance == nullptr) {
-            return 0U;
+            return;
         }
-        return m_subscribedInstance->getClientReceiveBufferSize();
+        m_subscribedInstance->Resubscribe_Topics();
     }
 
-    static uint16_t staticGetClientSendBufferSize() {
+    static void staticDrainSpool() {
         if (m_subscribedInstance == nullptr) {
-            return 0U;
+            return;
         }
-        return m_subscribedInstance->getClientSendBufferSize();
+        m_subscribedInstance->Drain_Spool();
     }
 
-    static bool staticSetBufferSize(uint16_t receive_buffer_size, uint16_t send_buffer_size) {
+    static void staticFlushCoalescedTelemetry() {
         if (m_subscribedInstance == nullptr) {
-            return false;
+            return;
         }
-        return m_subscribedInstance->setBufferSize(receive_buffer_size, send_buffer_size);
+        m_subscribedInstance->Flush_Coalesced_Telemetry();
     }
 
     // PubSub client cannot call a instanced method when message arrives on subscribed topic.
@@ -910,22 +1777,56 @@ class ThingsBoardSized {
 #endif // THINGSBOARD_ENABLE_STREAM_UTILS
 #if !THINGSBOARD_ENABLE_DYNAMIC
     Array<IAPI_Implementation*, MaxEndpointsAmount> m_api_implementations = {}; // Can hold a pointer to all possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
+    Topic_Router<MaxEndpointsAmount>                m_topic_router = {};        // Routes received responses to the API implementations that handle the topic they were received on
 #else
     size_t                                          m_max_response_size = {};   // Maximum size allocated on the heap to hold the Json data structure for received cloud response payload, prevents possible malicious payload allocaitng a lot of memory
+    bool                                            m_receive_arena_enabled = {};           // Whether received payloads are deserialized into the persistent receive arena instead of a JsonDocument allocated for each message
+    size_t                                          m_max_receive_arena_size = {};          // Maximum size the persistent receive arena grows to, larger messages allocate their own JsonDocument instead
+    size_t                                          m_receive_arena_shrink_interval = {};   // Amount of received messages after which the receive arena is shrunk if it was mostly unused
+    size_t                                          m_receive_arena_interval_messages = {}; // Amount of messages received in the current shrink interval
+    size_t                                          m_receive_arena_interval_peak = {};     // Largest document size required by any message received in the current shrink interval
+    size_t                                          m_receive_arena_peak_size = {};         // Largest size the receive arena has ever been allocated with
+    bool                                            m_receive_arena_in_use = {};            // Whether the receive arena is currently used by a message that is still being processed
+    TBJsonDocument                                  m_receive_arena;                        // Persistent JsonDocument reused to deserialize received messages, prevents allocating and freeing heap memory for each message
     Vector<IAPI_Implementation*>                    m_api_implementations = {}; // Can hold a pointer to all  possible API implementations (Server side RPC, Client side RPC, Shared attribute update, Client-side or shared attribute request, Provision)   
+    Topic_Router                                    m_topic_router = {};        // Routes received responses to the API implementations that handle the topic they were received on
 #endif // !THINGSBOARD_ENABLE_DYNAMIC                
+    StaticAPIs                                      m_static_apis = {};         // API implementations owned by this instance, whose calls are dispatched at compile time
+#if !THINGSBOARD_ENABLE_DYNAMIC
+    Timer_Wheel_Entry                               m_timer_entries[MaxTimers]; // Storage for the timeout timers that can be armed at the same time in the timer wheel
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+    Timer_Wheel                                     m_timer_wheel;              // Shared timer wheel that handles the timeouts of all requests
+    ITelemetry_Spool *                              m_spool = {};               // Non-owning pointer to the spool that stores the data sent while the device is not connected
+    Callback<uint64_t>                              m_get_timestamp_callback = {}; // Callback that returns the current unix timestamp in milliseconds, stored together with the spooled data
+    uint64_t                                        m_spool_drain_interval = {};   // Amount of microseconds between sending two batches of spooled data
+    Callback<void>                                  m_spool_drain_callback = {};   // Callback armed in the timer wheel to send the next batch of spooled data
+    Timer_Handle                                    m_spool_drain_handle = {};     // Handle of the armed timer that sends the next batch of spooled data
+    Telemetry_Coalescer                             m_coalescer = {};              // Accumulates telemetry key value pairs, so that they can be sent as one json object
+    uint64_t                                        m_coalescing_window = {};      // Amount of microseconds after the first accumulated key value pair the coalesced data is flushed, 0 if it is flushed on every loop() call
+    Callback<void>                                  m_coalescing_flush_callback = {}; // Callback armed in the timer wheel to flush the coalesced data once the time window has passed
+    Timer_Handle                                    m_coalescing_flush_handle = {};   // Handle of the armed timer that flushes the coalesced data
 };
 
 #if !THINGSBOARD_ENABLE_STL
 #if !THINGSBOARD_ENABLE_DYNAMIC
-template<size_t MaxResponse, size_t MaxEndpointsAmount, typename Logger>
-ThingsBoardSized<MaxResponse, MaxEndpointsAmount, Logger> *ThingsBoardSized<MaxResponse, MaxEndpointsAmount, Logger>::m_subscribedInstance = nullptr;
+template<size_t MaxResponse, size_t MaxEndpointsAmount, typename Logger, size_t MaxTimers, typename StaticAPIs>
+ThingsBoardSized<MaxResponse, MaxEndpointsAmount, Logger, MaxTimers, StaticAPIs> *ThingsBoardSized<MaxResponse, MaxEndpointsAmount, Logger, MaxTimers, StaticAPIs>::m_subscribedInstance = nullptr;
 #else
-template<typename Logger>
-ThingsBoardSized<Logger> *ThingsBoardSized<Logger>::m_subscribedInstance = nullptr;
+template<typename Logger, typename StaticAPIs>
+ThingsBoardSized<Logger, StaticAPIs> *ThingsBoardSized<Logger, StaticAPIs>::m_subscribedInstance = nullptr;
 #endif // !THINGSBOARD_ENABLE_DYNAMIC
 #endif // !THINGSBOARD_ENABLE_STL
 
 using ThingsBoard = ThingsBoardSized<>;
 
+/// @brief ThingsBoardSized with the default sizes, that owns the given API implementations and dispatches all calls to them at compile time.
+/// Each API implementation is default constructed and can be accessed with getAPI<API>(), for example ThingsBoardStatic<Server_Side_RPC<>, Shared_Attribute_Update<>>
+/// @tparam APIs Types of the API implementations that should be owned by the instance
+template <typename... APIs>
+#if THINGSBOARD_ENABLE_DYNAMIC
+using ThingsBoardStatic = ThingsBoardSized<DefaultLogger, API_Pack<APIs...>>;
+#else
+using ThingsBoardStatic = ThingsBoardSized<Default_Response_Amount, Default_Endpoints_Amount, DefaultLogger, Default_Timers_Amount, API_Pack<APIs...>>;
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+
 #endif // ThingsBoard_h
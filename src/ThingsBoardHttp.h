@@ -83,19 +83,24 @@ class ThingsBoardHttpSized {
         }
         bool result = false;
         if (getMaximumStackSize() < json_size) {
-            char * json = new char[json_size]();
+            char * json = Allocator_Policy::Create_Array<char>(json_size, Memory_Subsystem::SEND_BUFFER);
+            if (json == nullptr) {
+                Logger::printfln(UNABLE_TO_ALLOCATE_MEMORY, json_size);
+                return false;
+            }
             if (serializeJson(source, json, json_size) < json_size - 1) {
                 Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
             }
             else {
                 result = Send_Json_String(topic, json);
             }
-            // Ensure to actually delete the memory placed onto the heap, to make sure we do not create a memory leak
+            // Ensure to actually free the allocated memory, to make sure we do not create a memory leak
             // and set the pointer to null so we do not have a dangling reference.
-            delete[] json;
+            Allocator_Policy::Destroy_Array(json);
             json = nullptr;
         }
         else {
+            Memory_Stats::Record_Stack(Memory_Subsystem::SEND_BUFFER, json_size);
             char json[json_size] = {};
             if (serializeJson(source, json, json_size) < json_size - 1) {
                 Logger::printfln(UNABLE_TO_SERIALIZE_JSON);
@@ -0,0 +1,460 @@
+#ifndef Timer_Wheel_h
+#define Timer_Wheel_h
+
+// Local includes.
+#include "Callback.h"
+#include "Allocator_Policy.h"
+
+// Library includes.
+#if THINGSBOARD_USE_ESP_TIMER
+#include <esp_timer.h>
+#elif THINGSBOARD_USE_POSIX_SOCKETS
+#include <time.h>
+#else
+#include <Arduino.h>
+#endif // THINGSBOARD_USE_ESP_TIMER
+
+
+uint32_t constexpr TIMER_WHEEL_TICK_MICROSECONDS = 10U * 1000U;
+uint8_t constexpr TIMER_WHEEL_LEVELS = 4U;
+uint8_t constexpr TIMER_WHEEL_SLOT_BITS = 5U;
+uint8_t constexpr TIMER_WHEEL_SLOTS = 1U << TIMER_WHEEL_SLOT_BITS;
+uint32_t constexpr TIMER_WHEEL_SLOT_MASK = TIMER_WHEEL_SLOTS - 1U;
+uint32_t constexpr TIMER_WHEEL_MAX_TICKS = (1UL << (TIMER_WHEEL_SLOT_BITS * TIMER_WHEEL_LEVELS)) - 1U;
+uint32_t constexpr TIMER_WHEEL_MAX_TIMEOUT_TICKS = INT32_MAX;
+uint16_t constexpr TIMER_WHEEL_INVALID_INDEX = UINT16_MAX;
+uint8_t constexpr TIMER_WHEEL_NO_BUCKET = UINT8_MAX;
+uint16_t constexpr TIMER_WHEEL_INITIAL_CAPACITY = 4U;
+uint64_t constexpr NO_PENDING_TIMEOUT = UINT64_MAX;
+
+
+/// @brief Identifies one armed timer of a Timer_Wheel, consists of the index of the internal entry and the generation of that entry when it was armed.
+/// The generation is increased every time an entry is released, which ensures that handles of timers that already expired or were cancelled,
+/// can never cancel a different timer that is now using the same entry. A value of INVALID_TIMER_HANDLE is never returned for an armed timer
+using Timer_Handle = uint32_t;
+Timer_Handle constexpr INVALID_TIMER_HANDLE = 0U;
+
+
+/// @brief Internal storage for one timer of the Timer_Wheel, entries are linked by index instead of by pointer,
+/// because that keeps them valid even if the underlying storage is reallocated to make space for further timers
+struct Timer_Wheel_Entry {
+    Callback<void> callback = {};                          // Callback that will be called once the timer expires
+    uint32_t       expires = {};                           // Absolute tick the timer expires at
+    uint16_t       next = TIMER_WHEEL_INVALID_INDEX;       // Next entry in the same bucket or in the list of free entries
+    uint16_t       prev = TIMER_WHEEL_INVALID_INDEX;       // Previous entry in the same bucket
+    uint16_t       generation = 1U;                        // Increased every time the entry is released, to invalidate previously returned handles
+    uint8_t        bucket = TIMER_WHEEL_NO_BUCKET;         // Bucket the entry is currently linked into, or TIMER_WHEEL_NO_BUCKET if it is not armed
+};
+
+
+/// @brief Hierarchical timing wheel, that allows to share one software timer between all requests that can timeout, instead of each request owning its own timer.
+/// Arming and cancelling a timer are O(1) operations and expiring them only requires touching the bucket of the current tick,
+/// plus cascading the timers of a higher level into the lower levels once every TIMER_WHEEL_SLOTS ticks.
+/// The wheel has TIMER_WHEEL_LEVELS levels with TIMER_WHEEL_SLOTS buckets each and a resolution of TIMER_WHEEL_TICK_MICROSECONDS,
+/// timeouts that are longer than the range of the highest level are simply cascaded from the highest level again until they are in range.
+/// Expired timers are only processed when update() is called, which is done internally from the loop() method of the ThingsBoard client,
+/// so we expect the user to recently often call that method. The callbacks are called from the same context as update(),
+/// which means that arming, cancelling and updating the wheel is expected to happen from the same task or with additional external locking.
+/// Time is measured with a 32-bit microsecond counter, therefore update() has to be called at least once every ~71 minutes while timers are armed
+class Timer_Wheel {
+  public:
+    /// @brief Constructs a timer wheel that allocates its entries on the heap and grows the allocation,
+    /// as soon as more timers are armed at the same time, than there are currently entries
+    Timer_Wheel()
+      : m_entries(nullptr)
+      , m_capacity(0U)
+      , m_owns_entries(true)
+      , m_free_head(TIMER_WHEEL_INVALID_INDEX)
+      , m_size(0U)
+      , m_current_tick(0U)
+      , m_now_tick(0U)
+      , m_remainder(0U)
+      , m_last_update(0U)
+      , m_heads()
+      , m_occupied()
+    {
+        clear_buckets();
+    }
+
+    /// @brief Constructs a timer wheel that uses the given externally owned entries, allows to allocate the entries on the stack instead of the heap.
+    /// Once all entries are armed at the same time, further attempts to arm a timer will fail
+    /// @param entries Pointer to the first element of the entries, that should be used to store the armed timers
+    /// @param capacity Amount of entries the given pointer points to, has to be smaller than TIMER_WHEEL_INVALID_INDEX
+    Timer_Wheel(Timer_Wheel_Entry * entries, uint16_t const & capacity)
+      : m_entries(entries)
+      , m_capacity(capacity)
+      , m_owns_entries(false)
+      , m_free_head(TIMER_WHEEL_INVALID_INDEX)
+      , m_size(0U)
+      , m_current_tick(0U)
+      , m_now_tick(0U)
+      , m_remainder(0U)
+      , m_last_update(0U)
+      , m_heads()
+      , m_occupied()
+    {
+        clear_buckets();
+        link_free_entries(0U);
+    }
+
+    /// @brief Destructor
+    ~Timer_Wheel() {
+        if (m_owns_entries) {
+            Allocator_Policy::Destroy_Array(m_entries);
+        }
+        m_entries = nullptr;
+    }
+
+    /// @brief Copying is not allowed, because previously returned handles would then refer to two different wheels
+    Timer_Wheel(Timer_Wheel const &) = delete;
+    Timer_Wheel & operator=(Timer_Wheel const &) = delete;
+
+    /// @brief Arms a oneshot timer that calls the given callback once the given timeout has passed, unless it is cancelled beforehand.
+    /// The timeout is measured from the time this method is called, not from the last time update() was called
+    /// and is rounded up to the next tick, meaning the callback is never called before the full timeout has passed
+    /// @param timeout_microseconds Amount of microseconds until the given callback is called
+    /// @param callback Callback that will be called once the timer expires, is copied into the internal entry
+    /// @return Handle that allows to cancel the timer again, or INVALID_TIMER_HANDLE if there is no free entry and none could be allocated
+    Timer_Handle arm(uint64_t const & timeout_microseconds, Callback<void> const & callback) {
+        if (m_size == 0U) {
+            synchronize();
+        }
+        uint16_t const index = allocate_entry();
+        if (index == TIMER_WHEEL_INVALID_INDEX) {
+            return INVALID_TIMER_HANDLE;
+        }
+
+        uint64_t ticks = (timeout_microseconds + elapsed_microseconds(get_time_microseconds()) + TIMER_WHEEL_TICK_MICROSECONDS - 1U) / TIMER_WHEEL_TICK_MICROSECONDS;
+        // Ensure the timer always expires at a later tick than the one that might currently be processed,
+        // because a timer armed from inside an expiring callback would otherwise be added to the bucket that is currently being emptied
+        if (ticks == 0U) {
+            ticks = 1U;
+        }
+        else if (ticks > TIMER_WHEEL_MAX_TIMEOUT_TICKS) {
+            ticks = TIMER_WHEEL_MAX_TIMEOUT_TICKS;
+        }
+
+        Timer_Wheel_Entry & entry = m_entries[index];
+        entry.callback = callback;
+        entry.expires = m_now_tick + static_cast<uint32_t>(ticks);
+        insert_entry(index);
+        return (static_cast<uint32_t>(entry.generation) << 16U) | index;
+    }
+
+    /// @brief Cancels the timer connected to the given handle, ensuring its callback is not called anymore.
+    /// Cancelling a timer that already expired or was already cancelled is allowed and simply does nothing
+    /// @param handle Handle returned when the timer was armed, is reset to INVALID_TIMER_HANDLE afterwards
+    /// @return Whether the timer was still armed and has now been cancelled
+    bool cancel(Timer_Handle & handle) {
+        uint16_t const index = handle & UINT16_MAX;
+        uint16_t const generation = handle >> 16U;
+        handle = INVALID_TIMER_HANDLE;
+
+        if (index >= m_capacity) {
+            return false;
+        }
+        Timer_Wheel_Entry const & entry = m_entries[index];
+        if (entry.generation != generation || entry.bucket == TIMER_WHEEL_NO_BUCKET) {
+            return false;
+        }
+        unlink_entry(index);
+        free_entry(index);
+        return true;
+    }
+
+    /// @brief Whether the timer connected to the given handle is still armed, meaning it has not expired and was not cancelled yet
+    /// @param handle Handle returned when the timer was armed
+    /// @return Whether the timer is still armed
+    bool armed(Timer_Handle const & handle) const {
+        uint16_t const index = handle & UINT16_MAX;
+        if (index >= m_capacity) {
+            return false;
+        }
+        Timer_Wheel_Entry const & entry = m_entries[index];
+        return entry.generation == (handle >> 16U) && entry.bucket != TIMER_WHEEL_NO_BUCKET;
+    }
+
+    /// @brief Advances the wheel to the current time and calls the callbacks of all timers that expired in the meantime.
+    /// Ticks without any timers in the lowest level are skipped, so calling this method after a longer pause does not process every tick one by one
+    void update() {
+        if (m_size == 0U) {
+            synchronize();
+            m_current_tick = m_now_tick + 1U;
+            return;
+        }
+
+        uint32_t const now = get_time_microseconds();
+        uint64_t const elapsed = elapsed_microseconds(now);
+        m_last_update = now;
+        m_now_tick += static_cast<uint32_t>(elapsed / TIMER_WHEEL_TICK_MICROSECONDS);
+        m_remainder = static_cast<uint32_t>(elapsed % TIMER_WHEEL_TICK_MICROSECONDS);
+
+        while (m_size != 0U && static_cast<int32_t>(m_now_tick - m_current_tick) >= 0) {
+            // Skip directly to the next boundary of the lowest level, if no timer could expire before then.
+            // Boundaries themselves still have to be processed, because that is where the higher levels are cascaded
+            if ((m_current_tick & TIMER_WHEEL_SLOT_MASK) != 0U && m_occupied[0U] == 0U) {
+                uint32_t const boundary = (m_current_tick | TIMER_WHEEL_SLOT_MASK) + 1U;
+                m_current_tick = static_cast<int32_t>(m_now_tick - boundary) >= 0 ? boundary : m_now_tick + 1U;
+                continue;
+            }
+            process_tick();
+        }
+
+        if (m_size == 0U) {
+            m_current_tick = m_now_tick + 1U;
+        }
+    }
+
+    /// @brief Calculates the amount of microseconds until the next timer could expire, allows to sleep or block for that long, without missing any timeout.
+    /// For timers in the higher levels the returned value is the time until they are cascaded into a lower level, which is never later than their actual expiry
+    /// @return Amount of microseconds until update() should be called again at the latest, 0 if timers are already overdue
+    /// or NO_PENDING_TIMEOUT if no timer is currently armed
+    uint64_t time_until_next_timeout() const {
+        if (m_size == 0U) {
+            return NO_PENDING_TIMEOUT;
+        }
+
+        uint32_t ticks = UINT32_MAX;
+        for (uint8_t level = 0U; level < TIMER_WHEEL_LEVELS; level++) {
+            uint32_t const occupied = m_occupied[level];
+            if (occupied == 0U) {
+                continue;
+            }
+            uint8_t const shift = TIMER_WHEEL_SLOT_BITS * level;
+            uint8_t const index = (m_current_tick >> shift) & TIMER_WHEEL_SLOT_MASK;
+            uint32_t const rotated = index == 0U ? occupied : (occupied >> index) | (occupied << (TIMER_WHEEL_SLOTS - index));
+
+            uint32_t level_ticks = 0U;
+            if (level == 0U) {
+                level_ticks = __builtin_ctzl(static_cast<unsigned long>(rotated));
+            }
+            else {
+                // Buckets of the higher levels are cascaded once the index of that level advances to them,
+                // the bucket at the current index is therefore only reached again after a full rotation, unless the next tick is exactly the one cascading it
+                uint32_t const offset = m_current_tick & ((1UL << shift) - 1U);
+                uint32_t const ahead = offset == 0U ? rotated : rotated & ~1UL;
+                uint32_t const distance = ahead != 0U ? __builtin_ctzl(static_cast<unsigned long>(ahead)) : TIMER_WHEEL_SLOTS;
+                level_ticks = (distance << shift) - offset;
+            }
+            if (level_ticks < ticks) {
+                ticks = level_ticks;
+            }
+        }
+
+        int64_t const remaining_ticks = static_cast<int64_t>(ticks) + static_cast<int32_t>(m_current_tick - m_now_tick);
+        int64_t const remaining = remaining_ticks * TIMER_WHEEL_TICK_MICROSECONDS - static_cast<int64_t>(elapsed_microseconds(get_time_microseconds()));
+        return remaining > 0 ? static_cast<uint64_t>(remaining) : 0U;
+    }
+
+    /// @brief Gets the amount of timers that are currently armed
+    /// @return Amount of currently armed timers
+    size_t size() const {
+        return m_size;
+    }
+
+    /// @brief Gets the amount of entries that are currently available to arm timers with
+    /// @return Amount of entries that are currently allocated or were passed in the constructor
+    size_t capacity() const {
+        return m_capacity;
+    }
+
+    /// @brief Gets the current time from the ESP Timer if it exists, from the monotonic POSIX clock when running natively on a POSIX system or from the Arduino micros() method otherwise
+    /// @return Current time in microseconds, truncated to 32-bit, meaning durations have to be calculated as the unsigned difference of two values and may not exceed around 71 minutes
+    static uint32_t get_time_microseconds() {
+#if THINGSBOARD_USE_ESP_TIMER
+        return static_cast<uint32_t>(esp_timer_get_time());
+#elif THINGSBOARD_USE_POSIX_SOCKETS
+        timespec time = {};
+        (void)clock_gettime(CLOCK_MONOTONIC, &time);
+        return static_cast<uint32_t>(static_cast<uint64_t>(time.tv_sec) * 1000000ULL + static_cast<uint64_t>(time.tv_nsec) / 1000ULL);
+#else
+        return static_cast<uint32_t>(micros());
+#endif // THINGSBOARD_USE_ESP_TIMER
+    }
+
+  private:
+    /// @brief Calculates the amount of microseconds that passed since the last tick was accounted for
+    /// @param now Current time in microseconds
+    /// @return Amount of microseconds since the start of the tick m_now_tick
+    uint64_t elapsed_microseconds(uint32_t const & now) const {
+        return static_cast<uint64_t>(m_remainder) + static_cast<uint32_t>(now - m_last_update);
+    }
+
+    /// @brief Restarts the time measurement from the current time, only allowed while no timer is armed,
+    /// because it allows the wheel to skip over all time where no timer was armed and therefore update() might not have been called
+    void synchronize() {
+        m_last_update = get_time_microseconds();
+        m_remainder = 0U;
+    }
+
+    /// @brief Resets all buckets to be empty
+    void clear_buckets() {
+        for (auto & head : m_heads) {
+            head = TIMER_WHEEL_INVALID_INDEX;
+        }
+        for (auto & occupied : m_occupied) {
+            occupied = 0U;
+        }
+    }
+
+    /// @brief Links all entries starting at the given index into the list of free entries
+    /// @param first Index of the first entry that should be linked
+    void link_free_entries(uint16_t const & first) {
+        for (uint16_t index = m_capacity; index > first; index--) {
+            m_entries[index - 1U].next = m_free_head;
+            m_free_head = index - 1U;
+        }
+    }
+
+    /// @brief Increases the amount of allocated entries, only possible if the entries are owned by the wheel itself
+    /// @return Whether additional entries could be allocated
+    bool grow() {
+        if (!m_owns_entries || m_capacity >= TIMER_WHEEL_INVALID_INDEX / 2U) {
+            return false;
+        }
+        uint16_t const capacity = m_capacity == 0U ? TIMER_WHEEL_INITIAL_CAPACITY : m_capacity * 2U;
+        Timer_Wheel_Entry * entries = Allocator_Policy::Create_Array<Timer_Wheel_Entry>(capacity, Memory_Subsystem::TIMERS);
+        if (entries == nullptr) {
+            return false;
+        }
+        for (uint16_t index = 0U; index < m_capacity; index++) {
+            entries[index] = m_entries[index];
+        }
+        Allocator_Policy::Destroy_Array(m_entries);
+        m_entries = entries;
+        uint16_t const first = m_capacity;
+        m_capacity = capacity;
+        link_free_entries(first);
+        return true;
+    }
+
+    /// @brief Takes one entry from the list of free entries, grows the allocated entries if there is no free entry left and that is possible
+    /// @return Index of the allocated entry or TIMER_WHEEL_INVALID_INDEX if there is none
+    uint16_t allocate_entry() {
+        if (m_free_head == TIMER_WHEEL_INVALID_INDEX && !grow()) {
+            return TIMER_WHEEL_INVALID_INDEX;
+        }
+        uint16_t const index = m_free_head;
+        m_free_head = m_entries[index].next;
+        m_entries[index].next = TIMER_WHEEL_INVALID_INDEX;
+        m_size++;
+        return index;
+    }
+
+    /// @brief Returns the given entry to the list of free entries and invalidates all handles that were returned for it
+    /// @param index Index of the entry that should be released, has to already be unlinked from its bucket
+    void free_entry(uint16_t const & index) {
+        Timer_Wheel_Entry & entry = m_entries[index];
+        entry.callback = Callback<void>();
+        entry.generation++;
+        if (entry.generation == 0U) {
+            entry.generation = 1U;
+        }
+        entry.next = m_free_head;
+        m_free_head = index;
+        m_size--;
+    }
+
+    /// @brief Links the given entry into the bucket matching its expiry time, relative to the tick that will be processed next.
+    /// Timers that are further away than the range of the highest level are linked into the last bucket in range and inserted again once they are cascaded
+    /// @param index Index of the entry that should be linked
+    void insert_entry(uint16_t const & index) {
+        Timer_Wheel_Entry & entry = m_entries[index];
+        int32_t const delta = static_cast<int32_t>(entry.expires - m_current_tick);
+        uint32_t const ticks = delta < 0 ? 0U : (static_cast<uint32_t>(delta) > TIMER_WHEEL_MAX_TICKS ? TIMER_WHEEL_MAX_TICKS : static_cast<uint32_t>(delta));
+        uint32_t const target = m_current_tick + ticks;
+
+        uint8_t level = 0U;
+        while (level < TIMER_WHEEL_LEVELS - 1U && ticks >= (1UL << (TIMER_WHEEL_SLOT_BITS * (level + 1U)))) {
+            level++;
+        }
+        uint8_t const slot = (target >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+        uint8_t const bucket = level * TIMER_WHEEL_SLOTS + slot;
+
+        entry.bucket = bucket;
+        entry.prev = TIMER_WHEEL_INVALID_INDEX;
+        entry.next = m_heads[bucket];
+        if (entry.next != TIMER_WHEEL_INVALID_INDEX) {
+            m_entries[entry.next].prev = index;
+        }
+        m_heads[bucket] = index;
+        m_occupied[level] |= 1UL << slot;
+    }
+
+    /// @brief Removes the given entry from the bucket it is currently linked into
+    /// @param index Index of the entry that should be unlinked
+    void unlink_entry(uint16_t const & index) {
+        Timer_Wheel_Entry & entry = m_entries[index];
+        uint8_t const bucket = entry.bucket;
+        if (entry.prev != TIMER_WHEEL_INVALID_INDEX) {
+            m_entries[entry.prev].next = entry.next;
+        }
+        else {
+            m_heads[bucket] = entry.next;
+        }
+        if (entry.next != TIMER_WHEEL_INVALID_INDEX) {
+            m_entries[entry.next].prev = entry.prev;
+        }
+        if (m_heads[bucket] == TIMER_WHEEL_INVALID_INDEX) {
+            m_occupied[bucket / TIMER_WHEEL_SLOTS] &= ~(1UL << (bucket & TIMER_WHEEL_SLOT_MASK));
+        }
+        entry.bucket = TIMER_WHEEL_NO_BUCKET;
+        entry.next = TIMER_WHEEL_INVALID_INDEX;
+        entry.prev = TIMER_WHEEL_INVALID_INDEX;
+    }
+
+    /// @brief Moves all entries of the given bucket into the lower levels
+    /// @param level Level of the bucket that should be cascaded
+    /// @param slot Slot of the bucket that should be cascaded
+    void cascade(uint8_t const & level, uint8_t const & slot) {
+        uint8_t const bucket = level * TIMER_WHEEL_SLOTS + slot;
+        uint16_t index = m_heads[bucket];
+        m_heads[bucket] = TIMER_WHEEL_INVALID_INDEX;
+        m_occupied[level] &= ~(1UL << slot);
+
+        while (index != TIMER_WHEEL_INVALID_INDEX) {
+            uint16_t const next = m_entries[index].next;
+            insert_entry(index);
+            index = next;
+        }
+    }
+
+    /// @brief Processes the next tick, cascades the higher levels if the lowest level wrapped around and calls the callbacks of all timers expiring in this tick
+    void process_tick() {
+        uint8_t const slot = m_current_tick & TIMER_WHEEL_SLOT_MASK;
+        if (slot == 0U) {
+            for (uint8_t level = 1U; level < TIMER_WHEEL_LEVELS; level++) {
+                uint8_t const level_slot = (m_current_tick >> (TIMER_WHEEL_SLOT_BITS * level)) & TIMER_WHEEL_SLOT_MASK;
+                cascade(level, level_slot);
+                if (level_slot != 0U) {
+                    break;
+                }
+            }
+        }
+
+        while (m_heads[slot] != TIMER_WHEEL_INVALID_INDEX) {
+            uint16_t const index = m_heads[slot];
+            unlink_entry(index);
+            // Copy the callback before releasing the entry, because the callback is allowed to arm further timers,
+            // which could reuse the same entry or reallocate all entries
+            Callback<void> const callback = m_entries[index].callback;
+            free_entry(index);
+            callback.Call_Callback();
+        }
+        m_current_tick++;
+    }
+
+    Timer_Wheel_Entry *m_entries = {};                                             // Entries used to store the armed timers
+    uint16_t          m_capacity = {};                                             // Amount of entries m_entries points to
+    bool              m_owns_entries = {};                                         // Whether the entries were allocated by the wheel and can be grown
+    uint16_t          m_free_head = {};                                            // First entry in the list of currently free entries
+    uint16_t          m_size = {};                                                 // Amount of currently armed timers
+    uint32_t          m_current_tick = {};                                         // Next tick that will be processed
+    uint32_t          m_now_tick = {};                                             // Tick the current time was in, when update() was last called
+    uint32_t          m_remainder = {};                                            // Microseconds that passed since the start of m_now_tick, when update() was last called
+    uint32_t          m_last_update = {};                                          // Time in microseconds update() was last called
+    uint16_t          m_heads[TIMER_WHEEL_LEVELS * TIMER_WHEEL_SLOTS] = {};        // First entry of each bucket
+    uint32_t          m_occupied[TIMER_WHEEL_LEVELS] = {};                         // Bitmask for each level containing which buckets contain at least one entry
+};
+
+#endif // Timer_Wheel_h
@@ -0,0 +1,227 @@
+#ifndef Topic_Router_h
+#define Topic_Router_h
+
+// Local includes.
+#include "IAPI_Implementation.h"
+
+
+uint16_t constexpr TOPIC_ROUTER_INVALID_INDEX = UINT16_MAX;
+uint16_t constexpr TOPIC_ROUTER_ROOT_INDEX = 0U;
+
+
+/// @brief Node of the radix tree used by the Topic_Router, each node represents the part of a response topic prefix that follows the part represented by its parent.
+/// Nodes are linked by index instead of by pointer, because that keeps them valid even if the underlying storage is reallocated to make space for further routes
+struct Topic_Router_Node {
+    char const * label = {};                                // Pointer into the response topic prefix of the route that created this node, has to be kept alive for as long as the router
+    uint16_t     label_length = {};                         // Amount of characters of the label this node represents
+    uint16_t     parent = TOPIC_ROUTER_INVALID_INDEX;       // Node that represents the part of the prefix before this node
+    uint16_t     first_child = TOPIC_ROUTER_INVALID_INDEX;  // First node that continues the prefix represented by this node
+    uint16_t     next_sibling = TOPIC_ROUTER_INVALID_INDEX; // Next node with the same parent, no two siblings ever start with the same character
+    uint16_t     raw_routes = TOPIC_ROUTER_INVALID_INDEX;   // First route that processes responses as raw bytes and whose prefix ends at this node
+    uint16_t     json_routes = TOPIC_ROUTER_INVALID_INDEX;  // First route that processes responses as json and whose prefix ends at this node
+};
+
+
+/// @brief Route of the Topic_Router, links one API implementation to the node its response topic prefix ends at
+struct Topic_Route {
+    IAPI_Implementation * api = {};                          // Non-owning pointer to the API implementation that handles responses received on topics starting with the prefix
+    uint16_t              next = TOPIC_ROUTER_INVALID_INDEX; // Next route of the same process type whose prefix ends at the same node
+};
+
+
+/// @brief Routes received responses to the API implementations that handle them. Instead of comparing the received topic against every subscribed API implementation,
+/// the response topic prefixes are inserted into a radix tree once the API implementation is subscribed. Dispatching a received topic then only walks the tree once
+/// and only calls Compare_Response_Topic on the API implementations whose prefix actually matches, to still support topics that have to match exactly (Shared attribute update, Provision).
+/// The tree is only ever appended to and dispatching does not allocate any memory
+#if THINGSBOARD_ENABLE_DYNAMIC
+class Topic_Router {
+#else
+/// @tparam MaxRoutes Maximum amount of API implementations that can be routed to.
+/// Once the maximum amount has been reached it is not possible to increase the size, this is done because it allows to allcoate the memory on the stack instead of the heap.
+/// Every inserted route creates at most two nodes, therefore the tree never needs more than twice that amount of nodes plus the root
+template<size_t MaxRoutes>
+class Topic_Router {
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+  public:
+    /// @brief Constructor
+    Topic_Router()
+      : m_nodes()
+      , m_routes()
+    {
+        m_nodes.push_back(Topic_Router_Node());
+    }
+
+    /// @brief Inserts the response topic prefix of the given API implementation into the tree,
+    /// so that responses received on topics starting with that prefix are routed to the given API implementation from now on
+    /// @param api API implementation that should be routed to, the prefix returned by its Get_Response_Topic_Prefix method has to be kept alive for as long as the router
+    /// @return Whether inserting the route was successful or not, fails if the maximum amount of routes has been reached
+    bool insert(IAPI_Implementation & api) {
+#if !THINGSBOARD_ENABLE_DYNAMIC
+        if (m_routes.size() + 1U > m_routes.capacity() || m_nodes.size() + 2U > m_nodes.capacity()) {
+            return false;
+        }
+#endif // !THINGSBOARD_ENABLE_DYNAMIC
+        char const * prefix = api.Get_Response_Topic_Prefix();
+        if (prefix == nullptr) {
+            prefix = "";
+        }
+        uint16_t const prefix_length = strlen(prefix);
+        uint16_t node = TOPIC_ROUTER_ROOT_INDEX;
+        uint16_t position = 0U;
+
+        while (position < prefix_length) {
+            uint16_t const child = find_child(node, prefix[position]);
+            if (child == TOPIC_ROUTER_INVALID_INDEX) {
+                Topic_Router_Node leaf = {};
+                leaf.label = prefix + position;
+                leaf.label_length = prefix_length - position;
+                node = append_child(node, leaf);
+                position = prefix_length;
+                break;
+            }
+            uint16_t const common_length = get_common_length(m_nodes[child].label, m_nodes[child].label_length, prefix + position, prefix_length - position);
+            if (common_length < m_nodes[child].label_length) {
+                split_node(child, common_length);
+            }
+            node = child;
+            position += common_length;
+        }
+
+        Topic_Route route = {};
+        route.api = &api;
+        m_routes.push_back(route);
+        uint16_t const index = m_routes.size() - 1U;
+        uint16_t * tail = api.Get_Process_Type() == API_Process_Type::RAW ? &m_nodes[node].raw_routes : &m_nodes[node].json_routes;
+        while (*tail != TOPIC_ROUTER_INVALID_INDEX) {
+            tail = &m_routes[*tail].next;
+        }
+        *tail = index;
+        return true;
+    }
+
+    /// @brief Walks the tree along the given topic once and returns the deepest node whose full prefix the topic starts with,
+    /// the returned node and all its parents then contain every route that could handle a response received on the given topic
+    /// @param topic Received topic that should be routed, has to be null terminated
+    /// @return Index of the deepest matching node, which is the root node if no prefix except the empty one matched
+    uint16_t find(char const * topic) const {
+        uint16_t node = TOPIC_ROUTER_ROOT_INDEX;
+        if (topic == nullptr) {
+            return node;
+        }
+        char const * remaining = topic;
+        while (*remaining != '\0') {
+            uint16_t const child = find_child(node, *remaining);
+            if (child == TOPIC_ROUTER_INVALID_INDEX || strncmp(m_nodes[child].label, remaining, m_nodes[child].label_length) != 0) {
+                break;
+            }
+            remaining += m_nodes[child].label_length;
+            node = child;
+        }
+        return node;
+    }
+
+    /// @brief Calls the given function for every API implementation with the given process type, that is routed to by the given node or any of its parents
+    /// and additionally confirms it handles the given topic with its Compare_Response_Topic method
+    /// @tparam Function Function that receives a reference to the matching API implementation
+    /// @param node Index of the node previously returned by find() for the given topic
+    /// @param type Process type the API implementations have to use
+    /// @param topic Received topic that was previously passed to find()
+    /// @param function Function that will be called for every matching API implementation
+    /// @return Amount of API implementations the function was called for
+    template<typename Function>
+    size_t for_each_match(uint16_t node, API_Process_Type const & type, char const * topic, Function const & function) const {
+        size_t matches = 0U;
+        for (; node != TOPIC_ROUTER_INVALID_INDEX; node = m_nodes[node].parent) {
+            uint16_t route = type == API_Process_Type::RAW ? m_nodes[node].raw_routes : m_nodes[node].json_routes;
+            for (; route != TOPIC_ROUTER_INVALID_INDEX; route = m_routes[route].next) {
+                IAPI_Implementation & api = *m_routes[route].api;
+                if (!api.Compare_Response_Topic(topic)) {
+                    continue;
+                }
+                function(api);
+                matches++;
+            }
+        }
+        return matches;
+    }
+
+    /// @brief Gets the amount of routes that have been inserted
+    /// @return Amount of API implementations that are currently routed to
+    size_t size() const {
+        return m_routes.size();
+    }
+
+  private:
+    /// @brief Searches the child of the given node whose label starts with the given character
+    /// @param node Index of the node whose children should be searched
+    /// @param character First character of the label of the searched child
+    /// @return Index of the matching child or TOPIC_ROUTER_INVALID_INDEX if there is none
+    uint16_t find_child(uint16_t const & node, char const & character) const {
+        uint16_t child = m_nodes[node].first_child;
+        while (child != TOPIC_ROUTER_INVALID_INDEX && m_nodes[child].label[0] != character) {
+            child = m_nodes[child].next_sibling;
+        }
+        return child;
+    }
+
+    /// @brief Appends the given node as the last child of the given parent
+    /// @param parent Index of the node the given node should be appended to
+    /// @param node Node that should be appended, parent and sibling are overwritten
+    /// @return Index of the appended node
+    uint16_t append_child(uint16_t const & parent, Topic_Router_Node node) {
+        node.parent = parent;
+        node.next_sibling = m_nodes[parent].first_child;
+        m_nodes.push_back(node);
+        uint16_t const index = m_nodes.size() - 1U;
+        m_nodes[parent].first_child = index;
+        return index;
+    }
+
+    /// @brief Splits the given node after the given amount of characters, by moving the remaining characters, its routes and its children into a new child node.
+    /// The index of the given node stays the same, which keeps the links of its parent and siblings valid
+    /// @param node Index of the node that should be split
+    /// @param length Amount of characters the given node should keep, has to be smaller than its current label length
+    void split_node(uint16_t const & node, uint16_t const & length) {
+        Topic_Router_Node tail = m_nodes[node];
+        tail.label += length;
+        tail.label_length -= length;
+        tail.parent = node;
+        tail.next_sibling = TOPIC_ROUTER_INVALID_INDEX;
+        m_nodes.push_back(tail);
+        uint16_t const index = m_nodes.size() - 1U;
+
+        for (uint16_t child = tail.first_child; child != TOPIC_ROUTER_INVALID_INDEX; child = m_nodes[child].next_sibling) {
+            m_nodes[child].parent = index;
+        }
+        Topic_Router_Node & head = m_nodes[node];
+        head.label_length = length;
+        head.first_child = index;
+        head.raw_routes = TOPIC_ROUTER_INVALID_INDEX;
+        head.json_routes = TOPIC_ROUTER_INVALID_INDEX;
+    }
+
+    /// @brief Counts the amount of characters both given strings start with
+    /// @param first First string, does not need to be null terminated
+    /// @param first_length Amount of characters in the first string
+    /// @param second Second string, does not need to be null terminated
+    /// @param second_length Amount of characters in the second string
+    /// @return Amount of equal characters at the start of both strings
+    static uint16_t get_common_length(char const * first, uint16_t const & first_length, char const * second, uint16_t const & second_length) {
+        uint16_t const length = first_length < second_length ? first_length : second_length;
+        uint16_t common_length = 0U;
+        while (common_length < length && first[common_length] == second[common_length]) {
+            common_length++;
+        }
+        return common_length;
+    }
+
+#if THINGSBOARD_ENABLE_DYNAMIC
+    Vector<Topic_Router_Node>                     m_nodes = {};  // Nodes of the radix tree, the first node is always the root and represents the empty prefix
+    Vector<Topic_Route>                           m_routes = {}; // Routes to every inserted API implementation
+#else
+    Array<Topic_Router_Node, 2U * MaxRoutes + 1U> m_nodes = {};  // Nodes of the radix tree, the first node is always the root and represents the empty prefix
+    Array<Topic_Route, MaxRoutes>                 m_routes = {}; // Routes to every inserted API implementation
+#endif // THINGSBOARD_ENABLE_DYNAMIC
+};
+
+#endif // Topic_Router_h
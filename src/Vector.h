@@ -3,12 +3,16 @@
 
 // Local include.
 #include "Helper.h"
+#include "Allocator_Policy.h"
 
 // Library includes.
 #include <assert.h>
+#include <stddef.h>
 
 
 /// @brief Replacement data container for boards that do not support the C++ STL and therefore do not have the std::vector class.
+/// Elements are constructed in uninitialized memory with placement new and moved into the new memory once the capacity is increased,
+/// meaning elements that are not trivially copyable, like the callbacks with their own nested Vector, are copied, moved and destroyed correctly
 /// @tparam T Type of the underlying data the list should point too.
 template <typename T>
 class Vector {
@@ -18,6 +22,29 @@ class Vector {
     /// @brief Constructor
     Vector(void) = default;
 
+    /// @brief Copy constructor, copies every element into newly allocated memory
+    /// @param other Vector whose elements should be copied
+    Vector(Vector const & other)
+      : m_elements(nullptr)
+      , m_capacity(0U)
+      , m_size(0U)
+    {
+        reserve(other.m_size);
+        insert(nullptr, other.begin(), other.end());
+    }
+
+    /// @brief Move constructor, takes over the memory of the given vector, which is empty afterwards
+    /// @param other Vector whose memory should be taken over
+    Vector(Vector && other)
+      : m_elements(other.m_elements)
+      , m_capacity(other.m_capacity)
+      , m_size(other.m_size)
+    {
+        other.m_elements = nullptr;
+        other.m_capacity = 0U;
+        other.m_size = 0U;
+    }
+
     /// @brief Constructor that allows compatibility with std::vector, simply forwards call to internal insert method and copies all data between the first and last iterator
     /// @tparam InputIterator Class that points to the begin and end iterator
     /// of the given data container, allows for using / passing either std::vector or std::array.
@@ -30,6 +57,7 @@ class Vector {
       , m_capacity(0U)
       , m_size(0U)
     {
+        reserve(Helper::distance(first, last));
         insert(nullptr, first, last);
     }
 
@@ -45,16 +73,45 @@ class Vector {
       , m_capacity(0U)
       , m_size(0U)
     {
+        reserve(Helper::distance(container.begin(), container.end()));
         insert(nullptr, container.begin(), container.end());
     }
 
     /// @brief Destructor
     ~Vector() {
-        delete[] m_elements;
+        clear();
+        deallocate(m_elements);
         m_elements = nullptr;
     }
 
-    /// @brief Method that allows compatibility with std::vector, simply forwards call to internal insert method and copies all data between the first and last iterator
+    /// @brief Copy assignment operator, destroys all elements and copies every element of the given vector
+    /// @param other Vector whose elements should be copied
+    /// @return Reference to this vector
+    Vector & operator=(Vector const & other) {
+        if (this != &other) {
+            assign(other.begin(), other.end());
+        }
+        return *this;
+    }
+
+    /// @brief Move assignment operator, destroys all elements and takes over the memory of the given vector, which is empty afterwards
+    /// @param other Vector whose memory should be taken over
+    /// @return Reference to this vector
+    Vector & operator=(Vector && other) {
+        if (this != &other) {
+            clear();
+            deallocate(m_elements);
+            m_elements = other.m_elements;
+            m_capacity = other.m_capacity;
+            m_size = other.m_size;
+            other.m_elements = nullptr;
+            other.m_capacity = 0U;
+            other.m_size = 0U;
+        }
+        return *this;
+    }
+
+    /// @brief Method that allows compatibility with std::vector, replaces all elements with the data between the first and last iterator
     /// @tparam InputIterator Class that points to the begin and end iterator
     /// of the given data container, allows for using / passing either std::vector or std::array.
     /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
@@ -62,10 +119,12 @@ class Vector {
     /// @param last Iterator pointing to one past the end of the elements we want to copy into our underlying data container
     template<typename InputIterator>
     void assign(InputIterator const & first, InputIterator const & last) {
+        clear();
+        reserve(Helper::distance(first, last));
         insert(nullptr, first, last);
     }
 
-    /// @brief Method that allows compatibility with std::vector, simply forwards call to internal insert method and copies all data from the given container
+    /// @brief Method that allows compatibility with std::vector, replaces all elements with the data from the given container
     /// @tparam Container Class that contains the actual data we want to copy into our internal data container,
     /// requires access to a begin() and end() method, that point to the first element and one past the last element we want to copy respectively.
     /// Both methods need to return an InputIterator, allows for using / passing either std::vector or std::array.
@@ -73,7 +132,7 @@ class Vector {
     /// @param container Data container with begin() and end() method that we want to copy fully into our underlying data container
     template<typename Container>
     void assign(Container const & container) {
-        insert(nullptr, container.begin(), container.end());
+        assign(container.begin(), container.end());
     }
 
     /// @brief Returns whether there are still any element in the underlying data container
@@ -94,6 +153,21 @@ class Vector {
         return m_capacity;
     }
 
+    /// @brief Increases the capacity to atleast the given amount of elements, allows to allocate the required memory once before inserting multiple elements
+    /// @param capacity Amount of elements that should be insertable without increasing the capacity again
+    void reserve(size_t const & capacity) {
+        if (capacity > m_capacity) {
+            (void)reallocate(capacity);
+        }
+    }
+
+    /// @brief Decreases the capacity to the amount of elements currently contained, frees all memory if the vector is empty
+    void shrink_to_fit() {
+        if (m_size < m_capacity) {
+            (void)reallocate(m_size);
+        }
+    }
+
     /// @brief Returns a iterator to the first element of the underlying data container
     /// @return Iterator pointing to the first element of the underlying data container
     T * begin() {
@@ -137,23 +211,51 @@ class Vector {
         return m_elements + m_size;
     }
 
-    /// @brief Inserts the given element at the end of the underlying data container,
-    /// If the interal data structure is full already then this method will assert and stop the application.
-    /// Because if we do not we could cause an out of bounds write, which could possibly overwrite other memory.
-    /// Causing hard to debug issues, therefore this behaviour is not allowed in the first place
+    /// @brief Copies the given element to the end of the underlying data container,
+    /// if the capacity has been reached already it is doubled and all elements are moved into the newly allocated memory
     /// @param element Element that should be inserted at the end
     void push_back(T const & element) {
-        if (m_size == m_capacity) {
-            m_capacity = (m_capacity == 0) ? 1 : 2 * m_capacity;
-            T* new_elements = new T[m_capacity]();
-            if (m_elements != nullptr) {
-                memcpy(new_elements, m_elements, m_size * sizeof(T));
-                delete[] m_elements;
-            }
-            m_elements = new_elements;
+        (void)emplace_back(element);
+    }
+
+    /// @brief Moves the given element to the end of the underlying data container,
+    /// if the capacity has been reached already it is doubled and all elements are moved into the newly allocated memory
+    /// @param element Element that should be inserted at the end
+    void push_back(T && element) {
+        (void)emplace_back(static_cast<T &&>(element));
+    }
+
+    /// @brief Constructs an element directly at the end of the underlying data container, instead of constructing it first and then copying it,
+    /// if the capacity has been reached already it is doubled and all elements are moved into the newly allocated memory
+    /// @tparam ...Args Types of the arguments that are forwarded to the constructor of the element
+    /// @param ...args Arguments that are forwarded to the constructor of the element
+    /// @return Pointer to the constructed element or nullptr if the capacity could not be increased, because the Allocator_Policy ran out of memory
+    template<typename... Args>
+    T * emplace_back(Args &&... args) {
+        // Casting to the deduced reference type forwards lvalues as lvalues and rvalues as rvalues, like std::forward
+        if (m_size != m_capacity) {
+            T * element = new (Allocator_Placement(), m_elements + m_size) T(static_cast<Args &&>(args)...);
+            m_size++;
+            return element;
+        }
+        size_t const capacity = m_capacity == 0U ? 1U : 2U * m_capacity;
+        T * new_elements = allocate(capacity);
+        if (new_elements == nullptr) {
+            return nullptr;
         }
-        m_elements[m_size] = element;
+        // The new element has to be constructed before the previous elements are moved and their memory is freed,
+        // because the arguments might reference one of them, for example when calling push_back(vector[0])
+        T * element = new (Allocator_Placement(), new_elements + m_size) T(static_cast<Args &&>(args)...);
+        relocate(new_elements, capacity);
         m_size++;
+        return element;
+    }
+
+    /// @brief Destroys the last element of the underlying data container
+    void pop_back() {
+        assert(m_size != 0U);
+        m_size--;
+        m_elements[m_size].~T();
     }
 
     /// @brief Inserts all element from the given start to the given end iterator into the underlying data container.
@@ -172,7 +274,7 @@ class Vector {
         }
     }
 
-    /// @brief Removes the element at the given position, has to move all element one to the left if the index is not at the end of the array
+    /// @brief Removes the element at the given position, has to move all element one to the left if the index is not at the end of the vector
     /// @tparam InputIterator Class that points to the begin and end iterator
     /// of the given data container, allows for using / passing either std::vector or std::array.
     /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
@@ -184,13 +286,31 @@ class Vector {
         if (index < m_size) {
             // Move all elements after the index one position to the left
             for (size_t i = index; i < m_size - 1; ++i) {
-                m_elements[i] = m_elements[i + 1];
+                m_elements[i] = static_cast<T &&>(m_elements[i + 1]);
             }
-            // Decrease the size of the vector to remove the last element, because either it was moved one index to the left or was the element we wanted to delete
-            m_size--;
+            // Destroy the last element, because either it was moved one index to the left or was the element we wanted to delete
+            pop_back();
         }
     }
 
+    /// @brief Removes the element at the given position, by moving the last element into its position instead of moving all following elements.
+    /// Is therefore O(1), but does not keep the order of the remaining elements and should only be used if their order does not matter
+    /// @tparam InputIterator Class that points to the begin and end iterator
+    /// of the given data container, allows for using / passing either std::vector or std::array.
+    /// See https://en.cppreference.com/w/cpp/iterator/input_iterator for more information on the requirements of the iterator
+    /// @param position Iterator pointing to the element, that should be removed from the underlying data container
+    template<typename InputIterator>
+    void erase_unordered(InputIterator const & position) {
+        size_t const index = Helper::distance(begin(), position);
+        if (index >= m_size) {
+            return;
+        }
+        else if (index != m_size - 1U) {
+            m_elements[index] = static_cast<T &&>(m_elements[m_size - 1U]);
+        }
+        pop_back();
+    }
+
     /// @brief Method to access an element at a given index,
     /// ensures the device crashes if we attempted to access in an invalid location
     /// @param index Index we want to get the corresponding element for
@@ -214,12 +334,55 @@ class Vector {
     }
 
     /// @brief Clears the given underlying data container.
-    /// Simply sets the underlying size to 0, data will only be cleared in the destructor
+    /// Destroys all elements, but keeps the allocated memory, call shrink_to_fit() afterwards to free it as well
     void clear() {
-        m_size = 0;
+        while (m_size > 0U) {
+            pop_back();
+        }
     }
 
   private:
+    /// @brief Moves all elements into newly allocated uninitialized memory with the given capacity and frees the previous memory
+    /// @param capacity Amount of elements the newly allocated memory can hold, has to be atleast the amount of elements currently contained
+    /// @return Whether the memory could be allocated, if not the elements are kept in the previous memory
+    bool reallocate(size_t const & capacity) {
+        T * new_elements = allocate(capacity);
+        if (capacity != 0U && new_elements == nullptr) {
+            return false;
+        }
+        relocate(new_elements, capacity);
+        return true;
+    }
+
+    /// @brief Moves all elements into the given uninitialized memory, destroys them in the previous memory and frees it afterwards
+    /// @param new_elements Pointer to the memory the elements should be moved into, has to hold atleast the amount of elements currently contained
+    /// @param capacity Amount of elements the given memory can hold
+    void relocate(T * new_elements, size_t const & capacity) {
+        for (size_t i = 0U; i < m_size; ++i) {
+            new (Allocator_Placement(), new_elements + i) T(static_cast<T &&>(m_elements[i]));
+            m_elements[i].~T();
+        }
+        deallocate(m_elements);
+        m_elements = new_elements;
+        m_capacity = capacity;
+    }
+
+    /// @brief Allocates uninitialized memory for the given amount of elements, accounted to the subsystem of the current Memory_Scope or to Memory_Subsystem::CALLBACKS if there is none
+    /// @param capacity Amount of elements the allocated memory should be able to hold
+    /// @return Pointer to the allocated memory or nullptr if the capacity is 0 or the Allocator_Policy ran out of memory
+    static T * allocate(size_t const & capacity) {
+        if (capacity == 0U) {
+            return nullptr;
+        }
+        return static_cast<T *>(Allocator_Policy::allocate(capacity * sizeof(T), Memory_Scope::Current_Or(Memory_Subsystem::CALLBACKS)));
+    }
+
+    /// @brief Frees the given uninitialized memory, all elements have to be destroyed beforehand
+    /// @param elements Pointer to the memory that should be freed, may be nullptr
+    static void deallocate(T * elements) {
+        Allocator_Policy::deallocate(elements);
+    }
+
     T      *m_elements = {}; // Pointer to the start of our elements
     size_t m_capacity = {};  // Allocated capacity that shows how many elements we could hold
     size_t m_size = {};      // Used size that shows how many elements we entered